@@ -18,7 +18,20 @@ uniform samplerCube MonteCarloPrefilter;
 uniform sampler2D Normal;
 uniform sampler2D Roughness;
 
-uniform vec3 camera_position;
+// Per frame data (see frame/opengl/uniform_blocks.h).
+layout(std140) uniform FrameBlock
+{
+	mat4 projection;
+	mat4 view;
+	mat4 projection_inv;
+	mat4 view_inv;
+	mat4 env_map_model;
+	vec3 camera_position;
+	float time_s;
+	vec3 light_dir;
+	float time;
+	vec3 light_color;
+};
 
 // ----------------------------------------------------------------------------
 // Easy trick to get tangent-normals to world-space to keep PBR code simplified.
@@ -3,20 +3,42 @@
 layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec3 in_normal;
 layout(location = 2) in vec2 in_texcoord;
+layout(location = 8) in mat4 in_instance_model;
 
 out vec3 vert_world_position;
 out vec3 vert_normal;
 out vec2 vert_texcoord;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+// Per frame data (see frame/opengl/uniform_blocks.h).
+layout(std140) uniform FrameBlock
+{
+	mat4 projection;
+	mat4 view;
+	mat4 projection_inv;
+	mat4 view_inv;
+	mat4 env_map_model;
+	vec3 camera_position;
+	float time_s;
+	vec3 light_dir;
+	float time;
+	vec3 light_color;
+};
+
+// Per object data.
+layout(std140) uniform ObjectBlock
+{
+	mat4 model;
+	mat4 model_inv;
+};
+
+uniform int instancing_enabled;
 
 void main()
 {
 	vert_texcoord = in_texcoord;
-	vert_world_position = vec3(model * vec4(in_position, 1.0));
-	vert_normal = mat3(model) * in_normal;
+	mat4 world_model = (instancing_enabled != 0) ? in_instance_model : model;
+	vert_world_position = vec3(world_model * vec4(in_position, 1.0));
+	vert_normal = mat3(world_model) * in_normal;
 
 	gl_Position = projection * view * vec4(vert_world_position, 1.0);
 }
@@ -5,15 +5,36 @@ layout(location = 1) in vec3 in_normal;
 layout(location = 2) in vec2 in_texcoord;
 layout(location = 3) in ivec4 in_bone_ids;
 layout(location = 4) in vec4 in_bone_weights;
+layout(location = 8) in mat4 in_instance_model;
 
 out vec3 vert_normal;
 out vec3 vert_position;
 out vec2 vert_texcoord;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+// Per frame data (see frame/opengl/uniform_blocks.h).
+layout(std140) uniform FrameBlock
+{
+	mat4 projection;
+	mat4 view;
+	mat4 projection_inv;
+	mat4 view_inv;
+	mat4 env_map_model;
+	vec3 camera_position;
+	float time_s;
+	vec3 light_dir;
+	float time;
+	vec3 light_color;
+};
+
+// Per object data.
+layout(std140) uniform ObjectBlock
+{
+	mat4 model;
+	mat4 model_inv;
+};
+
 uniform int skinning_enabled;
+uniform int instancing_enabled;
 uniform mat4 bone_matrices[128];
 
 void main()
@@ -30,9 +51,10 @@ void main()
 		local_position = skin * local_position;
 		local_normal = mat3(skin) * local_normal;
 	}
-	vert_normal = normalize(mat3(model) * local_normal);
+	mat4 world_model = (instancing_enabled != 0) ? in_instance_model : model;
+	vert_normal = normalize(mat3(world_model) * local_normal);
 	vert_texcoord = in_texcoord;
-	mat4 pvm = projection * view * model;
+	mat4 pvm = projection * view * world_model;
 	vert_position = (pvm * local_position).xyz;
 	gl_Position = pvm * local_position;
 }
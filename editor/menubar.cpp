@@ -165,6 +165,11 @@ void Menubar::MenuView()
         {
             menubar_view_.ShowLoggerWindow();
         }
+        if (ImGui::MenuItem(
+                "Show GPU Profiler", nullptr, &show_gpu_profiler_))
+        {
+            menubar_view_.ShowGpuProfilerWindow();
+        }
         ImGui::Separator();
         if (ImGui::BeginMenu("Texture"))
         {
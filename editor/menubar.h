@@ -67,6 +67,7 @@ class Menubar : public GuiMenuBarInterface
     bool end_ = true;
     bool show_logger_ = false;
     bool show_resolution_ = false;
+    bool show_gpu_profiler_ = false;
     MenubarFile& menubar_file_;
     MenubarView& menubar_view_;
     DeviceInterface& device_;
@@ -7,6 +7,7 @@
 #include <imgui_impl_sdl3.h>
 
 #include "frame/gui/window_cubemap.h"
+#include "frame/gui/window_gpu_profiler.h"
 #include "frame/gui/window_logger.h"
 #include "frame/gui/window_texture.h"
 #include "frame/opengl/texture.h"
@@ -67,6 +68,24 @@ void MenubarView::ShowLoggerWindow()
     window_state_["Logger"] = !window_state_["Logger"];
 }
 
+void MenubarView::ShowGpuProfilerWindow()
+{
+    if (!window_state_.contains("GPU Profiler"))
+    {
+        window_state_["GPU Profiler"] = false;
+    }
+    if (window_state_["GPU Profiler"])
+    {
+        draw_gui_.DeleteWindow("GPU Profiler");
+    }
+    else
+    {
+        draw_gui_.AddWindow(
+            std::make_unique<WindowGpuProfiler>("GPU Profiler", device_));
+    }
+    window_state_["GPU Profiler"] = !window_state_["GPU Profiler"];
+}
+
 void MenubarView::ShowResolutionWindow()
 {
     if (!window_state_.contains("Resolution"))
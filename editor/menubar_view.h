@@ -34,6 +34,7 @@ class MenubarView
   public:
     void ShowLoggerWindow();
     void ShowResolutionWindow();
+    void ShowGpuProfilerWindow();
     void ShowTexturesWindow(DeviceInterface& device);
     void Reset();
     
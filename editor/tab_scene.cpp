@@ -7,6 +7,8 @@
 #include <unordered_set>
 #include <imgui.h>
 
+#include "frame/camera.h"
+
 namespace frame::gui
 {
 
@@ -33,11 +35,55 @@ const char* NodeTypeToLabel(frame::NodeTypeEnum type)
 
 } // namespace
 
+void TabScene::PickFromMouse(LevelInterface& level)
+{
+    const ImGuiIO& io = ImGui::GetIO();
+    // Only clicks that are not on a window.
+    if (io.WantCaptureMouse || !ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+    {
+        return;
+    }
+    if (io.DisplaySize.x <= 0.0f || io.DisplaySize.y <= 0.0f)
+    {
+        return;
+    }
+    Camera camera(level.GetDefaultCamera());
+    camera.SetAspectRatio(io.DisplaySize.x / io.DisplaySize.y);
+    const glm::mat4 inverse_view_projection =
+        glm::inverse(camera.ComputeProjection() * camera.ComputeView());
+    const float x = 2.0f * io.MousePos.x / io.DisplaySize.x - 1.0f;
+    const float y = 1.0f - 2.0f * io.MousePos.y / io.DisplaySize.y;
+    glm::vec4 near_point = inverse_view_projection * glm::vec4(x, y, -1.0f, 1.0f);
+    glm::vec4 far_point = inverse_view_projection * glm::vec4(x, y, 1.0f, 1.0f);
+    near_point /= near_point.w;
+    far_point /= far_point.w;
+    const auto maybe_hit = level.PickNode(
+        glm::vec3(near_point), glm::vec3(far_point - near_point));
+    selected_node_id_ = maybe_hit ? maybe_hit->id : NullId;
+}
+
 void TabScene::Draw(LevelInterface& level)
 {
     ImGui::TextUnformatted("Scene Tree");
     ImGui::Separator();
 
+    PickFromMouse(level);
+    if (selected_node_id_)
+    {
+        try
+        {
+            ImGui::Text(
+                "Selected: %s",
+                level.GetNameFromId(selected_node_id_).c_str());
+            ImGui::Separator();
+        }
+        catch (const std::exception&)
+        {
+            // The node was removed from the level.
+            selected_node_id_ = NullId;
+        }
+    }
+
     const auto root_id = level.GetDefaultRootSceneNodeId();
     if (!root_id)
     {
@@ -86,6 +132,10 @@ void TabScene::Draw(LevelInterface& level)
         {
             flags |= ImGuiTreeNodeFlags_DefaultOpen;
         }
+        if (node_id == selected_node_id_)
+        {
+            flags |= ImGuiTreeNodeFlags_Selected;
+        }
 
         const char* node_type = NodeTypeToLabel(node_ptr->GetNodeType());
         const bool open = ImGui::TreeNodeEx(
@@ -95,6 +145,10 @@ void TabScene::Draw(LevelInterface& level)
             node_name.c_str(),
             node_type,
             static_cast<long long>(node_id));
+        if (ImGui::IsItemClicked())
+        {
+            selected_node_id_ = node_id;
+        }
         if (!is_leaf && open)
         {
             for (const auto child_id : children)
@@ -15,6 +15,13 @@ class TabScene : public TabInterface
     ~TabScene() override = default;
 
     void Draw(LevelInterface& level) override;
+
+  private:
+    // Select the closest mesh node under the mouse (click in the viewport).
+    void PickFromMouse(LevelInterface& level);
+
+  private:
+    EntityId selected_node_id_ = NullId;
 };
 
 } // namespace frame::gui
@@ -0,0 +1,418 @@
+#include "frame/aabb_tree.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <format>
+
+namespace frame
+{
+
+namespace
+{
+
+AABB Union(const AABB& a, const AABB& b)
+{
+    AABB result;
+    result.min = glm::min(a.min, b.min);
+    result.max = glm::max(a.max, b.max);
+    return result;
+}
+
+float Area(const AABB& aabb)
+{
+    const glm::vec3 d = aabb.max - aabb.min;
+    return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool Contains(const AABB& outer, const AABB& inner)
+{
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) &&
+           glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+bool Overlaps(const AABB& a, const AABB& b)
+{
+    return glm::all(glm::lessThanEqual(a.min, b.max)) &&
+           glm::all(glm::greaterThanEqual(a.max, b.min));
+}
+
+// Slab test, return the entry distance or nullopt.
+std::optional<float> IntersectRay(
+    const AABB& aabb,
+    const glm::vec3& origin,
+    const glm::vec3& inv_direction,
+    float max_distance)
+{
+    const glm::vec3 t0 = (aabb.min - origin) * inv_direction;
+    const glm::vec3 t1 = (aabb.max - origin) * inv_direction;
+    const glm::vec3 t_min = glm::min(t0, t1);
+    const glm::vec3 t_max = glm::max(t0, t1);
+    const float enter = std::max({t_min.x, t_min.y, t_min.z, 0.f});
+    const float exit = std::min({t_max.x, t_max.y, t_max.z, max_distance});
+    if (enter > exit)
+    {
+        return std::nullopt;
+    }
+    return enter;
+}
+
+} // namespace
+
+AABBTree::AABBTree(float margin) : margin_(margin)
+{
+}
+
+std::int32_t AABBTree::AllocateNode()
+{
+    if (free_list_ == kNullNode)
+    {
+        nodes_.emplace_back();
+        nodes_.back().height = 0;
+        return static_cast<std::int32_t>(nodes_.size() - 1);
+    }
+    // Free nodes are chained through their parent index.
+    const std::int32_t node = free_list_;
+    free_list_ = nodes_[node].parent;
+    nodes_[node] = Node{};
+    nodes_[node].height = 0;
+    return node;
+}
+
+void AABBTree::FreeNode(std::int32_t node)
+{
+    nodes_[node].parent = free_list_;
+    nodes_[node].height = -1;
+    nodes_[node].left = kNullNode;
+    nodes_[node].right = kNullNode;
+    nodes_[node].id = NullId;
+    free_list_ = node;
+}
+
+std::int32_t AABBTree::Insert(const AABB& aabb, EntityId id)
+{
+    const std::int32_t proxy = AllocateNode();
+    auto& node = nodes_[proxy];
+    node.aabb = aabb;
+    node.fat_aabb.min = aabb.min - glm::vec3(margin_);
+    node.fat_aabb.max = aabb.max + glm::vec3(margin_);
+    node.id = id;
+    InsertLeaf(proxy);
+    ++proxy_count_;
+    return proxy;
+}
+
+void AABBTree::Remove(std::int32_t proxy)
+{
+    if (proxy < 0 || proxy >= static_cast<std::int32_t>(nodes_.size()) ||
+        !nodes_[proxy].IsLeaf() || nodes_[proxy].height != 0)
+    {
+        throw std::runtime_error(
+            std::format("Invalid AABB tree proxy #{}.", proxy));
+    }
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    --proxy_count_;
+}
+
+bool AABBTree::Move(std::int32_t proxy, const AABB& aabb)
+{
+    if (proxy < 0 || proxy >= static_cast<std::int32_t>(nodes_.size()) ||
+        !nodes_[proxy].IsLeaf() || nodes_[proxy].height != 0)
+    {
+        throw std::runtime_error(
+            std::format("Invalid AABB tree proxy #{}.", proxy));
+    }
+    nodes_[proxy].aabb = aabb;
+    if (Contains(nodes_[proxy].fat_aabb, aabb))
+    {
+        return false;
+    }
+    RemoveLeaf(proxy);
+    nodes_[proxy].fat_aabb.min = aabb.min - glm::vec3(margin_);
+    nodes_[proxy].fat_aabb.max = aabb.max + glm::vec3(margin_);
+    InsertLeaf(proxy);
+    return true;
+}
+
+void AABBTree::Clear()
+{
+    nodes_.clear();
+    root_ = kNullNode;
+    free_list_ = kNullNode;
+    proxy_count_ = 0;
+}
+
+void AABBTree::InsertLeaf(std::int32_t leaf)
+{
+    nodes_[leaf].parent = kNullNode;
+    if (root_ == kNullNode)
+    {
+        root_ = leaf;
+        return;
+    }
+    // Find the best sibling with the surface area heuristic.
+    const AABB leaf_aabb = nodes_[leaf].fat_aabb;
+    std::int32_t index = root_;
+    while (!nodes_[index].IsLeaf())
+    {
+        const auto& node = nodes_[index];
+        const float area = Area(node.fat_aabb);
+        const float combined_area = Area(Union(node.fat_aabb, leaf_aabb));
+        // Cost of creating a new parent here.
+        const float cost = 2.f * combined_area;
+        // Minimum cost of pushing the leaf further down.
+        const float inheritance_cost = 2.f * (combined_area - area);
+        auto child_cost = [&](std::int32_t child) {
+            const AABB merged = Union(nodes_[child].fat_aabb, leaf_aabb);
+            if (nodes_[child].IsLeaf())
+            {
+                return Area(merged) + inheritance_cost;
+            }
+            return Area(merged) - Area(nodes_[child].fat_aabb) +
+                   inheritance_cost;
+        };
+        const float cost_left = child_cost(node.left);
+        const float cost_right = child_cost(node.right);
+        if (cost < cost_left && cost < cost_right)
+        {
+            break;
+        }
+        index = (cost_left < cost_right) ? node.left : node.right;
+    }
+    const std::int32_t sibling = index;
+    const std::int32_t old_parent = nodes_[sibling].parent;
+    const std::int32_t new_parent = AllocateNode();
+    nodes_[new_parent].parent = old_parent;
+    nodes_[new_parent].fat_aabb = Union(leaf_aabb, nodes_[sibling].fat_aabb);
+    nodes_[new_parent].height = nodes_[sibling].height + 1;
+    nodes_[new_parent].left = sibling;
+    nodes_[new_parent].right = leaf;
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+    if (old_parent == kNullNode)
+    {
+        root_ = new_parent;
+    }
+    else if (nodes_[old_parent].left == sibling)
+    {
+        nodes_[old_parent].left = new_parent;
+    }
+    else
+    {
+        nodes_[old_parent].right = new_parent;
+    }
+    FixUpwards(nodes_[leaf].parent);
+}
+
+void AABBTree::RemoveLeaf(std::int32_t leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = kNullNode;
+        return;
+    }
+    const std::int32_t parent = nodes_[leaf].parent;
+    const std::int32_t grand_parent = nodes_[parent].parent;
+    const std::int32_t sibling = (nodes_[parent].left == leaf)
+                                     ? nodes_[parent].right
+                                     : nodes_[parent].left;
+    if (grand_parent == kNullNode)
+    {
+        root_ = sibling;
+        nodes_[sibling].parent = kNullNode;
+        FreeNode(parent);
+        return;
+    }
+    if (nodes_[grand_parent].left == parent)
+    {
+        nodes_[grand_parent].left = sibling;
+    }
+    else
+    {
+        nodes_[grand_parent].right = sibling;
+    }
+    nodes_[sibling].parent = grand_parent;
+    FreeNode(parent);
+    FixUpwards(grand_parent);
+}
+
+void AABBTree::FixUpwards(std::int32_t index)
+{
+    while (index != kNullNode)
+    {
+        index = Balance(index);
+        auto& node = nodes_[index];
+        node.height =
+            1 + std::max(nodes_[node.left].height, nodes_[node.right].height);
+        node.fat_aabb =
+            Union(nodes_[node.left].fat_aabb, nodes_[node.right].fat_aabb);
+        index = node.parent;
+    }
+}
+
+std::int32_t AABBTree::Balance(std::int32_t a)
+{
+    // Rotate the taller child up if the node is unbalanced (AVL like).
+    if (nodes_[a].IsLeaf() || nodes_[a].height < 2)
+    {
+        return a;
+    }
+    const std::int32_t b = nodes_[a].left;
+    const std::int32_t c = nodes_[a].right;
+    const std::int32_t balance = nodes_[c].height - nodes_[b].height;
+    if (balance >= -1 && balance <= 1)
+    {
+        return a;
+    }
+    // Child to be promoted (up) and child that stays (other).
+    const std::int32_t up = (balance > 1) ? c : b;
+    const std::int32_t other = (balance > 1) ? b : c;
+    const std::int32_t f = nodes_[up].left;
+    const std::int32_t g = nodes_[up].right;
+    // Swap a and up.
+    nodes_[up].left = a;
+    nodes_[up].parent = nodes_[a].parent;
+    nodes_[a].parent = up;
+    if (nodes_[up].parent == kNullNode)
+    {
+        root_ = up;
+    }
+    else if (nodes_[nodes_[up].parent].left == a)
+    {
+        nodes_[nodes_[up].parent].left = up;
+    }
+    else
+    {
+        nodes_[nodes_[up].parent].right = up;
+    }
+    // Keep the tallest grand child under up, move the other one under a.
+    const bool f_taller = nodes_[f].height > nodes_[g].height;
+    const std::int32_t keep = f_taller ? f : g;
+    const std::int32_t move = f_taller ? g : f;
+    nodes_[up].right = keep;
+    if (balance > 1)
+    {
+        nodes_[a].right = move;
+    }
+    else
+    {
+        nodes_[a].left = move;
+    }
+    nodes_[move].parent = a;
+    nodes_[a].fat_aabb = Union(nodes_[other].fat_aabb, nodes_[move].fat_aabb);
+    nodes_[a].height =
+        1 + std::max(nodes_[other].height, nodes_[move].height);
+    nodes_[up].fat_aabb = Union(nodes_[a].fat_aabb, nodes_[keep].fat_aabb);
+    nodes_[up].height = 1 + std::max(nodes_[a].height, nodes_[keep].height);
+    return up;
+}
+
+void AABBTree::QueryBox(
+    const AABB& aabb, const std::function<bool(EntityId)>& callback) const
+{
+    if (root_ == kNullNode)
+    {
+        return;
+    }
+    std::vector<std::int32_t> stack = {root_};
+    while (!stack.empty())
+    {
+        const auto& node = nodes_[stack.back()];
+        stack.pop_back();
+        // Leaves are tested with their tight box, like a brute force query.
+        if (!Overlaps(node.IsLeaf() ? node.aabb : node.fat_aabb, aabb))
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            if (!callback(node.id))
+            {
+                return;
+            }
+            continue;
+        }
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+}
+
+void AABBTree::QueryFrustum(
+    const Frustum& frustum,
+    const std::function<bool(EntityId)>& callback) const
+{
+    if (root_ == kNullNode)
+    {
+        return;
+    }
+    // Second element is true if the parent was already fully inside.
+    std::vector<std::pair<std::int32_t, bool>> stack = {{root_, false}};
+    while (!stack.empty())
+    {
+        const auto [index, inside] = stack.back();
+        stack.pop_back();
+        const auto& node = nodes_[index];
+        bool node_inside = inside;
+        if (!node_inside)
+        {
+            // A fat box inside the frustum has its tight box inside too.
+            const AABB& bounds = node.IsLeaf() ? node.aabb : node.fat_aabb;
+            if (!frustum.IsVisible(bounds))
+            {
+                continue;
+            }
+            node_inside = frustum.Contains(bounds);
+        }
+        if (node.IsLeaf())
+        {
+            if (!callback(node.id))
+            {
+                return;
+            }
+            continue;
+        }
+        stack.push_back({node.left, node_inside});
+        stack.push_back({node.right, node_inside});
+    }
+}
+
+std::optional<RayHit> AABBTree::QueryRay(
+    const glm::vec3& origin,
+    const glm::vec3& direction,
+    float max_distance) const
+{
+    if (root_ == kNullNode)
+    {
+        return std::nullopt;
+    }
+    // Division by zero gives infinities which the slab test handles.
+    const glm::vec3 inv_direction = 1.f / direction;
+    std::optional<RayHit> best = std::nullopt;
+    float best_distance = max_distance;
+    std::vector<std::int32_t> stack = {root_};
+    while (!stack.empty())
+    {
+        const auto& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!IntersectRay(node.fat_aabb, origin, inv_direction, best_distance))
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            auto maybe_distance =
+                IntersectRay(node.aabb, origin, inv_direction, best_distance);
+            if (maybe_distance)
+            {
+                best_distance = *maybe_distance;
+                best = RayHit{node.id, *maybe_distance};
+            }
+            continue;
+        }
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+    return best;
+}
+
+} // End namespace frame.
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "frame/bvh.h"
+#include "frame/entity_id.h"
+#include "frame/frustum.h"
+
+namespace frame
+{
+
+/**
+ * @class RayHit
+ * @brief Result of a ray query against the tree bounds.
+ */
+struct RayHit
+{
+    EntityId id = NullId;
+    float distance = 0.f;
+};
+
+/**
+ * @class AABBTree
+ * @brief Dynamic AABB tree (incremental insert/remove/move) over world space
+ *        boxes, leaves store a fattened box so small motions don't touch the
+ *        tree. Used by the level to cull and pick scene nodes.
+ */
+class AABBTree
+{
+  public:
+    //! @brief Invalid proxy / node index.
+    static constexpr std::int32_t kNullNode = -1;
+    /**
+     * @brief Constructor.
+     * @param margin: Distance the leaf boxes are fattened by.
+     */
+    explicit AABBTree(float margin = 0.1f);
+
+  public:
+    /**
+     * @brief Insert a box in the tree.
+     * @param aabb: Tight world space box.
+     * @param id: Payload returned by the queries.
+     * @return The proxy used to move or remove the box.
+     */
+    std::int32_t Insert(const AABB& aabb, EntityId id);
+    /**
+     * @brief Remove a proxy from the tree.
+     * @param proxy: Proxy returned by insert.
+     */
+    void Remove(std::int32_t proxy);
+    /**
+     * @brief Update the box of a proxy, the tree is only modified when the
+     *        new box leaves the fat one.
+     * @param proxy: Proxy returned by insert.
+     * @param aabb: New tight world space box.
+     * @return True if the proxy was reinserted.
+     */
+    bool Move(std::int32_t proxy, const AABB& aabb);
+    //! @brief Remove everything from the tree.
+    void Clear();
+    /**
+     * @brief Call back every payload whose fat box overlaps the box.
+     * @param aabb: Query box.
+     * @param callback: Called with the payload, return false to stop.
+     */
+    void QueryBox(
+        const AABB& aabb,
+        const std::function<bool(EntityId)>& callback) const;
+    /**
+     * @brief Call back every payload whose fat box is inside the frustum,
+     *        fully visible subtrees are accepted without further tests.
+     * @param frustum: Query frustum.
+     * @param callback: Called with the payload, return false to stop.
+     */
+    void QueryFrustum(
+        const Frustum& frustum,
+        const std::function<bool(EntityId)>& callback) const;
+    /**
+     * @brief Get the closest payload whose tight box is hit by a ray.
+     * @param origin: Origin of the ray.
+     * @param direction: Direction of the ray (doesn't need to be unit).
+     * @param max_distance: Maximum distance in direction units.
+     * @return The hit or nullopt.
+     */
+    std::optional<RayHit> QueryRay(
+        const glm::vec3& origin,
+        const glm::vec3& direction,
+        float max_distance = std::numeric_limits<float>::max()) const;
+
+  public:
+    /**
+     * @brief Get the payload of a proxy.
+     * @param proxy: Proxy returned by insert.
+     * @return The payload id.
+     */
+    EntityId GetId(std::int32_t proxy) const
+    {
+        return nodes_.at(proxy).id;
+    }
+    /**
+     * @brief Get the fat box of a proxy.
+     * @param proxy: Proxy returned by insert.
+     * @return The fat box stored in the tree.
+     */
+    const AABB& GetFatAABB(std::int32_t proxy) const
+    {
+        return nodes_.at(proxy).fat_aabb;
+    }
+    /**
+     * @brief Height of the tree (0 if empty or a single leaf).
+     * @return The height of the root.
+     */
+    std::int32_t GetHeight() const
+    {
+        return root_ == kNullNode ? 0 : nodes_[root_].height;
+    }
+    /**
+     * @brief Number of proxies in the tree.
+     * @return Leaf count.
+     */
+    std::size_t GetProxyCount() const
+    {
+        return proxy_count_;
+    }
+
+  private:
+    struct Node
+    {
+        AABB fat_aabb = {};
+        // Tight box, used by ray queries so picking isn't fooled by the
+        // margin.
+        AABB aabb = {};
+        EntityId id = NullId;
+        std::int32_t parent = kNullNode;
+        std::int32_t left = kNullNode;
+        std::int32_t right = kNullNode;
+        // Leaf is 0, free node is -1.
+        std::int32_t height = -1;
+        bool IsLeaf() const
+        {
+            return left == kNullNode;
+        }
+    };
+    std::int32_t AllocateNode();
+    void FreeNode(std::int32_t node);
+    void InsertLeaf(std::int32_t leaf);
+    void RemoveLeaf(std::int32_t leaf);
+    std::int32_t Balance(std::int32_t node);
+    void FixUpwards(std::int32_t node);
+
+  private:
+    std::vector<Node> nodes_;
+    std::int32_t root_ = kNullNode;
+    std::int32_t free_list_ = kNullNode;
+    std::size_t proxy_count_ = 0;
+    float margin_ = 0.1f;
+};
+
+} // End namespace frame.
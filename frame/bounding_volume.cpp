@@ -0,0 +1,56 @@
+#include "frame/bounding_volume.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace frame
+{
+
+BoundingVolume ComputeBoundingVolume(const std::vector<float>& points)
+{
+    BoundingVolume bounding_volume;
+    if (points.size() < 3)
+    {
+        return bounding_volume;
+    }
+    for (std::size_t i = 0; i + 2 < points.size(); i += 3)
+    {
+        bounding_volume.aabb.expand(
+            glm::vec3(points[i], points[i + 1], points[i + 2]));
+    }
+    // Sphere centered on the box, radius from the farthest point (tighter
+    // than the half diagonal of the box).
+    const glm::vec3 center =
+        (bounding_volume.aabb.min + bounding_volume.aabb.max) * 0.5f;
+    float radius_squared = 0.f;
+    for (std::size_t i = 0; i + 2 < points.size(); i += 3)
+    {
+        const glm::vec3 delta =
+            glm::vec3(points[i], points[i + 1], points[i + 2]) - center;
+        radius_squared = std::max(radius_squared, glm::dot(delta, delta));
+    }
+    bounding_volume.sphere.center = center;
+    bounding_volume.sphere.radius = std::sqrt(radius_squared);
+    return bounding_volume;
+}
+
+AABB TransformAABB(const AABB& aabb, const glm::mat4& model)
+{
+    // Arvo's method: project the extents on each axis of the new basis.
+    const glm::vec3 center = (aabb.min + aabb.max) * 0.5f;
+    const glm::vec3 extent = (aabb.max - aabb.min) * 0.5f;
+    const glm::vec3 new_center = glm::vec3(model * glm::vec4(center, 1.f));
+    glm::vec3 new_extent(0.f);
+    for (int row = 0; row < 3; ++row)
+    {
+        new_extent[row] = std::abs(model[0][row]) * extent.x +
+                          std::abs(model[1][row]) * extent.y +
+                          std::abs(model[2][row]) * extent.z;
+    }
+    AABB result;
+    result.min = new_center - new_extent;
+    result.max = new_center + new_extent;
+    return result;
+}
+
+} // End namespace frame.
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "frame/bvh.h"
+
+namespace frame
+{
+
+/**
+ * @class BoundingSphere
+ * @brief Sphere enclosing a mesh, a negative radius means no bounds.
+ */
+struct BoundingSphere
+{
+    glm::vec3 center{0.f};
+    float radius{-1.f};
+};
+
+/**
+ * @class BoundingVolume
+ * @brief Local space bounds of a mesh, computed once at load time and used
+ *        by the renderers to cull what is outside of the view.
+ */
+struct BoundingVolume
+{
+    AABB aabb = {};
+    BoundingSphere sphere = {};
+    /**
+     * @brief Check if the volume was computed (an empty volume is never
+     *        culled).
+     * @return True if the bounds are usable.
+     */
+    bool IsValid() const
+    {
+        return sphere.radius >= 0.f && aabb.min.x <= aabb.max.x &&
+               aabb.min.y <= aabb.max.y && aabb.min.z <= aabb.max.z;
+    }
+};
+
+/**
+ * @brief Compute the bounding volume of a point list.
+ * @param points: Flat list of points (x, y, z triplets).
+ * @return The bounding volume (invalid if there are no points).
+ */
+BoundingVolume ComputeBoundingVolume(const std::vector<float>& points);
+
+/**
+ * @brief Transform an AABB by a matrix (result is axis aligned again).
+ * @param aabb: Local space box.
+ * @param model: Model matrix to apply.
+ * @return The box enclosing the transformed box.
+ */
+AABB TransformAABB(const AABB& aabb, const glm::mat4& model);
+
+} // End namespace frame.
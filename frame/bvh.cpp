@@ -6,6 +6,9 @@
 #include <limits>
 #include <numeric>
 
+#include "frame/jobs.h"
+#include "frame/profiler.h"
+
 namespace frame
 {
 
@@ -16,6 +19,9 @@ constexpr int kBinCount = 12;
 constexpr float kMinExtent = 1e-5f;
 constexpr float kTraversalCost = 1.0f;
 constexpr float kTriangleCost = 1.0f;
+// Subtrees with more triangles are built by a job, smaller ones are not
+// worth the scheduling.
+constexpr int kParallelBuildTriangles = 4096;
 
 struct BuildTriangle
 {
@@ -46,6 +52,7 @@ float SurfaceArea(const AABB& bounds)
 std::vector<BVHNode> BuildBVH(
     const std::vector<float>& points, const std::vector<std::uint32_t>& indices)
 {
+    FRAME_PROFILE_SCOPE("Build BVH");
     const int tri_count = static_cast<int>(indices.size() / 3);
     std::vector<BuildTriangle> tris(static_cast<std::size_t>(tri_count));
     for (int i = 0; i < tri_count; ++i)
@@ -71,10 +78,13 @@ std::vector<BVHNode> BuildBVH(
     std::vector<int> tri_indices(static_cast<std::size_t>(tri_count));
     std::iota(tri_indices.begin(), tri_indices.end(), 0);
 
-    std::vector<BVHNode> nodes;
-    nodes.reserve(static_cast<std::size_t>(tri_count) * 2);
-
-    std::function<int(int, int)> build = [&](int start, int end) -> int {
+    auto& scheduler = jobs::Scheduler::GetInstance();
+    // Build the subtree of [start, end) at the end of nodes, returns the
+    // index of its root. Large subtrees build their children in separate
+    // vectors in parallel, then append them in the order of the serial
+    // build, so the layout does not depend on the threads.
+    std::function<int(int, int, std::vector<BVHNode>&)> build =
+        [&](int start, int end, std::vector<BVHNode>& nodes) -> int {
         AABB bounds;
         for (int i = start; i < end; ++i)
         {
@@ -233,14 +243,45 @@ std::vector<BVHNode> BuildBVH(
                 });
         }
 
-        node.left = build(start, mid);
-        node.right = build(mid, end);
+        if (count < kParallelBuildTriangles)
+        {
+            node.left = build(start, mid, nodes);
+            node.right = build(mid, end, nodes);
+            nodes[node_index] = node;
+            return node_index;
+        }
+        std::vector<BVHNode> left_nodes;
+        std::vector<BVHNode> right_nodes;
+        jobs::Counter counter;
+        scheduler.Run(
+            [&build, &left_nodes, start, mid] {
+                build(start, mid, left_nodes);
+            },
+            counter);
+        build(mid, end, right_nodes);
+        scheduler.Wait(counter);
+        auto append = [&nodes](const std::vector<BVHNode>& subtree) {
+            const int offset = static_cast<int>(nodes.size());
+            for (BVHNode child : subtree)
+            {
+                if (child.left >= 0)
+                    child.left += offset;
+                if (child.right >= 0)
+                    child.right += offset;
+                nodes.push_back(child);
+            }
+            return offset;
+        };
+        node.left = append(left_nodes);
+        node.right = append(right_nodes);
         nodes[node_index] = node;
         return node_index;
     };
 
+    std::vector<BVHNode> nodes;
+    nodes.reserve(static_cast<std::size_t>(tri_count) * 2);
     if (tri_count > 0)
-        build(0, tri_count);
+        build(0, tri_count, nodes);
     return nodes;
 }
 
@@ -4,6 +4,7 @@
 #include <fstream>
 
 #include "frame/logger.h"
+#include "frame/profiler.h"
 #include "frame/proto/bvh_cache.pb.h"
 
 namespace frame
@@ -24,6 +25,7 @@ Logger& GetLogger()
 std::optional<std::vector<BVHNode>> LoadBvhCache(
     const BvhCacheMetadata& metadata)
 {
+    FRAME_PROFILE_SCOPE("Load BVH cache");
     if (metadata.cache_path.empty())
     {
         return std::nullopt;
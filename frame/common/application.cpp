@@ -7,11 +7,19 @@
 #include "absl/strings/ascii.h"
 
 #include "frame/common/draw.h"
+#include "frame/jobs.h"
 #include "frame/logger.h"
+#include "frame/profiler.h"
 #include "frame/window_factory.h"
 #include "frame/vulkan/window_factory.h"
 
 ABSL_FLAG(std::string, device, "vulkan", "Rendering backend (vulkan|opengl).");
+ABSL_FLAG(
+    std::uint32_t,
+    job_workers,
+    0,
+    "Worker threads of the job system (0: one per core less the main "
+    "thread).");
 #if defined(_DEBUG)
 ABSL_FLAG(bool, vk_validation, true, "Enable Vulkan validation layers.");
 #else
@@ -22,6 +30,31 @@ ABSL_FLAG(
     auto_exit_seconds,
     0.0,
     "Auto-exit executable after N seconds (0 disables).");
+ABSL_FLAG(
+    std::uint32_t,
+    shader_compile_threads,
+    0,
+    "Shaders of a level compiled at once on the job system (0: one per "
+    "thread of the job system).");
+ABSL_FLAG(
+    std::uint32_t,
+    offscreen_frames,
+    1,
+    "Frames rendered per run by the headless Vulkan target.");
+ABSL_FLAG(
+    std::string,
+    offscreen_output,
+    "",
+    "Directory receiving the frame timings (frame_timings.csv), the GPU "
+    "pass timings (gpu_passes.csv), the CPU trace (cpu_trace.json) and the "
+    "last frame (final_frame.png) of a headless Vulkan run (empty "
+    "disables).");
+ABSL_FLAG(
+    std::string,
+    profile_trace,
+    "",
+    "File receiving the CPU profile as Chrome trace_event JSON each time the "
+    "window returns from Run (empty disables).");
 
 namespace frame::common
 {
@@ -42,6 +75,10 @@ Application::Application(
     DrawingTargetEnum drawing_target)
 {
     absl::ParseCommandLine(argc, argv);
+    if (const auto workers = absl::GetFlag(FLAGS_job_workers); workers != 0)
+    {
+        jobs::Scheduler::GetInstance().SetWorkerCount(workers);
+    }
     InitializeFromArgs(argc, argv, size, drawing_target);
 }
 
@@ -90,7 +127,14 @@ void Application::Resize(glm::uvec2 size, FullScreenEnum fullscreen_enum)
 
 WindowReturnEnum Application::Run(std::function<bool()> lambda)
 {
-    return GetWindow().Run(std::move(lambda));
+    FRAME_PROFILE_THREAD("Main");
+    const auto return_enum = GetWindow().Run(std::move(lambda));
+    const std::string trace_path = absl::GetFlag(FLAGS_profile_trace);
+    if (!trace_path.empty())
+    {
+        Profiler::GetInstance().WriteChromeTrace(trace_path);
+    }
+    return return_enum;
 }
 
 RenderingAPIEnum Application::ParseDeviceFlag(const std::string& value) const
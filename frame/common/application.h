@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -10,8 +11,13 @@
 #include "frame/api.h"
 #include "frame/window_interface.h"
 
+ABSL_DECLARE_FLAG(std::uint32_t, job_workers);
 ABSL_DECLARE_FLAG(bool, vk_validation);
 ABSL_DECLARE_FLAG(double, auto_exit_seconds);
+ABSL_DECLARE_FLAG(std::uint32_t, shader_compile_threads);
+ABSL_DECLARE_FLAG(std::uint32_t, offscreen_frames);
+ABSL_DECLARE_FLAG(std::string, offscreen_output);
+ABSL_DECLARE_FLAG(std::string, profile_trace);
 
 namespace frame::common
 {
@@ -5,6 +5,7 @@
 
 #include "frame/api.h"
 #include "frame/buffer_interface.h"
+#include "frame/gpu_pass_stats.h"
 #include "frame/level_interface.h"
 #include "frame/plugin_interface.h"
 #include "frame/texture_interface.h"
@@ -144,6 +145,17 @@ class DeviceInterface
      */
     virtual std::unique_ptr<MeshInterface> CreateMesh(
         const MeshParameter& mesh_parameter) = 0;
+    /**
+     * @brief Get the GPU time of the passes over the last frames, read back
+     *        a few frames late so the GPU is never waited on.
+     * @return One entry per timed pass (empty if the GPU has no timer).
+     */
+    virtual std::vector<GpuPassStats> GetGpuPassStats() const = 0;
+    /**
+     * @brief Get the calls made by the renderer during the last frame.
+     * @return The counters (all 0 if the backend does not count its calls).
+     */
+    virtual RenderCallStats GetRenderCallStats() const = 0;
 };
 
 } // End namespace frame.
@@ -0,0 +1,123 @@
+#include "frame/frame_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace frame
+{
+
+namespace
+{
+
+constexpr std::size_t kArenaAlignment = alignof(std::max_align_t);
+
+std::uintptr_t AlignUp(std::uintptr_t value, std::size_t alignment)
+{
+    assert(std::has_single_bit(alignment));
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+FrameAllocator::FrameAllocator(
+    std::size_t frame_size,
+    std::size_t frame_count,
+    std::pmr::memory_resource* upstream)
+    : upstream_(upstream), arenas_(std::max<std::size_t>(frame_count, 1))
+{
+    for (auto& arena : arenas_)
+    {
+        arena.size = frame_size;
+        if (frame_size)
+        {
+            arena.data = static_cast<std::byte*>(
+                upstream_->allocate(frame_size, kArenaAlignment));
+        }
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (auto& arena : arenas_)
+    {
+        ReleaseOverflow(arena);
+        if (arena.data)
+        {
+            upstream_->deallocate(arena.data, arena.size, kArenaAlignment);
+        }
+    }
+}
+
+void FrameAllocator::BeginFrame()
+{
+    current_ = (current_ + 1) % arenas_.size();
+    ResetArena(arenas_[current_]);
+}
+
+std::size_t FrameAllocator::GetUsedBytes() const
+{
+    return arenas_[current_].requested;
+}
+
+std::size_t FrameAllocator::GetOverflowCount() const
+{
+    return arenas_[current_].overflow_count;
+}
+
+void* FrameAllocator::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    auto& arena = arenas_[current_];
+    arena.requested += bytes + alignment - 1;
+    const auto base = reinterpret_cast<std::uintptr_t>(arena.data);
+    const std::size_t offset = AlignUp(base + arena.offset, alignment) - base;
+    if (arena.data && offset + bytes <= arena.size)
+    {
+        arena.offset = offset + bytes;
+        return arena.data + offset;
+    }
+    // Does not fit, the arena will be grown when it is reset.
+    const std::size_t block_alignment =
+        std::max(alignment, alignof(Overflow));
+    const std::size_t header_size = AlignUp(sizeof(Overflow), block_alignment);
+    auto* block = static_cast<std::byte*>(
+        upstream_->allocate(header_size + bytes, block_alignment));
+    auto* overflow = new (block) Overflow{
+        arena.overflow, header_size + bytes, block_alignment};
+    arena.overflow = overflow;
+    ++arena.overflow_count;
+    return block + header_size;
+}
+
+void FrameAllocator::ResetArena(Arena& arena)
+{
+    ReleaseOverflow(arena);
+    if (arena.requested > arena.size)
+    {
+        const std::size_t size = std::max(arena.requested, arena.size * 2);
+        if (arena.data)
+        {
+            upstream_->deallocate(arena.data, arena.size, kArenaAlignment);
+        }
+        arena.data =
+            static_cast<std::byte*>(upstream_->allocate(size, kArenaAlignment));
+        arena.size = size;
+    }
+    arena.offset = 0;
+    arena.requested = 0;
+    arena.overflow_count = 0;
+}
+
+void FrameAllocator::ReleaseOverflow(Arena& arena)
+{
+    while (arena.overflow)
+    {
+        Overflow* overflow = arena.overflow;
+        arena.overflow = overflow->next;
+        upstream_->deallocate(overflow, overflow->bytes, overflow->alignment);
+    }
+}
+
+} // End namespace frame.
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace frame
+{
+
+/**
+ * @class FrameAllocator
+ * @brief Linear (bump) allocator for the transient data of a frame, usable
+ *        with the std::pmr containers.
+ *
+ * Each frame in flight has its own arena, BeginFrame moves to the next one
+ * and resets it, so memory allocated during a frame stays valid until
+ * frame_count - 1 more frames have begun. Deallocation does nothing. When a
+ * frame needs more than its arena the extra allocations go to the upstream
+ * resource and the arena is grown the next time it is reset, so frames of a
+ * steady size end up never touching the heap.
+ */
+class FrameAllocator : public std::pmr::memory_resource
+{
+  public:
+    /**
+     * @brief Constructor, allocate the arenas.
+     * @param frame_size: Initial size in bytes of each arena.
+     * @param frame_count: Number of frames in flight (at least 1).
+     * @param upstream: Resource for the arenas and the overflow.
+     */
+    explicit FrameAllocator(
+        std::size_t frame_size = 64 * 1024,
+        std::size_t frame_count = 2,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    //! @brief Destructor, release the arenas and the overflow.
+    ~FrameAllocator() override;
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+  public:
+    /**
+     * @brief Start a new frame, the arena of the oldest frame in flight is
+     *        reset (and grown if it overflowed).
+     */
+    void BeginFrame();
+    /**
+     * @brief Get the bytes used in the current frame.
+     * @return The bytes allocated from the arena and the overflow.
+     */
+    std::size_t GetUsedBytes() const;
+    /**
+     * @brief Get the allocations of the current frame that did not fit in
+     *        the arena.
+     * @return Number of overflow allocations.
+     */
+    std::size_t GetOverflowCount() const;
+
+  protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override
+    {
+    }
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+  private:
+    // Header in front of the overflow allocations (intrusive list).
+    struct Overflow
+    {
+        Overflow* next = nullptr;
+        std::size_t bytes = 0;
+        std::size_t alignment = 0;
+    };
+    struct Arena
+    {
+        std::byte* data = nullptr;
+        std::size_t size = 0;
+        std::size_t offset = 0;
+        // Bytes (with alignment) asked for during the frame.
+        std::size_t requested = 0;
+        std::size_t overflow_count = 0;
+        Overflow* overflow = nullptr;
+    };
+    /**
+     * @brief Release the overflow of an arena and grow it to what the last
+     *        frame requested.
+     * @param arena: Arena to reset.
+     */
+    void ResetArena(Arena& arena);
+    void ReleaseOverflow(Arena& arena);
+
+  private:
+    std::pmr::memory_resource* upstream_ = nullptr;
+    std::vector<Arena> arenas_ = {};
+    std::size_t current_ = 0;
+};
+
+} // End namespace frame.
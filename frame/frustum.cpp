@@ -0,0 +1,177 @@
+#include "frame/frustum.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAME_FRUSTUM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace frame
+{
+
+namespace
+{
+
+bool IsBoxOutsidePlane(
+    const glm::vec4& plane, const glm::vec3& center, const glm::vec3& extent)
+{
+    const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+    const float radius = std::abs(plane.x) * extent.x +
+                         std::abs(plane.y) * extent.y +
+                         std::abs(plane.z) * extent.z;
+    return distance + radius < 0.f;
+}
+
+} // namespace
+
+Frustum::Frustum()
+{
+    // Planes that accept everything.
+    planes_.fill(glm::vec4(0.f, 0.f, 0.f, 1.f));
+}
+
+Frustum::Frustum(const glm::mat4& view_projection)
+{
+    // Gribb/Hartmann extraction, glm is column major so rows are m[c][r].
+    const glm::vec4 row0(
+        view_projection[0][0],
+        view_projection[1][0],
+        view_projection[2][0],
+        view_projection[3][0]);
+    const glm::vec4 row1(
+        view_projection[0][1],
+        view_projection[1][1],
+        view_projection[2][1],
+        view_projection[3][1]);
+    const glm::vec4 row2(
+        view_projection[0][2],
+        view_projection[1][2],
+        view_projection[2][2],
+        view_projection[3][2]);
+    const glm::vec4 row3(
+        view_projection[0][3],
+        view_projection[1][3],
+        view_projection[2][3],
+        view_projection[3][3]);
+    planes_[0] = row3 + row0;
+    planes_[1] = row3 - row0;
+    planes_[2] = row3 + row1;
+    planes_[3] = row3 - row1;
+    planes_[4] = row3 + row2;
+    planes_[5] = row3 - row2;
+    for (auto& plane : planes_)
+    {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.f)
+        {
+            plane /= length;
+        }
+    }
+}
+
+bool Frustum::IsVisible(const AABB& aabb) const
+{
+    const glm::vec3 center = (aabb.min + aabb.max) * 0.5f;
+    const glm::vec3 extent = (aabb.max - aabb.min) * 0.5f;
+    for (const auto& plane : planes_)
+    {
+        if (IsBoxOutsidePlane(plane, center, extent))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::Contains(const AABB& aabb) const
+{
+    const glm::vec3 center = (aabb.min + aabb.max) * 0.5f;
+    const glm::vec3 extent = (aabb.max - aabb.min) * 0.5f;
+    for (const auto& plane : planes_)
+    {
+        const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        const float radius = std::abs(plane.x) * extent.x +
+                             std::abs(plane.y) * extent.y +
+                             std::abs(plane.z) * extent.z;
+        if (distance - radius < 0.f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::IsVisible(const BoundingSphere& sphere) const
+{
+    for (const auto& plane : planes_)
+    {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w <
+            -sphere.radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::CullAABBs(
+    std::span<const AABB> aabbs, std::vector<std::uint8_t>& visible) const
+{
+    visible.resize(aabbs.size());
+    std::size_t i = 0;
+#ifdef FRAME_FRUSTUM_SSE2
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= aabbs.size(); i += 4)
+    {
+        // Structure of arrays of four boxes (center and extent).
+        const AABB& a = aabbs[i];
+        const AABB& b = aabbs[i + 1];
+        const AABB& c = aabbs[i + 2];
+        const AABB& d = aabbs[i + 3];
+        const __m128 min_x = _mm_setr_ps(a.min.x, b.min.x, c.min.x, d.min.x);
+        const __m128 min_y = _mm_setr_ps(a.min.y, b.min.y, c.min.y, d.min.y);
+        const __m128 min_z = _mm_setr_ps(a.min.z, b.min.z, c.min.z, d.min.z);
+        const __m128 max_x = _mm_setr_ps(a.max.x, b.max.x, c.max.x, d.max.x);
+        const __m128 max_y = _mm_setr_ps(a.max.y, b.max.y, c.max.y, d.max.y);
+        const __m128 max_z = _mm_setr_ps(a.max.z, b.max.z, c.max.z, d.max.z);
+        const __m128 center_x = _mm_mul_ps(_mm_add_ps(min_x, max_x), half);
+        const __m128 center_y = _mm_mul_ps(_mm_add_ps(min_y, max_y), half);
+        const __m128 center_z = _mm_mul_ps(_mm_add_ps(min_z, max_z), half);
+        const __m128 extent_x = _mm_mul_ps(_mm_sub_ps(max_x, min_x), half);
+        const __m128 extent_y = _mm_mul_ps(_mm_sub_ps(max_y, min_y), half);
+        const __m128 extent_z = _mm_mul_ps(_mm_sub_ps(max_z, min_z), half);
+        __m128 outside = _mm_setzero_ps();
+        for (const auto& plane : planes_)
+        {
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(plane.x), center_x),
+                    _mm_mul_ps(_mm_set1_ps(plane.y), center_y)),
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(plane.z), center_z),
+                    _mm_set1_ps(plane.w)));
+            const __m128 radius = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), extent_x),
+                    _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), extent_y)),
+                _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), extent_z));
+            outside = _mm_or_ps(
+                outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+        const int mask = _mm_movemask_ps(outside);
+        visible[i] = (mask & 1) ? 0 : 1;
+        visible[i + 1] = (mask & 2) ? 0 : 1;
+        visible[i + 2] = (mask & 4) ? 0 : 1;
+        visible[i + 3] = (mask & 8) ? 0 : 1;
+    }
+#endif // FRAME_FRUSTUM_SSE2
+    for (; i < aabbs.size(); ++i)
+    {
+        visible[i] = IsVisible(aabbs[i]) ? 1 : 0;
+    }
+}
+
+} // End namespace frame.
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "frame/bounding_volume.h"
+
+namespace frame
+{
+
+/**
+ * @class CullingStats
+ * @brief Count of drawn and culled node/material pairs for the last frame.
+ */
+struct CullingStats
+{
+    std::uint32_t drawn = 0;
+    std::uint32_t culled = 0;
+};
+
+/**
+ * @class Frustum
+ * @brief View frustum as six planes (normal pointing inside), extracted from
+ *        a projection * view matrix (OpenGL clip space).
+ */
+class Frustum
+{
+  public:
+    //! @brief Default frustum (everything is visible).
+    Frustum();
+    /**
+     * @brief Extract the planes from a view projection matrix.
+     * @param view_projection: Projection * view matrix.
+     */
+    explicit Frustum(const glm::mat4& view_projection);
+
+  public:
+    /**
+     * @brief Test a world space box against the frustum.
+     * @param aabb: Box to be tested.
+     * @return False if the box is completely outside of one plane.
+     */
+    bool IsVisible(const AABB& aabb) const;
+    /**
+     * @brief Check if a world space box is completely inside the frustum.
+     * @param aabb: Box to be tested.
+     * @return True if the box is inside of all the planes.
+     */
+    bool Contains(const AABB& aabb) const;
+    /**
+     * @brief Test a world space sphere against the frustum.
+     * @param sphere: Sphere to be tested.
+     * @return False if the sphere is completely outside of one plane.
+     */
+    bool IsVisible(const BoundingSphere& sphere) const;
+    /**
+     * @brief Test a batch of world space boxes, four at a time with SIMD
+     *        when available (scalar fallback otherwise).
+     * @param aabbs: Boxes to be tested.
+     * @param visible: Output, resized to the box count, 1 if visible.
+     */
+    void CullAABBs(
+        std::span<const AABB> aabbs, std::vector<std::uint8_t>& visible) const;
+    /**
+     * @brief Get the planes (xyz normal, w distance).
+     * @return The six planes left, right, bottom, top, near, far.
+     */
+    const std::array<glm::vec4, 6>& GetPlanes() const
+    {
+        return planes_;
+    }
+
+  private:
+    std::array<glm::vec4, 6> planes_;
+};
+
+} // End namespace frame.
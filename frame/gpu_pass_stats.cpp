@@ -0,0 +1,80 @@
+#include "frame/gpu_pass_stats.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace frame
+{
+
+GpuPassHistory::GpuPassHistory(std::size_t frame_count)
+    : frame_count_(std::max<std::size_t>(frame_count, 1))
+{
+}
+
+void GpuPassHistory::AddSample(std::string_view name, double ms)
+{
+    auto it = std::ranges::find(passes_, name, &Pass::name);
+    if (it == passes_.end())
+    {
+        passes_.push_back({std::string(name)});
+        passes_.back().samples.resize(frame_count_);
+        it = std::prev(passes_.end());
+    }
+    it->pending_ms += ms;
+    it->pending = true;
+}
+
+void GpuPassHistory::EndFrame()
+{
+    for (auto& pass : passes_)
+    {
+        if (!pass.pending)
+        {
+            continue;
+        }
+        pass.samples[pass.next] = pass.pending_ms;
+        pass.next = (pass.next + 1) % frame_count_;
+        pass.count = std::min(pass.count + 1, frame_count_);
+        pass.pending_ms = 0.0;
+        pass.pending = false;
+    }
+}
+
+std::vector<GpuPassStats> GpuPassHistory::GetStats() const
+{
+    std::vector<GpuPassStats> stats;
+    stats.reserve(passes_.size());
+    for (const auto& pass : passes_)
+    {
+        if (pass.count == 0)
+        {
+            continue;
+        }
+        // The oldest sample is at next once the window is full, at 0 before.
+        const std::size_t first =
+            pass.count == frame_count_ ? pass.next : 0;
+        GpuPassStats entry{pass.name};
+        entry.last_ms =
+            pass.samples[(pass.next + frame_count_ - 1) % frame_count_];
+        entry.min_ms = entry.max_ms = pass.samples[first];
+        double total = 0.0;
+        for (std::size_t i = 0; i < pass.count; ++i)
+        {
+            const double ms = pass.samples[(first + i) % frame_count_];
+            entry.min_ms = std::min(entry.min_ms, ms);
+            entry.max_ms = std::max(entry.max_ms, ms);
+            total += ms;
+        }
+        entry.avg_ms = total / static_cast<double>(pass.count);
+        entry.sample_count = static_cast<std::uint32_t>(pass.count);
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+void GpuPassHistory::Clear()
+{
+    passes_.clear();
+}
+
+} // End namespace frame.
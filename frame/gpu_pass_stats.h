@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frame
+{
+
+/**
+ * @brief Names of the GPU passes timed by the devices, a backend only
+ *        reports the passes it has.
+ */
+namespace gpu_pass
+{
+inline constexpr const char* kFrame = "frame";
+inline constexpr const char* kPreRender = "pre-render";
+inline constexpr const char* kSkybox = "skybox";
+inline constexpr const char* kScene = "scene";
+inline constexpr const char* kComputeRaytrace = "compute raytrace";
+inline constexpr const char* kPostProcess = "post-process";
+inline constexpr const char* kGui = "gui";
+} // End namespace gpu_pass.
+
+/**
+ * @class GpuPassStats
+ * @brief GPU time of a pass over the last frames, in milliseconds.
+ */
+struct GpuPassStats
+{
+    std::string name;
+    double last_ms = 0.0;
+    double min_ms = 0.0;
+    double avg_ms = 0.0;
+    double max_ms = 0.0;
+    //! @brief Frames in the window (at most the history size).
+    std::uint32_t sample_count = 0;
+};
+
+/**
+ * @class RenderCallStats
+ * @brief Calls made by the renderer during the last frame, with the ones it
+ *        skipped because the state or the uniform value was already set.
+ */
+struct RenderCallStats
+{
+    std::uint32_t draw_calls = 0;
+    std::uint32_t state_calls = 0;
+    std::uint32_t skipped_state_calls = 0;
+    std::uint32_t uniform_uploads = 0;
+    std::uint32_t skipped_uniform_uploads = 0;
+};
+
+/**
+ * @class GpuPassHistory
+ * @brief Sliding window of the GPU time of the named passes.
+ *
+ * The backends read their queries a few frames after they are recorded and
+ * feed them here one frame at a time: AddSample for each pass (a pass timed
+ * more than once in a frame, like the scene in stereo, is summed), then
+ * EndFrame. Passes keep the order in which they were first seen.
+ */
+class GpuPassHistory
+{
+  public:
+    /**
+     * @brief Constructor.
+     * @param frame_count: Frames kept per pass (at least 1).
+     */
+    explicit GpuPassHistory(std::size_t frame_count = 120);
+
+  public:
+    /**
+     * @brief Add the time of a pass to the frame being resolved.
+     * @param name: Name of the pass.
+     * @param ms: GPU time in milliseconds.
+     */
+    void AddSample(std::string_view name, double ms);
+    //! @brief Push the samples added since the last call as one frame.
+    void EndFrame();
+    /**
+     * @brief Get the statistics of the passes.
+     * @return One entry per pass seen so far.
+     */
+    std::vector<GpuPassStats> GetStats() const;
+    //! @brief Forget all the passes (level reload).
+    void Clear();
+
+  private:
+    struct Pass
+    {
+        std::string name;
+        std::vector<double> samples;
+        std::size_t next = 0;
+        std::size_t count = 0;
+        double pending_ms = 0.0;
+        bool pending = false;
+    };
+
+  private:
+    std::size_t frame_count_ = 0;
+    std::vector<Pass> passes_ = {};
+};
+
+} // End namespace frame.
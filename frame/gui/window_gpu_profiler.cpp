@@ -0,0 +1,75 @@
+#include "frame/gui/window_gpu_profiler.h"
+
+#include <imgui.h>
+
+namespace frame::gui
+{
+
+WindowGpuProfiler::WindowGpuProfiler(
+    const std::string& name, DeviceInterface& device)
+    : name_(name), device_(device)
+{
+}
+
+bool WindowGpuProfiler::DrawCallback()
+{
+    const auto calls = device_.GetRenderCallStats();
+    ImGui::Text("Draw calls: %u", calls.draw_calls);
+    ImGui::Text(
+        "State calls: %u (%u skipped)",
+        calls.state_calls,
+        calls.skipped_state_calls);
+    ImGui::Text(
+        "Uniform uploads: %u (%u skipped)",
+        calls.uniform_uploads,
+        calls.skipped_uniform_uploads);
+    const auto stats = device_.GetGpuPassStats();
+    if (stats.empty())
+    {
+        ImGui::Text("No GPU timing available.");
+        return true;
+    }
+    if (ImGui::BeginTable("Passes", 5, ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("Last (ms)");
+        ImGui::TableSetupColumn("Min (ms)");
+        ImGui::TableSetupColumn("Avg (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableHeadersRow();
+        for (const auto& pass : stats)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(pass.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", pass.last_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", pass.min_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", pass.avg_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", pass.max_ms);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::Text("Over the last %u frames.", stats.front().sample_count);
+    return true;
+}
+
+std::string WindowGpuProfiler::GetName() const
+{
+    return name_;
+}
+
+void WindowGpuProfiler::SetName(const std::string& name)
+{
+    name_ = name;
+}
+
+bool WindowGpuProfiler::End() const
+{
+    return false;
+}
+
+} // End namespace frame::gui.
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+
+#include "frame/device_interface.h"
+#include "frame/gui/draw_gui_interface.h"
+
+namespace frame::gui
+{
+
+/**
+ * @class WindowGpuProfiler
+ * @brief Show the GPU time of the passes of the device (last, min, average
+ *        and max over the recent frames) and the calls of the last frame.
+ */
+class WindowGpuProfiler : public GuiWindowInterface
+{
+  public:
+    /**
+     * @brief Constructor.
+     * @param name: The name of the window.
+     * @param device: Device whose passes are shown.
+     */
+    WindowGpuProfiler(const std::string& name, DeviceInterface& device);
+    virtual ~WindowGpuProfiler() = default;
+
+  public:
+    //! @brief Draw callback setting.
+    bool DrawCallback() override;
+    /**
+     * @brief Get the name of the window.
+     * @return The name of the window.
+     */
+    std::string GetName() const override;
+    /**
+     * @brief Set the name of the window.
+     * @param name: The name of the window.
+     */
+    void SetName(const std::string& name) override;
+    /**
+     * @brief Check if this is the end of the software.
+     * @return True if this is the end false if not.
+     */
+    bool End() const override;
+
+  private:
+    std::string name_;
+    DeviceInterface& device_;
+};
+
+} // End namespace frame::gui.
@@ -0,0 +1,289 @@
+#include "frame/jobs.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "frame/profiler.h"
+
+namespace frame::jobs
+{
+
+namespace
+{
+
+// Pool and index of the calling thread, set by the workers.
+thread_local const Scheduler* tls_scheduler = nullptr;
+thread_local std::size_t tls_thread_index = 0;
+
+// Jobs per thread made by ParallelFor without grain.
+constexpr std::size_t kJobsPerThread = 4;
+
+} // namespace
+
+Scheduler::Scheduler(std::size_t worker_count)
+{
+    // Created first so it outlives the workers, they record to it until
+    // they exit.
+    Profiler::GetInstance();
+    Start(worker_count);
+}
+
+Scheduler::~Scheduler()
+{
+    Stop();
+}
+
+Scheduler& Scheduler::GetInstance()
+{
+    static Scheduler scheduler(GetDefaultWorkerCount());
+    return scheduler;
+}
+
+std::size_t Scheduler::GetDefaultWorkerCount()
+{
+    const std::size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+std::size_t Scheduler::GetThreadIndex()
+{
+    return tls_thread_index;
+}
+
+void Scheduler::SetWorkerCount(std::size_t worker_count)
+{
+    if (worker_count == workers_.size())
+    {
+        return;
+    }
+    Stop();
+    Start(worker_count);
+}
+
+void Scheduler::Start(std::size_t worker_count)
+{
+    stop_ = false;
+    for (std::size_t i = 0; i < worker_count; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // The workers steal from each other, all the deques exist first.
+    for (std::size_t i = 0; i < worker_count; ++i)
+    {
+        workers_[i]->thread = std::jthread([this, i] { WorkerLoop(i); });
+    }
+}
+
+void Scheduler::Stop()
+{
+    {
+        std::scoped_lock lock(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker->thread.join();
+    }
+    workers_.clear();
+}
+
+void Scheduler::WorkerLoop(std::size_t index)
+{
+    tls_scheduler = this;
+    tls_thread_index = index + 1;
+    FRAME_PROFILE_THREAD("Job worker");
+    for (;;)
+    {
+        if (TryRunOne())
+        {
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex_);
+        if (stop_ && queued_.load() == 0)
+        {
+            return;
+        }
+        ++sleeping_;
+        wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+        --sleeping_;
+    }
+}
+
+void Scheduler::Run(Job job, Counter& counter)
+{
+    counter.pending_.fetch_add(1);
+    // Counted before it is visible so queued_ never goes below zero.
+    queued_.fetch_add(1);
+    Task task{std::move(job), &counter};
+    if (tls_scheduler == this)
+    {
+        auto& worker = *workers_[tls_thread_index - 1];
+        std::scoped_lock lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    else
+    {
+        std::scoped_lock lock(injected_mutex_);
+        injected_.push_back(std::move(task));
+    }
+    Notify(false);
+}
+
+void Scheduler::Wait(Counter& counter)
+{
+    FRAME_PROFILE_SCOPE("Wait for jobs");
+    while (!counter.IsDone())
+    {
+        if (TryRunOne())
+        {
+            continue;
+        }
+        // Nothing to help with, the last jobs run on other threads.
+        std::unique_lock lock(sleep_mutex_);
+        ++sleeping_;
+        wake_.wait(lock, [this, &counter] {
+            return counter.IsDone() || queued_.load() > 0;
+        });
+        --sleeping_;
+    }
+    // The jobs stored their error before counting down.
+    if (auto error = std::exchange(counter.error_, nullptr))
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void Scheduler::ParallelFor(
+    std::size_t count,
+    const std::function<void(std::size_t)>& body,
+    std::size_t grain)
+{
+    if (grain == 0)
+    {
+        grain = std::max<std::size_t>(
+            count / ((workers_.size() + 1) * kJobsPerThread), 1);
+    }
+    Counter counter;
+    for (std::size_t begin = 0; begin < count; begin += grain)
+    {
+        const std::size_t end = std::min(begin + grain, count);
+        Run(
+            [&body, begin, end] {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    body(i);
+                }
+            },
+            counter);
+    }
+    Wait(counter);
+}
+
+bool Scheduler::Pop(Task& task)
+{
+    if (queued_.load() == 0)
+    {
+        return false;
+    }
+    auto take = [this, &task](std::deque<Task>& tasks, bool back) {
+        if (tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(back ? tasks.back() : tasks.front());
+        back ? tasks.pop_back() : tasks.pop_front();
+        queued_.fetch_sub(1);
+        return true;
+    };
+    const std::size_t worker_count = workers_.size();
+    const bool is_worker = tls_scheduler == this;
+    const std::size_t self =
+        is_worker ? tls_thread_index - 1 : worker_count;
+    if (is_worker)
+    {
+        auto& worker = *workers_[self];
+        std::scoped_lock lock(worker.mutex);
+        if (take(worker.tasks, true))
+        {
+            return true;
+        }
+    }
+    {
+        std::scoped_lock lock(injected_mutex_);
+        if (take(injected_, false))
+        {
+            return true;
+        }
+    }
+    // Steal the oldest job, starting next to the calling worker so the
+    // thieves spread over the victims.
+    for (std::size_t i = 1; i <= worker_count; ++i)
+    {
+        const std::size_t victim = (self + i) % worker_count;
+        if (victim == self)
+        {
+            continue;
+        }
+        auto& worker = *workers_[victim];
+        std::scoped_lock lock(worker.mutex);
+        if (take(worker.tasks, false))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Scheduler::TryRunOne()
+{
+    Task task;
+    if (!Pop(task))
+    {
+        return false;
+    }
+    Execute(task);
+    return true;
+}
+
+void Scheduler::Execute(Task& task)
+{
+    {
+        FRAME_PROFILE_SCOPE("Job");
+        try
+        {
+            task.job();
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(task.counter->error_mutex_);
+            if (!task.counter->error_)
+            {
+                task.counter->error_ = std::current_exception();
+            }
+        }
+        // Release the captures before the waiter goes on.
+        task.job = nullptr;
+    }
+    // The counter can be gone as soon as it reaches zero.
+    if (task.counter->pending_.fetch_sub(1) == 1)
+    {
+        Notify(true);
+    }
+}
+
+void Scheduler::Notify(bool all)
+{
+    if (sleeping_.load() == 0)
+    {
+        return;
+    }
+    // Taking the lock orders the wake up after the sleeper checked its
+    // condition.
+    {
+        std::scoped_lock lock(sleep_mutex_);
+    }
+    all ? wake_.notify_all() : wake_.notify_one();
+}
+
+} // End namespace frame::jobs.
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace frame::jobs
+{
+
+//! @brief Work run by the scheduler.
+using Job = std::function<void()>;
+
+/**
+ * @class Counter
+ * @brief Jobs not finished yet of a group, see Scheduler::Run and Wait.
+ *
+ * A job can run children against its own counter and wait for them, the
+ * wait runs queued jobs so nesting never blocks a worker.
+ */
+class Counter
+{
+  public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+  public:
+    /**
+     * @brief Check if every job run against the counter has finished.
+     * @return True when nothing is pending.
+     */
+    bool IsDone() const
+    {
+        return pending_.load() == 0;
+    }
+
+  private:
+    friend class Scheduler;
+    std::atomic<std::uint32_t> pending_ = 0;
+    // First exception of a job, rethrown by Wait.
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @class Scheduler
+ * @brief Work-stealing thread pool shared by the subsystems.
+ *
+ * Every worker has its own deque: the jobs it runs go to the back and it
+ * takes from the back (the last pushed is still in cache), idle workers
+ * steal from the front of the others. Jobs run from outside the pool go to
+ * a shared queue. Threads waiting on a counter run queued jobs meanwhile,
+ * so a scheduler without worker runs everything in Wait.
+ */
+class Scheduler
+{
+  public:
+    /**
+     * @brief Constructor, start the workers.
+     * @param worker_count: Threads of the pool (0: jobs run in Wait).
+     */
+    explicit Scheduler(std::size_t worker_count);
+    //! @brief Destructor, run the queued jobs and join the workers.
+    ~Scheduler();
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+  public:
+    /**
+     * @brief Get the scheduler of the engine (see singleton).
+     * @return A reference to the instance, GetDefaultWorkerCount workers.
+     */
+    static Scheduler& GetInstance();
+    /**
+     * @brief Get the worker count using every core.
+     * @return One per core less the calling thread.
+     */
+    static std::size_t GetDefaultWorkerCount();
+    /**
+     * @brief Get the index of the calling thread.
+     * @return 0 outside of the pools, worker index + 1 in a pool.
+     */
+    static std::size_t GetThreadIndex();
+    /**
+     * @brief Restart the pool with another worker count, no job may be
+     *        queued or running.
+     * @param worker_count: Threads of the pool (0: jobs run in Wait).
+     */
+    void SetWorkerCount(std::size_t worker_count);
+    /**
+     * @brief Get the worker count.
+     * @return Threads of the pool.
+     */
+    std::size_t GetWorkerCount() const
+    {
+        return workers_.size();
+    }
+
+  public:
+    /**
+     * @brief Queue a job.
+     * @param job: Work to run on any thread of the pool or a waiting one.
+     * @param counter: Counter of the group, has to outlive the job.
+     */
+    void Run(Job job, Counter& counter);
+    /**
+     * @brief Run queued jobs until the jobs of the counter are done.
+     * @param counter: Counter the jobs were run against.
+     *
+     * Rethrows the first exception thrown by one of the jobs.
+     */
+    void Wait(Counter& counter);
+    /**
+     * @brief Call body on [0, count) in parallel and wait for it.
+     * @param count: Number of indices.
+     * @param body: Called once per index, from any thread.
+     * @param grain: Indices per job (0: a few jobs per thread).
+     */
+    void ParallelFor(
+        std::size_t count,
+        const std::function<void(std::size_t)>& body,
+        std::size_t grain = 0);
+
+  private:
+    struct Task
+    {
+        Job job;
+        Counter* counter = nullptr;
+    };
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::jthread thread;
+    };
+    void Start(std::size_t worker_count);
+    void Stop();
+    void WorkerLoop(std::size_t index);
+    bool Pop(Task& task);
+    bool TryRunOne();
+    void Execute(Task& task);
+    // Wake the sleeping threads if any.
+    void Notify(bool all);
+
+  private:
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injected_mutex_;
+    std::deque<Task> injected_;
+    // Jobs queued and not taken yet.
+    std::atomic<std::size_t> queued_ = 0;
+    // Idle workers and blocked waiters share the condition.
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> sleeping_ = 0;
+    bool stop_ = false;
+};
+
+} // End namespace frame::jobs.
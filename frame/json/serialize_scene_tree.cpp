@@ -204,6 +204,8 @@ proto::NodeMesh SerializeNodeMesh(
         node_mesh.GetData().render_time_enum());
     proto_node_mesh.set_acceleration_structure_enum(
         node_mesh.GetData().acceleration_structure_enum());
+    proto_node_mesh.set_clear_depth_buffer(
+        node_mesh.GetData().clear_depth_buffer());
     proto_node_mesh.set_play_animation(
         node_mesh.GetData().play_animation());
     if (node_mesh.GetData().has_animation_speed())
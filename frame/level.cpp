@@ -61,6 +61,47 @@ void Level::AddMeshMaterialId(
     default:
         throw std::runtime_error("Unknown render time?");
     }
+    ++revision_;
+}
+
+const std::vector<RenderItem>& Level::GetRenderItems(
+    proto::NodeMesh::RenderTimeEnum render_time_enum) const
+{
+    auto& view = render_item_views_[render_time_enum];
+    // The revision covers the level maps (the mesh of a node is set when
+    // the node is built and never changes).
+    if (view.revision == revision_)
+    {
+        return view.items;
+    }
+    view.items.clear();
+    for (const auto& [node_id, material_id] :
+         GetMeshMaterialIds(render_time_enum))
+    {
+        RenderItem item;
+        item.node_id = node_id;
+        item.material_id = material_id;
+        auto node_it = id_scene_node_map_.find(node_id);
+        if (node_it != id_scene_node_map_.end() &&
+            node_it->second->GetNodeType() == NodeTypeEnum::NODE_MESH)
+        {
+            item.node_mesh = static_cast<NodeMesh*>(node_it->second.get());
+            item.mesh_id = item.node_mesh->GetLocalMesh();
+            auto mesh_it = id_mesh_map_.find(item.mesh_id);
+            if (mesh_it != id_mesh_map_.end())
+            {
+                item.mesh = mesh_it->second.get();
+            }
+        }
+        auto material_it = id_material_map_.find(material_id);
+        if (material_it != id_material_map_.end())
+        {
+            item.material = material_it->second.get();
+        }
+        view.items.push_back(item);
+    }
+    view.revision = revision_;
+    return view.items;
 }
 
 void Level::SetRenderPassProgramIds(
@@ -174,6 +215,7 @@ EntityId Level::AddSceneNode(std::unique_ptr<NodeInterface>&& scene_node)
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::NODE});
+    ++revision_;
     // Now check if this is a light and add it to the light map.
     NodeInterface* node = id_scene_node_map_.at(id).get();
     if (auto* node_light = dynamic_cast<NodeLight*>(node))
@@ -228,6 +270,7 @@ EntityId Level::AddTexture(std::unique_ptr<TextureInterface>&& texture)
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::TEXTURE});
+    ++revision_;
     return id;
 }
 
@@ -243,6 +286,7 @@ EntityId Level::AddProgram(std::unique_ptr<ProgramInterface>&& program)
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::PROGRAM});
+    ++revision_;
     return id;
 }
 
@@ -296,6 +340,7 @@ void Level::RemoveProgram(EntityId program_id)
     id_name_map_.erase(program_id);
     name_id_map_.erase(name);
     id_enum_map_.erase(program_id);
+    ++revision_;
 }
 
 EntityId Level::AddMaterial(std::unique_ptr<MaterialInterface>&& material)
@@ -311,6 +356,7 @@ EntityId Level::AddMaterial(std::unique_ptr<MaterialInterface>&& material)
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::MATERIAL});
+    ++revision_;
     return id;
 }
 
@@ -327,6 +373,7 @@ EntityId Level::AddBuffer(std::unique_ptr<BufferInterface>&& buffer)
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::BUFFER});
+    ++revision_;
     return id;
 }
 
@@ -344,6 +391,7 @@ EntityId Level::AddLight(std::unique_ptr<LightInterface>&& light)
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::LIGHT});
+    ++revision_;
     return id;
 }
 
@@ -355,10 +403,16 @@ void Level::RemoveSceneNode(EntityId node_id)
             std::format("No scene node with id #{}.", node_id));
     }
     std::string name = id_name_map_.at(node_id);
+    if (auto it = node_proxy_map_.find(node_id); it != node_proxy_map_.end())
+    {
+        spatial_index_.Remove(it->second);
+        node_proxy_map_.erase(it);
+    }
     id_scene_node_map_.erase(node_id);
     id_name_map_.erase(node_id);
     name_id_map_.erase(name);
     id_enum_map_.erase(node_id);
+    ++revision_;
 }
 
 void Level::RemoveBuffer(EntityId buffer_id)
@@ -373,6 +427,7 @@ void Level::RemoveBuffer(EntityId buffer_id)
     id_name_map_.erase(buffer_id);
     name_id_map_.erase(name);
     id_enum_map_.erase(buffer_id);
+    ++revision_;
 }
 
 EntityId Level::AddMesh(
@@ -390,6 +445,7 @@ EntityId Level::AddMesh(
     id_name_map_.insert({id, name});
     name_id_map_.insert({name, id});
     id_enum_map_.insert({id, EntityTypeEnum::MESH});
+    ++revision_;
     return id;
 }
 
@@ -486,6 +542,142 @@ void Level::UpdateLights(double dt)
     }
 }
 
+void Level::UpdateSpatialIndex(double dt)
+{
+    if (spatial_index_revision_ != revision_)
+    {
+        RebuildSpatialIndex(dt);
+        return;
+    }
+    for (const EntityId node_id : animated_nodes_)
+    {
+        UpdateNodeBounds(node_id, dt);
+    }
+    for (const EntityId dirty_id : dirty_transform_nodes_)
+    {
+        auto it = spatial_dependents_.find(dirty_id);
+        if (it == spatial_dependents_.end())
+        {
+            continue;
+        }
+        for (const EntityId node_id : it->second)
+        {
+            UpdateNodeBounds(node_id, dt);
+        }
+    }
+    dirty_transform_nodes_.clear();
+}
+
+void Level::MarkTransformDirty(EntityId node_id)
+{
+    dirty_transform_nodes_.push_back(node_id);
+}
+
+void Level::RebuildSpatialIndex(double dt)
+{
+    spatial_dependents_.clear();
+    animated_nodes_.clear();
+    dirty_transform_nodes_.clear();
+    for (const auto& [node_id, material_id] : mesh_material_scene_render_ids_)
+    {
+        // The same node can be listed once per material.
+        if (spatial_dependents_.count(node_id))
+        {
+            continue;
+        }
+        // Walk up the parents, the node moves with each of them.
+        bool animated = false;
+        auto it = id_scene_node_map_.find(node_id);
+        while (it != id_scene_node_map_.end())
+        {
+            spatial_dependents_[it->first].push_back(node_id);
+            const auto& node = *it->second;
+            if (node.GetNodeType() == NodeTypeEnum::NODE_MATRIX &&
+                static_cast<const NodeMatrix&>(node)
+                        .GetData()
+                        .matrix_type_enum() ==
+                    proto::NodeMatrix::ROTATION_MATRIX)
+            {
+                animated = true;
+            }
+            if (node.GetParentName().empty())
+            {
+                break;
+            }
+            auto parent_it = name_id_map_.find(node.GetParentName());
+            if (parent_it == name_id_map_.end())
+            {
+                break;
+            }
+            it = id_scene_node_map_.find(parent_it->second);
+        }
+        if (animated)
+        {
+            animated_nodes_.push_back(node_id);
+        }
+        UpdateNodeBounds(node_id, dt);
+    }
+    spatial_index_revision_ = revision_;
+}
+
+void Level::UpdateNodeBounds(EntityId node_id, double dt)
+{
+    auto it = id_scene_node_map_.find(node_id);
+    if (it == id_scene_node_map_.end())
+    {
+        return;
+    }
+    const EntityId mesh_id = it->second->GetLocalMesh();
+    auto mesh_it = id_mesh_map_.find(mesh_id);
+    if (!mesh_id || mesh_it == id_mesh_map_.end())
+    {
+        return;
+    }
+    const auto& bounding_volume = mesh_it->second->GetBoundingVolume();
+    if (!bounding_volume.IsValid())
+    {
+        return;
+    }
+    const AABB world_aabb = TransformAABB(
+        bounding_volume.aabb, it->second->GetLocalModel(dt));
+    auto proxy_it = node_proxy_map_.find(node_id);
+    if (proxy_it == node_proxy_map_.end())
+    {
+        node_proxy_map_.insert(
+            {node_id, spatial_index_.Insert(world_aabb, node_id)});
+    }
+    else
+    {
+        spatial_index_.Move(proxy_it->second, world_aabb);
+    }
+}
+
+std::vector<EntityId> Level::QueryNodesInFrustum(const Frustum& frustum) const
+{
+    std::vector<EntityId> node_ids;
+    spatial_index_.QueryFrustum(frustum, [&node_ids](EntityId id) {
+        node_ids.push_back(id);
+        return true;
+    });
+    return node_ids;
+}
+
+std::vector<EntityId> Level::QueryNodesInBox(const AABB& aabb) const
+{
+    std::vector<EntityId> node_ids;
+    spatial_index_.QueryBox(aabb, [&node_ids](EntityId id) {
+        node_ids.push_back(id);
+        return true;
+    });
+    return node_ids;
+}
+
+std::optional<RayHit> Level::PickNode(
+    const glm::vec3& origin, const glm::vec3& direction) const
+{
+    return spatial_index_.QueryRay(origin, direction);
+}
+
 std::vector<frame::EntityId> Level::GetPrograms() const
 {
     std::vector<EntityId> list;
@@ -522,6 +714,7 @@ std::unique_ptr<frame::TextureInterface> Level::ExtractTexture(EntityId id)
     auto node_name = id_name_map_.extract(id);
     auto node_id = name_id_map_.extract(node_name.mapped());
     auto node_enum = id_enum_map_.extract(id);
+    ++revision_;
     return std::move(node_texture.mapped());
 }
 
@@ -567,6 +760,38 @@ void Level::ReplaceMesh(
     }
     id_mesh_map_.erase(id);
     id_mesh_map_.emplace(id, std::move(mesh));
+    ++revision_;
+}
+
+const std::vector<MeshInterface*>& Level::GetSkinnedMeshes() const
+{
+    if (skinned_meshes_revision_ == revision_)
+    {
+        return skinned_meshes_;
+    }
+    // Only the meshes used by a node, like the scene walk it replaces.
+    skinned_meshes_.clear();
+    for (const auto& [node_id, node] : id_scene_node_map_)
+    {
+        if (node->GetNodeType() != NodeTypeEnum::NODE_MESH)
+        {
+            continue;
+        }
+        auto mesh_it = id_mesh_map_.find(node->GetLocalMesh());
+        if (mesh_it == id_mesh_map_.end() || !mesh_it->second ||
+            mesh_it->second->GetMeshType() != MeshTypeEnum::SKINNED_MESH)
+        {
+            continue;
+        }
+        auto* mesh = mesh_it->second.get();
+        if (std::find(skinned_meshes_.begin(), skinned_meshes_.end(), mesh) ==
+            skinned_meshes_.end())
+        {
+            skinned_meshes_.push_back(mesh);
+        }
+    }
+    skinned_meshes_revision_ = revision_;
+    return skinned_meshes_;
 }
 
 std::string Level::GetNameFromNodeInterface(const NodeInterface& node) const
@@ -120,6 +120,30 @@ class Level : public LevelInterface
     std::vector<std::pair<EntityId, EntityId>> GetMeshMaterialIds(
         proto::NodeMesh::RenderTimeEnum render_time_enum =
             proto::NodeMesh::SCENE_RENDER_TIME) const override;
+    /**
+     * @brief Get the mesh/material pairs of a render pass with their node,
+     *        mesh and material already resolved.
+     * @param render_time_enum: Render pass.
+     * @return Items in the order of GetMeshMaterialIds.
+     */
+    const std::vector<RenderItem>& GetRenderItems(
+        proto::NodeMesh::RenderTimeEnum render_time_enum =
+            proto::NodeMesh::SCENE_RENDER_TIME) const override;
+    /**
+     * @brief Get the skinned meshes of the level attached to a mesh node,
+     *        the list is rebuilt only when the revision changed.
+     * @return Meshes whose type is SKINNED_MESH (each listed once).
+     */
+    const std::vector<MeshInterface*>& GetSkinnedMeshes() const override;
+    /**
+     * @brief Counter incremented every time an entity or a mesh/material
+     *        pair is added, removed or replaced.
+     * @return Current revision.
+     */
+    std::uint64_t GetRevision() const override
+    {
+        return revision_;
+    }
     /**
      * @brief Get the default output texture id.
      * @return Id of the default output texture.
@@ -343,6 +367,39 @@ class Level : public LevelInterface
      * @param dt: Delta time from the beginning of the software in seconds.
      */
     void UpdateLights(double dt) override;
+    /**
+     * @brief Update the world bounds of the animated and dirty scene mesh
+     *        nodes in the spatial index (all of them after a level change).
+     * @param dt: Delta time from the beginning of the software in seconds.
+     */
+    void UpdateSpatialIndex(double dt) override;
+    /**
+     * @brief Mark the transform of a node as changed, the scene mesh nodes
+     *        under it are updated by the next UpdateSpatialIndex.
+     * @param node_id: Node whose transform changed.
+     */
+    void MarkTransformDirty(EntityId node_id) override;
+    /**
+     * @brief Get the scene mesh nodes whose bounds are inside a frustum.
+     * @param frustum: World space frustum.
+     * @return A vector of node ids.
+     */
+    std::vector<EntityId> QueryNodesInFrustum(
+        const Frustum& frustum) const override;
+    /**
+     * @brief Get the scene mesh nodes whose bounds overlap a box.
+     * @param aabb: World space box.
+     * @return A vector of node ids.
+     */
+    std::vector<EntityId> QueryNodesInBox(const AABB& aabb) const override;
+    /**
+     * @brief Get the closest scene mesh node whose bounds are hit by a ray.
+     * @param origin: World space origin of the ray.
+     * @param direction: World space direction of the ray.
+     * @return The node id and distance or nullopt.
+     */
+    std::optional<RayHit> PickNode(
+        const glm::vec3& origin, const glm::vec3& direction) const override;
     /**
      * @brief Get all the program from level.
      * @return A vector of program ids.
@@ -399,6 +456,18 @@ class Level : public LevelInterface
      * @return The name of the node.
      */
     std::string GetNameFromNodeInterface(const NodeInterface& node) const;
+    /**
+     * @brief Rebuild the spatial dependencies (which scene mesh nodes move
+     *        with a node, which ones are animated) and every proxy.
+     * @param dt: Delta time from the beginning of the software in seconds.
+     */
+    void RebuildSpatialIndex(double dt);
+    /**
+     * @brief Insert or move the proxy of a scene mesh node.
+     * @param node_id: Scene mesh node.
+     * @param dt: Delta time from the beginning of the software in seconds.
+     */
+    void UpdateNodeBounds(EntityId node_id, double dt);
 
   protected:
     /**
@@ -489,6 +558,28 @@ class Level : public LevelInterface
     std::map<proto::NodeMesh::RenderTimeEnum, EntityId> render_program_ids_;
     std::map<proto::NodeMesh::RenderTimeEnum, EntityId>
         render_preprocess_program_ids_;
+    // Spatial index over the scene mesh nodes (node id to tree proxy).
+    AABBTree spatial_index_;
+    std::map<EntityId, std::int32_t> node_proxy_map_;
+    // Scene mesh nodes moving with a node (itself and its ancestors), the
+    // ones under a rotation matrix and the nodes marked dirty since the last
+    // update, rebuilt when the revision changed.
+    std::map<EntityId, std::vector<EntityId>> spatial_dependents_;
+    std::vector<EntityId> animated_nodes_;
+    std::vector<EntityId> dirty_transform_nodes_;
+    std::uint64_t spatial_index_revision_ = 0;
+    // Cached views, the render items and the skinned meshes are rebuilt on
+    // demand when the revision changed.
+    struct RenderItemView
+    {
+        std::uint64_t revision = 0;
+        std::vector<RenderItem> items;
+    };
+    std::uint64_t revision_ = 1;
+    mutable std::map<proto::NodeMesh::RenderTimeEnum, RenderItemView>
+        render_item_views_;
+    mutable std::uint64_t skinned_meshes_revision_ = 0;
+    mutable std::vector<MeshInterface*> skinned_meshes_;
 };
 
 } // End namespace frame.
@@ -4,6 +4,7 @@
 #include <optional>
 #include <unordered_map>
 
+#include "frame/aabb_tree.h"
 #include "frame/buffer_interface.h"
 #include "frame/camera_interface.h"
 #include "frame/entity_id.h"
@@ -17,6 +18,28 @@
 namespace frame
 {
 
+class NodeMesh;
+
+/**
+ * @class RenderItem
+ * @brief Mesh/material pair of a render pass with its objects resolved
+ *        (pointers stay valid until the level revision changes or the node
+ *        points to another mesh).
+ */
+struct RenderItem
+{
+    EntityId node_id = NullId;
+    EntityId material_id = NullId;
+    //! Mesh of the node when the item was resolved.
+    EntityId mesh_id = NullId;
+    //! Null if the node is not a mesh node.
+    NodeMesh* node_mesh = nullptr;
+    //! Null for clear nodes (no mesh).
+    MeshInterface* mesh = nullptr;
+    //! Null if there is no material.
+    MaterialInterface* material = nullptr;
+};
+
 /**
  * @class LevelInterface
  * @brief This is the interface to a level class, a level class is the
@@ -85,6 +108,28 @@ class LevelInterface : public NameInterface
     virtual std::vector<std::pair<EntityId, EntityId>> GetMeshMaterialIds(
         proto::NodeMesh::RenderTimeEnum render_time_enum =
             proto::NodeMesh::SCENE_RENDER_TIME) const = 0;
+    /**
+     * @brief Get the mesh/material pairs of a render pass with their node,
+     *        mesh and material already resolved, the list is rebuilt only
+     *        when the revision changed.
+     * @param render_time_enum: Render pass.
+     * @return Items in the order of GetMeshMaterialIds.
+     */
+    virtual const std::vector<RenderItem>& GetRenderItems(
+        proto::NodeMesh::RenderTimeEnum render_time_enum =
+            proto::NodeMesh::SCENE_RENDER_TIME) const = 0;
+    /**
+     * @brief Get the skinned meshes of the level attached to a mesh node.
+     * @return Meshes whose type is SKINNED_MESH (each listed once).
+     */
+    virtual const std::vector<MeshInterface*>& GetSkinnedMeshes() const = 0;
+    /**
+     * @brief Counter incremented every time an entity or a mesh/material
+     *        pair is added, removed or replaced, used to rebuild the cached
+     *        views (here and in the renderers).
+     * @return Current revision.
+     */
+    virtual std::uint64_t GetRevision() const = 0;
     /**
      * @brief Get the id of an element from a name string.
      * @param name: The name string of the element.
@@ -286,6 +331,45 @@ class LevelInterface : public NameInterface
      * @param dt: Delta time from the beginning of the software in seconds.
      */
     virtual void UpdateLights(double dt) = 0;
+    /**
+     * @brief Update the world bounds of the scene mesh nodes in the spatial
+     *        index, only the nodes that left their fat bounds touch the
+     *        tree.
+     *
+     * Only the animated nodes (under a rotation matrix) and the nodes marked
+     * with MarkTransformDirty are visited, all of them when the revision
+     * changed.
+     * @param dt: Delta time from the beginning of the software in seconds.
+     */
+    virtual void UpdateSpatialIndex(double dt) = 0;
+    /**
+     * @brief Tell the level the transform of a node changed (matrix edited
+     *        or parent changed), the scene mesh nodes under it get their
+     *        bounds updated by the next UpdateSpatialIndex.
+     * @param node_id: Node whose transform changed.
+     */
+    virtual void MarkTransformDirty(EntityId node_id) = 0;
+    /**
+     * @brief Get the scene mesh nodes whose bounds are inside a frustum.
+     * @param frustum: World space frustum.
+     * @return A vector of node ids.
+     */
+    virtual std::vector<EntityId> QueryNodesInFrustum(
+        const Frustum& frustum) const = 0;
+    /**
+     * @brief Get the scene mesh nodes whose bounds overlap a box.
+     * @param aabb: World space box.
+     * @return A vector of node ids.
+     */
+    virtual std::vector<EntityId> QueryNodesInBox(const AABB& aabb) const = 0;
+    /**
+     * @brief Get the closest scene mesh node whose bounds are hit by a ray.
+     * @param origin: World space origin of the ray.
+     * @param direction: World space direction of the ray.
+     * @return The node id and distance or nullopt.
+     */
+    virtual std::optional<RayHit> PickNode(
+        const glm::vec3& origin, const glm::vec3& direction) const = 0;
     /**
      * @brief Get all the program from the level.
      * @return A vector of program ids.
@@ -4,6 +4,7 @@
 #include <memory>
 #include <set>
 
+#include "frame/bounding_volume.h"
 #include "frame/entity_id.h"
 #include "frame/json/proto.h"
 #include "frame/serialize.h"
@@ -11,6 +12,16 @@
 namespace frame
 {
 
+/**
+ * @brief Concrete kind of a mesh, lets the renderers pick the backend type
+ *        without RTTI.
+ */
+enum class MeshTypeEnum : std::uint8_t
+{
+    STATIC_MESH = 0,
+    SKINNED_MESH = 1,
+};
+
 /**
  * @class Mesh parameter
  * @brief This class is there to pass entity id of buffer and a config
@@ -117,6 +128,21 @@ class MeshInterface : public Serialize<proto::NodeMesh>
      * @return Is depth buffer cleared?
      */
     virtual bool IsClearBuffer() const = 0;
+    /**
+     * @brief Get the local space bounding volume (computed at load time).
+     * @return Bounding volume, invalid if unknown (then never culled).
+     */
+    virtual const BoundingVolume& GetBoundingVolume() const = 0;
+    /**
+     * @brief Set the local space bounding volume.
+     * @param bounding_volume: Bounds of the points of the mesh.
+     */
+    virtual void SetBoundingVolume(const BoundingVolume& bounding_volume) = 0;
+    /**
+     * @brief Get the kind of mesh.
+     * @return Static or skinned.
+     */
+    virtual MeshTypeEnum GetMeshType() const = 0;
 };
 
 } // End namespace frame.
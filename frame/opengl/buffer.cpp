@@ -39,6 +39,28 @@ void Buffer::BindBase(int binding) const
         static_cast<GLenum>(buffer_type_), binding, buffer_object_);
 }
 
+void Buffer::BindRange(int binding, std::size_t offset, std::size_t size) const
+{
+    glBindBufferRange(
+        static_cast<GLenum>(buffer_type_),
+        binding,
+        buffer_object_,
+        static_cast<GLintptr>(offset),
+        static_cast<GLsizeiptr>(size));
+}
+
+void Buffer::Update(
+    const std::size_t offset, const std::size_t size, const void* data) const
+{
+    Bind();
+    glBufferSubData(
+        static_cast<GLenum>(buffer_type_),
+        static_cast<GLintptr>(offset),
+        static_cast<GLsizeiptr>(size),
+        data);
+    UnBind();
+}
+
 void Buffer::Copy(const std::size_t size, const void* data /*= nullptr*/) const
 {
     Bind();
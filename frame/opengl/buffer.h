@@ -110,6 +110,24 @@ class Buffer : public BindInterface, public BufferInterface
      * @param binding: The attachment point.
      */
     void BindBase(int binding) const override;
+    /**
+     * @brief Bind a range of a buffer to an attachment point.
+     * @param binding: The attachment point.
+     * @param offset: Offset in bytes (aligned as the target requires).
+     * @param size: Size of the range in bytes.
+     */
+    void BindRange(int binding, std::size_t offset, std::size_t size) const;
+    /**
+     * @brief Copy a value to a part of the buffer, the storage has to exist
+     *        (see Copy) and the size is in bytes.
+     * @param offset: Offset in bytes in the buffer.
+     * @param size: Number of bytes to be copied.
+     * @param data: Data pointer to the data to be copied.
+     */
+    void Update(
+        const std::size_t offset,
+        const std::size_t size,
+        const void* data) const;
 
   public:
     /**
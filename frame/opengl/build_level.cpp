@@ -2,9 +2,11 @@
 
 #include <format>
 #include <string>
+#include <vector>
 
 #include "frame/level.h"
 #include "frame/logger.h"
+#include "frame/profiler.h"
 #include "frame/json/program_catalog.h"
 #include "frame/opengl/material.h"
 #include "frame/opengl/mesh.h"
@@ -166,6 +168,7 @@ std::unique_ptr<frame::LevelInterface> BuildLevelInternal(
     glm::uvec2 size,
     const frame::proto::Level& proto_level)
 {
+    FRAME_PROFILE_SCOPE("OpenGL BuildLevel");
     auto logger = Logger::GetInstance();
     auto level = std::make_unique<frame::Level>();
     level->SetName(proto_level.name());
@@ -213,9 +216,14 @@ std::unique_ptr<frame::LevelInterface> BuildLevelInternal(
         throw std::runtime_error("should have a default texture.");
     }
 
-    for (const auto& proto_program : proto_level.programs())
+    const std::vector<frame::proto::Program> proto_programs(
+        proto_level.programs().begin(), proto_level.programs().end());
+    auto programs =
+        frame::json::ParseProgramsOpenGL(proto_programs, *level.get());
+    for (std::size_t i = 0; i < programs.size(); ++i)
     {
-        auto program = frame::json::ParseProgramOpenGL(proto_program, *level.get());
+        const auto& proto_program = proto_programs[i];
+        auto program = std::move(programs[i]);
         if (!program)
         {
             throw std::runtime_error(
@@ -16,6 +16,7 @@
 #include "frame/opengl/render_buffer.h"
 #include "frame/opengl/renderer.h"
 #include "frame/opengl/mesh.h"
+#include "frame/profiler.h"
 
 namespace frame::opengl
 {
@@ -37,6 +38,7 @@ Device::Device(void* gl_context, glm::uvec2 size)
     glDepthFunc(GL_LEQUAL);
     // Enable seamless cube map.
     glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+    gpu_profiler_ = std::make_unique<GpuProfiler>();
 }
 
 Device::~Device()
@@ -48,6 +50,7 @@ void Device::Startup(std::unique_ptr<frame::LevelInterface>&& level)
 {
     // Copy level into the local area.
     level_ = std::move(level);
+    gpu_profiler_->Clear();
     // Setup camera.
     auto& camera = level_->GetDefaultCamera();
     camera.SetAspectRatio(
@@ -159,10 +162,20 @@ void Device::DisplayCamera(
         throw std::runtime_error("No Renderer.");
     }
     renderer_->SetDeltaTime(time);
-    renderer_->PreRender();
+    {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kPreRender);
+        renderer_->PreRender();
+    }
     renderer_->SetViewport(viewport);
-    renderer_->RenderSkybox(camera);
-    renderer_->RenderScene(camera);
+    {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kSkybox);
+        renderer_->RenderSkybox(camera);
+    }
+    {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kScene);
+        renderer_->RenderScene(camera);
+    }
+    GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kPostProcess);
     renderer_->PostProcess();
 }
 
@@ -178,35 +191,49 @@ void Device::DisplayLeftRightCamera(
         throw std::runtime_error("No Renderer.");
     }
     renderer_->SetDeltaTime(time);
-    renderer_->PreRender();
+    {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kPreRender);
+        renderer_->PreRender();
+    }
     renderer_->SetViewport(viewport_left);
-    renderer_->RenderSkybox(camera_left);
+    {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kSkybox);
+        renderer_->RenderSkybox(camera_left);
+    }
+    // Both eyes add up in the scene pass.
     if (invert_left_right_)
     {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kScene);
         renderer_->SetViewport(viewport_right);
         renderer_->RenderScene(camera_left);
         renderer_->SetViewport(viewport_left);
         renderer_->RenderScene(camera_right);
-        renderer_->PostProcess();
     }
     else
     {
+        GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kScene);
         renderer_->SetViewport(viewport_left);
         renderer_->RenderScene(camera_left);
         renderer_->SetViewport(viewport_right);
         renderer_->RenderScene(camera_right);
-        renderer_->PostProcess();
     }
+    GpuProfiler::Scope scope(gpu_profiler_.get(), gpu_pass::kPostProcess);
+    renderer_->PostProcess();
 }
 
 void Device::Display(double dt /*= 0.0*/)
 {
+    // The previous frame ends here, with the plugins and GUI run after it.
+    FRAME_PROFILE_END_FRAME();
+    FRAME_PROFILE_SCOPE("OpenGL Display");
     if (!renderer_)
         throw std::runtime_error("No Renderer.");
     elapsed_time_seconds_ += dt;
     const double time_s = elapsed_time_seconds_;
+    gpu_profiler_->BeginFrame();
     Clear();
     level_->UpdateLights(time_s);
+    level_->UpdateSpatialIndex(time_s);
     Camera camera_for_frame{level_->GetDefaultCamera()};
     auto camera_holder_id = level_->GetDefaultCameraId();
     if (camera_holder_id != NullId)
@@ -311,6 +338,21 @@ std::unique_ptr<frame::MeshInterface> Device::CreateMesh(
         GetLevel(), mesh_parameter);
 }
 
+RenderCallStats Device::GetRenderCallStats() const
+{
+    if (!renderer_)
+    {
+        return {};
+    }
+    const auto counters = renderer_->GetGLCallCounters();
+    return {
+        counters.draw_calls,
+        counters.state_calls,
+        counters.skipped_calls,
+        counters.uniform_uploads,
+        counters.skipped_uniform_uploads};
+}
+
 void Device::Resize(glm::uvec2 size)
 {
     Cleanup();
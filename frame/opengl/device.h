@@ -13,6 +13,7 @@
 #include "frame/logger.h"
 #include "frame/node_camera.h"
 #include "frame/opengl/buffer.h"
+#include "frame/opengl/gpu_profiler.h"
 #include "frame/opengl/material.h"
 #include "frame/opengl/program.h"
 #include "frame/opengl/renderer.h"
@@ -178,6 +179,30 @@ class Device : public DeviceInterface
      */
     std::unique_ptr<MeshInterface> CreateMesh(
         const MeshParameter& mesh_parameter) final;
+    /**
+     * @brief Get the GPU time of the passes over the last frames.
+     * @return One entry per timed pass.
+     */
+    std::vector<GpuPassStats> GetGpuPassStats() const final
+    {
+        return gpu_profiler_ ? gpu_profiler_->GetStats()
+                             : std::vector<GpuPassStats>{};
+    }
+    /**
+     * @brief Get the calls made by the renderer during the last frame (see
+     *        GLCallCounters).
+     * @return The counters of the renderer.
+     */
+    RenderCallStats GetRenderCallStats() const final;
+    /**
+     * @brief Get the GPU profiler, passes drawn outside of the device (the
+     *        GUI) are timed with it.
+     * @return The profiler of the device.
+     */
+    GpuProfiler* GetGpuProfiler()
+    {
+        return gpu_profiler_.get();
+    }
 
   protected:
     void DisplayCamera(
@@ -201,6 +226,8 @@ class Device : public DeviceInterface
         json::PixelElementSize_HALF();
     // Rendering pipeline.
     std::unique_ptr<Renderer> renderer_ = nullptr;
+    // Timer queries of the passes.
+    std::unique_ptr<GpuProfiler> gpu_profiler_ = nullptr;
     double elapsed_time_seconds_ = 0.0;
     // Stereo mode.
     StereoEnum stereo_enum_ = StereoEnum::NONE;
@@ -1678,6 +1678,7 @@ std::vector<std::pair<EntityId, EntityId>> LoadMeshesFromGltfFile(
                 ? std::format("{}.mesh", name)
                 : std::format("{}.{}.mesh", name, mesh_index);
         mesh_interface->SetName(mesh_name);
+        mesh_interface->SetBoundingVolume(ComputeBoundingVolume(points));
         auto maybe_mesh_id = level.AddMesh(std::move(mesh_interface));
         if (!maybe_mesh_id)
         {
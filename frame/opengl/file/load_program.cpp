@@ -2,18 +2,37 @@
 
 #include <frame/file/file_system.h>
 #include <frame/json/program_catalog.h>
+#include <frame/logger.h>
+#include <frame/opengl/file/program_binary_cache.h>
 #include <frame/opengl/program.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <format>
+#include <optional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace frame::opengl::file
 {
 
-// TODO(anirul): Should be moved to the device.
-std::unique_ptr<frame::ProgramInterface> LoadProgram(
+namespace
+{
+
+std::atomic<std::uint32_t> programs_from_binary = 0;
+std::atomic<std::uint32_t> programs_compiled = 0;
+
+struct ProgramSources
+{
+    const proto::Program* proto_program = nullptr;
+    std::string vertex_source;
+    std::string fragment_source;
+};
+
+std::pair<std::string, std::string> ResolveShaderFiles(
     const proto::Program& proto_program)
 {
     auto shader_files = frame::json::ResolveProgramShaderFiles(
@@ -29,15 +48,12 @@ std::unique_ptr<frame::ProgramInterface> LoadProgram(
                     ? proto_program.pipeline_name()
                     : proto_program.name()));
     }
-    std::string vertex_file =
-        std::string("asset/shader/opengl/" + shader_files->vertex_shader);
-    std::string fragment_file =
-        std::string("asset/shader/opengl/" + shader_files->fragment_shader);
-    return LoadProgram(proto_program, vertex_file, fragment_file);
+    return {
+        std::string("asset/shader/opengl/" + shader_files->vertex_shader),
+        std::string("asset/shader/opengl/" + shader_files->fragment_shader)};
 }
 
-// TODO(anirul): Should be moved to the device.
-std::unique_ptr<frame::ProgramInterface> LoadProgram(
+ProgramSources ReadProgramSources(
     const proto::Program& proto_program,
     const std::string& vertex_file,
     const std::string& fragment_file)
@@ -46,7 +62,124 @@ std::unique_ptr<frame::ProgramInterface> LoadProgram(
         frame::file::FindFile(std::filesystem::path(vertex_file))};
     std::ifstream fragment_ifs{
         frame::file::FindFile(std::filesystem::path(fragment_file))};
-    return CreateProgram(proto_program, vertex_ifs, fragment_ifs);
+    return {
+        &proto_program,
+        std::string(std::istreambuf_iterator<char>(vertex_ifs), {}),
+        std::string(std::istreambuf_iterator<char>(fragment_ifs), {})};
+}
+
+std::vector<std::unique_ptr<frame::ProgramInterface>> LoadProgramSources(
+    const std::vector<ProgramSources>& sources)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto& logger = Logger::GetInstance();
+    std::vector<std::unique_ptr<frame::ProgramInterface>> programs(
+        sources.size());
+    std::vector<std::optional<ProgramBinaryCacheKey>> cache_keys(
+        sources.size());
+    std::vector<std::unique_ptr<ProgramBuild>> builds(sources.size());
+    std::size_t cached_count = 0;
+    // Warm start: link from the binary of a previous run, a binary from
+    // another driver or stale sources falls back to compiling. Every compile
+    // is started before waiting for any, so the driver can overlap them.
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        const auto& proto_program = *sources[i].proto_program;
+        cache_keys[i] = MakeProgramBinaryCacheKey(
+            proto_program.name(),
+            sources[i].vertex_source,
+            sources[i].fragment_source);
+        if (cache_keys[i])
+        {
+            if (auto binary = LoadProgramBinaryCache(*cache_keys[i]))
+            {
+                programs[i] = CreateProgramFromBinary(proto_program, *binary);
+                if (programs[i])
+                {
+                    ++cached_count;
+                    continue;
+                }
+                logger->info(
+                    "Program [{}] binary rejected by the driver, compiling.",
+                    proto_program.name());
+            }
+        }
+        builds[i] = std::make_unique<ProgramBuild>(
+            proto_program,
+            sources[i].vertex_source,
+            sources[i].fragment_source);
+    }
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        if (!builds[i])
+        {
+            continue;
+        }
+        programs[i] = builds[i]->Finish();
+        if (cache_keys[i])
+        {
+            const auto& gl_program = static_cast<const Program&>(*programs[i]);
+            if (auto binary = gl_program.GetProgramBinary())
+            {
+                SaveProgramBinaryCache(*cache_keys[i], *binary);
+            }
+        }
+    }
+    programs_from_binary += static_cast<std::uint32_t>(cached_count);
+    programs_compiled +=
+        static_cast<std::uint32_t>(sources.size() - cached_count);
+    logger->info(
+        "Loaded {} program(s) in {:.2f} ms ({} from binary cache, {} "
+        "compiled).",
+        sources.size(),
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        cached_count,
+        sources.size() - cached_count);
+    return programs;
+}
+
+} // namespace
+
+// TODO(anirul): Should be moved to the device.
+std::unique_ptr<frame::ProgramInterface> LoadProgram(
+    const proto::Program& proto_program)
+{
+    const auto [vertex_file, fragment_file] =
+        ResolveShaderFiles(proto_program);
+    return LoadProgram(proto_program, vertex_file, fragment_file);
+}
+
+// TODO(anirul): Should be moved to the device.
+std::unique_ptr<frame::ProgramInterface> LoadProgram(
+    const proto::Program& proto_program,
+    const std::string& vertex_file,
+    const std::string& fragment_file)
+{
+    auto programs = LoadProgramSources(
+        {ReadProgramSources(proto_program, vertex_file, fragment_file)});
+    return std::move(programs.front());
+}
+
+std::vector<std::unique_ptr<frame::ProgramInterface>> LoadPrograms(
+    const std::vector<proto::Program>& proto_programs)
+{
+    std::vector<ProgramSources> sources;
+    sources.reserve(proto_programs.size());
+    for (const auto& proto_program : proto_programs)
+    {
+        const auto [vertex_file, fragment_file] =
+            ResolveShaderFiles(proto_program);
+        sources.push_back(
+            ReadProgramSources(proto_program, vertex_file, fragment_file));
+    }
+    return LoadProgramSources(sources);
+}
+
+ProgramLoadStats GetProgramLoadStats()
+{
+    return {programs_from_binary.load(), programs_compiled.load()};
 }
 
 } // namespace frame::opengl::file
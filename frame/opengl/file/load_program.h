@@ -1,13 +1,26 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "frame/program_interface.h"
 
 namespace frame::opengl::file
 {
 
+/**
+ * @class ProgramLoadStats
+ * @brief Programs loaded since the start, linked from a cached binary or
+ *        compiled from their sources.
+ */
+struct ProgramLoadStats
+{
+    std::uint32_t from_binary = 0;
+    std::uint32_t compiled = 0;
+};
+
 /**
  * @brief Load from a name (something like "Blur").
  * @param name: Program name.
@@ -28,5 +41,19 @@ std::unique_ptr<ProgramInterface> LoadProgram(
     const proto::Program& proto_program,
     const std::string& vertex_file,
     const std::string& fragment_file);
+/**
+ * @brief Load several programs at once, every compilation is started before
+ *        waiting for any so the driver can compile them in parallel (see
+ *        GL_KHR_parallel_shader_compile).
+ * @param proto_programs: Programs to load.
+ * @return The programs in the same order.
+ */
+std::vector<std::unique_ptr<ProgramInterface>> LoadPrograms(
+    const std::vector<proto::Program>& proto_programs);
+/**
+ * @brief Get the programs loaded so far (all threads).
+ * @return The counts of programs from the binary cache and compiled.
+ */
+ProgramLoadStats GetProgramLoadStats();
 
 } // namespace frame::opengl::file
@@ -0,0 +1,209 @@
+#include "frame/opengl/file/program_binary_cache.h"
+
+#include <glad/glad.h>
+
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "frame/file/file_system.h"
+#include "frame/logger.h"
+#include "frame/proto/program_binary_cache.pb.h"
+
+namespace frame::opengl::file
+{
+
+namespace
+{
+
+constexpr std::uint32_t kCacheVersion = 1;
+
+Logger& GetLogger()
+{
+    return Logger::GetInstance();
+}
+
+// FNV-1a, stable across runs and standard libraries (unlike std::hash).
+std::uint64_t HashSource(std::uint64_t hash, std::string_view source)
+{
+    for (const char c : source)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+    // Separator so moving text between the stages changes the hash.
+    hash ^= 0xffu;
+    return hash * 0x100000001b3ull;
+}
+
+std::string GetGLString(GLenum name)
+{
+    const auto* value = reinterpret_cast<const char*>(glGetString(name));
+    return value ? value : "";
+}
+
+} // namespace
+
+std::optional<ProgramBinaryCacheKey> MakeProgramBinaryCacheKey(
+    const std::string& program_name,
+    std::string_view vertex_source,
+    std::string_view fragment_source)
+{
+    std::filesystem::path asset_root;
+    try
+    {
+        asset_root = frame::file::FindDirectory("asset");
+    }
+    catch (const std::exception& exception)
+    {
+        GetLogger()->warn(
+            "Program binary cache disabled: {}", exception.what());
+        return std::nullopt;
+    }
+    ProgramBinaryCacheKey key;
+    key.program_name = program_name;
+    key.source_hash = HashSource(
+        HashSource(0xcbf29ce484222325ull, vertex_source), fragment_source);
+    key.vendor = GetGLString(GL_VENDOR);
+    key.renderer = GetGLString(GL_RENDERER);
+    key.version = GetGLString(GL_VERSION);
+    key.cache_path = (asset_root / "cache" / "program" / "opengl" /
+                      MakeProgramBinaryCacheFileName(key))
+                         .lexically_normal();
+    return key;
+}
+
+std::string MakeProgramBinaryCacheFileName(const ProgramBinaryCacheKey& key)
+{
+    // Sources and driver in the name, other versions get their own file.
+    const std::uint64_t file_hash = HashSource(
+        HashSource(HashSource(key.source_hash, key.vendor), key.renderer),
+        key.version);
+    return std::format("{}-{:016x}.glprog", key.program_name, file_hash);
+}
+
+std::optional<ProgramBinary> LoadProgramBinaryCache(
+    const ProgramBinaryCacheKey& key)
+{
+    if (key.cache_path.empty() || !std::filesystem::exists(key.cache_path))
+    {
+        return std::nullopt;
+    }
+    std::ifstream input(key.cache_path, std::ios::binary);
+    if (!input)
+    {
+        GetLogger()->warn(
+            "Failed to open program binary cache {} for reading.",
+            key.cache_path.string());
+        return std::nullopt;
+    }
+    proto::ProgramBinaryCache cache_proto;
+    if (!cache_proto.ParseFromIstream(&input))
+    {
+        GetLogger()->warn(
+            "Could not parse program binary cache {}.",
+            key.cache_path.string());
+        return std::nullopt;
+    }
+    if (cache_proto.cache_version() != kCacheVersion)
+    {
+        GetLogger()->info(
+            "Ignoring program binary cache {} due to version mismatch ({} != "
+            "{}).",
+            key.cache_path.string(),
+            cache_proto.cache_version(),
+            kCacheVersion);
+        return std::nullopt;
+    }
+    if (cache_proto.program_name() != key.program_name ||
+        cache_proto.source_hash() != key.source_hash)
+    {
+        GetLogger()->info(
+            "Ignoring program binary cache {} due to changed sources.",
+            key.cache_path.string());
+        return std::nullopt;
+    }
+    if (cache_proto.vendor() != key.vendor ||
+        cache_proto.renderer() != key.renderer ||
+        cache_proto.version() != key.version)
+    {
+        GetLogger()->info(
+            "Ignoring program binary cache {} due to a different driver.",
+            key.cache_path.string());
+        return std::nullopt;
+    }
+    ProgramBinary binary;
+    binary.format = cache_proto.binary_format();
+    const std::string& data = cache_proto.binary();
+    binary.data.assign(data.begin(), data.end());
+    return binary;
+}
+
+void SaveProgramBinaryCache(
+    const ProgramBinaryCacheKey& key, const ProgramBinary& binary)
+{
+    if (key.cache_path.empty())
+    {
+        return;
+    }
+    std::error_code ec;
+    const auto parent = key.cache_path.parent_path();
+    if (!parent.empty())
+    {
+        std::filesystem::create_directories(parent, ec);
+        if (ec)
+        {
+            GetLogger()->warn(
+                "Failed to create program binary cache directory {}: {}",
+                parent.string(),
+                ec.message());
+            return;
+        }
+    }
+    proto::ProgramBinaryCache cache_proto;
+    cache_proto.set_cache_version(kCacheVersion);
+    cache_proto.set_program_name(key.program_name);
+    cache_proto.set_source_hash(key.source_hash);
+    cache_proto.set_vendor(key.vendor);
+    cache_proto.set_renderer(key.renderer);
+    cache_proto.set_version(key.version);
+    cache_proto.set_binary_format(binary.format);
+    cache_proto.set_binary(binary.data.data(), binary.data.size());
+    // Write then rename so a concurrent reader never sees a partial binary.
+    std::ostringstream suffix;
+    suffix << ".tmp" << std::this_thread::get_id();
+    auto temporary_path = key.cache_path;
+    temporary_path += suffix.str();
+    {
+        std::ofstream output(
+            temporary_path, std::ios::binary | std::ios::trunc);
+        if (!output)
+        {
+            GetLogger()->warn(
+                "Failed to open program binary cache {} for writing.",
+                temporary_path.string());
+            return;
+        }
+        if (!cache_proto.SerializeToOstream(&output))
+        {
+            GetLogger()->warn(
+                "Failed to serialize program binary cache {}.",
+                temporary_path.string());
+            output.close();
+            std::filesystem::remove(temporary_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, key.cache_path, ec);
+    if (ec)
+    {
+        GetLogger()->warn(
+            "Failed to save program binary cache {}: {}",
+            key.cache_path.string(),
+            ec.message());
+        std::filesystem::remove(temporary_path, ec);
+    }
+}
+
+} // namespace frame::opengl::file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "frame/opengl/program.h"
+
+namespace frame::opengl::file
+{
+
+/**
+ * @class ProgramBinaryCacheKey
+ * @brief What a cached program binary has to match to be reused: the shader
+ *        sources and the driver that linked it.
+ */
+struct ProgramBinaryCacheKey
+{
+    std::filesystem::path cache_path;
+    std::string program_name;
+    std::uint64_t source_hash = 0;
+    std::string vendor;
+    std::string renderer;
+    std::string version;
+};
+
+/**
+ * @brief Build the cache key of a program for the current context, the file
+ *        is asset/cache/program/opengl/<name>-<hash>.glprog (hash of the
+ *        sources and the driver).
+ * @param program_name: Name of the program.
+ * @param vertex_source: Vertex shader source.
+ * @param fragment_source: Fragment shader source.
+ * @return The key, nothing if there is no asset directory.
+ */
+std::optional<ProgramBinaryCacheKey> MakeProgramBinaryCacheKey(
+    const std::string& program_name,
+    std::string_view vertex_source,
+    std::string_view fragment_source);
+
+/**
+ * @brief Get the file name of a cached program, <name>-<hash>.glprog with
+ *        the hash of the sources and the driver strings of the key.
+ * @param key: Key of the program (the cache path is not used).
+ * @return The file name.
+ */
+std::string MakeProgramBinaryCacheFileName(const ProgramBinaryCacheKey& key);
+
+/**
+ * @brief Load a cached binary, stale entries (other sources, driver or
+ *        cache version) are ignored.
+ * @param key: Key of the program.
+ * @return The binary or nothing.
+ */
+std::optional<ProgramBinary> LoadProgramBinaryCache(
+    const ProgramBinaryCacheKey& key);
+
+/**
+ * @brief Save the binary of a program, replacing any stale entry.
+ * @param key: Key of the program.
+ * @param binary: Binary from Program::GetProgramBinary.
+ */
+void SaveProgramBinaryCache(
+    const ProgramBinaryCacheKey& key, const ProgramBinary& binary);
+
+} // namespace frame::opengl::file
@@ -0,0 +1,82 @@
+#include "frame/opengl/gpu_profiler.h"
+
+namespace frame::opengl
+{
+
+GpuProfiler::~GpuProfiler()
+{
+    for (auto& frame : frames_)
+    {
+        if (!frame.ids.empty())
+        {
+            glDeleteQueries(
+                static_cast<GLsizei>(frame.ids.size()), frame.ids.data());
+        }
+    }
+}
+
+void GpuProfiler::BeginFrame()
+{
+    if (scope_open_)
+    {
+        EndScope();
+    }
+    current_ = (current_ + 1) % kFrameLatency;
+    Resolve(frames_[current_]);
+}
+
+bool GpuProfiler::BeginScope(const char* name)
+{
+    if (scope_open_)
+    {
+        return false;
+    }
+    auto& frame = frames_[current_];
+    if (frame.used.size() == frame.ids.size())
+    {
+        GLuint id = 0;
+        glGenQueries(1, &id);
+        frame.ids.push_back(id);
+    }
+    const GLuint id = frame.ids[frame.used.size()];
+    frame.used.push_back({name, id});
+    glBeginQuery(GL_TIME_ELAPSED, id);
+    scope_open_ = true;
+    return true;
+}
+
+void GpuProfiler::EndScope()
+{
+    if (!scope_open_)
+    {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    scope_open_ = false;
+}
+
+void GpuProfiler::Resolve(FrameQueries& frame)
+{
+    if (frame.used.empty())
+    {
+        return;
+    }
+    // The queries complete in order, the last one tells for the frame.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(
+        frame.used.back().id, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_TRUE)
+    {
+        for (const auto& query : frame.used)
+        {
+            GLuint64 elapsed_ns = 0;
+            glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsed_ns);
+            history_.AddSample(
+                query.name, static_cast<double>(elapsed_ns) * 1e-6);
+        }
+        history_.EndFrame();
+    }
+    frame.used.clear();
+}
+
+} // End namespace frame::opengl.
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "frame/gpu_pass_stats.h"
+
+namespace frame::opengl
+{
+
+/**
+ * @class GpuProfiler
+ * @brief GPU time of the named passes, from GL_TIME_ELAPSED queries.
+ *
+ * The queries of a frame are read kFrameLatency frames later, by then the
+ * GPU is done with them and reading does not stall the pipeline (a frame
+ * whose queries are still not available is dropped). Time elapsed queries
+ * cannot nest: a scope begun while another one is open is not timed.
+ */
+class GpuProfiler
+{
+  public:
+    //! @brief Frames between recording a query and reading it.
+    static constexpr std::size_t kFrameLatency = 4;
+
+  public:
+    //! @brief Constructor, needs a current OpenGL context.
+    GpuProfiler() = default;
+    //! @brief Destructor, delete the queries.
+    ~GpuProfiler();
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+  public:
+    /**
+     * @brief Start a new frame, the queries of the frame recorded
+     *        kFrameLatency frames ago are read and reused.
+     */
+    void BeginFrame();
+    /**
+     * @brief Begin timing a pass.
+     * @param name: Name of the pass (static string, see gpu_pass).
+     * @return False if another scope is open, nothing is timed then.
+     */
+    bool BeginScope(const char* name);
+    //! @brief End the open scope.
+    void EndScope();
+    /**
+     * @brief Get the statistics of the passes.
+     * @return One entry per pass timed so far.
+     */
+    std::vector<GpuPassStats> GetStats() const
+    {
+        return history_.GetStats();
+    }
+    //! @brief Forget the statistics (level reload).
+    void Clear()
+    {
+        history_.Clear();
+    }
+
+  public:
+    /**
+     * @class Scope
+     * @brief Time a pass for the lifetime of the object, does nothing with a
+     *        null profiler.
+     */
+    class Scope
+    {
+      public:
+        Scope(GpuProfiler* profiler, const char* name)
+            : profiler_(
+                  profiler && profiler->BeginScope(name) ? profiler : nullptr)
+        {
+        }
+        ~Scope()
+        {
+            if (profiler_)
+            {
+                profiler_->EndScope();
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        GpuProfiler* profiler_ = nullptr;
+    };
+
+  private:
+    struct Query
+    {
+        const char* name = nullptr;
+        GLuint id = 0;
+    };
+    struct FrameQueries
+    {
+        // Query objects of the slot, the first used.size() are in use.
+        std::vector<GLuint> ids;
+        std::vector<Query> used;
+    };
+    void Resolve(FrameQueries& frame);
+
+  private:
+    std::array<FrameQueries, kFrameLatency> frames_ = {};
+    std::size_t current_ = 0;
+    bool scope_open_ = false;
+    GpuPassHistory history_;
+};
+
+} // End namespace frame::opengl.
@@ -111,9 +111,30 @@ EntityId EnsureRaytracingDefaultTexture(
 std::unique_ptr<frame::ProgramInterface> ParseProgramOpenGL(
     const proto::Program& proto_program, LevelInterface& level)
 {
-    Logger& logger = Logger::GetInstance();
     // Create the program.
-    auto program = opengl::file::LoadProgram(proto_program);
+    return ParseProgramOpenGL(
+        proto_program, level, opengl::file::LoadProgram(proto_program));
+}
+
+std::vector<std::unique_ptr<frame::ProgramInterface>> ParseProgramsOpenGL(
+    const std::vector<proto::Program>& proto_programs, LevelInterface& level)
+{
+    // Create the programs, compiled together.
+    auto programs = opengl::file::LoadPrograms(proto_programs);
+    for (std::size_t i = 0; i < programs.size(); ++i)
+    {
+        programs[i] = ParseProgramOpenGL(
+            proto_programs[i], level, std::move(programs[i]));
+    }
+    return programs;
+}
+
+std::unique_ptr<frame::ProgramInterface> ParseProgramOpenGL(
+    const proto::Program& proto_program,
+    LevelInterface& level,
+    std::unique_ptr<ProgramInterface> program)
+{
+    Logger& logger = Logger::GetInstance();
     if (!program)
     {
         return nullptr;
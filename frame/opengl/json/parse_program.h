@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "frame/json/proto.h"
 #include "frame/level_interface.h"
@@ -18,5 +19,25 @@ namespace frame::json
  */
 std::unique_ptr<ProgramInterface> ParseProgramOpenGL(
     const proto::Program& proto_program, LevelInterface& level);
+/**
+ * @brief Parse a program loaded beforehand (see ParseProgramsOpenGL).
+ * @param proto_program: The proto form of the program.
+ * @param level: A pointer to a level.
+ * @param program: The loaded program.
+ * @return A unique pointer to a program interface or error.
+ */
+std::unique_ptr<ProgramInterface> ParseProgramOpenGL(
+    const proto::Program& proto_program,
+    LevelInterface& level,
+    std::unique_ptr<ProgramInterface> program);
+/**
+ * @brief Parse the programs of a level, their shaders are compiled together
+ *        (in parallel when the driver supports it).
+ * @param proto_programs: The proto form of the programs.
+ * @param level: A pointer to a level.
+ * @return The programs in the same order, nullptr for the invalid ones.
+ */
+std::vector<std::unique_ptr<ProgramInterface>> ParseProgramsOpenGL(
+    const std::vector<proto::Program>& proto_programs, LevelInterface& level);
 
 } // End namespace frame::json.
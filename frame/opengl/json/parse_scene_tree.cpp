@@ -518,6 +518,8 @@ void ApplyAnimationPlayback(
         dynamic_cast<NodeMesh&>(level.GetSceneNodeFromId(scene_id));
     node.GetData().set_render_time_enum(
         proto_scene_mesh.render_time_enum());
+    node.GetData().set_clear_depth_buffer(
+        proto_scene_mesh.clear_depth_buffer());
     ApplyAnimationPlayback(proto_scene_mesh, node, &mesh);
     level.AddMeshMaterialId(
         scene_id, material_id, proto_scene_mesh.render_time_enum());
@@ -608,6 +610,8 @@ void ApplyAnimationPlayback(
         }
         mesh_node.GetData().set_render_time_enum(
             proto_scene_mesh.render_time_enum());
+        mesh_node.GetData().set_clear_depth_buffer(
+            proto_scene_mesh.clear_depth_buffer());
         ApplyAnimationPlayback(proto_scene_mesh, mesh_node, &mesh);
         EnsureRaytracingBvhBuffers(level, material_id, mesh);
         if (!material_id)
@@ -684,6 +688,8 @@ void ApplyAnimationPlayback(
         dynamic_cast<NodeMesh&>(level.GetSceneNodeFromId(scene_id));
     node.GetData().set_render_time_enum(
         proto_scene_mesh.render_time_enum());
+    node.GetData().set_clear_depth_buffer(
+        proto_scene_mesh.clear_depth_buffer());
     ApplyAnimationPlayback(proto_scene_mesh, node, &mesh_ref);
     level.AddMeshMaterialId(
         scene_id, material_id, proto_scene_mesh.render_time_enum());
@@ -10,6 +10,7 @@ namespace frame::opengl
 bool Material::AddTextureId(EntityId id, const std::string& name)
 {
     RemoveTextureId(id);
+    id_name_id_map_[id] = InternUniformName(name);
     return id_name_map_.insert({id, name}).second;
 }
 
@@ -29,10 +30,17 @@ bool Material::RemoveTextureId(EntityId id)
         return false;
     auto it = id_name_map_.find(id);
     id_name_map_.erase(it);
+    id_name_id_map_.erase(id);
     return true;
 }
 
 std::pair<std::string, int> Material::EnableTextureId(EntityId id) const
+{
+    const int slot = EnableTextureSlot(id);
+    return {id_name_map_.at(id), slot};
+}
+
+int Material::EnableTextureSlot(EntityId id) const
 {
     // Check it exist.
     if (!HasTextureId(id))
@@ -51,7 +59,7 @@ std::pair<std::string, int> Material::EnableTextureId(EntityId id) const
         if (id_array_[i] == 0)
         {
             id_array_[i] = id;
-            return {id_name_map_.at(id), i};
+            return i;
         }
     }
     // No free slots.
@@ -179,7 +187,12 @@ std::string Material::GetInnerNodeName(const std::string& name) const
 bool Material::AddNodeName(
     const std::string& name, const std::string& inner_name)
 {
-    return name_node_name_map_.insert({name, inner_name}).second;
+    if (!name_node_name_map_.insert({name, inner_name}).second)
+    {
+        return false;
+    }
+    name_node_name_id_map_.insert({name, InternUniformName(inner_name)});
+    return true;
 }
 
 std::vector<std::string> Material::GetNodeNames() const
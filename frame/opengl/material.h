@@ -7,6 +7,7 @@
 #include "frame/level_interface.h"
 #include "frame/material_interface.h"
 #include "frame/opengl/texture.h"
+#include "frame/uniform_value.h"
 
 namespace frame::opengl
 {
@@ -42,6 +43,16 @@ class Material : public MaterialInterface
      * @return The string.
      */
     std::string GetInnerName(EntityId id) const;
+    /**
+     * @brief Get the interned inner name of a texture id (interned when the
+     *        texture is added).
+     * @param id: The id to check for corresponding name.
+     * @return The uniform name id.
+     */
+    UniformNameId GetInnerNameId(EntityId id) const
+    {
+        return id_name_id_map_.at(id);
+    }
     /**
      * @brief Store local program id.
      * @param id: the stored program id.
@@ -82,6 +93,12 @@ class Material : public MaterialInterface
      * passed to the program).
      */
     std::pair<std::string, int> EnableTextureId(EntityId id) const override;
+    /**
+     * @brief Enable a texture without copying its name (see GetInnerNameId).
+     * @param id: Id of the texture to be enabled.
+     * @return Return the binding slot of the texture.
+     */
+    int EnableTextureSlot(EntityId id) const;
     /**
      * @brief Unbind the texture and remove it from the list.
      * @param id: Texture id.
@@ -100,12 +117,23 @@ class Material : public MaterialInterface
     bool AddNodeName(
         const std::string& name, const std::string& inner_name) override;
     std::vector<std::string> GetNodeNames() const override;
+    /**
+     * @brief Get the node names with their interned inner name (interned
+     *        when the node name is added).
+     * @return Map of node name to uniform name id.
+     */
+    const std::map<std::string, UniformNameId>& GetNodeNameIds() const
+    {
+        return name_node_name_id_map_;
+    }
 
   private:
     std::map<EntityId, std::string> id_name_map_ = {};
+    std::map<EntityId, UniformNameId> id_name_id_map_ = {};
     // Preserve insertion order for buffer bindings to match shader layout
     std::vector<std::pair<std::string, std::string>> buffer_name_vec_ = {};
     std::map<std::string, std::string> name_node_name_map_ = {};
+    std::map<std::string, UniformNameId> name_node_name_id_map_ = {};
     mutable std::array<EntityId, 32> id_array_ = {};
     mutable EntityId program_id_ = 0;
     mutable EntityId preprocess_program_id_ = 0;
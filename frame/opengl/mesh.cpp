@@ -349,6 +349,7 @@ EntityId CreateQuadMesh(LevelInterface& level)
     parameter.index_buffer_id = maybe_index_buffer_id;
     parameter.render_primitive_enum = proto::NodeMesh::TRIANGLE_PRIMITIVE;
     auto mesh = std::make_unique<Mesh>(level, parameter);
+    mesh->SetBoundingVolume(ComputeBoundingVolume(points));
     mesh->SetName(std::format("QuadMesh.{}", count));
     return level.AddMesh(std::move(mesh));
 }
@@ -538,6 +539,7 @@ EntityId CreateCubeMesh(LevelInterface& level)
     parameter.index_buffer_id = maybe_index_buffer_id;
     parameter.render_primitive_enum = proto::NodeMesh::TRIANGLE_PRIMITIVE;
     auto mesh = std::make_unique<Mesh>(level, parameter);
+    mesh->SetBoundingVolume(ComputeBoundingVolume(points));
     mesh->SetName(std::format("CubeMesh.{}", count));
     return level.AddMesh(std::move(mesh));
 }
@@ -62,6 +62,18 @@ class Mesh : public BindInterface, public MeshInterface
     {
         return clear_depth_buffer_;
     }
+    const BoundingVolume& GetBoundingVolume() const override
+    {
+        return bounding_volume_;
+    }
+    void SetBoundingVolume(const BoundingVolume& bounding_volume) override
+    {
+        bounding_volume_ = bounding_volume;
+    }
+    MeshTypeEnum GetMeshType() const override
+    {
+        return MeshTypeEnum::STATIC_MESH;
+    }
 
   public:
     void Bind(const unsigned int slot = 0) const override;
@@ -83,7 +95,8 @@ class Mesh : public BindInterface, public MeshInterface
 
   protected:
     LevelInterface& level_;
-    bool clear_depth_buffer_ = true;
+    // The scene asks for depth clears per node (clear_depth_buffer).
+    bool clear_depth_buffer_ = false;
     mutable bool locked_bind_ = false;
     EntityId point_buffer_id_ = NullId;
     std::uint32_t point_buffer_size_ = 3;
@@ -99,6 +112,7 @@ class Mesh : public BindInterface, public MeshInterface
     std::size_t index_size_ = 0;
     unsigned int vertex_array_object_ = 0;
     float point_size_ = 1.0f;
+    BoundingVolume bounding_volume_ = {};
 };
 
 /**
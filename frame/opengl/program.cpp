@@ -19,11 +19,52 @@
 #include "frame/level_interface.h"
 #include "frame/logger.h"
 #include "frame/opengl/buffer.h"
+#include "frame/opengl/uniform_blocks.h"
 #include "frame/uniform.h"
 
 namespace frame::opengl
 {
 
+namespace
+{
+
+// Number of locations written by a proto uniform.
+std::size_t GetElementCount(const proto::Uniform& data)
+{
+    switch (data.type())
+    {
+    case proto::Uniform::INTS:
+        return data.uniform_ints().size().x() * data.uniform_ints().size().y();
+    case proto::Uniform::FLOATS:
+        return data.uniform_floats().size().x() *
+               data.uniform_floats().size().y();
+    default:
+        return 1;
+    }
+}
+
+// After linking, the program knows about all active uniforms. Preserve the
+// enum identifiers from the proto so serialization keeps the same names.
+void AddUniformEnums(Program& program, const proto::Program& proto_program)
+{
+    const ProgramInterface& program_iface = program;
+    for (const auto& uniform : proto_program.uniforms())
+    {
+        if (uniform.has_uniform_enum() &&
+            program_iface.HasUniform(uniform.name()))
+        {
+            std::unique_ptr<UniformInterface> uniform_interface =
+                std::make_unique<Uniform>(
+                    uniform.name(), uniform.uniform_enum());
+            // Bypass the check because the uniform exists but may not be
+            // currently active due to the INVALID_TYPE placeholder.
+            program.AddUniform(std::move(uniform_interface));
+        }
+    }
+}
+
+} // namespace
+
 Program::Program(const std::string& name)
 {
     SetName(name);
@@ -43,6 +84,15 @@ void Program::AddShader(const Shader& shader)
 
 void Program::LinkShader()
 {
+    StartLink();
+    FinishLink();
+}
+
+void Program::StartLink()
+{
+    // Keep the binary retrievable for the program binary cache.
+    glProgramParameteri(
+        program_id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program_id_);
     GLenum error = glGetError();
     if (error != GL_NO_ERROR)
@@ -59,13 +109,95 @@ void Program::LinkShader()
         error_str += "but GL_LINK_STATUS is GL_TRUE?";
         logger_->warn(error_str);
     }
+}
+
+void Program::FinishLink()
+{
+    // Waits for the link, a failed link has its reason in the info log.
+    GLint program_status = 0;
+    glGetProgramiv(program_id_, GL_LINK_STATUS, &program_status);
+    if (program_status != GL_TRUE)
+    {
+        GLint length = 0;
+        glGetProgramiv(program_id_, GL_INFO_LOG_LENGTH, &length);
+        std::string info_log(std::max(length, 1), '\0');
+        glGetProgramInfoLog(program_id_, length, nullptr, info_log.data());
+        throw std::runtime_error(std::format(
+            "Failed to link program [{}]: {}", name_, info_log.c_str()));
+    }
     for (const auto& id : attached_shaders_)
     {
         glDetachShader(program_id_, id);
     }
+    attached_shaders_.clear();
+    OnLinked();
+}
+
+bool Program::LinkBinary(const ProgramBinary& binary)
+{
+    glProgramBinary(
+        program_id_,
+        static_cast<GLenum>(binary.format),
+        binary.data.data(),
+        static_cast<GLsizei>(binary.data.size()));
+    // An unknown format is an error, the link status tells about the rest.
+    while (glGetError() != GL_NO_ERROR)
+    {
+    }
+    GLint program_status = 0;
+    glGetProgramiv(program_id_, GL_LINK_STATUS, &program_status);
+    if (program_status != GL_TRUE)
+    {
+        return false;
+    }
+    OnLinked();
+    return true;
+}
+
+std::optional<ProgramBinary> Program::GetProgramBinary() const
+{
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    GLint length = 0;
+    glGetProgramiv(program_id_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (format_count <= 0 || length <= 0)
+    {
+        return std::nullopt;
+    }
+    ProgramBinary binary;
+    binary.data.resize(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(
+        program_id_, length, &written, &format, binary.data.data());
+    if (written <= 0)
+    {
+        return std::nullopt;
+    }
+    binary.data.resize(written);
+    binary.format = format;
+    return binary;
+}
+
+void Program::OnLinked()
+{
+    has_frame_block_ = BindUniformBlock(kFrameBlockName, kFrameBlockBinding);
+    has_object_block_ =
+        BindUniformBlock(kObjectBlockName, kObjectBlockBinding);
     CreateUniformList();
 }
 
+bool Program::BindUniformBlock(const char* name, unsigned int binding)
+{
+    const GLuint block_index = glGetUniformBlockIndex(program_id_, name);
+    if (block_index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+    glUniformBlockBinding(program_id_, block_index, binding);
+    return true;
+}
+
 void Program::Use() const
 {
     glUseProgram(program_id_);
@@ -74,25 +206,33 @@ void Program::Use() const
 
 void Program::Use(
     const UniformCollectionInterface& uniform_collection_interface,
-    const LevelInterface* level)
+    const LevelInterface* /*level*/)
 {
-    glUseProgram(program_id_);
-    is_used_ = true;
-    for (const auto& name : uniform_collection_interface.GetUniformNames())
+    Use();
+    UploadUniforms(uniform_collection_interface);
+}
+
+void Program::UploadUniforms(
+    const UniformCollectionInterface& uniform_collection_interface)
+{
+    for (const auto& value : uniform_collection_interface.GetUniformValues())
     {
-        if (HasUniform(name))
+        if (!HasUniform(value.GetNameId()))
         {
-            UploadUniform(uniform_collection_interface.GetUniform(name));
+            continue;
         }
-    }
-    if (level)
-    {
-        for (const auto& [id, name_binding] : buffer_map_)
+        if (value.GetType() == UniformValueType::INVALID)
         {
-            const auto& buffer =
-                dynamic_cast<const Buffer&>(level->GetBufferFromId(id));
-            buffer.BindBase(name_binding.second);
+            // No plain payload (arrays, enums), go through the proto.
+            UploadUniform(
+                uniform_collection_interface.GetUniform(value.GetName()));
+            continue;
         }
+        UploadUniformValue(value);
+    }
+    for (const auto& buffer_binding : buffers_)
+    {
+        buffer_binding.buffer->BindBase(buffer_binding.binding);
     }
 }
 
@@ -105,6 +245,13 @@ const UniformInterface& Program::GetUniform(const std::string& name) const
                 "Uniform [{}] not found in program [{}].", name, name_));
     }
     auto it = uniform_map_.find(name);
+    // Values set at runtime are only converted when read.
+    const auto& value = GetUniformSlot(InternUniformName(name)).value;
+    if (value.GetType() != UniformValueType::INVALID &&
+        !it->second->GetData().has_uniform_enum())
+    {
+        it->second->FromProto(UniformValueToProto(value));
+    }
     return *(it->second);
 }
 
@@ -131,6 +278,7 @@ void Program::AddUniformInternal(
                 name_));
         return;
     }
+    GetUniformSlot(InternUniformName(name)).value = {};
     auto it = uniform_map_.find(name);
     if (it != uniform_map_.end())
     {
@@ -139,6 +287,7 @@ void Program::AddUniformInternal(
     else
     {
         uniform_map_.emplace(name, std::move(uniform_interface));
+        UpdateUniformPresence(name);
     }
     auto* uniform_ptr = uniform_map_[name].get();
     if (uniform_ptr->GetData().has_uniform_enum())
@@ -147,6 +296,13 @@ void Program::AddUniformInternal(
         // here.
         return;
     }
+    if (uniform_ptr->GetData().type() != proto::Uniform::INVALID_TYPE)
+    {
+        // Uploaded below without the shadow copy.
+        ForgetUploadedValues(
+            GetMemoizeUniformLocation(name),
+            GetElementCount(uniform_ptr->GetData()));
+    }
     switch (uniform_ptr->GetData().type())
     {
     case proto::Uniform::INVALID_TYPE:
@@ -223,6 +379,17 @@ void Program::UploadUniform(const UniformInterface& uniform_interface) const
 {
     const std::string& name = uniform_interface.GetName();
     const auto& data = uniform_interface.GetData();
+    // Plain values go through the shadow copy, the others reset it.
+    if (auto maybe_value = UniformValueFromProto(data))
+    {
+        UploadUniformValue(*maybe_value);
+        return;
+    }
+    if (data.type() != proto::Uniform::INVALID_TYPE)
+    {
+        ForgetUploadedValues(
+            GetMemoizeUniformLocation(name), GetElementCount(data));
+    }
     switch (data.type())
     {
     case proto::Uniform::INVALID_TYPE:
@@ -287,24 +454,127 @@ void Program::UploadUniform(const UniformInterface& uniform_interface) const
     }
 }
 
+void Program::SetUniformValue(const UniformValue& uniform_value)
+{
+    if (!HasUniform(uniform_value.GetNameId()))
+    {
+        logger_->warn(
+            std::format(
+                "Uniform [{}] not active in program [{}], skipping.",
+                uniform_value.GetName(),
+                name_));
+        return;
+    }
+    GetUniformSlot(uniform_value.GetNameId()).value = uniform_value;
+    UploadUniformValue(uniform_value);
+}
+
+void Program::UploadUniformValue(const UniformValue& uniform_value) const
+{
+    if (uniform_value.GetType() == UniformValueType::INVALID)
+    {
+        return;
+    }
+    const int location = GetMemoizeUniformLocation(uniform_value.GetNameId());
+    if (static_cast<std::size_t>(location) >= uploaded_values_.size())
+    {
+        uploaded_values_.resize(location + 1);
+    }
+    auto& uploaded_value = uploaded_values_[location];
+    if (uploaded_value.SameValue(uniform_value))
+    {
+        ++upload_counters_.skipped;
+        return;
+    }
+    uploaded_value = uniform_value;
+    ++upload_counters_.issued;
+    switch (uniform_value.GetType())
+    {
+    case UniformValueType::INT:
+        glUniform1i(location, uniform_value.GetInt());
+        break;
+    case UniformValueType::FLOAT:
+        glUniform1f(location, uniform_value.GetFloat());
+        break;
+    case UniformValueType::FLOAT_VECTOR2:
+        glUniform2fv(location, 1, uniform_value.GetFloats());
+        break;
+    case UniformValueType::FLOAT_VECTOR3:
+        glUniform3fv(location, 1, uniform_value.GetFloats());
+        break;
+    case UniformValueType::FLOAT_VECTOR4:
+        glUniform4fv(location, 1, uniform_value.GetFloats());
+        break;
+    case UniformValueType::FLOAT_MATRIX4:
+        glUniformMatrix4fv(location, 1, GL_FALSE, uniform_value.GetFloats());
+        break;
+    default:
+        break;
+    }
+}
+
+void Program::ForgetUploadedValues(int location, std::size_t count) const
+{
+    const auto begin = static_cast<std::size_t>(location);
+    const auto end = std::min(begin + count, uploaded_values_.size());
+    for (auto i = begin; i < end; ++i)
+    {
+        uploaded_values_[i] = {};
+    }
+}
+
 void Program::RemoveUniform(const std::string& name)
 {
+    GetUniformSlot(InternUniformName(name)).value = {};
     auto it = uniform_map_.find(name);
     if (it != uniform_map_.end())
     {
         uniform_map_.erase(it);
+        UpdateUniformPresence(name);
+    }
+}
+
+Program::UniformSlot& Program::GetUniformSlot(UniformNameId name_id) const
+{
+    if (name_id >= uniform_slots_.size())
+    {
+        uniform_slots_.resize(name_id + 1);
+    }
+    return uniform_slots_[name_id];
+}
+
+void Program::UpdateUniformPresence(const std::string& name)
+{
+    // A uniform is found by its name or, for arrays, by the name without the
+    // [0] suffix (see HasUniform).
+    GetUniformSlot(InternUniformName(name)).active =
+        uniform_map_.count(name) || uniform_map_.count(name + "[0]");
+    constexpr std::string_view array_suffix = "[0]";
+    if (name.ends_with(array_suffix))
+    {
+        const std::string base_name =
+            name.substr(0, name.size() - array_suffix.size());
+        GetUniformSlot(InternUniformName(base_name)).active =
+            uniform_map_.count(base_name) || uniform_map_.count(name);
     }
 }
 
 int Program::GetMemoizeUniformLocation(const std::string& name) const
+{
+    return GetMemoizeUniformLocation(InternUniformName(name));
+}
+
+int Program::GetMemoizeUniformLocation(UniformNameId name_id) const
 {
     if (!is_used_)
     {
         throw std::runtime_error(
             "Program is not used, cannot get uniform location.");
     }
-    if (!memoize_map_.count(name))
+    auto& slot = GetUniformSlot(name_id);
+    if (slot.location == -1)
     {
+        const std::string& name = GetUniformName(name_id);
         while (glGetError() != GL_NO_ERROR)
         {
             // Clear the error.
@@ -327,9 +597,9 @@ int Program::GetMemoizeUniformLocation(const std::string& name) const
                     name,
                     error));
         }
-        memoize_map_.insert({name, location});
+        slot.location = location;
     }
-    return memoize_map_.at(name);
+    return slot.location;
 }
 
 void Program::AddInputTextureId(EntityId id)
@@ -416,6 +686,8 @@ void Program::UnUse() const
 void Program::CreateUniformList()
 {
     uniform_map_.clear();
+    uniform_slots_.clear();
+    uploaded_values_.clear();
     GLint count = 0;
     glGetProgramiv(program_id_, GL_ACTIVE_UNIFORMS, &count);
     logger_->info("Uniform [{}] count: {}", name_, count);
@@ -430,6 +702,14 @@ void Program::CreateUniformList()
         glGetActiveUniform(
             program_id_, i, max_size, &length, &size, &type, name);
         std::string name_str = std::string(name, name + length);
+        GLint block_index = -1;
+        glGetActiveUniformsiv(
+            program_id_, 1, &i, GL_UNIFORM_BLOCK_INDEX, &block_index);
+        if (block_index != -1)
+        {
+            // Block members are set through the uniform buffers.
+            continue;
+        }
         logger_->info("Uniform: {}, type {}, size [{}].", name, type, size);
         std::unique_ptr<UniformInterface> uniform_interface = nullptr;
         switch (type)
@@ -517,14 +797,7 @@ std::vector<std::string> Program::GetUniformNameList() const
 
 bool Program::HasUniform(const std::string& name) const
 {
-    std::vector<std::string> uniform_list = GetUniformNameList();
-    if (!std::count(uniform_list.begin(), uniform_list.end(), name))
-    {
-        // To solve the fact that the uniform could end with a `[0]`.
-        return std::count(
-            uniform_list.begin(), uniform_list.end(), name + "[0]");
-    }
-    return true;
+    return HasUniform(InternUniformName(name));
 }
 
 std::string Program::GetTemporarySceneRoot() const
@@ -585,47 +858,56 @@ std::unique_ptr<ProgramInterface> CreateProgram(
     auto& logger = Logger::GetInstance();
     logger->info("Creating program");
 #endif // _DEBUG
-    auto program = std::make_unique<Program>(proto_program.name());
-    program->FromProto(proto::Program(proto_program));
-    Shader vertex(ShaderEnum::VERTEX_SHADER);
-    Shader fragment(ShaderEnum::FRAGMENT_SHADER);
-    if (!vertex.LoadFromSource(vertex_source))
+    ProgramBuild build(proto_program, vertex_source, pixel_source);
+    auto program = build.Finish();
+#ifdef _DEBUG
+    logger->info("with pointer := {}", static_cast<void*>(program.get()));
+#endif // _DEBUG
+    return program;
+}
+
+ProgramBuild::ProgramBuild(
+    const proto::Program& proto_program,
+    const std::string& vertex_source,
+    const std::string& pixel_source)
+    : proto_program_(proto_program),
+      program_(std::make_unique<Program>(proto_program.name()))
+{
+    program_->FromProto(proto::Program(proto_program));
+    vertex_.Compile(vertex_source);
+    fragment_.Compile(pixel_source);
+    program_->AddShader(vertex_);
+    program_->AddShader(fragment_);
+    program_->StartLink();
+}
+
+std::unique_ptr<ProgramInterface> ProgramBuild::Finish()
+{
+    if (!vertex_.CheckCompileStatus())
     {
-        throw std::runtime_error(vertex.GetErrorMessage());
+        throw std::runtime_error(vertex_.GetErrorMessage());
     }
-    if (!fragment.LoadFromSource(pixel_source))
+    if (!fragment_.CheckCompileStatus())
     {
-        throw std::runtime_error(fragment.GetErrorMessage());
+        throw std::runtime_error(fragment_.GetErrorMessage());
     }
-    program->AddShader(vertex);
-    program->AddShader(fragment);
+    program_->FinishLink();
     // Need to add the uniform enum list for serialization.
-    program->LinkShader();
-    // After linking, the program knows about all active uniforms. Preserve the
-    // enum identifiers from the proto so serialization keeps the same names.
-    for (const auto& uniform : proto_program.uniforms())
-    {
-        ProgramInterface* program_iface = program.get();
-        if (uniform.has_uniform_enum() &&
-            program_iface->HasUniform(uniform.name()))
-        {
-            std::unique_ptr<UniformInterface> uniform_interface =
-                std::make_unique<Uniform>(
-                    uniform.name(), uniform.uniform_enum());
-            // Bypass the check because the uniform exists but may not be
-            // currently active due to the INVALID_TYPE placeholder.
-            program->AddUniform(std::move(uniform_interface));
-        }
-    }
-#ifdef _DEBUG
-    logger->info("with pointer := {}", static_cast<void*>(program.get()));
-#endif // _DEBUG
-    return program;
+    AddUniformEnums(*program_, proto_program_);
+    return std::move(program_);
 }
 
-void Program::AddBuffer(EntityId id, const std::string& name, int binding)
+std::unique_ptr<ProgramInterface> CreateProgramFromBinary(
+    const proto::Program& proto_program, const ProgramBinary& binary)
 {
-    buffer_map_[id] = {name, binding};
+    auto program = std::make_unique<Program>(proto_program.name());
+    program->FromProto(proto::Program(proto_program));
+    if (!program->LinkBinary(binary))
+    {
+        return nullptr;
+    }
+    AddUniformEnums(*program, proto_program);
+    return program;
 }
 
 void Program::UploadMatrix4ArrayUniform(
@@ -635,11 +917,13 @@ void Program::UploadMatrix4ArrayUniform(
     {
         return;
     }
-    if (!HasUniform(name) && !HasUniform(name + "[0]"))
+    // Also true for name[0] (see UpdateUniformPresence).
+    if (!HasUniform(name))
     {
         return;
     }
     const int location = GetMemoizeUniformLocation(name);
+    ForgetUploadedValues(location, values.size());
     glUniformMatrix4fv(
         location,
         static_cast<GLsizei>(values.size()),
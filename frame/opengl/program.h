@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "frame/json/proto.h"
@@ -16,6 +19,41 @@
 namespace frame::opengl
 {
 
+class Buffer;
+
+/**
+ * @class UniformUploadCounters
+ * @brief Uniform uploads issued and skipped because the location already
+ *        had the value.
+ */
+struct UniformUploadCounters
+{
+    std::uint32_t issued = 0;
+    std::uint32_t skipped = 0;
+};
+
+/**
+ * @class ProgramBinary
+ * @brief Linked program as returned by glGetProgramBinary, only valid for the
+ *        driver that produced it.
+ */
+struct ProgramBinary
+{
+    std::uint32_t format = 0;
+    std::vector<std::uint8_t> data = {};
+};
+
+/**
+ * @class BufferBinding
+ * @brief Shader storage buffer already resolved from the level and its
+ *        binding point.
+ */
+struct BufferBinding
+{
+    const Buffer* buffer = nullptr;
+    int binding = 0;
+};
+
 /**
  * @class Program
  * @brief This is containing the program and all associated functions.
@@ -88,6 +126,28 @@ class Program : public ProgramInterface
     void AddShader(const Shader& shader);
     //! @brief Link shaders to a program.
     void LinkShader() override;
+    /**
+     * @brief Start the link without waiting for it (LinkShader is StartLink
+     *        then FinishLink), see ProgramBuild.
+     */
+    void StartLink();
+    /**
+     * @brief Wait for the link started by StartLink and list the uniforms,
+     *        throw with the info log if the link failed.
+     */
+    void FinishLink();
+    /**
+     * @brief Link the program from a binary instead of shaders.
+     * @param binary: Binary from GetProgramBinary (a previous run).
+     * @return False if the driver rejected the binary (other driver or
+     *         version), the program should then be linked from source.
+     */
+    bool LinkBinary(const ProgramBinary& binary);
+    /**
+     * @brief Get the binary of the linked program.
+     * @return The binary or nothing if the driver has no binary format.
+     */
+    std::optional<ProgramBinary> GetProgramBinary() const;
     /**
      * @brief Use the program, a little bit like bind.
      * @param uniform_interface: The way to communicate the uniform like
@@ -103,18 +163,76 @@ class Program : public ProgramInterface
     void Use() const override;
     //! @brief Stop using the program, a little bit like unbind.
     void UnUse() const override;
+    /**
+     * @brief Upload the uniforms and bind the storage buffers, the program
+     *        has to be in use (see the renderer state cache).
+     * @param uniform_collection_interface: Uniforms to upload.
+     */
+    void UploadUniforms(
+        const UniformCollectionInterface& uniform_collection_interface);
+    /**
+     * @brief Forget the program is in use without calling OpenGL, used when
+     *        another program was bound over it.
+     */
+    void ReleaseUse() const
+    {
+        is_used_ = false;
+    }
     /**
      * @brief Set the uniform.
      * @param uniform: The uniform to set.
      */
     void AddUniform(std::unique_ptr<UniformInterface>&& uniform) override;
     /**
-     * @brief Add a buffer to the program.
-     * @param id: Id of the buffer.
-     * @param name: Name of the buffer in the shader.
-     * @param binding: Binding point of the buffer.
+     * @brief Set a uniform from a runtime value, it is uploaded right away
+     *        (the program has to be in use) and only converted to a proto if
+     *        the uniform is read back (serialization).
+     * @param uniform_value: The value to set.
+     */
+    void SetUniformValue(const UniformValue& uniform_value);
+    /**
+     * @brief Get the uniform upload counters and reset them.
+     * @return Uploads issued and skipped since the last call.
      */
-    void AddBuffer(EntityId id, const std::string& name, int binding);
+    UniformUploadCounters TakeUniformUploadCounters() const
+    {
+        return std::exchange(upload_counters_, {});
+    }
+    /**
+     * @brief Check if the program has a uniform (array indexing).
+     * @param name_id: Interned name of the uniform (name or name[0]).
+     * @return True if present false otherwise.
+     */
+    bool HasUniform(UniformNameId name_id) const
+    {
+        return name_id < uniform_slots_.size() &&
+               uniform_slots_[name_id].active;
+    }
+    /**
+     * @brief Does the program declare the FrameBlock uniform block (see
+     *        uniform_blocks.h), its members are not loose uniforms.
+     * @return True if the block is bound to kFrameBlockBinding.
+     */
+    bool HasFrameBlock() const
+    {
+        return has_frame_block_;
+    }
+    /**
+     * @brief Does the program declare the ObjectBlock uniform block.
+     * @return True if the block is bound to kObjectBlockBinding.
+     */
+    bool HasObjectBlock() const
+    {
+        return has_object_block_;
+    }
+    /**
+     * @brief Set the storage buffers bound by the next uniform upload.
+     * @param buffers: Buffers of the material (see Renderer).
+     */
+    void SetBuffers(std::span<const BufferBinding> buffers)
+    {
+        buffers_.assign(buffers.begin(), buffers.end());
+    }
     void UploadMatrix4ArrayUniform(
         const std::string& name, const std::vector<glm::mat4>& values) const;
 
@@ -140,6 +258,19 @@ class Program : public ProgramInterface
      *        information.
      */
     void UploadUniform(const UniformInterface& uniform) const;
+    /**
+     * @brief Upload a runtime value to the currently bound program, skipped
+     *        if the location already has the value.
+     * @param uniform_value: Value to upload (INVALID is ignored).
+     */
+    void UploadUniformValue(const UniformValue& uniform_value) const;
+    /**
+     * @brief Forget the uploaded values of locations written without the
+     *        shadow copy (arrays, protos).
+     * @param location: First location.
+     * @param count: Number of locations.
+     */
+    void ForgetUploadedValues(int location, std::size_t count) const;
 
   protected:
     /**
@@ -148,6 +279,12 @@ class Program : public ProgramInterface
      * @return Id of the uniform.
      */
     int GetMemoizeUniformLocation(const std::string& name) const;
+    /**
+     * @brief Get the memoize version of the uniform (stored locally).
+     * @param name_id: Interned name of the uniform.
+     * @return Id of the uniform.
+     */
+    int GetMemoizeUniformLocation(UniformNameId name_id) const;
     /**
      * @brief Throw an exception in case this texture is already in the
      * program.
@@ -160,6 +297,15 @@ class Program : public ProgramInterface
      * Unknown uniform types reported by OpenGL are skipped.
      */
     void CreateUniformList();
+    /**
+     * @brief Bind a uniform block of the program to a binding point.
+     * @param name: Name of the block.
+     * @param binding: Binding point.
+     * @return True if the program declares the block.
+     */
+    bool BindUniformBlock(const char* name, unsigned int binding);
+    //! @brief Bind the uniform blocks and list the uniforms after a link.
+    void OnLinked();
     /**
      * @brief Get the list of uniforms needed by the program.
      * @return Vector of string that represent the names of uniforms.
@@ -183,11 +329,41 @@ class Program : public ProgramInterface
      */
     bool HasUniform(const std::string& name) const override;
 
+  private:
+    // Per uniform state, indexed by interned name id.
+    struct UniformSlot
+    {
+        //! Location in the program (-1 until queried).
+        int location = -1;
+        //! In the uniform map (directly or as name[0]).
+        bool active = false;
+        //! Last value set with SetUniformValue (INVALID if none).
+        UniformValue value = {};
+    };
+    /**
+     * @brief Get the slot of a uniform, the table grows as needed.
+     * @param name_id: Interned name of the uniform.
+     * @return The slot.
+     */
+    UniformSlot& GetUniformSlot(UniformNameId name_id) const;
+    /**
+     * @brief Update the active flag of a name (and of its array alias) from
+     *        the uniform map, called when the map changes.
+     * @param name: Name added to or removed from the map.
+     */
+    void UpdateUniformPresence(const std::string& name);
+
   private:
     const Logger& logger_ = Logger::GetInstance();
-    mutable std::map<std::string, int> memoize_map_ = {};
     mutable std::map<std::string, std::unique_ptr<UniformInterface>>
         uniform_map_ = {};
+    // Locations, presence and runtime values, built at link time so the per
+    // draw lookups are array indexing.
+    mutable std::vector<UniformSlot> uniform_slots_ = {};
+    // Shadow copy of the last value uploaded, indexed by location (uniform
+    // values are program state, they survive Use/UnUse).
+    mutable std::vector<UniformValue> uploaded_values_ = {};
+    mutable UniformUploadCounters upload_counters_ = {};
     std::vector<unsigned int> attached_shaders_ = {};
     std::string temporary_scene_root_;
     std::string name_;
@@ -196,8 +372,10 @@ class Program : public ProgramInterface
     std::vector<EntityId> input_texture_ids_ = {};
     std::vector<EntityId> output_texture_ids_ = {};
     mutable bool is_used_ = false;
-    // Map of id and name, binding point.
-    std::map<EntityId, std::pair<std::string, int>> buffer_map_ = {};
+    bool has_frame_block_ = false;
+    bool has_object_block_ = false;
+    // Storage buffers bound when the uniforms are uploaded.
+    std::vector<BufferBinding> buffers_ = {};
 };
 
 /**
@@ -220,5 +398,49 @@ std::unique_ptr<frame::ProgramInterface> CreateProgram(
     const proto::Program& proto_program,
     std::istream& vertex_shader_code,
     std::istream& pixel_shader_code);
+/**
+ * @class ProgramBuild
+ * @brief Program whose shaders are compiled and linked without waiting, so
+ *        the driver can work on several programs at once (on its own threads
+ *        with GL_KHR_parallel_shader_compile) until Finish is called.
+ */
+class ProgramBuild
+{
+  public:
+    /**
+     * @brief Constructor, start compiling and linking the program.
+     * @param proto_program: Program description.
+     * @param vertex_source: Vertex shader source.
+     * @param pixel_source: Fragment shader source.
+     */
+    ProgramBuild(
+        const proto::Program& proto_program,
+        const std::string& vertex_source,
+        const std::string& pixel_source);
+    ProgramBuild(const ProgramBuild&) = delete;
+    ProgramBuild& operator=(const ProgramBuild&) = delete;
+
+  public:
+    /**
+     * @brief Wait for the program, throw if a shader did not compile.
+     * @return The program (once).
+     */
+    std::unique_ptr<frame::ProgramInterface> Finish();
+
+  private:
+    proto::Program proto_program_;
+    std::unique_ptr<Program> program_;
+    Shader vertex_{ShaderEnum::VERTEX_SHADER};
+    Shader fragment_{ShaderEnum::FRAGMENT_SHADER};
+};
+
+/**
+ * @brief Create a program from a binary (see Program::GetProgramBinary).
+ * @param proto_program: Program description.
+ * @param binary: Binary of the linked program.
+ * @return The program or nullptr if the driver rejected the binary.
+ */
+std::unique_ptr<frame::ProgramInterface> CreateProgramFromBinary(
+    const proto::Program& proto_program, const ProgramBinary& binary);
 
 } // End namespace frame::opengl.
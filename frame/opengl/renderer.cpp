@@ -1,11 +1,14 @@
 #include "renderer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <format>
+#include <map>
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <stdexcept>
 
+#include "frame/frustum.h"
 #include "frame/json/parse_uniform.h"
 #include "frame/json/program_catalog.h"
 #include "frame/node_matrix.h"
@@ -17,6 +20,7 @@
 #include "frame/opengl/mesh.h"
 #include "frame/opengl/skinned_mesh.h"
 #include "frame/opengl/texture.h"
+#include "frame/profiler.h"
 #include "frame/uniform_collection_wrapper.h"
 
 namespace frame::opengl
@@ -25,16 +29,54 @@ namespace frame::opengl
 namespace
 {
 
-bool IsRaytracingProgram(const ProgramInterface& program)
+// Meshes, textures, buffers and programs of an OpenGL level are all OpenGL
+// objects, the type tags select the derived class without RTTI.
+SkinnedMesh* AsSkinnedMesh(MeshInterface& mesh)
 {
-    const auto key = frame::json::ResolveProgramKey(program.GetData());
-    return frame::json::IsRaytracingProgramKey(key);
+    if (mesh.GetMeshType() != MeshTypeEnum::SKINNED_MESH)
+        return nullptr;
+    return static_cast<SkinnedMesh*>(&mesh);
+}
+
+// Names of the uniforms set by the renderer for every draw, interned once.
+struct RendererUniformNames
+{
+    UniformNameId light_dir = InternUniformName("light_dir");
+    UniformNameId light_color = InternUniformName("light_color");
+    UniformNameId env_map_model = InternUniformName("env_map_model");
+    UniformNameId skinning_enabled = InternUniformName("skinning_enabled");
+    UniformNameId instancing_enabled = InternUniformName("instancing_enabled");
+};
+
+const RendererUniformNames& GetRendererUniformNames()
+{
+    static const RendererUniformNames names;
+    return names;
+}
+
+unsigned int GetTextureGLId(TextureInterface& texture)
+{
+    if (texture.GetData().cubemap())
+        return static_cast<Cubemap&>(texture).GetId();
+    return static_cast<Texture&>(texture).GetId();
+}
+
+// Nodes asking for a depth clear after their mesh, the next draws are
+// painted over it.
+bool ClearsDepth(const frame::RenderItem& item)
+{
+    return item.node_mesh && item.node_mesh->GetData().clear_depth_buffer();
 }
 
 } // namespace
 
-Renderer::Renderer(LevelInterface& level, glm::uvec4 viewport)
-    : level_(level), viewport_(viewport)
+Renderer::Renderer(
+    LevelInterface& level,
+    glm::uvec4 viewport,
+    std::pmr::memory_resource* frame_upstream)
+    : level_(level),
+      viewport_(viewport),
+      frame_allocator_(64 * 1024, 2, frame_upstream)
 {
     frame_buffer_ = std::make_unique<FrameBuffer>();
     render_buffer_ = std::make_unique<RenderBuffer>();
@@ -42,6 +84,9 @@ Renderer::Renderer(LevelInterface& level, glm::uvec4 viewport)
     render_buffer_->CreateStorage(
         {viewport_.z - viewport_.x, viewport_.w - viewport_.y});
     frame_buffer_->AttachRender(*render_buffer_);
+    instance_buffer_ = std::make_unique<Buffer>(
+        BufferTypeEnum::ARRAY_BUFFER, BufferUsageEnum::STREAM_DRAW);
+    uniform_blocks_ = std::make_unique<UniformBlocks>();
     proto::Program proto_program;
     proto_program.set_name("display");
     proto_program.set_pipeline_name("display");
@@ -80,6 +125,7 @@ Renderer::Renderer(LevelInterface& level, glm::uvec4 viewport)
 
 void Renderer::UpdateRaytraceBuffersIfNeeded(SkinnedMesh& skinned_mesh)
 {
+    FRAME_PROFILE_SCOPE("Skinning");
     const double skinning_time = skinned_mesh.GetSkinningTime(delta_time_);
 
     if (skinned_mesh.HasRaytraceTriangleCallback())
@@ -91,7 +137,7 @@ void Renderer::UpdateRaytraceBuffersIfNeeded(SkinnedMesh& skinned_mesh)
                 skinned_mesh.EvaluateRaytraceTriangles(skinning_time);
             if (!triangles.empty())
             {
-                auto& triangle_buffer = dynamic_cast<Buffer&>(
+                auto& triangle_buffer = static_cast<Buffer&>(
                     level_.GetBufferFromId(triangle_buffer_id));
                 triangle_buffer.Copy(triangles);
             }
@@ -107,7 +153,7 @@ void Renderer::UpdateRaytraceBuffersIfNeeded(SkinnedMesh& skinned_mesh)
             if (!bvh_nodes.empty())
             {
                 auto& bvh_buffer =
-                    dynamic_cast<Buffer&>(level_.GetBufferFromId(bvh_buffer_id));
+                    static_cast<Buffer&>(level_.GetBufferFromId(bvh_buffer_id));
                 bvh_buffer.Copy(
                     bvh_nodes.size() * sizeof(frame::BVHNode),
                     bvh_nodes.data());
@@ -116,6 +162,81 @@ void Renderer::UpdateRaytraceBuffersIfNeeded(SkinnedMesh& skinned_mesh)
     }
 }
 
+bool Renderer::IsRaytracingProgram(EntityId program_id) const
+{
+    const auto [it, inserted] =
+        raytracing_programs_.try_emplace(program_id, false);
+    if (inserted)
+    {
+        const auto key = frame::json::ResolveProgramKey(
+            level_.GetProgramFromId(program_id).GetData());
+        it->second = frame::json::IsRaytracingProgramKey(key);
+    }
+    return it->second;
+}
+
+std::optional<AABB> Renderer::ComputeWorldBounds(
+    const frame::RenderItem& item) const
+{
+    if (!item.node_mesh || !item.material)
+        return std::nullopt;
+    // Clear nodes have no mesh and must always run.
+    if (!item.mesh)
+        return std::nullopt;
+    const auto& bounding_volume = item.mesh->GetBoundingVolume();
+    if (!bounding_volume.IsValid())
+        return std::nullopt;
+    // Animated skins can move out of their bind pose bounds.
+    if (auto* gl_skinned_mesh = AsSkinnedMesh(*item.mesh);
+        gl_skinned_mesh && gl_skinned_mesh->HasSkinning())
+    {
+        return std::nullopt;
+    }
+    const EntityId program_id = item.material->GetProgramId(&level_);
+    if (!program_id)
+        return std::nullopt;
+    auto& program = level_.GetProgramFromId(program_id);
+    // Raytracing programs draw a screen quad, the mesh is only data.
+    if (IsRaytracingProgram(program_id))
+        return std::nullopt;
+    glm::mat4 model = item.node_mesh->GetLocalModel(delta_time_);
+    if (!program.GetTemporarySceneRoot().empty())
+    {
+        auto temp_id = level_.GetIdFromName(program.GetTemporarySceneRoot());
+        if (temp_id != NullId)
+        {
+            model = level_.GetSceneNodeFromId(temp_id).GetLocalModel(
+                delta_time_);
+        }
+    }
+    return TransformAABB(bounding_volume.aabb, model);
+}
+
+std::optional<EntityId> Renderer::GetInstancingMeshId(
+    const frame::RenderItem& item) const
+{
+    if (!item.node_mesh || !item.mesh || !item.material)
+        return std::nullopt;
+    // Skinned meshes have per node bones and raytrace buffers.
+    if (item.mesh->GetMeshType() == MeshTypeEnum::SKINNED_MESH)
+        return std::nullopt;
+    // Meshes clearing the depth after them are painted one at a time.
+    if (ClearsDepth(item))
+        return std::nullopt;
+    const EntityId program_id = item.material->GetProgramId(&level_);
+    if (!program_id)
+        return std::nullopt;
+    auto& program = level_.GetProgramFromId(program_id);
+    if (!static_cast<const opengl::Program&>(program).HasUniform(
+            GetRendererUniformNames().instancing_enabled) ||
+        !program.GetTemporarySceneRoot().empty() ||
+        IsRaytracingProgram(program_id))
+    {
+        return std::nullopt;
+    }
+    return item.mesh_id;
+}
+
 std::optional<glm::mat4> Renderer::RenderNode(
     EntityId node_id,
     EntityId material_id,
@@ -125,13 +246,42 @@ std::optional<glm::mat4> Renderer::RenderNode(
     // Bail out in case of no node.
     if (node_id == NullId)
         return std::nullopt;
-    // Check current node.
+    // Resolve the pair the same way the level does for its render items.
+    frame::RenderItem item;
+    item.node_id = node_id;
+    item.material_id = material_id;
     auto& node = level_.GetSceneNodeFromId(node_id);
-    // Try to cast to a node Mesh.
-    auto& node_mesh = dynamic_cast<NodeMesh&>(node);
-    auto mesh_id = node.GetLocalMesh();
+    if (node.GetNodeType() != NodeTypeEnum::NODE_MESH)
+    {
+        throw std::runtime_error(
+            std::format("Node #{} is not a mesh node.", node_id));
+    }
+    item.node_mesh = static_cast<NodeMesh*>(&node);
+    item.mesh_id = node.GetLocalMesh();
+    if (item.mesh_id)
+    {
+        item.mesh = &level_.GetMeshFromId(item.mesh_id);
+    }
+    if (material_id != NullId)
+    {
+        item.material = &level_.GetMaterialFromId(material_id);
+    }
+    return RenderItemNode(item, projection, view);
+}
+
+std::optional<glm::mat4> Renderer::RenderItemNode(
+    const frame::RenderItem& item,
+    const glm::mat4& projection,
+    const glm::mat4& view)
+{
+    if (!item.node_mesh)
+    {
+        throw std::runtime_error(
+            std::format("Node #{} is not a mesh node.", item.node_id));
+    }
+    auto& node_mesh = *item.node_mesh;
     // In case no mesh then this is a clear event.
-    if (!mesh_id)
+    if (!item.mesh)
     {
         GLbitfield bit_field = 0;
         std::uint32_t clean_buffer = 0;
@@ -150,17 +300,19 @@ std::optional<glm::mat4> Renderer::RenderNode(
         }
         if (bit_field)
         {
+            // Clear nodes work on the default frame buffer.
+            state_cache_.BindFrameBuffer(nullptr);
             glClear(bit_field);
         }
         return std::nullopt;
     }
-    auto& mesh = level_.GetMeshFromId(mesh_id);
+    auto& mesh = *item.mesh;
     // Try to find the material for the mesh.
-    if (material_id == NullId)
+    if (!item.material)
     {
         throw std::runtime_error("No material?");
     }
-    MaterialInterface& material = level_.GetMaterialFromId(material_id);
+    MaterialInterface& material = *item.material;
     EntityId program_id = material.GetProgramId(&level_);
     if (!program_id)
     {
@@ -176,20 +328,27 @@ std::optional<glm::mat4> Renderer::RenderNode(
         throw std::runtime_error("No program configured for material.");
     }
     auto& program = level_.GetProgramFromId(program_id);
-    glm::mat4 model = node.GetLocalModel(delta_time_);
+    glm::mat4 model = node_mesh.GetLocalModel(delta_time_);
     MeshInterface* mesh_to_render = &mesh;
     const EntityId quad_id = level_.GetDefaultMeshQuadId();
     if (quad_id != NullId &&
-        mesh_id != quad_id &&
-        IsRaytracingProgram(program))
+        node_mesh.GetLocalMesh() != quad_id &&
+        IsRaytracingProgram(program_id))
     {
-        if (auto* gl_skinned_mesh = dynamic_cast<SkinnedMesh*>(&mesh))
+        if (auto* gl_skinned_mesh = AsSkinnedMesh(mesh))
         {
             UpdateRaytraceBuffersIfNeeded(*gl_skinned_mesh);
         }
         mesh_to_render = &level_.GetMeshFromId(quad_id);
     }
-    RenderMesh(*mesh_to_render, material, projection, view, model);
+    DrawMesh(
+        *mesh_to_render,
+        material,
+        projection,
+        view,
+        model,
+        {},
+        ClearsDepth(item));
     return model;
 }
 
@@ -199,6 +358,31 @@ void Renderer::RenderMesh(
     const glm::mat4& projection,
     const glm::mat4& view,
     const glm::mat4& model /* = glm::mat4(1.0f)*/)
+{
+    DrawMesh(mesh, material, projection, view, model, {}, false);
+}
+
+void Renderer::RenderMeshInstanced(
+    MeshInterface& mesh,
+    MaterialInterface& material,
+    const glm::mat4& projection,
+    const glm::mat4& view,
+    std::span<const glm::mat4> models)
+{
+    if (models.empty())
+        return;
+    DrawMesh(
+        mesh, material, projection, view, models.front(), models, false);
+}
+
+void Renderer::DrawMesh(
+    MeshInterface& mesh,
+    MaterialInterface& material,
+    const glm::mat4& projection,
+    const glm::mat4& view,
+    const glm::mat4& model,
+    std::span<const glm::mat4> instance_models,
+    bool clear_depth)
 {
     auto program_id = material.GetProgramId();
     auto& program = level_.GetProgramFromId(program_id);
@@ -214,28 +398,34 @@ void Renderer::RenderMesh(
     }
 
     // In case the camera doesn't exist it will create a basic one.
-    UniformCollectionWrapper uniform_collection_wrapper(
+    const auto& uniform_names = GetRendererUniformNames();
+    // Reused between draws, reset keeps the storage.
+    auto& uniform_collection_wrapper = uniform_collection_wrapper_;
+    uniform_collection_wrapper.Reset(
         projection, view, model_matrix, delta_time_);
     if (level_.GetLights().size() > 0)
     {
         auto& light = level_.GetLightFromId(level_.GetLights()[0]);
-        uniform_collection_wrapper.AddUniform(
-            std::make_unique<Uniform>("light_dir", light.GetVector()));
-        uniform_collection_wrapper.AddUniform(
-            std::make_unique<Uniform>(
-                "light_color", light.GetColorIntensity()));
+        uniform_collection_wrapper.AddUniformValue(
+            {uniform_names.light_dir, light.GetVector()});
+        uniform_collection_wrapper.AddUniformValue(
+            {uniform_names.light_color, light.GetColorIntensity()});
     }
     if (render_time_ == proto::NodeMesh::SCENE_RENDER_TIME)
     {
-        std::unique_ptr<UniformInterface> env_map_uniform =
-            std::make_unique<Uniform>("env_map_model", env_map_model_);
-        uniform_collection_wrapper.AddUniform(std::move(env_map_uniform));
+        uniform_collection_wrapper.AddUniformValue(
+            {uniform_names.env_map_model, env_map_model_});
+    }
+    // Go through the callback, it may have used a program.
+    if (has_callback_)
+    {
+        callback_(uniform_collection_wrapper, mesh, material);
+        state_cache_.InvalidateProgram();
     }
-    // Go through the callback.
-    callback_(uniform_collection_wrapper, mesh, material);
 
-    // Add node-based model matrices.
-    for (const auto& name : material.GetNodeNames())
+    // Add node-based model matrices (inner names interned by the material).
+    const auto& gl_material = static_cast<const Material&>(material);
+    for (const auto& [name, inner_name_id] : gl_material.GetNodeNameIds())
     {
         auto node_id = level_.GetIdFromName(name);
         if (node_id == NullId)
@@ -244,35 +434,52 @@ void Renderer::RenderMesh(
         }
         auto& node = level_.GetSceneNodeFromId(node_id);
         glm::mat4 node_model = node.GetLocalModel(delta_time_);
-        auto inner_name = material.GetInnerNodeName(name);
-        std::unique_ptr<UniformInterface> node_uniform =
-            std::make_unique<Uniform>(inner_name, node_model);
-        uniform_collection_wrapper.AddUniform(std::move(node_uniform));
+        uniform_collection_wrapper.AddUniformValue(
+            {inner_name_id, node_model});
     }
 
     // Register shader storage buffers before using the program so they are
-    // bound when Program::Use uploads them.
-    int j = 0;
-    for (const auto& name : material.GetBufferNames())
-    {
-        auto id = level_.GetIdFromName(name);
-        if (id == NullId)
-        {
-            throw std::runtime_error("Could not find buffer: " + name);
-        }
-        auto inner_name = material.GetInnerBufferName(name);
-        dynamic_cast<opengl::Program&>(program).AddBuffer(id, inner_name, j++);
-    }
+    // bound when the uniforms are uploaded.
+    static_cast<opengl::Program&>(program).SetBuffers(
+        GetMaterialBuffers(material));
 
-    auto& gl_mesh = dynamic_cast<Mesh&>(mesh);
-    auto* gl_skinned_mesh = dynamic_cast<SkinnedMesh*>(&gl_mesh);
+    auto& gl_mesh = static_cast<Mesh&>(mesh);
+    auto* gl_skinned_mesh = AsSkinnedMesh(mesh);
     if (gl_skinned_mesh)
     {
         UpdateRaytraceBuffersIfNeeded(*gl_skinned_mesh);
     }
-    program.Use(uniform_collection_wrapper, &level_);
+    // Outside of a pass (direct call to render mesh) the default state is
+    // restored after the draw.
+    const bool standalone = !in_pass_;
+    if (standalone)
+    {
+        BeginPass();
+    }
+    auto& gl_program = static_cast<opengl::Program&>(program);
+    state_cache_.UseProgram(gl_program);
+    gl_program.UploadUniforms(uniform_collection_wrapper);
+    // The frame block is filled by the first draw of the pass, the pass
+    // only changes it when it renders with an other camera (cubemap faces
+    // of the pre-render or draws outside of a pass).
+    if (gl_program.HasFrameBlock() &&
+        (!frame_block_filled_ || frame_block_.projection != projection ||
+         frame_block_.view != view))
+    {
+        frame_block_ = {};
+        FillFrameBlock(
+            uniform_collection_wrapper.GetUniformValues(), frame_block_);
+        uniform_blocks_->SetFrame(frame_block_);
+        frame_block_filled_ = true;
+    }
+    if (gl_program.HasObjectBlock())
+    {
+        ObjectBlock object_block;
+        FillObjectBlock(
+            uniform_collection_wrapper.GetUniformValues(), object_block);
+        uniform_blocks_->SetObject(object_block);
+    }
     int skinning_enabled = 0;
-    auto& gl_program = dynamic_cast<opengl::Program&>(program);
     if (gl_skinned_mesh && gl_skinned_mesh->HasSkinning())
     {
         const double skinning_time =
@@ -290,56 +497,36 @@ void Renderer::RenderMesh(
             skinning_enabled = 1;
         }
     }
-    if (program.HasUniform("skinning_enabled"))
+    if (gl_program.HasUniform(uniform_names.skinning_enabled))
     {
-        program.AddUniform(
-            std::make_unique<Uniform>("skinning_enabled", skinning_enabled));
+        gl_program.SetUniformValue(
+            {uniform_names.skinning_enabled, skinning_enabled});
     }
-
-    auto texture_out_ids = program.GetOutputTextureIds();
-    glViewport(viewport_.x, viewport_.y, viewport_.z, viewport_.w);
-    std::unique_ptr<ScopedBind> scoped_frame;
-    if (!texture_out_ids.empty())
+    const bool instanced = !instance_models.empty();
+    if (gl_program.HasUniform(uniform_names.instancing_enabled))
     {
-        scoped_frame = std::make_unique<ScopedBind>(*frame_buffer_);
-        int i = 0;
-        for (const auto& texture_id : texture_out_ids)
-        {
-            if (level_.GetTextureFromId(texture_id).GetData().cubemap())
-            {
-                auto& opengl_texture =
-                    dynamic_cast<Cubemap&>(level_.GetTextureFromId(texture_id));
-                // TODO(anirul): Check the mipmap level (last parameter)!
-                frame_buffer_->AttachTexture(
-                    opengl_texture.GetId(),
-                    FrameBuffer::GetFrameColorAttachment(i),
-                    FrameBuffer::GetFrameTextureType(texture_frame_),
-                    0);
-            }
-            else
-            {
-                auto& opengl_texture =
-                    dynamic_cast<Texture&>(level_.GetTextureFromId(texture_id));
-                // TODO(anirul): Check the mipmap level (last parameter)!
-                frame_buffer_->AttachTexture(
-                    opengl_texture.GetId(),
-                    FrameBuffer::GetFrameColorAttachment(i),
-                    FrameTextureType::TEXTURE_2D,
-                    0);
-            }
-            i++;
-        }
-        frame_buffer_->DrawBuffers(
-            static_cast<std::uint32_t>(texture_out_ids.size()));
+        gl_program.SetUniformValue(
+            {uniform_names.instancing_enabled, instanced ? 1 : 0});
     }
-    else
+
+    state_cache_.Viewport(viewport_);
+    state_cache_.BindFrameBuffer(frame_buffer_.get());
+    frame_attachments_.clear();
+    int attachment_index = 0;
+    for (const auto& texture_id : program.GetOutputTextureIds())
     {
-        scoped_frame = std::make_unique<ScopedBind>(*frame_buffer_);
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
+        auto& texture = level_.GetTextureFromId(texture_id);
+        frame_attachments_.push_back(
+            {GetTextureGLId(texture),
+             FrameBuffer::GetFrameColorAttachment(attachment_index),
+             texture.GetData().cubemap()
+                 ? FrameBuffer::GetFrameTextureType(texture_frame_)
+                 : FrameTextureType::TEXTURE_2D});
+        attachment_index++;
     }
+    state_cache_.AttachTextures(*frame_buffer_, frame_attachments_);
 
-    std::map<std::string, std::vector<std::int32_t>> uniform_include;
+    std::uint32_t used_units = 0;
     for (const auto& id : material.GetTextureIds())
     {
         EntityId texture_id = NullId;
@@ -354,58 +541,59 @@ void Renderer::RenderMesh(
             texture_id = id + 1;
         }
         // TODO(anirul): Why? id and not texture id?
-        const auto p = material.EnableTextureId(id);
+        const int slot = gl_material.EnableTextureSlot(id);
         auto& texture = level_.GetTextureFromId(texture_id);
-        if (texture.GetData().cubemap())
-        {
-            auto& gl_texture =
-                dynamic_cast<Cubemap&>(level_.GetTextureFromId(texture_id));
-            gl_texture.Bind(p.second);
-        }
-        else
+        const auto unit = static_cast<unsigned int>(slot);
+        state_cache_.BindTexture(
+            unit,
+            texture.GetData().cubemap() ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D,
+            GetTextureGLId(texture));
+        used_units |= 1u << unit;
+        gl_program.SetUniformValue({gl_material.GetInnerNameId(id), slot});
+    }
+    // Textures left by the previous draws could be one of the outputs.
+    state_cache_.ReleaseTextureUnits(used_units);
+
+    state_cache_.BindVertexArray(gl_mesh.GetId());
+    if (instanced)
+    {
+        // Per instance model matrix, one vec4 column per attribute.
+        instance_buffer_->Copy(
+            instance_models.size_bytes(), instance_models.data());
+        instance_buffer_->Bind();
+        for (unsigned int i = 0; i < 4; ++i)
         {
-            auto& gl_texture =
-                dynamic_cast<Texture&>(level_.GetTextureFromId(texture_id));
-            gl_texture.Bind(p.second);
+            const unsigned int location = kInstanceModelLocation + i;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(
+                location,
+                4,
+                GL_FLOAT,
+                GL_FALSE,
+                sizeof(glm::mat4),
+                reinterpret_cast<const void*>(i * sizeof(glm::vec4)));
+            glVertexAttribDivisor(location, 1);
         }
-        std::unique_ptr<UniformInterface> uniform_interface =
-            std::make_unique<Uniform>(p.first, p.second);
-        program.AddUniform(std::move(uniform_interface));
+        instance_buffer_->UnBind();
     }
 
-    glBindVertexArray(gl_mesh.GetId());
-
     auto& index_buffer = level_.GetBufferFromId(mesh.GetIndexBufferId());
-    auto& gl_index_buffer = dynamic_cast<Buffer&>(index_buffer);
+    auto& gl_index_buffer = static_cast<Buffer&>(index_buffer);
     // This was crashing the driver so...
     if (mesh.GetIndexSize())
     {
-        gl_index_buffer.Bind();
+        state_cache_.BindIndexBuffer(gl_index_buffer);
+        GLenum primitive = GL_TRIANGLES;
         switch (mesh.GetData().render_primitive_enum())
         {
         case proto::NodeMesh::TRIANGLE_PRIMITIVE:
-            glDrawElements(
-                GL_TRIANGLES,
-                static_cast<GLsizei>(mesh.GetIndexSize()) /
-                    sizeof(std::uint32_t),
-                GL_UNSIGNED_INT,
-                nullptr);
+            primitive = GL_TRIANGLES;
             break;
         case proto::NodeMesh::POINT_PRIMITIVE:
-            glDrawElements(
-                GL_POINTS,
-                static_cast<GLsizei>(mesh.GetIndexSize()) /
-                    sizeof(std::uint32_t),
-                GL_UNSIGNED_INT,
-                nullptr);
+            primitive = GL_POINTS;
             break;
         case proto::NodeMesh::LINE_PRIMITIVE:
-            glDrawElements(
-                GL_LINES,
-                static_cast<GLsizei>(mesh.GetIndexSize()) /
-                    sizeof(std::uint32_t),
-                GL_UNSIGNED_INT,
-                nullptr);
+            primitive = GL_LINES;
             break;
         default:
             throw std::runtime_error(
@@ -414,42 +602,49 @@ void Renderer::RenderMesh(
                     proto::NodeMesh_RenderPrimitiveEnum_Name(
                         mesh.GetData().render_primitive_enum())));
         }
-        gl_index_buffer.UnBind();
-    }
-    program.UnUse();
-    glBindVertexArray(0);
-
-    for (const auto id : material.GetTextureIds())
-    {
-        EntityId texture_id = id;
-        if (level_.GetEnumTypeFromId(id) != EntityTypeEnum::TEXTURE)
+        const GLsizei index_count = static_cast<GLsizei>(
+            mesh.GetIndexSize() / sizeof(std::uint32_t));
+        if (instanced)
         {
-            texture_id = id + 1;
+            glDrawElementsInstanced(
+                primitive,
+                index_count,
+                GL_UNSIGNED_INT,
+                nullptr,
+                static_cast<GLsizei>(instance_models.size()));
         }
-        auto& texture = level_.GetTextureFromId(texture_id);
-        if (texture.GetData().cubemap())
+        else
         {
-            auto& gl_texture =
-                dynamic_cast<Cubemap&>(level_.GetTextureFromId(texture_id));
-            gl_texture.UnBind();
+            glDrawElements(primitive, index_count, GL_UNSIGNED_INT, nullptr);
         }
-        else
+        state_cache_.CountDraw();
+        render_depth_dirty_ = true;
+    }
+    state_cache_.CountUniformUploads(gl_program.TakeUniformUploadCounters());
+    if (instanced)
+    {
+        for (unsigned int i = 0; i < 4; ++i)
         {
-            auto& gl_texture =
-                dynamic_cast<Texture&>(level_.GetTextureFromId(texture_id));
-            gl_texture.UnBind();
+            glVertexAttribDivisor(kInstanceModelLocation + i, 0);
+            glDisableVertexAttribArray(kInstanceModelLocation + i);
         }
     }
     material.DisableAll();
 
-    if (mesh.IsClearBuffer())
+    // The next draws are painted over this one.
+    if (clear_depth)
+    {
+        ClearRenderDepth();
+    }
+    if (standalone)
     {
-        glClear(GL_DEPTH_BUFFER_BIT);
+        EndPass();
     }
 }
 
 void Renderer::PresentFinal()
 {
+    FRAME_PROFILE_SCOPE("Present final");
     auto maybe_quad_id = level_.GetDefaultMeshQuadId();
     if (maybe_quad_id == NullId)
         throw std::runtime_error("No quad id.");
@@ -457,21 +652,21 @@ void Renderer::PresentFinal()
     auto& program = level_.GetProgramFromId(display_program_id_);
     UniformCollectionWrapper uniform_collection_wrapper{};
     program.Use(uniform_collection_wrapper, &level_);
-    auto& material = level_.GetMaterialFromId(display_material_id_);
+    auto& material = static_cast<Material&>(
+        level_.GetMaterialFromId(display_material_id_));
     for (const auto id : material.GetTextureIds())
     {
         auto& opengl_texture =
-            dynamic_cast<Texture&>(level_.GetTextureFromId(id));
-        const auto p = material.EnableTextureId(id);
-        opengl_texture.Bind(p.second);
-        std::unique_ptr<UniformInterface> uniform_interface =
-            std::make_unique<Uniform>(p.first, p.second);
-        program.AddUniform(std::move(uniform_interface));
-    }
-    auto& gl_quad = dynamic_cast<Mesh&>(quad);
+            static_cast<Texture&>(level_.GetTextureFromId(id));
+        const int slot = material.EnableTextureSlot(id);
+        opengl_texture.Bind(slot);
+        static_cast<Program&>(program).SetUniformValue(
+            {material.GetInnerNameId(id), slot});
+    }
+    auto& gl_quad = static_cast<Mesh&>(quad);
     glBindVertexArray(gl_quad.GetId());
     auto& index_buffer = level_.GetBufferFromId(quad.GetIndexBufferId());
-    auto& gl_index_buffer = dynamic_cast<Buffer&>(index_buffer);
+    auto& gl_index_buffer = static_cast<Buffer&>(index_buffer);
 
     gl_index_buffer.Bind();
     glDrawElements(
@@ -487,7 +682,7 @@ void Renderer::PresentFinal()
     for (const auto id : material.GetTextureIds())
     {
         auto& opengl_texture =
-            dynamic_cast<Texture&>(level_.GetTextureFromId(id));
+            static_cast<Texture&>(level_.GetTextureFromId(id));
         opengl_texture.UnBind();
     }
     material.DisableAll();
@@ -495,6 +690,7 @@ void Renderer::PresentFinal()
 
 void Renderer::SetDepthTest(bool enable)
 {
+    depth_test_ = enable;
     if (enable)
     {
         glEnable(GL_DEPTH_TEST);
@@ -507,26 +703,26 @@ void Renderer::SetDepthTest(bool enable)
 
 void Renderer::PreRender()
 {
+    FRAME_PROFILE_SCOPE("Pre-render");
     render_time_ = proto::NodeMesh::PRE_RENDER_TIME;
+    // Pre render is the first pass of a frame.
+    state_cache_.ResetCounters();
+    BeginPass();
     // This will ensure that it is only true once.
     auto first_render = std::exchange(first_render_, false);
-    for (const auto& p : level_.GetMeshMaterialIds(
-             proto::NodeMesh::PRE_RENDER_TIME))
+    for (const auto& item :
+         level_.GetRenderItems(proto::NodeMesh::PRE_RENDER_TIME))
     {
-        auto& node = level_.GetSceneNodeFromId(p.first);
-        if (node.GetLocalMesh())
+        if (item.mesh)
         {
-            auto& mesh = level_.GetMeshFromId(node.GetLocalMesh());
-            auto* gl_skinned_mesh =
-                dynamic_cast<SkinnedMesh*>(&mesh);
-            if (gl_skinned_mesh)
+            if (auto* gl_skinned_mesh = AsSkinnedMesh(*item.mesh))
             {
                 UpdateRaytraceBuffersIfNeeded(*gl_skinned_mesh);
             }
         }
         if (first_render)
         {
-            auto material_id = p.second;
+            auto material_id = item.material_id;
             auto temp_viewport = viewport_;
             // Query textures from the material.
             auto& material = level_.GetMaterialFromId(material_id);
@@ -543,9 +739,8 @@ void Renderer::PreRender()
                     {
                         texture_frame_.set_value(proto::TextureFrame::TEXTURE_2D);
                         material.SetProgramId(preprocess_id);
-                        RenderNode(
-                            p.first,
-                            material_id,
+                        RenderItemNode(
+                            item,
                             kProjectionCubemap,
                             kViewsCubemap[0]);
                         material.SetProgramId(saved_program);
@@ -556,9 +751,8 @@ void Renderer::PreRender()
                     auto size = json::ParseSize(tex.GetData().size());
                     viewport_ = glm::ivec4(0, 0, size.x, size.y);
                     material.SetProgramId(preprocess_id);
-                    RenderNode(
-                        p.first,
-                        material_id,
+                    RenderItemNode(
+                        item,
                         kProjectionCubemap,
                         kViewsCubemap[0]);
                     material.SetProgramId(saved_program);
@@ -571,8 +765,7 @@ void Renderer::PreRender()
             {
                 // Mesh has no target texture: just render once to populate
                 // buffers without touching the framebuffer.
-                RenderNode(
-                    p.first, material_id, kProjectionCubemap, kViewsCubemap[0]);
+                RenderItemNode(item, kProjectionCubemap, kViewsCubemap[0]);
                 continue;
             }
             auto& texture = level_.GetTextureFromId(ids[0]);
@@ -587,9 +780,8 @@ void Renderer::PreRender()
                         static_cast<proto::TextureFrame::Enum>(
                             proto::TextureFrame::CUBE_MAP_POSITIVE_X + i));
                     SetCubeMapTarget(texture_frame);
-                    RenderNode(
-                        p.first,
-                        material_id,
+                    RenderItemNode(
+                        item,
                         kProjectionCubemap,
                         kViewsCubemap[i]);
                 }
@@ -598,55 +790,297 @@ void Renderer::PreRender()
             {
                 // Regular 2D texture target.
                 texture_frame_.set_value(proto::TextureFrame::TEXTURE_2D);
-                RenderNode(
-                    p.first, material_id, kProjectionCubemap, kViewsCubemap[0]);
+                RenderItemNode(item, kProjectionCubemap, kViewsCubemap[0]);
             }
             viewport_ = temp_viewport;
         }
     }
+    EndPass();
 }
 
 void Renderer::RenderSkybox(const CameraInterface& camera)
 {
+    FRAME_PROFILE_SCOPE("Render skybox");
     render_time_ = proto::NodeMesh::SKYBOX_RENDER_TIME;
-    for (const auto& p : level_.GetMeshMaterialIds(
-             proto::NodeMesh::SKYBOX_RENDER_TIME))
-    {
-        auto maybe_model = RenderNode(
-            p.first,
-            p.second,
-            camera.ComputeProjection(),
-            camera.ComputeView());
+    BeginPass();
+    for (const auto& item :
+         level_.GetRenderItems(proto::NodeMesh::SKYBOX_RENDER_TIME))
+    {
+        auto maybe_model = RenderItemNode(
+            item, camera.ComputeProjection(), camera.ComputeView());
         if (maybe_model)
         {
             env_map_model_ = *maybe_model;
         }
     }
+    EndPass();
 }
 
 void Renderer::RenderScene(const CameraInterface& camera)
 {
+    FRAME_PROFILE_SCOPE("Render scene");
     render_time_ = proto::NodeMesh::SCENE_RENDER_TIME;
-    for (const auto& p : level_.GetMeshMaterialIds(
-             proto::NodeMesh::SCENE_RENDER_TIME))
+    const glm::mat4 projection = camera.ComputeProjection();
+    const glm::mat4 view = camera.ComputeView();
+    const auto& render_items =
+        level_.GetRenderItems(proto::NodeMesh::SCENE_RENDER_TIME);
+    // Gather the boxes of the pairs that can be culled and test them in a
+    // single batch.
+    cull_indices_.clear();
+    cull_bounds_.clear();
+    for (std::size_t i = 0; i < render_items.size(); ++i)
+    {
+        auto maybe_bounds = ComputeWorldBounds(render_items[i]);
+        if (maybe_bounds)
+        {
+            cull_indices_.push_back(i);
+            cull_bounds_.push_back(*maybe_bounds);
+        }
+    }
+    const Frustum frustum(projection * view);
+    frustum.CullAABBs(cull_bounds_, cull_visible_);
+    culling_stats_ = {};
+    // Visible pairs sharing a mesh and a material are gathered in a single
+    // group (drawn instanced at the position of the first one).
+    instance_groups_.clear();
+    // Nothing of the previous pass is alive, the arena can be reused.
+    frame_allocator_.BeginFrame();
+    std::pmr::map<std::pair<EntityId, EntityId>, std::size_t> group_indices(
+        &frame_allocator_);
+    std::size_t cull_index = 0;
+    for (std::size_t i = 0; i < render_items.size(); ++i)
+    {
+        if (cull_index < cull_indices_.size() && cull_indices_[cull_index] == i)
+        {
+            if (!cull_visible_[cull_index++])
+            {
+                ++culling_stats_.culled;
+                // Outside of the frustum the draw writes nothing, the depth
+                // clear that follows it still has to happen.
+                if (ClearsDepth(render_items[i]))
+                {
+                    instance_groups_.push_back(
+                        {&render_items[i],
+                         NullId,
+                         std::pmr::vector<glm::mat4>(&frame_allocator_),
+                         true});
+                }
+                continue;
+            }
+        }
+        ++culling_stats_.drawn;
+        const auto& item = render_items[i];
+        const auto maybe_mesh_id = GetInstancingMeshId(item);
+        if (!maybe_mesh_id)
+        {
+            instance_groups_.push_back(
+                {&item,
+                 NullId,
+                 std::pmr::vector<glm::mat4>(&frame_allocator_)});
+            continue;
+        }
+        const auto [it, inserted] = group_indices.try_emplace(
+            std::make_pair(*maybe_mesh_id, item.material_id),
+            instance_groups_.size());
+        if (inserted)
+        {
+            instance_groups_.push_back(
+                {&item,
+                 *maybe_mesh_id,
+                 std::pmr::vector<glm::mat4>(&frame_allocator_)});
+        }
+        instance_groups_[it->second].models.push_back(
+            item.node_mesh->GetLocalModel(delta_time_));
+    }
+    BuildRenderQueue(view);
+    BeginPass();
+    for (const auto& item : render_queue_.GetItems())
+    {
+        const auto& group = instance_groups_[item.index];
+        if (group.clear_depth_only)
+        {
+            ClearRenderDepth();
+            continue;
+        }
+        if (group.models.size() > 1)
+        {
+            RenderMeshInstanced(
+                *group.item->mesh,
+                *group.item->material,
+                projection,
+                view,
+                group.models);
+            continue;
+        }
+        RenderItemNode(*group.item, projection, view);
+    }
+    EndPass();
+}
+
+void Renderer::BuildRenderQueue(const glm::mat4& view)
+{
+    render_queue_.Clear();
+    queue_inputs_.clear();
+    queue_outputs_.clear();
+    // Without depth test the draws are painted in order.
+    const auto sort_run = [this](std::size_t begin, std::size_t end) {
+        if (depth_test_)
+        {
+            render_queue_.Sort(begin, end);
+        }
+    };
+    const auto contains = [](const std::vector<EntityId>& ids, EntityId id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    };
+    std::size_t run_begin = 0;
+    for (std::size_t i = 0; i < instance_groups_.size(); ++i)
     {
-        RenderNode(
-            p.first,
-            p.second,
-            camera.ComputeProjection(),
-            camera.ComputeView());
+        const auto& group = instance_groups_[i];
+        const auto index = static_cast<std::uint32_t>(i);
+        const auto& item = *group.item;
+        // Clear nodes and depth clears of culled meshes stay between the
+        // draws around them.
+        if (!item.mesh || group.clear_depth_only)
+        {
+            sort_run(run_begin, i);
+            render_queue_.Push(0, index);
+            run_begin = i + 1;
+            queue_inputs_.clear();
+            queue_outputs_.clear();
+            continue;
+        }
+        if (!item.material)
+        {
+            throw std::runtime_error("No material?");
+        }
+        auto& material = *item.material;
+        const EntityId program_id = material.GetProgramId(&level_);
+        const auto input_ids = material.GetTextureIds();
+        std::vector<EntityId> output_ids;
+        if (program_id)
+        {
+            output_ids =
+                level_.GetProgramFromId(program_id).GetOutputTextureIds();
+        }
+        // A draw reading a texture written in the current run (or writing
+        // one that was read) starts a new run.
+        const bool depends =
+            std::any_of(
+                input_ids.begin(),
+                input_ids.end(),
+                [&](EntityId id) { return contains(queue_outputs_, id); }) ||
+            std::any_of(
+                output_ids.begin(),
+                output_ids.end(),
+                [&](EntityId id) { return contains(queue_inputs_, id); });
+        if (depends)
+        {
+            sort_run(run_begin, i);
+            run_begin = i;
+            queue_inputs_.clear();
+            queue_outputs_.clear();
+        }
+        queue_inputs_.insert(
+            queue_inputs_.end(), input_ids.begin(), input_ids.end());
+        queue_outputs_.insert(
+            queue_outputs_.end(), output_ids.begin(), output_ids.end());
+        const EntityId target_id =
+            output_ids.empty() ? NullId : output_ids.front();
+        const glm::mat4 model =
+            group.models.empty() ? item.node_mesh->GetLocalModel(delta_time_)
+                                 : group.models.front();
+        const float depth = -(view * model[3]).z;
+        // A mesh clearing the depth after it is drawn over the draws before
+        // it and under the ones after, it keeps its place.
+        const bool clears_depth = ClearsDepth(item);
+        if (clears_depth)
+        {
+            sort_run(run_begin, i);
+        }
+        render_queue_.Push(
+            MakeDrawKey(
+                static_cast<std::uint64_t>(target_id),
+                static_cast<std::uint64_t>(program_id),
+                static_cast<std::uint64_t>(item.material_id),
+                static_cast<std::uint64_t>(item.mesh_id),
+                depth),
+            index);
+        if (clears_depth)
+        {
+            run_begin = i + 1;
+            queue_inputs_.clear();
+            queue_outputs_.clear();
+        }
+    }
+    sort_run(run_begin, instance_groups_.size());
+}
+
+void Renderer::BeginPass()
+{
+    state_cache_.Invalidate();
+    uniform_blocks_->Invalidate();
+    frame_block_filled_ = false;
+    in_pass_ = true;
+}
+
+void Renderer::EndPass()
+{
+    in_pass_ = false;
+    state_cache_.Reset();
+}
+
+void Renderer::ClearRenderDepth()
+{
+    if (!std::exchange(render_depth_dirty_, false))
+    {
+        return;
+    }
+    state_cache_.BindFrameBuffer(frame_buffer_.get());
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+const std::vector<BufferBinding>& Renderer::GetMaterialBuffers(
+    const MaterialInterface& material)
+{
+    if (material_buffers_revision_ != level_.GetRevision())
+    {
+        material_buffers_.clear();
+        material_buffers_revision_ = level_.GetRevision();
+    }
+    auto it = material_buffers_.find(&material);
+    if (it != material_buffers_.end())
+    {
+        return it->second;
+    }
+    std::vector<BufferBinding> buffers;
+    int binding = 0;
+    for (const auto& name : material.GetBufferNames())
+    {
+        auto id = level_.GetIdFromName(name);
+        if (id == NullId)
+        {
+            throw std::runtime_error("Could not find buffer: " + name);
+        }
+        buffers.push_back(
+            {&static_cast<const Buffer&>(level_.GetBufferFromId(id)),
+             binding++});
     }
+    return material_buffers_.emplace(&material, std::move(buffers))
+        .first->second;
 }
 
 void Renderer::PostProcess()
 {
+    FRAME_PROFILE_SCOPE("Post-process");
     render_time_ = proto::NodeMesh::POST_PROCESS_TIME;
-    for (const auto& p : level_.GetMeshMaterialIds(
-             proto::NodeMesh::POST_PROCESS_TIME))
+    BeginPass();
+    for (const auto& item :
+         level_.GetRenderItems(proto::NodeMesh::POST_PROCESS_TIME))
     {
         // Is it correct for projection and view? This is a post process?
-        RenderNode(p.first, p.second, glm::mat4(1.0), glm::mat4(1.0));
+        RenderItemNode(item, glm::mat4(1.0), glm::mat4(1.0));
     }
+    EndPass();
 }
 
 } // End namespace frame::opengl.
@@ -1,11 +1,24 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
+#include "frame/frame_allocator.h"
+#include "frame/opengl/buffer.h"
 #include "frame/opengl/frame_buffer.h"
+#include "frame/opengl/program.h"
 #include "frame/opengl/render_buffer.h"
+#include "frame/opengl/state_cache.h"
+#include "frame/opengl/uniform_blocks.h"
 #include "frame/program_interface.h"
+#include "frame/render_queue.h"
 #include "frame/renderer_interface.h"
+#include "frame/uniform_collection_wrapper.h"
 #include "frame/mesh_interface.h"
 #include "frame/uniform_interface.h"
 #include "frame/window_interface.h"
@@ -15,6 +28,12 @@ namespace frame::opengl
 
 class SkinnedMesh;
 
+/**
+ * @brief First vertex attribute location of the per instance model matrix
+ * (a mat4 uses this location and the three following ones).
+ */
+constexpr unsigned int kInstanceModelLocation = 8;
+
 /**
  * @class Renderer
  * @brief This is the renderer class this is the class that is doing the
@@ -29,8 +48,14 @@ class Renderer : public RendererInterface
      * @brief Constructor
      * @param level: The level to render.
      * @param viewport: The viewport.
+     * @param frame_upstream: Upstream of the frame allocator (arenas and the
+     *        overflow of a frame that did not fit).
      */
-    Renderer(LevelInterface& level, glm::uvec4 viewport);
+    Renderer(
+        LevelInterface& level,
+        glm::uvec4 viewport,
+        std::pmr::memory_resource* frame_upstream =
+            std::pmr::new_delete_resource());
 
   public:
     /**
@@ -59,12 +84,31 @@ class Renderer : public RendererInterface
         viewport_ = viewport;
     }
     /**
-     * @brief Add a mesh render callback.
+     * @brief Add a mesh render callback, the program in use is forgotten by
+     *        the state cache after each call (the callback may use another
+     *        one), other bindings have to be restored by the callback.
      * @param callback: The callback to be added to the render.
      */
     void SetMeshRenderCallback(RenderCallback callback) override
     {
         callback_ = callback;
+        has_callback_ = static_cast<bool>(callback_);
+    }
+    /**
+     * @brief Get the frustum culling statistics of the last scene pass.
+     * @return Count of drawn and culled node/material pairs.
+     */
+    CullingStats GetCullingStats() const override
+    {
+        return culling_stats_;
+    }
+    /**
+     * @brief Get the OpenGL calls of the current frame (since pre render).
+     * @return Count of issued and skipped state calls and of draw calls.
+     */
+    GLCallCounters GetGLCallCounters() const
+    {
+        return state_cache_.GetCounters();
     }
 
   public:
@@ -125,6 +169,100 @@ class Renderer : public RendererInterface
 
   private:
     void UpdateRaytraceBuffersIfNeeded(SkinnedMesh& skinned_mesh);
+    /**
+     * @brief Check if a program raytraces (draws a screen quad), the name
+     *        lookup is done the first time the program is seen.
+     * @param program_id: Program of the draw.
+     * @return True for the raytracing programs.
+     */
+    bool IsRaytracingProgram(EntityId program_id) const;
+    /**
+     * @brief Render a node/material pair already resolved by the level (see
+     *        LevelInterface::GetRenderItems).
+     * @param item: Node, mesh and material to be rendered.
+     * @param projection: Projection matrix used.
+     * @param view: View matrix used.
+     * @return the computed model matrix.
+     */
+    std::optional<glm::mat4> RenderItemNode(
+        const frame::RenderItem& item,
+        const glm::mat4& projection,
+        const glm::mat4& view);
+    /**
+     * @brief Compute the world space box of a node/material pair.
+     * @param item: Node, mesh and material to be rendered.
+     * @return The box or nullopt if the pair should never be culled (clear
+     *         node, no bounds, animated skin, raytracing quad, etc).
+     */
+    std::optional<AABB> ComputeWorldBounds(const frame::RenderItem& item) const;
+    /**
+     * @brief Check if a node/material pair can be drawn instanced.
+     * @param item: Node, mesh and material to be rendered.
+     * @return The mesh id or nullopt if the pair has to be drawn alone
+     *         (animated skin, raytracing, temporary scene root, program
+     *         without instancing support, etc).
+     */
+    std::optional<EntityId> GetInstancingMeshId(
+        const frame::RenderItem& item) const;
+    /**
+     * @brief Render a mesh once per model matrix in a single draw call, the
+     *        program has to read the per instance model (see
+     *        kInstanceModelLocation) when instancing_enabled is set.
+     * @param mesh: Mesh to render.
+     * @param material: Material to be used.
+     * @param projection: Projection matrix used.
+     * @param view: View matrix used.
+     * @param models: Model matrix of every instance.
+     */
+    void RenderMeshInstanced(
+        MeshInterface& mesh,
+        MaterialInterface& material,
+        const glm::mat4& projection,
+        const glm::mat4& view,
+        std::span<const glm::mat4> models);
+    /**
+     * @brief Fill the render queue with the scene draws (instance_groups_)
+     *        sorted on their state, clear nodes, meshes clearing the depth
+     *        and draws reading a texture written earlier in the pass keep
+     *        their relative order.
+     * @param view: View matrix used for the depth.
+     */
+    void BuildRenderQueue(const glm::mat4& view);
+    /**
+     * @brief Start a pass, the state cache forgets the current state and the
+     *        frame block is filled again by the next draw.
+     */
+    void BeginPass();
+    //! @brief End a pass, go back to the default OpenGL state.
+    void EndPass();
+    /**
+     * @brief Clear the depth of the render frame buffer (after the meshes
+     *        that clear the buffer), skipped if nothing was drawn since the
+     *        last clear.
+     */
+    void ClearRenderDepth();
+    /**
+     * @brief Get the storage buffers of a material, looked up in the level
+     *        the first time the material is drawn after a level change.
+     * @param material: Material drawn.
+     * @return Buffers and binding points (in the material order).
+     */
+    const std::vector<BufferBinding>& GetMaterialBuffers(
+        const MaterialInterface& material);
+    /**
+     * @brief Shared implementation of the single and instanced draws.
+     * @param instance_models: Empty for a regular draw.
+     * @param clear_depth: Clear the depth after the draw (node option
+     *        clear_depth_buffer).
+     */
+    void DrawMesh(
+        MeshInterface& mesh,
+        MaterialInterface& material,
+        const glm::mat4& projection,
+        const glm::mat4& view,
+        const glm::mat4& model,
+        std::span<const glm::mat4> instance_models,
+        bool clear_depth);
 
   private:
     LevelInterface& level_;
@@ -148,6 +286,49 @@ class Renderer : public RendererInterface
     RenderCallback callback_ = [](UniformCollectionInterface&,
                                   MeshInterface&,
                                   MaterialInterface&) {};
+    bool has_callback_ = false;
+    // Raytracing flag per program id (see IsRaytracingProgram).
+    mutable std::unordered_map<EntityId, bool> raytracing_programs_ = {};
+    // Storage buffers per material, valid for the level revision.
+    std::unordered_map<const MaterialInterface*, std::vector<BufferBinding>>
+        material_buffers_ = {};
+    std::uint64_t material_buffers_revision_ = 0;
+    // Frustum culling state, buffers are kept to avoid reallocations.
+    CullingStats culling_stats_ = {};
+    std::vector<std::size_t> cull_indices_ = {};
+    std::vector<AABB> cull_bounds_ = {};
+    std::vector<std::uint8_t> cull_visible_ = {};
+    // Transient data of a scene pass (reset by RenderScene), declared before
+    // the containers using it.
+    FrameAllocator frame_allocator_{};
+    // Instanced draws, group of visible pairs sharing a mesh and a material.
+    struct InstanceGroup
+    {
+        const frame::RenderItem* item = nullptr;
+        EntityId mesh_id = NullId;
+        std::pmr::vector<glm::mat4> models = {};
+        // Culled mesh clearing the depth, only the clear is done.
+        bool clear_depth_only = false;
+    };
+    std::vector<InstanceGroup> instance_groups_ = {};
+    std::unique_ptr<Buffer> instance_buffer_{nullptr};
+    // Frame and object uniform buffers (programs declaring the blocks).
+    std::unique_ptr<UniformBlocks> uniform_blocks_{nullptr};
+    // Frame block of the current pass (see BeginPass).
+    FrameBlock frame_block_ = {};
+    bool frame_block_filled_ = false;
+    // Draw order of the scene pass and state shadow used by all passes.
+    RenderQueue render_queue_ = {};
+    std::vector<EntityId> queue_inputs_ = {};
+    std::vector<EntityId> queue_outputs_ = {};
+    std::vector<FrameAttachment> frame_attachments_ = {};
+    StateCache state_cache_ = {};
+    // Uniforms of the current draw (see DrawMesh).
+    UniformCollectionWrapper uniform_collection_wrapper_ = {};
+    bool in_pass_ = false;
+    bool depth_test_ = true;
+    // Depth of the render frame buffer written since it was last cleared.
+    bool render_depth_dirty_ = true;
 };
 
 } // End namespace frame::opengl.
@@ -13,6 +13,7 @@
 #include <string>
 
 #include "frame/gui/draw_gui_interface.h"
+#include "frame/opengl/device.h"
 #include "frame/opengl/gui/sdl_opengl_draw_gui.h"
 #include "frame/opengl/message_callback.h"
 
@@ -161,13 +162,20 @@ WindowReturnEnum SDLOpenGLWindow::Run(std::function<bool()> lambda)
         device_->Display(dt);
 
         // Draw the Scene not used?
-        for (const auto& plugin_interface : device_->GetPluginPtrs())
         {
-            if (plugin_interface)
+            // The plugins draw the GUI.
+            auto* opengl_device = dynamic_cast<Device*>(device_.get());
+            GpuProfiler::Scope scope(
+                opengl_device ? opengl_device->GetGpuProfiler() : nullptr,
+                gpu_pass::kGui);
+            for (const auto& plugin_interface : device_->GetPluginPtrs())
             {
-                if (!plugin_interface->Update(*device_.get(), dt))
+                if (plugin_interface)
                 {
-                    window_return_enum = WindowReturnEnum::QUIT;
+                    if (!plugin_interface->Update(*device_.get(), dt))
+                    {
+                        window_return_enum = WindowReturnEnum::QUIT;
+                    }
                 }
             }
         }
@@ -15,11 +15,22 @@ Shader::~Shader()
 }
 
 bool Shader::LoadFromSource(const std::string& source)
+{
+    Compile(source);
+    return CheckCompileStatus();
+}
+
+void Shader::Compile(const std::string& source)
 {
     id_ = glCreateShader(static_cast<unsigned int>(type_));
     const char* c_source = source.c_str();
     glShaderSource(id_, 1, &c_source, nullptr);
     glCompileShader(id_);
+    created_ = true;
+}
+
+bool Shader::CheckCompileStatus()
+{
     int result;
     glGetShaderiv(id_, GL_COMPILE_STATUS, &result);
     if (result == GL_FALSE)
@@ -42,6 +42,17 @@ class Shader
      * @param source: Content of the shader in text form.
      */
     bool LoadFromSource(const std::string& source);
+    /**
+     * @brief Start the compilation, with GL_KHR_parallel_shader_compile the
+     *        driver compiles in the background until the status is queried.
+     * @param source: Content of the shader in text form.
+     */
+    void Compile(const std::string& source);
+    /**
+     * @brief Wait for the compilation started by Compile.
+     * @return True if the shader compiled, see GetErrorMessage otherwise.
+     */
+    bool CheckCompileStatus();
 
   public:
     /**
@@ -24,6 +24,12 @@ class SkinnedMesh : public Mesh
     SkinnedMesh(LevelInterface& level, const MeshParameter& parameters);
     ~SkinnedMesh() override;
 
+  public:
+    MeshTypeEnum GetMeshType() const override
+    {
+        return MeshTypeEnum::SKINNED_MESH;
+    }
+
   public:
     void SetSkinningBuffers(
         EntityId bone_index_buffer_id,
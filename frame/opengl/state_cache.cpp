@@ -0,0 +1,232 @@
+#include "frame/opengl/state_cache.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace frame::opengl
+{
+
+void StateCache::Invalidate()
+{
+    // Keep the lock consistent with what OpenGL does from now on.
+    if (frame_buffer_)
+    {
+        frame_buffer_->UnlockedBind();
+    }
+    InvalidateProgram();
+    frame_buffer_ = nullptr;
+    frame_buffer_known_ = false;
+    attachments_.clear();
+    attachments_known_ = false;
+    vertex_array_ = kUnknown;
+    index_buffer_ = kUnknown;
+    viewport_ = glm::uvec4(kUnknown);
+    active_unit_ = kUnknown;
+    textures_ = {};
+}
+
+void StateCache::InvalidateProgram()
+{
+    if (program_)
+    {
+        program_->ReleaseUse();
+    }
+    program_ = nullptr;
+    program_known_ = false;
+}
+
+void StateCache::Reset()
+{
+    ReleaseTextureUnits(0);
+    if (program_ || !program_known_)
+    {
+        if (program_)
+        {
+            program_->UnUse();
+        }
+        else
+        {
+            glUseProgram(0);
+        }
+        ++counters_.state_calls;
+        program_ = nullptr;
+        program_known_ = true;
+    }
+    BindVertexArray(0);
+    BindFrameBuffer(nullptr);
+}
+
+void StateCache::UseProgram(const Program& program)
+{
+    if (program_known_ && program_ == &program)
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    if (program_)
+    {
+        program_->ReleaseUse();
+    }
+    program.Use();
+    ++counters_.state_calls;
+    program_ = &program;
+    program_known_ = true;
+}
+
+void StateCache::BindFrameBuffer(const FrameBuffer* frame_buffer)
+{
+    if (frame_buffer_known_ && frame_buffer_ == frame_buffer)
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    if (frame_buffer_)
+    {
+        frame_buffer_->UnlockedBind();
+    }
+    if (frame_buffer)
+    {
+        frame_buffer->Bind();
+        frame_buffer->LockedBind();
+    }
+    else
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    ++counters_.state_calls;
+    frame_buffer_ = frame_buffer;
+    frame_buffer_known_ = true;
+}
+
+void StateCache::AttachTextures(
+    FrameBuffer& frame_buffer,
+    std::span<const FrameAttachment> attachments)
+{
+    assert(frame_buffer_known_ && frame_buffer_ == &frame_buffer);
+    if (attachments_known_ &&
+        std::equal(
+            attachments.begin(),
+            attachments.end(),
+            attachments_.begin(),
+            attachments_.end()))
+    {
+        // The attachments and the draw buffers.
+        counters_.skipped_calls +=
+            static_cast<std::uint32_t>(attachments.size()) + 1;
+        return;
+    }
+    for (const auto& attachment : attachments)
+    {
+        // TODO(anirul): Check the mipmap level (last parameter)!
+        frame_buffer.AttachTexture(
+            attachment.texture_id,
+            attachment.attachment,
+            attachment.texture_type,
+            0);
+        ++counters_.state_calls;
+    }
+    if (attachments.empty())
+    {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        counters_.state_calls += 2;
+    }
+    else
+    {
+        frame_buffer.DrawBuffers(
+            static_cast<std::uint32_t>(attachments.size()));
+        ++counters_.state_calls;
+    }
+    attachments_.assign(attachments.begin(), attachments.end());
+    attachments_known_ = true;
+}
+
+void StateCache::BindVertexArray(unsigned int vertex_array_id)
+{
+    if (vertex_array_ == vertex_array_id)
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    glBindVertexArray(vertex_array_id);
+    ++counters_.state_calls;
+    vertex_array_ = vertex_array_id;
+    // The element array binding is part of the vertex array state.
+    index_buffer_ = kUnknown;
+}
+
+void StateCache::BindIndexBuffer(const Buffer& index_buffer)
+{
+    if (vertex_array_ != kUnknown && index_buffer_ == index_buffer.GetId())
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    index_buffer.Bind();
+    ++counters_.state_calls;
+    index_buffer_ = index_buffer.GetId();
+}
+
+void StateCache::Viewport(glm::uvec4 viewport)
+{
+    if (viewport_ == viewport)
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    glViewport(viewport.x, viewport.y, viewport.z, viewport.w);
+    ++counters_.state_calls;
+    viewport_ = viewport;
+}
+
+void StateCache::BindTexture(
+    unsigned int unit, unsigned int target, unsigned int texture_id)
+{
+    assert(unit < kMaxTextureUnits);
+    auto& binding = textures_[unit];
+    if (binding.target == target && binding.id == texture_id)
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    ActiveTexture(unit);
+    // Don't leave a texture of the other target bound on the unit.
+    if (binding.id && binding.target != target)
+    {
+        glBindTexture(binding.target, 0);
+        ++counters_.state_calls;
+    }
+    glBindTexture(target, texture_id);
+    ++counters_.state_calls;
+    binding = {target, texture_id};
+}
+
+void StateCache::ReleaseTextureUnits(std::uint32_t used_units)
+{
+    for (unsigned int unit = 0; unit < kMaxTextureUnits; ++unit)
+    {
+        auto& binding = textures_[unit];
+        if (!binding.id || (used_units & (1u << unit)))
+            continue;
+        ActiveTexture(unit);
+        glBindTexture(binding.target, 0);
+        ++counters_.state_calls;
+        binding = {};
+    }
+}
+
+void StateCache::ActiveTexture(unsigned int unit)
+{
+    if (active_unit_ == unit)
+    {
+        ++counters_.skipped_calls;
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    ++counters_.state_calls;
+    active_unit_ = unit;
+}
+
+} // End namespace frame::opengl.
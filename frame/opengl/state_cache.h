@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "frame/opengl/buffer.h"
+#include "frame/opengl/frame_buffer.h"
+#include "frame/opengl/program.h"
+
+namespace frame::opengl
+{
+
+/**
+ * @class GLCallCounters
+ * @brief OpenGL calls issued and skipped by the state cache (binds, viewport
+ *        and attachments), uniform uploads issued and skipped by the
+ *        programs and draw calls, reset every frame.
+ */
+struct GLCallCounters
+{
+    std::uint32_t state_calls = 0;
+    std::uint32_t skipped_calls = 0;
+    std::uint32_t uniform_uploads = 0;
+    std::uint32_t skipped_uniform_uploads = 0;
+    std::uint32_t draw_calls = 0;
+};
+
+/**
+ * @class FrameAttachment
+ * @brief Color attachment of the render frame buffer.
+ */
+struct FrameAttachment
+{
+    unsigned int texture_id = 0;
+    FrameColorAttachment attachment = FrameColorAttachment::COLOR_ATTACHMENT0;
+    FrameTextureType texture_type = FrameTextureType::TEXTURE_2D;
+    bool operator==(const FrameAttachment&) const = default;
+};
+
+/**
+ * @class StateCache
+ * @brief Shadow of the OpenGL binding state used by the renderer, binds that
+ *        would not change anything are skipped.
+ *
+ * The cache only sees the calls going through it, code outside of the
+ * renderer is expected to unbind what it binds (as everywhere in frame).
+ * Invalidate is called before a pass and Reset after it so the rest of the
+ * code finds the default state.
+ */
+class StateCache
+{
+  public:
+    //! @brief Texture units tracked (same as the material slots).
+    static constexpr std::size_t kMaxTextureUnits = 32;
+
+  public:
+    /**
+     * @brief Forget the state (except the textures that are assumed to be
+     *        unbound), the next binds are always issued.
+     */
+    void Invalidate();
+    //! @brief Forget the program in use (a callback may have changed it).
+    void InvalidateProgram();
+    //! @brief Go back to the default state: no program, vertex array,
+    //!        frame buffer or texture.
+    void Reset();
+    /**
+     * @brief Use a program.
+     * @param program: Program to use.
+     */
+    void UseProgram(const Program& program);
+    /**
+     * @brief Bind a frame buffer, it stays locked (see ScopedBind) until
+     *        another one is bound so its own bind calls are no-ops.
+     * @param frame_buffer: Frame buffer or null for the default one.
+     */
+    void BindFrameBuffer(const FrameBuffer* frame_buffer);
+    /**
+     * @brief Attach the output textures to the bound frame buffer and set the
+     *        draw buffers, nothing is done if they are already attached.
+     * @param frame_buffer: The bound frame buffer.
+     * @param attachments: Color attachments (empty for no color output).
+     */
+    void AttachTextures(
+        FrameBuffer& frame_buffer,
+        std::span<const FrameAttachment> attachments);
+    /**
+     * @brief Bind a vertex array.
+     * @param vertex_array_id: OpenGL id of the vertex array.
+     */
+    void BindVertexArray(unsigned int vertex_array_id);
+    /**
+     * @brief Bind an index buffer to the current vertex array.
+     * @param index_buffer: Element array buffer.
+     */
+    void BindIndexBuffer(const Buffer& index_buffer);
+    /**
+     * @brief Set the viewport.
+     * @param viewport: Position and size of the viewport.
+     */
+    void Viewport(glm::uvec4 viewport);
+    /**
+     * @brief Bind a texture to a unit.
+     * @param unit: Texture unit (less than kMaxTextureUnits).
+     * @param target: OpenGL target (2D or cube map).
+     * @param texture_id: OpenGL id of the texture.
+     */
+    void BindTexture(
+        unsigned int unit, unsigned int target, unsigned int texture_id);
+    /**
+     * @brief Unbind the textures on the units that are not used.
+     * @param used_units: Bit mask of the units used by the next draw.
+     */
+    void ReleaseTextureUnits(std::uint32_t used_units);
+    //! @brief Count a draw call.
+    void CountDraw()
+    {
+        ++counters_.draw_calls;
+    }
+    /**
+     * @brief Count the uniform uploads of a program.
+     * @param upload_counters: Counters taken from the program.
+     */
+    void CountUniformUploads(UniformUploadCounters upload_counters)
+    {
+        counters_.uniform_uploads += upload_counters.issued;
+        counters_.skipped_uniform_uploads += upload_counters.skipped;
+    }
+    /**
+     * @brief Get the counters since the last reset.
+     * @return The counters.
+     */
+    GLCallCounters GetCounters() const
+    {
+        return counters_;
+    }
+    //! @brief Reset the counters (every frame).
+    void ResetCounters()
+    {
+        counters_ = {};
+    }
+
+  private:
+    void ActiveTexture(unsigned int unit);
+
+  private:
+    static constexpr unsigned int kUnknown = ~0u;
+    struct TextureBinding
+    {
+        unsigned int target = 0;
+        unsigned int id = 0;
+    };
+    const Program* program_ = nullptr;
+    bool program_known_ = false;
+    const FrameBuffer* frame_buffer_ = nullptr;
+    bool frame_buffer_known_ = false;
+    std::vector<FrameAttachment> attachments_ = {};
+    bool attachments_known_ = false;
+    unsigned int vertex_array_ = kUnknown;
+    unsigned int index_buffer_ = kUnknown;
+    glm::uvec4 viewport_ = glm::uvec4(kUnknown);
+    unsigned int active_unit_ = kUnknown;
+    std::array<TextureBinding, kMaxTextureUnits> textures_ = {};
+    GLCallCounters counters_ = {};
+};
+
+} // End namespace frame::opengl.
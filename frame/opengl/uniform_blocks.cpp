@@ -0,0 +1,136 @@
+#include "frame/opengl/uniform_blocks.h"
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+namespace frame::opengl
+{
+
+namespace
+{
+
+// Names of the block members in the uniform collection, interned once.
+struct BlockUniformNames
+{
+    UniformNameId projection = InternUniformName("projection");
+    UniformNameId view = InternUniformName("view");
+    UniformNameId projection_inv = InternUniformName("projection_inv");
+    UniformNameId view_inv = InternUniformName("view_inv");
+    UniformNameId env_map_model = InternUniformName("env_map_model");
+    UniformNameId camera_position = InternUniformName("camera_position");
+    UniformNameId time_s = InternUniformName("time_s");
+    UniformNameId light_dir = InternUniformName("light_dir");
+    UniformNameId time = InternUniformName("time");
+    UniformNameId light_color = InternUniformName("light_color");
+    UniformNameId model = InternUniformName("model");
+    UniformNameId model_inv = InternUniformName("model_inv");
+};
+
+const BlockUniformNames& GetBlockUniformNames()
+{
+    static const BlockUniformNames names;
+    return names;
+}
+
+void SetMatrix(const UniformValue& value, glm::mat4& matrix)
+{
+    if (value.GetType() == UniformValueType::FLOAT_MATRIX4)
+        matrix = value.GetMatrix4();
+}
+
+void SetVector(const UniformValue& value, glm::vec3& vector)
+{
+    if (value.GetType() == UniformValueType::FLOAT_VECTOR3)
+        vector = value.GetVector3();
+}
+
+void SetFloat(const UniformValue& value, float& scalar)
+{
+    if (value.GetType() == UniformValueType::FLOAT)
+        scalar = value.GetFloat();
+}
+
+} // namespace
+
+void FillFrameBlock(
+    std::span<const UniformValue> values, FrameBlock& frame_block)
+{
+    const auto& names = GetBlockUniformNames();
+    for (const auto& value : values)
+    {
+        const auto name_id = value.GetNameId();
+        if (name_id == names.projection)
+            SetMatrix(value, frame_block.projection);
+        else if (name_id == names.view)
+            SetMatrix(value, frame_block.view);
+        else if (name_id == names.projection_inv)
+            SetMatrix(value, frame_block.projection_inv);
+        else if (name_id == names.view_inv)
+            SetMatrix(value, frame_block.view_inv);
+        else if (name_id == names.env_map_model)
+            SetMatrix(value, frame_block.env_map_model);
+        else if (name_id == names.camera_position)
+            SetVector(value, frame_block.camera_position);
+        else if (name_id == names.time_s)
+            SetFloat(value, frame_block.time_s);
+        else if (name_id == names.light_dir)
+            SetVector(value, frame_block.light_dir);
+        else if (name_id == names.time)
+            SetFloat(value, frame_block.time);
+        else if (name_id == names.light_color)
+            SetVector(value, frame_block.light_color);
+    }
+}
+
+void FillObjectBlock(
+    std::span<const UniformValue> values, ObjectBlock& object_block)
+{
+    const auto& names = GetBlockUniformNames();
+    for (const auto& value : values)
+    {
+        const auto name_id = value.GetNameId();
+        if (name_id == names.model)
+            SetMatrix(value, object_block.model);
+        else if (name_id == names.model_inv)
+            SetMatrix(value, object_block.model_inv);
+    }
+}
+
+UniformBlocks::UniformBlocks(std::size_t object_count)
+    : object_count_(object_count)
+{
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const std::size_t align = alignment > 0 ? alignment : 256;
+    object_stride_ = (sizeof(ObjectBlock) + align - 1) / align * align;
+    frame_buffer_.SetName("FrameBlock");
+    frame_buffer_.Copy(sizeof(FrameBlock));
+    object_buffer_.SetName("ObjectBlock");
+    object_buffer_.Copy(object_stride_ * object_count_);
+}
+
+void UniformBlocks::SetFrame(const FrameBlock& frame_block)
+{
+    if (frame_known_ &&
+        std::memcmp(&frame_block_, &frame_block, sizeof(FrameBlock)) == 0)
+    {
+        return;
+    }
+    frame_block_ = frame_block;
+    frame_buffer_.Update(0, sizeof(FrameBlock), &frame_block_);
+    frame_buffer_.BindBase(kFrameBlockBinding);
+    frame_known_ = true;
+}
+
+void UniformBlocks::SetObject(const ObjectBlock& object_block)
+{
+    // Consecutive draws use different slots, the driver does not have to
+    // wait for the previous draw before the update.
+    const std::size_t offset = object_index_ * object_stride_;
+    object_index_ = (object_index_ + 1) % object_count_;
+    object_buffer_.Update(offset, sizeof(ObjectBlock), &object_block);
+    object_buffer_.BindRange(kObjectBlockBinding, offset, sizeof(ObjectBlock));
+}
+
+} // End namespace frame::opengl.
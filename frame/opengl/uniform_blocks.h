@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "frame/opengl/buffer.h"
+#include "frame/uniform_value.h"
+
+namespace frame::opengl
+{
+
+//! @brief Binding point and name of the per frame uniform block.
+constexpr unsigned int kFrameBlockBinding = 0;
+constexpr const char* kFrameBlockName = "FrameBlock";
+//! @brief Binding point and name of the per object uniform block.
+constexpr unsigned int kObjectBlockBinding = 1;
+constexpr const char* kObjectBlockName = "ObjectBlock";
+
+/**
+ * @class FrameBlock
+ * @brief Data shared by the draws of a pass, std140 layout of the FrameBlock
+ *        declared in the shaders (see asset/shader/opengl/scene_simple.vert).
+ */
+struct alignas(16) FrameBlock
+{
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection_inv = glm::mat4(1.0f);
+    glm::mat4 view_inv = glm::mat4(1.0f);
+    glm::mat4 env_map_model = glm::mat4(1.0f);
+    glm::vec3 camera_position = glm::vec3(0.0f);
+    float time_s = 0.0f;
+    glm::vec3 light_dir = glm::vec3(0.0f);
+    float time = 0.0f;
+    glm::vec3 light_color = glm::vec3(0.0f);
+    float padding = 0.0f;
+};
+
+/**
+ * @class ObjectBlock
+ * @brief Data of a single draw, std140 layout of the ObjectBlock declared in
+ *        the shaders.
+ */
+struct alignas(16) ObjectBlock
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::mat4 model_inv = glm::mat4(1.0f);
+};
+
+static_assert(offsetof(FrameBlock, camera_position) == 320);
+static_assert(offsetof(FrameBlock, light_dir) == 336);
+static_assert(offsetof(FrameBlock, light_color) == 352);
+static_assert(sizeof(FrameBlock) == 368);
+static_assert(sizeof(ObjectBlock) == 128);
+
+/**
+ * @brief Fill the frame block from the uniforms of a draw, values with an
+ *        unknown name or an unexpected type are ignored.
+ * @param values: Uniforms of the draw (see UniformCollectionInterface).
+ * @param frame_block: Frame block to fill.
+ */
+void FillFrameBlock(
+    std::span<const UniformValue> values, FrameBlock& frame_block);
+
+/**
+ * @brief Fill the object block from the uniforms of a draw (see
+ *        FillFrameBlock).
+ * @param values: Uniforms of the draw (see UniformCollectionInterface).
+ * @param object_block: Object block to fill.
+ */
+void FillObjectBlock(
+    std::span<const UniformValue> values, ObjectBlock& object_block);
+
+/**
+ * @class UniformBlocks
+ * @brief Uniform buffers of the renderer, the frame block is uploaded once
+ *        per pass (and only when it changed) and the object blocks are
+ *        written to a ring and bound per draw with glBindBufferRange.
+ *
+ * Programs that do not declare the blocks keep using loose uniforms.
+ */
+class UniformBlocks
+{
+  public:
+    /**
+     * @brief Constructor, allocate the buffers (needs a context).
+     * @param object_count: Number of object blocks in the ring.
+     */
+    explicit UniformBlocks(std::size_t object_count = 1024);
+
+  public:
+    /**
+     * @brief Upload the frame block if it changed and bind it.
+     * @param frame_block: The frame block.
+     */
+    void SetFrame(const FrameBlock& frame_block);
+    /**
+     * @brief Write the object block in the next slot of the ring and bind
+     *        the slot.
+     * @param object_block: The object block.
+     */
+    void SetObject(const ObjectBlock& object_block);
+    /**
+     * @brief Forget the uploaded frame block, the next SetFrame uploads and
+     *        binds it again.
+     */
+    void Invalidate()
+    {
+        frame_known_ = false;
+    }
+
+  private:
+    Buffer frame_buffer_{
+        BufferTypeEnum::UNIFORM_BUFFER, BufferUsageEnum::DYNAMIC_DRAW};
+    Buffer object_buffer_{
+        BufferTypeEnum::UNIFORM_BUFFER, BufferUsageEnum::STREAM_DRAW};
+    FrameBlock frame_block_ = {};
+    bool frame_known_ = false;
+    // Size of a slot of the ring (aligned for glBindBufferRange).
+    std::size_t object_stride_ = 0;
+    std::size_t object_count_ = 0;
+    std::size_t object_index_ = 0;
+};
+
+} // End namespace frame::opengl.
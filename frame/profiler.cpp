@@ -0,0 +1,304 @@
+#include "frame/profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace frame
+{
+
+namespace
+{
+
+std::uint64_t SteadyNowNs()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Names come from the code, only quotes and backslashes need escaping.
+std::string EscapeJson(const char* str)
+{
+    std::string escaped;
+    for (const char* c = str; c && *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(*c);
+    }
+    return escaped;
+}
+
+} // namespace
+
+// Ring of the events of a thread. The owner thread is the only writer, the
+// readers (EndFrame, export) hold the profiler mutex and copy the slots
+// lock free: started is bumped before a slot is written and committed
+// after, a reader drops the slots started got past while it copied them.
+struct Profiler::ThreadBuffer
+{
+    struct Slot
+    {
+        std::atomic<const char*> name = nullptr;
+        std::atomic<std::uint64_t> begin_ns = 0;
+        std::atomic<std::uint64_t> end_ns = 0;
+        std::atomic<std::uint32_t> depth = 0;
+    };
+
+    // Thread id and name, changed under the profiler mutex when the buffer
+    // is handed to a new thread.
+    std::atomic<std::uint32_t> thread = 0;
+    const char* thread_name = nullptr;
+    bool in_use = false;
+    std::unique_ptr<Slot[]> slots =
+        std::make_unique<Slot[]>(kEventsPerThread);
+    std::atomic<std::uint64_t> started = 0;
+    std::atomic<std::uint64_t> committed = 0;
+    // First event not aggregated by EndFrame yet.
+    std::uint64_t frame_read = 0;
+
+    void Write(const char* name,
+               std::uint64_t begin_ns,
+               std::uint64_t end_ns,
+               std::uint32_t depth)
+    {
+        const std::uint64_t index = started.load(std::memory_order_relaxed);
+        started.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        auto& slot = slots[index % kEventsPerThread];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        slot.depth.store(depth, std::memory_order_relaxed);
+        committed.store(index + 1, std::memory_order_release);
+    }
+
+    // Copy the events from first on (or the oldest still kept), returns
+    // the index following the last one copied.
+    std::uint64_t Read(
+        std::uint64_t first, std::vector<ProfileEvent>& events) const
+    {
+        const std::uint64_t end = committed.load(std::memory_order_acquire);
+        const std::uint64_t begin = std::max(
+            first, end > kEventsPerThread ? end - kEventsPerThread : 0);
+        const std::size_t offset = events.size();
+        const std::uint32_t thread_id = thread.load(std::memory_order_relaxed);
+        for (std::uint64_t i = begin; i < end; ++i)
+        {
+            const auto& slot = slots[i % kEventsPerThread];
+            events.push_back(
+                {slot.name.load(std::memory_order_relaxed),
+                 slot.begin_ns.load(std::memory_order_relaxed),
+                 slot.end_ns.load(std::memory_order_relaxed),
+                 thread_id,
+                 slot.depth.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t overwritten_end = [this] {
+            const auto now = started.load(std::memory_order_relaxed);
+            return now > kEventsPerThread ? now - kEventsPerThread : 0;
+        }();
+        if (overwritten_end > begin)
+        {
+            const auto dropped = static_cast<std::ptrdiff_t>(
+                std::min(overwritten_end, end) - begin);
+            events.erase(
+                events.begin() + offset, events.begin() + offset + dropped);
+        }
+        return end;
+    }
+};
+
+// Buffer of the calling thread, given back to the profiler when the thread
+// ends so short lived threads do not grow the list.
+struct Profiler::ThreadState
+{
+    ThreadBuffer* buffer = nullptr;
+    std::uint32_t depth = 0;
+
+    ~ThreadState()
+    {
+        if (buffer)
+        {
+            Profiler::GetInstance().ReleaseThreadBuffer(*buffer);
+        }
+    }
+    ThreadBuffer& GetBuffer()
+    {
+        if (!buffer)
+        {
+            buffer = &Profiler::GetInstance().AcquireThreadBuffer();
+        }
+        return *buffer;
+    }
+};
+
+Profiler::Profiler() : start_ns_(SteadyNowNs())
+{
+}
+
+Profiler::~Profiler() = default;
+
+Profiler& Profiler::GetInstance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadState& Profiler::GetThreadState()
+{
+    thread_local ThreadState state;
+    return state;
+}
+
+std::uint64_t Profiler::Now() const
+{
+    return SteadyNowNs() - start_ns_;
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    auto& buffer = GetThreadState().GetBuffer();
+    std::scoped_lock lock(GetInstance().mutex_);
+    buffer.thread_name = name;
+}
+
+std::uint32_t Profiler::EnterScope()
+{
+    return GetThreadState().depth++;
+}
+
+void Profiler::LeaveScope(
+    const char* name, std::uint64_t begin_ns, std::uint32_t depth)
+{
+    auto& state = GetThreadState();
+    state.depth = depth;
+    state.GetBuffer().Write(name, begin_ns, GetInstance().Now(), depth);
+}
+
+Profiler::ThreadBuffer& Profiler::AcquireThreadBuffer()
+{
+    std::scoped_lock lock(mutex_);
+    auto it = std::ranges::find_if(
+        buffers_, [](const auto& buffer) { return !buffer->in_use; });
+    if (it == buffers_.end())
+    {
+        buffers_.push_back(std::make_unique<ThreadBuffer>());
+        it = std::prev(buffers_.end());
+    }
+    // The events of the previous thread stay, they are reported under the
+    // new id (the exports keep the thread names of the live threads only).
+    auto& buffer = **it;
+    buffer.in_use = true;
+    buffer.thread_name = nullptr;
+    buffer.thread.store(next_thread_id_++, std::memory_order_relaxed);
+    return buffer;
+}
+
+void Profiler::ReleaseThreadBuffer(ThreadBuffer& buffer)
+{
+    std::scoped_lock lock(mutex_);
+    buffer.in_use = false;
+}
+
+void Profiler::EndFrame()
+{
+    const std::uint64_t now_ns = Now();
+    std::vector<ProfileEvent> events;
+    std::scoped_lock lock(mutex_);
+    for (auto& buffer : buffers_)
+    {
+        buffer->frame_read = buffer->Read(buffer->frame_read, events);
+    }
+    // Parents begin before their children.
+    std::ranges::sort(events, {}, &ProfileEvent::begin_ns);
+    ProfileFrameStats stats{
+        ++frame_number_,
+        static_cast<double>(now_ns - frame_begin_ns_) * 1e-6};
+    std::map<std::pair<const char*, std::uint32_t>, std::size_t> indices;
+    for (const auto& event : events)
+    {
+        const auto [it, inserted] = indices.try_emplace(
+            {event.name, event.depth}, stats.scopes.size());
+        if (inserted)
+        {
+            stats.scopes.push_back({event.name, event.depth});
+        }
+        auto& scope = stats.scopes[it->second];
+        const double ms =
+            static_cast<double>(event.end_ns - event.begin_ns) * 1e-6;
+        ++scope.calls;
+        scope.total_ms += ms;
+        scope.max_ms = std::max(scope.max_ms, ms);
+    }
+    frame_begin_ns_ = now_ns;
+    last_frame_ = std::move(stats);
+}
+
+ProfileFrameStats Profiler::GetLastFrameStats() const
+{
+    std::scoped_lock lock(mutex_);
+    return last_frame_;
+}
+
+void Profiler::WriteChromeTrace(std::ostream& os) const
+{
+    std::vector<ProfileEvent> events;
+    std::scoped_lock lock(mutex_);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&first, &os] {
+        if (!std::exchange(first, false))
+        {
+            os << ",\n";
+        }
+    };
+    for (const auto& buffer : buffers_)
+    {
+        if (buffer->in_use && buffer->thread_name)
+        {
+            separator();
+            os << std::format(
+                "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                buffer->thread.load(std::memory_order_relaxed),
+                EscapeJson(buffer->thread_name));
+        }
+        buffer->Read(0, events);
+    }
+    // Complete events, in microseconds.
+    for (const auto& event : events)
+    {
+        separator();
+        os << std::format(
+            "{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},"
+            "\"ts\":{:.3f},\"dur\":{:.3f}}}",
+            EscapeJson(event.name),
+            event.thread,
+            static_cast<double>(event.begin_ns) * 1e-3,
+            static_cast<double>(event.end_ns - event.begin_ns) * 1e-3);
+    }
+    os << "]}\n";
+}
+
+void Profiler::WriteChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error(std::format("Couldn't write {}", path));
+    }
+    WriteChromeTrace(file);
+}
+
+} // End namespace frame.
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace frame
+{
+
+/**
+ * @class ProfileEvent
+ * @brief A scope timed on a thread, times in nanoseconds since the profiler
+ *        was created.
+ */
+struct ProfileEvent
+{
+    const char* name = nullptr;
+    std::uint64_t begin_ns = 0;
+    std::uint64_t end_ns = 0;
+    std::uint32_t thread = 0;
+    //! @brief Scopes open on the thread around this one.
+    std::uint32_t depth = 0;
+};
+
+/**
+ * @class ProfileScopeStats
+ * @brief Time spent in a scope (at a depth) during a frame, all threads
+ *        together.
+ */
+struct ProfileScopeStats
+{
+    const char* name = nullptr;
+    std::uint32_t depth = 0;
+    std::uint32_t calls = 0;
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @class ProfileFrameStats
+ * @brief Scopes that ended during a frame, parents before their children.
+ */
+struct ProfileFrameStats
+{
+    std::uint64_t frame = 0;
+    double frame_ms = 0.0;
+    std::vector<ProfileScopeStats> scopes;
+};
+
+/**
+ * @class Profiler
+ * @brief Hierarchical CPU profiler, the scopes are recorded through the
+ *        FRAME_PROFILE_* macros (removed when FRAME_PROFILER is not
+ *        defined).
+ *
+ * Each thread writes its ended scopes to its own ring buffer (the oldest
+ * events are overwritten), recording takes no lock. Names are static
+ * strings, only the pointer is stored. EndFrame aggregates the scopes ended
+ * since the previous frame, WriteChromeTrace exports what the buffers still
+ * hold in the Chrome trace_event format (chrome://tracing, Perfetto).
+ */
+class Profiler
+{
+  public:
+    //! @brief Events kept per thread.
+    static constexpr std::size_t kEventsPerThread = 16 * 1024;
+
+  private:
+    Profiler();
+
+  public:
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+  public:
+    /**
+     * @brief Get the profiler (see singleton).
+     * @return A reference to the instance.
+     */
+    static Profiler& GetInstance();
+    /**
+     * @brief Name the calling thread in the exports.
+     * @param name: Static string.
+     */
+    static void SetThreadName(const char* name);
+    /**
+     * @brief Open a scope on the calling thread.
+     * @return The depth of the scope.
+     */
+    static std::uint32_t EnterScope();
+    /**
+     * @brief Close the scope opened last on the calling thread.
+     * @param name: Static string naming the scope.
+     * @param begin_ns: Time the scope was opened (see Now).
+     * @param depth: Depth returned by EnterScope.
+     */
+    static void LeaveScope(
+        const char* name, std::uint64_t begin_ns, std::uint32_t depth);
+    /**
+     * @brief Get the time.
+     * @return Nanoseconds since the profiler was created.
+     */
+    std::uint64_t Now() const;
+
+  public:
+    //! @brief Aggregate the scopes ended since the previous frame.
+    void EndFrame();
+    /**
+     * @brief Get the statistics of the last frame.
+     * @return The scopes of the frame ended by the last EndFrame.
+     */
+    ProfileFrameStats GetLastFrameStats() const;
+    /**
+     * @brief Write the events kept by all the threads.
+     * @param os: Stream receiving the trace_event JSON.
+     */
+    void WriteChromeTrace(std::ostream& os) const;
+    /**
+     * @brief Write the events kept by all the threads to a file.
+     * @param path: File receiving the trace_event JSON.
+     */
+    void WriteChromeTrace(const std::string& path) const;
+
+  private:
+    struct ThreadBuffer;
+    struct ThreadState;
+    static ThreadState& GetThreadState();
+    ThreadBuffer& AcquireThreadBuffer();
+    void ReleaseThreadBuffer(ThreadBuffer& buffer);
+
+  private:
+    const std::uint64_t start_ns_ = 0;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::uint32_t next_thread_id_ = 1;
+    std::uint64_t frame_number_ = 0;
+    std::uint64_t frame_begin_ns_ = 0;
+    ProfileFrameStats last_frame_;
+};
+
+/**
+ * @class ProfileScope
+ * @brief Time the lifetime of the object, see FRAME_PROFILE_SCOPE.
+ */
+class ProfileScope
+{
+  public:
+    //! @brief Only string literals, the pointer outlives the profiler.
+    template <std::size_t N>
+    explicit ProfileScope(const char (&name)[N])
+        : name_(name), depth_(Profiler::EnterScope()),
+          begin_ns_(Profiler::GetInstance().Now())
+    {
+    }
+    ~ProfileScope()
+    {
+        Profiler::LeaveScope(name_, begin_ns_, depth_);
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    const char* name_ = nullptr;
+    std::uint32_t depth_ = 0;
+    std::uint64_t begin_ns_ = 0;
+};
+
+} // End namespace frame.
+
+#define FRAME_PROFILE_CONCAT_INNER(a, b) a##b
+#define FRAME_PROFILE_CONCAT(a, b) FRAME_PROFILE_CONCAT_INNER(a, b)
+
+#if defined(FRAME_PROFILER)
+//! @brief Time the rest of the enclosing block under a static name.
+#define FRAME_PROFILE_SCOPE(name)                                             \
+    ::frame::ProfileScope FRAME_PROFILE_CONCAT(                               \
+        frame_profile_scope_, __LINE__)(name)
+//! @brief Name the calling thread in the trace.
+#define FRAME_PROFILE_THREAD(name) ::frame::Profiler::SetThreadName(name)
+//! @brief End of a frame, aggregate its scopes.
+#define FRAME_PROFILE_END_FRAME() ::frame::Profiler::GetInstance().EndFrame()
+#else
+#define FRAME_PROFILE_SCOPE(name) static_cast<void>(0)
+#define FRAME_PROFILE_THREAD(name) static_cast<void>(0)
+#define FRAME_PROFILE_END_FRAME() static_cast<void>(0)
+#endif
@@ -0,0 +1,126 @@
+#include "frame/render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace frame
+{
+
+namespace
+{
+
+constexpr std::uint64_t kTargetBits = 10;
+constexpr std::uint64_t kProgramBits = 12;
+constexpr std::uint64_t kMaterialBits = 12;
+constexpr std::uint64_t kMeshBits = 14;
+constexpr std::uint64_t kDepthBits = 16;
+static_assert(
+    kTargetBits + kProgramBits + kMaterialBits + kMeshBits + kDepthBits == 64);
+
+// Under this size an insertion sort beats the histogram passes.
+constexpr std::size_t kInsertionSortThreshold = 32;
+
+std::uint64_t Truncate(std::uint64_t value, std::uint64_t bits)
+{
+    return value & ((std::uint64_t{1} << bits) - 1);
+}
+
+std::uint64_t QuantizeDepth(float depth)
+{
+    // Positive floats compare like their bit pattern, keep the top bits
+    // after the sign (exponent and the upper part of the mantissa).
+    if (!(depth > 0.f))
+        return 0;
+    const auto bits = std::bit_cast<std::uint32_t>(depth);
+    return bits >> (31 - kDepthBits);
+}
+
+void InsertionSort(std::span<DrawItem> items)
+{
+    for (std::size_t i = 1; i < items.size(); ++i)
+    {
+        const DrawItem item = items[i];
+        std::size_t j = i;
+        while (j > 0 && items[j - 1].key > item.key)
+        {
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = item;
+    }
+}
+
+} // namespace
+
+std::uint64_t MakeDrawKey(
+    std::uint64_t target,
+    std::uint64_t program,
+    std::uint64_t material,
+    std::uint64_t mesh,
+    float depth)
+{
+    std::uint64_t key = Truncate(target, kTargetBits);
+    key = (key << kProgramBits) | Truncate(program, kProgramBits);
+    key = (key << kMaterialBits) | Truncate(material, kMaterialBits);
+    key = (key << kMeshBits) | Truncate(mesh, kMeshBits);
+    key = (key << kDepthBits) | QuantizeDepth(depth);
+    return key;
+}
+
+void SortDrawItems(std::span<DrawItem> items, std::vector<DrawItem>& scratch)
+{
+    if (items.size() < kInsertionSortThreshold)
+    {
+        InsertionSort(items);
+        return;
+    }
+    // All the histograms are built in a single pass over the keys.
+    std::array<std::array<std::uint32_t, 256>, 8> histograms = {};
+    for (const auto& item : items)
+    {
+        for (std::size_t digit = 0; digit < 8; ++digit)
+        {
+            ++histograms[digit][(item.key >> (digit * 8)) & 0xff];
+        }
+    }
+    scratch.resize(items.size());
+    std::span<DrawItem> source = items;
+    std::span<DrawItem> destination = scratch;
+    for (std::size_t digit = 0; digit < 8; ++digit)
+    {
+        auto& histogram = histograms[digit];
+        const std::uint32_t first_bucket =
+            (items.front().key >> (digit * 8)) & 0xff;
+        // Every key shares this digit, the pass would be a copy.
+        if (histogram[first_bucket] == items.size())
+            continue;
+        std::uint32_t offset = 0;
+        for (auto& count : histogram)
+        {
+            const std::uint32_t bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+        for (const auto& item : source)
+        {
+            destination[histogram[(item.key >> (digit * 8)) & 0xff]++] = item;
+        }
+        std::swap(source, destination);
+    }
+    if (source.data() != items.data())
+    {
+        std::copy(source.begin(), source.end(), items.begin());
+    }
+}
+
+void RenderQueue::Sort(std::size_t begin, std::size_t end)
+{
+    end = std::min(end, items_.size());
+    if (begin + 1 >= end)
+        return;
+    SortDrawItems(
+        std::span<DrawItem>(items_).subspan(begin, end - begin), scratch_);
+}
+
+} // End namespace frame.
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace frame
+{
+
+/**
+ * @class DrawItem
+ * @brief Entry of the render queue, the key is the sort order and the index
+ *        refers to the caller draw list.
+ */
+struct DrawItem
+{
+    std::uint64_t key = 0;
+    std::uint32_t index = 0;
+};
+
+/**
+ * @brief Build a sort key, from the most to the least significant bits:
+ *        target (10 bits), program (12 bits), material (12 bits), mesh (14
+ *        bits) and depth (16 bits). Ids are truncated to their bit width,
+ *        collisions only make the sort less efficient.
+ * @param target: Id of the render target (first output texture or 0).
+ * @param program: Id of the program.
+ * @param material: Id of the material.
+ * @param mesh: Id of the mesh.
+ * @param depth: View space distance (negative is clamped to 0), so draws
+ *        sharing the same state are sorted front to back.
+ * @return The key.
+ */
+std::uint64_t MakeDrawKey(
+    std::uint64_t target,
+    std::uint64_t program,
+    std::uint64_t material,
+    std::uint64_t mesh,
+    float depth);
+
+/**
+ * @brief Stable LSD radix sort of draw items on their keys (8 bits per pass,
+ *        passes where every key has the same digit are skipped).
+ * @param items: Items to be sorted in place.
+ * @param scratch: Scratch buffer (resized as needed, kept by the caller to
+ *        avoid reallocations).
+ */
+void SortDrawItems(std::span<DrawItem> items, std::vector<DrawItem>& scratch);
+
+/**
+ * @class RenderQueue
+ * @brief Per pass list of draw items, cleared and refilled every frame (the
+ *        buffers keep their capacity).
+ */
+class RenderQueue
+{
+  public:
+    //! @brief Remove all the items (keeps the memory).
+    void Clear()
+    {
+        items_.clear();
+    }
+    /**
+     * @brief Add an item.
+     * @param key: Sort key (see MakeDrawKey).
+     * @param index: Index in the caller draw list.
+     */
+    void Push(std::uint64_t key, std::uint32_t index)
+    {
+        items_.push_back({key, index});
+    }
+    /**
+     * @brief Sort a range of items, items outside of it keep their place
+     *        (used to keep order dependent draws as barriers).
+     * @param begin: First item of the range.
+     * @param end: One past the last item of the range.
+     */
+    void Sort(std::size_t begin, std::size_t end);
+    //! @brief Sort all the items.
+    void Sort()
+    {
+        Sort(0, items_.size());
+    }
+    /**
+     * @brief Get the items.
+     * @return The items in their current order.
+     */
+    std::span<const DrawItem> GetItems() const
+    {
+        return items_;
+    }
+
+  private:
+    std::vector<DrawItem> items_;
+    std::vector<DrawItem> scratch_;
+};
+
+} // End namespace frame.
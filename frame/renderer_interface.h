@@ -5,6 +5,7 @@
 #include <optional>
 
 #include "frame/camera_interface.h"
+#include "frame/frustum.h"
 #include "frame/material_interface.h"
 #include "frame/mesh_interface.h"
 
@@ -107,6 +108,11 @@ struct RendererInterface
      * @param callback: The callback to be added to the render.
      */
     virtual void SetMeshRenderCallback(RenderCallback callback) = 0;
+    /**
+     * @brief Get the frustum culling statistics of the last scene pass.
+     * @return Count of drawn and culled node/material pairs.
+     */
+    virtual CullingStats GetCullingStats() const = 0;
 };
 
 } // End namespace frame.
@@ -85,6 +85,11 @@ Uniform::Uniform(const UniformInterface& uniform_interface)
     data_ = uniform_interface.ToProto();
 }
 
+Uniform::Uniform(const UniformValue& uniform_value)
+{
+    data_ = UniformValueToProto(uniform_value);
+}
+
 Uniform::Uniform(
     const std::string& name,
     const proto::Uniform::UniformEnum& proto_uniform_enum)
@@ -4,6 +4,7 @@
 #include "frame/json/proto.h"
 #include "frame/serialize.h"
 #include "frame/uniform_interface.h"
+#include "frame/uniform_value.h"
 #include <glm/glm.hpp>
 
 namespace frame
@@ -49,6 +50,11 @@ class Uniform : public UniformInterface
      * @param uniform_interface: The uniform interface to copy.
      */
     Uniform(const UniformInterface& uniform_interface);
+    /**
+     * @brief Constructor from a runtime value (serialization).
+     * @param uniform_value: The value to convert.
+     */
+    explicit Uniform(const UniformValue& uniform_value);
 
     /**
      * @brief Get the enum stored in this uniform.
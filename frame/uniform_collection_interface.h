@@ -3,9 +3,11 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
 #include <memory>
+#include <span>
 #include <vector>
 #include <string>
 #include "uniform_interface.h"
+#include "frame/uniform_value.h"
 
 namespace frame
 {
@@ -43,6 +45,17 @@ class UniformCollectionInterface
      * @return The uniform names.
      */
     virtual std::vector<std::string> GetUniformNames() const = 0;
+    /**
+     * @brief Set a runtime value, replace the uniform with the same name.
+     * @param uniform_value: The value to set.
+     */
+    virtual void AddUniformValue(const UniformValue& uniform_value) = 0;
+    /**
+     * @brief Get the uniforms as runtime values, the ones without a payload
+     *        (type INVALID) are only available through GetUniform.
+     * @return The values (valid until the collection is modified).
+     */
+    virtual std::span<const UniformValue> GetUniformValues() const = 0;
 };
 
 } // End namespace frame.
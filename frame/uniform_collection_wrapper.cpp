@@ -1,95 +1,169 @@
 #include "frame/uniform_collection_wrapper.h"
 #include "frame/uniform.h"
 
+#include <algorithm>
 #include "frame/node_matrix.h"
 #include <glm/gtc/matrix_inverse.hpp>
 
 namespace frame
 {
 
+namespace
+{
+
+// Names of the uniforms set for every draw, interned once.
+struct DefaultUniformNames
+{
+    UniformNameId projection = InternUniformName("projection");
+    UniformNameId view = InternUniformName("view");
+    UniformNameId model = InternUniformName("model");
+    UniformNameId time = InternUniformName("time");
+    UniformNameId time_s = InternUniformName("time_s");
+    UniformNameId camera_position = InternUniformName("camera_position");
+    UniformNameId projection_inv = InternUniformName("projection_inv");
+    UniformNameId view_inv = InternUniformName("view_inv");
+    UniformNameId model_inv = InternUniformName("model_inv");
+};
+
+const DefaultUniformNames& GetDefaultUniformNames()
+{
+    static const DefaultUniformNames names;
+    return names;
+}
+
+// Find an entry by name in a flat list of (name id, uniform).
+template <typename Entries>
+auto FindProto(Entries& entries, UniformNameId name_id)
+{
+    return std::find_if(
+        entries.begin(), entries.end(), [name_id](const auto& entry) {
+            return entry.first == name_id;
+        });
+}
+
+} // namespace
+
 UniformCollectionWrapper::UniformCollectionWrapper(
     const glm::mat4& projection,
     const glm::mat4& view,
     const glm::mat4& model,
     double time)
 {
+    values_.reserve(16);
+    Reset(projection, view, model, time);
+}
+
+void UniformCollectionWrapper::Reset(
+    const glm::mat4& projection,
+    const glm::mat4& view,
+    const glm::mat4& model,
+    double time)
+{
+    values_.clear();
+    protos_.clear();
+    const auto& names = GetDefaultUniformNames();
     glm::mat4 projection_inv = glm::inverse(projection);
     glm::mat4 view_inv = glm::inverse(view);
     glm::mat4 model_inv = glm::inverse(model);
-
-    std::unique_ptr<Uniform> uniform_projection =
-        std::make_unique<Uniform>("projection", projection);
-    std::unique_ptr<Uniform> uniform_view =
-        std::make_unique<Uniform>("view", view);
-    std::unique_ptr<Uniform> uniform_model =
-        std::make_unique<Uniform>("model", model);
-    std::unique_ptr<Uniform> uniform_time =
-        std::make_unique<Uniform>("time", static_cast<float>(time));
-    std::unique_ptr<Uniform> uniform_time_s =
-        std::make_unique<Uniform>("time_s", static_cast<float>(time));
     glm::vec3 camera_position = glm::vec3(view_inv[3]);
-    std::unique_ptr<Uniform> uniform_camera_position =
-        std::make_unique<Uniform>("camera_position", camera_position);
+
+    AddUniformValue({names.projection, projection});
+    AddUniformValue({names.view, view});
+    AddUniformValue({names.model, model});
+    AddUniformValue({names.time, static_cast<float>(time)});
+    AddUniformValue({names.time_s, static_cast<float>(time)});
+    AddUniformValue({names.camera_position, camera_position});
     // Provide inverse matrices so shaders can reconstruct rays without
     // computing matrix inverses per-fragment.
-    std::unique_ptr<Uniform> uniform_projection_inv =
-        std::make_unique<Uniform>("projection_inv", projection_inv);
-    std::unique_ptr<Uniform> uniform_view_inv =
-        std::make_unique<Uniform>("view_inv", view_inv);
-    std::unique_ptr<Uniform> uniform_model_inv =
-        std::make_unique<Uniform>("model_inv", model_inv);
-
-    AddUniform(std::move(uniform_projection));
-    AddUniform(std::move(uniform_view));
-    AddUniform(std::move(uniform_model));
-    AddUniform(std::move(uniform_time));
-    AddUniform(std::move(uniform_time_s));
-    AddUniform(std::move(uniform_camera_position));
-    AddUniform(std::move(uniform_projection_inv));
-    AddUniform(std::move(uniform_view_inv));
-    AddUniform(std::move(uniform_model_inv));
+    AddUniformValue({names.projection_inv, projection_inv});
+    AddUniformValue({names.view_inv, view_inv});
+    AddUniformValue({names.model_inv, model_inv});
 }
 
 const UniformInterface& UniformCollectionWrapper::GetUniform(
     const std::string& name) const
 {
-    auto it = value_map_.find(name);
-    if (it != value_map_.end())
+    const auto name_id = InternUniformName(name);
+    auto it = std::find_if(
+        values_.begin(), values_.end(), [name_id](const UniformValue& value) {
+            return value.GetNameId() == name_id;
+        });
+    if (it == values_.end())
+    {
+        throw std::runtime_error("Uniform not found");
+    }
+    if (it->GetType() == UniformValueType::INVALID)
+    {
+        return *FindProto(protos_, name_id)->second;
+    }
+    auto cached = FindProto(proto_cache_, name_id);
+    if (cached == proto_cache_.end())
     {
-        return *(it->second);
+        proto_cache_.emplace_back(name_id, std::make_unique<Uniform>(*it));
+        return *proto_cache_.back().second;
     }
-    throw std::runtime_error("Uniform not found");
+    cached->second->FromProto(UniformValueToProto(*it));
+    return *cached->second;
 }
 
+
 void UniformCollectionWrapper::AddUniform(
     std::unique_ptr<UniformInterface>&& uniform)
 {
-    auto it = value_map_.find(uniform->GetName());
-    if (it != value_map_.end())
+    if (auto maybe_value = UniformValueFromProto(uniform->GetData()))
+    {
+        AddUniformValue(*maybe_value);
+        return;
+    }
+    const auto name_id = InternUniformName(uniform->GetName());
+    AddUniformValue(UniformValue::MakeInvalid(name_id));
+    protos_.emplace_back(name_id, std::move(uniform));
+}
+
+void UniformCollectionWrapper::AddUniformValue(
+    const UniformValue& uniform_value)
+{
+    auto proto = FindProto(protos_, uniform_value.GetNameId());
+    if (proto != protos_.end())
     {
-        it->second = std::move(uniform);
+        protos_.erase(proto);
     }
-    else
+    for (auto& value : values_)
     {
-        value_map_[uniform->GetName()] = std::move(uniform);
+        if (value.GetNameId() == uniform_value.GetNameId())
+        {
+            value = uniform_value;
+            return;
+        }
     }
+    values_.push_back(uniform_value);
 }
 
 void UniformCollectionWrapper::RemoveUniform(const std::string& name)
 {
-    auto it = value_map_.find(name);
-    if (it != value_map_.end())
+    const auto name_id = InternUniformName(name);
+    std::erase_if(values_, [name_id](const UniformValue& value) {
+        return value.GetNameId() == name_id;
+    });
+    auto proto = FindProto(protos_, name_id);
+    if (proto != protos_.end())
+    {
+        protos_.erase(proto);
+    }
+    auto cached = FindProto(proto_cache_, name_id);
+    if (cached != proto_cache_.end())
     {
-        value_map_.erase(it);
+        proto_cache_.erase(cached);
     }
 }
 
 std::vector<std::string> UniformCollectionWrapper::GetUniformNames() const
 {
     std::vector<std::string> names;
-    for (const auto& pair : value_map_)
+    names.reserve(values_.size());
+    for (const auto& value : values_)
     {
-        names.push_back(pair.first);
+        names.push_back(value.GetName());
     }
     return names;
 }
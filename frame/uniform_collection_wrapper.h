@@ -11,7 +11,10 @@ namespace frame
  * @brief Get access to essential part of the rendering uniform system.
  *
  * This class is to be passed to the rendering system to be able to get the
- * enum uniform.
+ * enum uniform. Uniforms are kept as runtime values, a proto is only built
+ * when a uniform is requested through GetUniform. The storage is flat and
+ * kept by Reset so a collection reused between draws stops allocating once
+ * it has seen the largest draw.
  */
 class UniformCollectionWrapper : public UniformCollectionInterface
 {
@@ -31,6 +34,19 @@ class UniformCollectionWrapper : public UniformCollectionInterface
         double dt);
 
   public:
+    /**
+     * @brief Remove all the uniforms (keep the storage) and set the default
+     *        ones, same as constructing a new collection.
+     * @param projection: Projection matrix.
+     * @param view: View matrix.
+     * @param model: Model matrix.
+     * @param dt: Time.
+     */
+    void Reset(
+        const glm::mat4& projection,
+        const glm::mat4& view,
+        const glm::mat4& model,
+        double dt);
     /**
      * @brief Get the uniform.
      * @return The uniform.
@@ -51,9 +67,29 @@ class UniformCollectionWrapper : public UniformCollectionInterface
      * @return The uniform names.
      */
     std::vector<std::string> GetUniformNames() const override;
+    /**
+     * @brief Set a runtime value, replace the uniform with the same name.
+     * @param uniform_value: The value to set.
+     */
+    void AddUniformValue(const UniformValue& uniform_value) override;
+    /**
+     * @brief Get the uniforms as runtime values.
+     * @return The values in insertion order.
+     */
+    std::span<const UniformValue> GetUniformValues() const override
+    {
+        return values_;
+    }
 
   private:
-    std::map<std::string, std::unique_ptr<UniformInterface>> value_map_ = {};
+    using ProtoEntry =
+        std::pair<UniformNameId, std::unique_ptr<UniformInterface>>;
+
+    std::vector<UniformValue> values_ = {};
+    // Uniforms without a plain payload (arrays, enums).
+    std::vector<ProtoEntry> protos_ = {};
+    // Protos built on demand by GetUniform, kept by Reset and overwritten.
+    mutable std::vector<ProtoEntry> proto_cache_ = {};
 };
 
 } // End namespace frame.
@@ -0,0 +1,242 @@
+#include "frame/uniform_value.h"
+
+#include <cstring>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "frame/json/parse_uniform.h"
+#include "frame/json/serialize_uniform.h"
+
+namespace frame
+{
+
+namespace
+{
+
+class UniformNameTable
+{
+  public:
+    UniformNameTable()
+    {
+        // Id 0 is the empty name.
+        Intern("");
+    }
+    UniformNameId Intern(std::string_view name)
+    {
+        std::scoped_lock lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end())
+        {
+            return it->second;
+        }
+        const auto id = static_cast<UniformNameId>(names_.size());
+        // Deque elements never move, the key views stay valid.
+        const auto& stored = names_.emplace_back(name);
+        ids_.emplace(stored, id);
+        return id;
+    }
+    const std::string& GetName(UniformNameId name_id)
+    {
+        std::scoped_lock lock(mutex_);
+        if (name_id >= names_.size())
+        {
+            throw std::runtime_error(
+                std::format("Unknown uniform name id #{}.", name_id));
+        }
+        return names_[name_id];
+    }
+
+  private:
+    std::mutex mutex_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, UniformNameId> ids_;
+};
+
+UniformNameTable& GetUniformNameTable()
+{
+    static UniformNameTable table;
+    return table;
+}
+
+} // namespace
+
+UniformNameId InternUniformName(std::string_view name)
+{
+    return GetUniformNameTable().Intern(name);
+}
+
+const std::string& GetUniformName(UniformNameId name_id)
+{
+    return GetUniformNameTable().GetName(name_id);
+}
+
+UniformValue::UniformValue(UniformNameId name_id, int value)
+    : name_id_(name_id), type_(UniformValueType::INT)
+{
+    payload_.int_value = value;
+}
+
+UniformValue::UniformValue(UniformNameId name_id, float value)
+    : name_id_(name_id), type_(UniformValueType::FLOAT)
+{
+    payload_.floats[0] = value;
+}
+
+UniformValue::UniformValue(UniformNameId name_id, glm::vec2 value)
+    : name_id_(name_id), type_(UniformValueType::FLOAT_VECTOR2)
+{
+    std::memcpy(payload_.floats, &value[0], sizeof(value));
+}
+
+UniformValue::UniformValue(UniformNameId name_id, glm::vec3 value)
+    : name_id_(name_id), type_(UniformValueType::FLOAT_VECTOR3)
+{
+    std::memcpy(payload_.floats, &value[0], sizeof(value));
+}
+
+UniformValue::UniformValue(UniformNameId name_id, glm::vec4 value)
+    : name_id_(name_id), type_(UniformValueType::FLOAT_VECTOR4)
+{
+    std::memcpy(payload_.floats, &value[0], sizeof(value));
+}
+
+UniformValue::UniformValue(UniformNameId name_id, const glm::mat4& value)
+    : name_id_(name_id), type_(UniformValueType::FLOAT_MATRIX4)
+{
+    std::memcpy(payload_.floats, &value[0][0], sizeof(value));
+}
+
+UniformValue UniformValue::MakeInvalid(UniformNameId name_id)
+{
+    UniformValue value;
+    value.name_id_ = name_id;
+    return value;
+}
+
+glm::vec2 UniformValue::GetVector2() const
+{
+    glm::vec2 value;
+    std::memcpy(&value[0], payload_.floats, sizeof(value));
+    return value;
+}
+
+glm::vec3 UniformValue::GetVector3() const
+{
+    glm::vec3 value;
+    std::memcpy(&value[0], payload_.floats, sizeof(value));
+    return value;
+}
+
+glm::vec4 UniformValue::GetVector4() const
+{
+    glm::vec4 value;
+    std::memcpy(&value[0], payload_.floats, sizeof(value));
+    return value;
+}
+
+glm::mat4 UniformValue::GetMatrix4() const
+{
+    glm::mat4 value;
+    std::memcpy(&value[0][0], payload_.floats, sizeof(value));
+    return value;
+}
+
+bool UniformValue::SameValue(const UniformValue& other) const
+{
+    if (type_ != other.type_)
+        return false;
+    switch (type_)
+    {
+    case UniformValueType::INT:
+        return payload_.int_value == other.payload_.int_value;
+    case UniformValueType::FLOAT:
+        return payload_.floats[0] == other.payload_.floats[0];
+    case UniformValueType::FLOAT_VECTOR2:
+        return GetVector2() == other.GetVector2();
+    case UniformValueType::FLOAT_VECTOR3:
+        return GetVector3() == other.GetVector3();
+    case UniformValueType::FLOAT_VECTOR4:
+        return GetVector4() == other.GetVector4();
+    case UniformValueType::FLOAT_MATRIX4:
+        return std::memcmp(
+                   payload_.floats,
+                   other.payload_.floats,
+                   sizeof(payload_.floats)) == 0;
+    default:
+        return false;
+    }
+}
+
+std::optional<UniformValue> UniformValueFromProto(
+    const proto::Uniform& uniform)
+{
+    const auto name_id = InternUniformName(uniform.name());
+    switch (uniform.value_oneof_case())
+    {
+    case proto::Uniform::kUniformInt:
+        return UniformValue(name_id, uniform.uniform_int());
+    case proto::Uniform::kUniformFloat:
+        return UniformValue(name_id, uniform.uniform_float());
+    case proto::Uniform::kUniformVec2:
+        return UniformValue(
+            name_id, json::ParseUniform(uniform.uniform_vec2()));
+    case proto::Uniform::kUniformVec3:
+        return UniformValue(
+            name_id, json::ParseUniform(uniform.uniform_vec3()));
+    case proto::Uniform::kUniformVec4:
+        return UniformValue(
+            name_id, json::ParseUniform(uniform.uniform_vec4()));
+    case proto::Uniform::kUniformMat4:
+        return UniformValue(
+            name_id, json::ParseUniform(uniform.uniform_mat4()));
+    default:
+        return std::nullopt;
+    }
+}
+
+proto::Uniform UniformValueToProto(const UniformValue& value)
+{
+    proto::Uniform uniform;
+    uniform.set_name(value.GetName());
+    uniform.set_uniform_enum(proto::Uniform::INVALID_UNIFORM);
+    switch (value.GetType())
+    {
+    case UniformValueType::INT:
+        uniform.set_type(proto::Uniform::INT);
+        uniform.set_uniform_int(value.GetInt());
+        break;
+    case UniformValueType::FLOAT:
+        uniform.set_type(proto::Uniform::FLOAT);
+        uniform.set_uniform_float(value.GetFloat());
+        break;
+    case UniformValueType::FLOAT_VECTOR2:
+        uniform.set_type(proto::Uniform::FLOAT_VECTOR2);
+        *uniform.mutable_uniform_vec2() =
+            json::SerializeUniformVector2(value.GetVector2());
+        break;
+    case UniformValueType::FLOAT_VECTOR3:
+        uniform.set_type(proto::Uniform::FLOAT_VECTOR3);
+        *uniform.mutable_uniform_vec3() =
+            json::SerializeUniformVector3(value.GetVector3());
+        break;
+    case UniformValueType::FLOAT_VECTOR4:
+        uniform.set_type(proto::Uniform::FLOAT_VECTOR4);
+        *uniform.mutable_uniform_vec4() =
+            json::SerializeUniformVector4(value.GetVector4());
+        break;
+    case UniformValueType::FLOAT_MATRIX4:
+        uniform.set_type(proto::Uniform::FLOAT_MATRIX4);
+        *uniform.mutable_uniform_mat4() =
+            json::SerializeUniformMatrix4(value.GetMatrix4());
+        break;
+    default:
+        uniform.set_type(proto::Uniform::INVALID_TYPE);
+        break;
+    }
+    return uniform;
+}
+
+} // End namespace frame.
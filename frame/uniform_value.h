@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+
+#include "frame/json/proto.h"
+
+namespace frame
+{
+
+//! @brief Interned uniform name (see InternUniformName), 0 is the empty name.
+using UniformNameId = std::uint32_t;
+
+/**
+ * @brief Get the id of a uniform name, the same name always gives the same id
+ *        for the lifetime of the process (thread safe).
+ * @param name: Name of the uniform.
+ * @return The id of the name.
+ */
+UniformNameId InternUniformName(std::string_view name);
+/**
+ * @brief Get the name of an interned id.
+ * @param name_id: Id returned by InternUniformName.
+ * @return The name (the reference stays valid).
+ */
+const std::string& GetUniformName(UniformNameId name_id);
+
+/**
+ * @brief Type of the payload of a uniform value.
+ */
+enum class UniformValueType : std::uint8_t
+{
+    //! No payload, the uniform only exists as a proto (arrays, enums).
+    INVALID = 0,
+    INT = 1,
+    FLOAT = 2,
+    FLOAT_VECTOR2 = 3,
+    FLOAT_VECTOR3 = 4,
+    FLOAT_VECTOR4 = 5,
+    FLOAT_MATRIX4 = 6,
+};
+
+/**
+ * @class UniformValue
+ * @brief Runtime uniform: interned name and a plain payload tagged by its
+ *        type, no allocation. This is what the renderers move around per
+ *        draw, the proto (see Uniform) is only built to serialize.
+ */
+class UniformValue
+{
+  public:
+    //! @brief Default constructor (invalid value).
+    UniformValue() = default;
+    /**
+     * @brief Constructors.
+     * @param name_id: Interned name of the uniform.
+     * @param value: The value of the uniform.
+     */
+    UniformValue(UniformNameId name_id, int value);
+    UniformValue(UniformNameId name_id, float value);
+    UniformValue(UniformNameId name_id, glm::vec2 value);
+    UniformValue(UniformNameId name_id, glm::vec3 value);
+    UniformValue(UniformNameId name_id, glm::vec4 value);
+    UniformValue(UniformNameId name_id, const glm::mat4& value);
+    /**
+     * @brief Value without payload (only a name).
+     * @param name_id: Interned name of the uniform.
+     * @return A value of type INVALID.
+     */
+    static UniformValue MakeInvalid(UniformNameId name_id);
+
+  public:
+    UniformNameId GetNameId() const
+    {
+        return name_id_;
+    }
+    UniformValueType GetType() const
+    {
+        return type_;
+    }
+    //! @brief Name of the uniform (from the intern table).
+    const std::string& GetName() const
+    {
+        return GetUniformName(name_id_);
+    }
+    int GetInt() const
+    {
+        return payload_.int_value;
+    }
+    float GetFloat() const
+    {
+        return payload_.floats[0];
+    }
+    glm::vec2 GetVector2() const;
+    glm::vec3 GetVector3() const;
+    glm::vec4 GetVector4() const;
+    glm::mat4 GetMatrix4() const;
+    /**
+     * @brief Get the raw floats of a float payload (column major for the
+     *        matrix), usable with the glUniform*fv functions.
+     * @return Pointer to the first float.
+     */
+    const float* GetFloats() const
+    {
+        return payload_.floats;
+    }
+    /**
+     * @brief Compare type and payload (not the name).
+     * @param other: Value to compare with.
+     * @return True if they would upload the same data.
+     */
+    bool SameValue(const UniformValue& other) const;
+
+  private:
+    UniformNameId name_id_ = 0;
+    UniformValueType type_ = UniformValueType::INVALID;
+    union Payload
+    {
+        std::int32_t int_value;
+        float floats[16];
+    } payload_ = {};
+};
+
+/**
+ * @brief Convert a proto uniform to a runtime value.
+ * @param uniform: Proto uniform.
+ * @return The value or nullopt if the proto has no plain payload (arrays,
+ *         enums, invalid).
+ */
+std::optional<UniformValue> UniformValueFromProto(
+    const proto::Uniform& uniform);
+/**
+ * @brief Convert a runtime value to a proto uniform (serialization).
+ * @param value: Runtime value.
+ * @return The proto uniform.
+ */
+proto::Uniform UniformValueToProto(const UniformValue& value);
+
+} // End namespace frame.
@@ -0,0 +1,117 @@
+#include "frame/vulkan/bindless_texture_table.h"
+
+#include <algorithm>
+
+namespace frame::vulkan
+{
+
+BindlessTextureTable::BindlessTextureTable(
+    vk::PhysicalDevice physical_device,
+    vk::Device device,
+    DescriptorLayoutCache& layout_cache,
+    std::uint32_t capacity)
+    : device_(device)
+{
+    const auto properties = physical_device.getProperties2<
+        vk::PhysicalDeviceProperties2,
+        vk::PhysicalDeviceVulkan12Properties>();
+    const auto& limits =
+        properties.get<vk::PhysicalDeviceVulkan12Properties>();
+    capacity_ = std::min(
+        {capacity,
+         limits.maxDescriptorSetUpdateAfterBindSampledImages,
+         limits.maxDescriptorSetUpdateAfterBindSamplers,
+         limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+         limits.maxPerStageDescriptorUpdateAfterBindSamplers});
+
+    const vk::DescriptorSetLayoutBinding binding(
+        kBinding,
+        vk::DescriptorType::eCombinedImageSampler,
+        capacity_,
+        vk::ShaderStageFlagBits::eAllGraphics |
+            vk::ShaderStageFlagBits::eCompute);
+    // Unused slots stay unwritten, and textures are added while the set is
+    // bound by frames in flight.
+    const vk::DescriptorBindingFlags binding_flags =
+        vk::DescriptorBindingFlagBits::ePartiallyBound |
+        vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+    layout_ = layout_cache.Get(
+        {&binding, 1},
+        vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+        {&binding_flags, 1});
+
+    const vk::DescriptorPoolSize pool_size(
+        vk::DescriptorType::eCombinedImageSampler, capacity_);
+    pool_ = device_.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo(
+        vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind, 1, 1, &pool_size));
+    set_ = device_
+               .allocateDescriptorSets(
+                   vk::DescriptorSetAllocateInfo(*pool_, 1, &layout_))
+               .front();
+}
+
+bool BindlessTextureTable::IsSupported(
+    const vk::PhysicalDeviceVulkan12Features& features)
+{
+    return features.runtimeDescriptorArray &&
+           features.descriptorBindingPartiallyBound &&
+           features.descriptorBindingSampledImageUpdateAfterBind &&
+           features.descriptorBindingUpdateUnusedWhilePending &&
+           features.shaderSampledImageArrayNonUniformIndexing;
+}
+
+void BindlessTextureTable::EnableFeatures(
+    vk::PhysicalDeviceVulkan12Features& features)
+{
+    features.descriptorIndexing = VK_TRUE;
+    features.runtimeDescriptorArray = VK_TRUE;
+    features.descriptorBindingPartiallyBound = VK_TRUE;
+    features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+}
+
+std::uint32_t BindlessTextureTable::Add(
+    const vk::DescriptorImageInfo& image_info)
+{
+    std::uint32_t index = 0;
+    if (!free_indices_.empty())
+    {
+        index = free_indices_.back();
+        free_indices_.pop_back();
+    }
+    else if (count_ < capacity_)
+    {
+        index = count_++;
+    }
+    else
+    {
+        return kInvalidIndex;
+    }
+    const vk::WriteDescriptorSet write(
+        set_,
+        kBinding,
+        index,
+        1,
+        vk::DescriptorType::eCombinedImageSampler,
+        &image_info);
+    device_.updateDescriptorSets(write, nullptr);
+    return index;
+}
+
+void BindlessTextureTable::Remove(std::uint32_t index)
+{
+    if (index < count_)
+    {
+        free_indices_.push_back(index);
+    }
+}
+
+void BindlessTextureTable::Clear()
+{
+    count_ = 0;
+    free_indices_.clear();
+}
+
+} // namespace frame::vulkan
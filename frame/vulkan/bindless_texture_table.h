@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+#include "frame/vulkan/descriptor_cache.h"
+
+namespace frame::vulkan
+{
+
+// One descriptor set holding every texture of the level in a partially
+// bound sampler array (descriptor indexing), materials refer to a texture
+// by its index. Bound once, switching material does not touch the
+// descriptors. In GLSL:
+//   layout(set = 1, binding = 0) uniform sampler2D textures[];
+class BindlessTextureTable
+{
+  public:
+    static constexpr std::uint32_t kBinding = 0;
+    static constexpr std::uint32_t kInvalidIndex = ~0u;
+
+    // Requires the Vulkan 1.2 descriptor indexing features, see IsSupported.
+    BindlessTextureTable(
+        vk::PhysicalDevice physical_device,
+        vk::Device device,
+        DescriptorLayoutCache& layout_cache,
+        std::uint32_t capacity = 4096);
+    BindlessTextureTable(const BindlessTextureTable&) = delete;
+    BindlessTextureTable& operator=(const BindlessTextureTable&) = delete;
+
+    // Features the table needs, chained to the device creation.
+    static bool IsSupported(const vk::PhysicalDeviceVulkan12Features& features);
+    static void EnableFeatures(vk::PhysicalDeviceVulkan12Features& features);
+
+    // Index of the texture in the array, kInvalidIndex when it is full.
+    std::uint32_t Add(const vk::DescriptorImageInfo& image_info);
+    // The slot is reused by a later Add, nothing may sample it anymore.
+    void Remove(std::uint32_t index);
+    // Remove all (level reload).
+    void Clear();
+
+    vk::DescriptorSetLayout GetLayout() const
+    {
+        return layout_;
+    }
+    vk::DescriptorSet GetSet() const
+    {
+        return set_;
+    }
+    std::uint32_t GetCapacity() const
+    {
+        return capacity_;
+    }
+    std::uint32_t GetCount() const
+    {
+        return count_ - static_cast<std::uint32_t>(free_indices_.size());
+    }
+
+  private:
+    vk::Device device_;
+    std::uint32_t capacity_ = 0;
+    vk::DescriptorSetLayout layout_;
+    vk::UniqueDescriptorPool pool_;
+    vk::DescriptorSet set_;
+    // Slots handed out so far, and the ones given back.
+    std::uint32_t count_ = 0;
+    std::vector<std::uint32_t> free_indices_;
+};
+
+} // namespace frame::vulkan
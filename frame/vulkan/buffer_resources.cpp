@@ -4,23 +4,51 @@
 #include <cstring>
 #include <stdexcept>
 
+#include "frame/profiler.h"
+
 namespace frame::vulkan
 {
 
+namespace
+{
+
+// Largest minUniformBufferOffsetAlignment the specification allows, any
+// device accepts offsets that are multiples of it.
+constexpr vk::DeviceSize kUniformOffsetAlignment = 256;
+
+} // namespace
+
 BufferResourceManager::BufferResourceManager(
     vk::Device device,
     GpuMemoryManager& memory_manager,
     CommandQueue& command_queue,
-    const Logger& logger)
+    const Logger& logger,
+    std::size_t frame_count,
+    UploadContext* upload_context)
     : device_(device),
       memory_manager_(&memory_manager),
       command_queue_(&command_queue),
-      logger_(&logger)
+      upload_context_(upload_context),
+      logger_(&logger),
+      frame_count_(std::max<std::size_t>(frame_count, 1))
 {
+    if (frame_count > 0)
+    {
+        staging_ring_ =
+            std::make_unique<StagingRing>(memory_manager, frame_count);
+    }
 }
 
 void BufferResourceManager::Clear()
 {
+    if (upload_context_)
+    {
+        upload_context_->WaitIdle();
+    }
+    if (staging_ring_)
+    {
+        staging_ring_->DiscardCopies();
+    }
     storage_buffers_.clear();
     storage_buffer_indices_.clear();
     uniform_buffer_ = {};
@@ -31,30 +59,29 @@ BufferResource BufferResourceManager::MakeGpuBuffer(
     const std::vector<std::uint8_t>& bytes,
     vk::BufferUsageFlags extra_flags)
 {
-    vk::UniqueDeviceMemory staging_memory;
+    GpuAllocation staging_allocation;
     auto staging_buffer = memory_manager_->CreateBuffer(
         bytes.size(),
         vk::BufferUsageFlagBits::eTransferSrc,
         vk::MemoryPropertyFlagBits::eHostVisible |
             vk::MemoryPropertyFlagBits::eHostCoherent,
-        staging_memory);
+        staging_allocation,
+        GpuMemoryPool::eTransient);
 
     if (!bytes.empty())
     {
-        void* mapped = device_.mapMemory(
-            *staging_memory, 0, bytes.size());
-        std::memcpy(mapped, bytes.data(), bytes.size());
-        device_.unmapMemory(*staging_memory);
+        std::memcpy(
+            staging_allocation.GetMappedData(), bytes.data(), bytes.size());
     }
 
-    vk::UniqueDeviceMemory gpu_memory;
+    GpuAllocation gpu_allocation;
     auto gpu_buffer = memory_manager_->CreateBuffer(
         bytes.size(),
         vk::BufferUsageFlagBits::eTransferDst |
             vk::BufferUsageFlagBits::eTransferSrc |
             extra_flags,
         vk::MemoryPropertyFlagBits::eDeviceLocal,
-        gpu_memory);
+        gpu_allocation);
 
     command_queue_->CopyBuffer(*staging_buffer, *gpu_buffer, bytes.size());
 
@@ -62,7 +89,7 @@ BufferResource BufferResourceManager::MakeGpuBuffer(
     res.name = name;
     res.size = bytes.size();
     res.buffer = std::move(gpu_buffer);
-    res.memory = std::move(gpu_memory);
+    res.allocation = std::move(gpu_allocation);
     return res;
 }
 
@@ -73,7 +100,7 @@ void BufferResourceManager::BuildStorageBuffers(
     struct PendingUpload
     {
         vk::UniqueBuffer staging_buffer;
-        vk::UniqueDeviceMemory staging_memory;
+        GpuAllocation staging_allocation;
         vk::Buffer destination = VK_NULL_HANDLE;
         vk::DeviceSize size = 0;
     };
@@ -107,37 +134,44 @@ void BufferResourceManager::BuildStorageBuffers(
                 continue;
             }
 
-            PendingUpload upload{};
-            upload.staging_buffer = memory_manager_->CreateBuffer(
-                bytes.size(),
-                vk::BufferUsageFlagBits::eTransferSrc,
-                vk::MemoryPropertyFlagBits::eHostVisible |
-                    vk::MemoryPropertyFlagBits::eHostCoherent,
-                upload.staging_memory);
-
-            void* mapped = device_.mapMemory(
-                *upload.staging_memory, 0, bytes.size());
-            std::memcpy(mapped, bytes.data(), bytes.size());
-            device_.unmapMemory(*upload.staging_memory);
-
-            vk::UniqueDeviceMemory gpu_memory;
+            GpuAllocation gpu_allocation;
             auto gpu_buffer = memory_manager_->CreateBuffer(
                 bytes.size(),
                 vk::BufferUsageFlagBits::eTransferDst |
                     vk::BufferUsageFlagBits::eTransferSrc |
                     vk::BufferUsageFlagBits::eStorageBuffer,
                 vk::MemoryPropertyFlagBits::eDeviceLocal,
-                gpu_memory);
+                gpu_allocation);
 
-            upload.destination = *gpu_buffer;
-            upload.size = static_cast<vk::DeviceSize>(bytes.size());
-            pending_uploads.push_back(std::move(upload));
+            if (upload_context_)
+            {
+                upload_context_->CopyToBuffer(
+                    bytes.data(), bytes.size(), *gpu_buffer);
+            }
+            else
+            {
+                PendingUpload upload{};
+                upload.staging_buffer = memory_manager_->CreateBuffer(
+                    bytes.size(),
+                    vk::BufferUsageFlagBits::eTransferSrc,
+                    vk::MemoryPropertyFlagBits::eHostVisible |
+                        vk::MemoryPropertyFlagBits::eHostCoherent,
+                    upload.staging_allocation,
+                    GpuMemoryPool::eTransient);
+                std::memcpy(
+                    upload.staging_allocation.GetMappedData(),
+                    bytes.data(),
+                    bytes.size());
+                upload.destination = *gpu_buffer;
+                upload.size = static_cast<vk::DeviceSize>(bytes.size());
+                pending_uploads.push_back(std::move(upload));
+            }
 
             BufferResource res{};
             res.name = level.GetNameFromId(buffer_id);
             res.size = bytes.size();
             res.buffer = std::move(gpu_buffer);
-            res.memory = std::move(gpu_memory);
+            res.allocation = std::move(gpu_allocation);
             storage_buffers_.push_back(std::move(res));
             storage_buffer_indices_[storage_buffers_.back().name] =
                 storage_buffers_.size() - 1;
@@ -151,6 +185,11 @@ void BufferResourceManager::BuildStorageBuffers(
         }
     }
 
+    if (upload_context_)
+    {
+        // Waited on before the first frame, not here.
+        upload_context_->Submit();
+    }
     if (!pending_uploads.empty())
     {
         command_queue_->SubmitOneTime(
@@ -168,6 +207,22 @@ void BufferResourceManager::BuildStorageBuffers(
     }
 }
 
+void BufferResourceManager::BeginFrame(std::size_t frame_index)
+{
+    frame_index_ = frame_index % frame_count_;
+    if (staging_ring_)
+    {
+        staging_ring_->BeginFrame(frame_index);
+    }
+}
+
+std::size_t BufferResourceManager::RecordUploads(
+    vk::CommandBuffer command_buffer)
+{
+    FRAME_PROFILE_SCOPE("Record uploads");
+    return staging_ring_ ? staging_ring_->RecordCopies(command_buffer) : 0;
+}
+
 bool BufferResourceManager::UpdateStorageBuffer(
     const std::string& name,
     const std::vector<std::uint8_t>& bytes)
@@ -195,18 +250,23 @@ bool BufferResourceManager::UpdateStorageBuffer(
             static_cast<std::size_t>(resource.size));
         return false;
     }
+    if (staging_ring_ &&
+        staging_ring_->Upload(bytes.data(), bytes.size(), *resource.buffer))
+    {
+        return true;
+    }
 
-    vk::UniqueDeviceMemory staging_memory;
+    // No ring or the frame region is full, upload and wait.
+    GpuAllocation staging_allocation;
     auto staging_buffer = memory_manager_->CreateBuffer(
         bytes.size(),
         vk::BufferUsageFlagBits::eTransferSrc,
         vk::MemoryPropertyFlagBits::eHostVisible |
             vk::MemoryPropertyFlagBits::eHostCoherent,
-        staging_memory);
-    void* mapped = device_.mapMemory(
-        *staging_memory, 0, bytes.size());
-    std::memcpy(mapped, bytes.data(), bytes.size());
-    device_.unmapMemory(*staging_memory);
+        staging_allocation,
+        GpuMemoryPool::eTransient);
+    std::memcpy(
+        staging_allocation.GetMappedData(), bytes.data(), bytes.size());
     command_queue_->CopyBuffer(
         *staging_buffer,
         *resource.buffer,
@@ -221,18 +281,20 @@ void BufferResourceManager::BuildUniformBuffer(vk::DeviceSize size_bytes)
         throw std::runtime_error("Uniform buffer size must be non-zero.");
     }
 
-    vk::UniqueDeviceMemory uniform_memory;
+    uniform_stride_ = (size_bytes + kUniformOffsetAlignment - 1) /
+                      kUniformOffsetAlignment * kUniformOffsetAlignment;
+    GpuAllocation uniform_allocation;
     auto uniform_buf = memory_manager_->CreateBuffer(
-        size_bytes,
+        uniform_stride_ * frame_count_,
         vk::BufferUsageFlagBits::eUniformBuffer,
         vk::MemoryPropertyFlagBits::eHostVisible |
             vk::MemoryPropertyFlagBits::eHostCoherent,
-        uniform_memory);
+        uniform_allocation);
 
     uniform_buffer_.name = "uniforms";
     uniform_buffer_.size = size_bytes;
     uniform_buffer_.buffer = std::move(uniform_buf);
-    uniform_buffer_.memory = std::move(uniform_memory);
+    uniform_buffer_.allocation = std::move(uniform_allocation);
 }
 
 void BufferResourceManager::UpdateUniform(
@@ -240,7 +302,7 @@ void BufferResourceManager::UpdateUniform(
     std::size_t byte_count) const
 {
     if (!uniform_buffer_.buffer ||
-        !uniform_buffer_.memory ||
+        !uniform_buffer_.allocation ||
         uniform_buffer_.size == 0)
     {
         (*logger_)->warn("Uniform buffer not initialized before update.");
@@ -254,8 +316,11 @@ void BufferResourceManager::UpdateUniform(
             static_cast<std::size_t>(uniform_buffer_.size));
         return;
     }
-    void* mapped = device_.mapMemory(
-        *uniform_buffer_.memory, 0, uniform_buffer_.size);
+    // The block is persistently mapped, the other copies may still be read
+    // by the frames in flight.
+    void* mapped = static_cast<std::uint8_t*>(
+                       uniform_buffer_.allocation.GetMappedData()) +
+                   GetUniformOffset();
     if (data && byte_count > 0)
     {
         std::memcpy(mapped, data, byte_count);
@@ -264,7 +329,6 @@ void BufferResourceManager::UpdateUniform(
     {
         std::memset(mapped, 0, uniform_buffer_.size);
     }
-    device_.unmapMemory(*uniform_buffer_.memory);
 }
 
 void BufferResourceManager::LogCpuBufferSamples(
@@ -324,20 +388,20 @@ void BufferResourceManager::LogGpuBufferSamples() const
         const vk::DeviceSize bytes_to_copy =
             std::min(res.size, sample_bytes);
 
-        vk::UniqueDeviceMemory staging_memory;
+        GpuAllocation staging_allocation;
         auto staging_buffer = memory_manager_->CreateBuffer(
             bytes_to_copy,
             vk::BufferUsageFlagBits::eTransferDst,
             vk::MemoryPropertyFlagBits::eHostVisible |
                 vk::MemoryPropertyFlagBits::eHostCoherent,
-            staging_memory);
+            staging_allocation,
+            GpuMemoryPool::eTransient);
 
         try
         {
             command_queue_->CopyBuffer(
                 *res.buffer, *staging_buffer, bytes_to_copy);
-            void* mapped = device_.mapMemory(
-                *staging_memory, 0, bytes_to_copy);
+            const void* mapped = staging_allocation.GetMappedData();
             if (mapped)
             {
                 const float* f = static_cast<const float*>(mapped);
@@ -346,7 +410,6 @@ void BufferResourceManager::LogGpuBufferSamples() const
                     res.name,
                     f[0], f[1], f[2], f[3],
                     f[4], f[5], f[6], f[7]);
-                device_.unmapMemory(*staging_memory);
             }
         }
         catch (const std::exception& ex)
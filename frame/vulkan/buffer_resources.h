@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -11,6 +12,8 @@
 #include "frame/vulkan/buffer.h"
 #include "frame/vulkan/command_queue.h"
 #include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/staging_ring.h"
+#include "frame/vulkan/upload_context.h"
 
 namespace frame::vulkan
 {
@@ -19,7 +22,7 @@ struct BufferResource
 {
     std::string name;
     vk::UniqueBuffer buffer;
-    vk::UniqueDeviceMemory memory;
+    GpuAllocation allocation;
     vk::DeviceSize size = 0;
 };
 
@@ -30,17 +33,31 @@ class BufferResourceManager
         vk::Device device,
         GpuMemoryManager& memory_manager,
         CommandQueue& command_queue,
-        const Logger& logger);
+        const Logger& logger,
+        std::size_t frame_count = 0,
+        UploadContext* upload_context = nullptr);
 
     void Clear();
+    // With frames in flight, storage buffer updates go through a staging
+    // ring and are copied by the frame command buffer. BeginFrame has to be
+    // called once the fence of the frame has been waited on.
+    void BeginFrame(std::size_t frame_index);
+    std::size_t RecordUploads(vk::CommandBuffer command_buffer);
     void BuildStorageBuffers(
         LevelInterface& level,
         const std::vector<EntityId>& buffer_ids);
     bool UpdateStorageBuffer(
         const std::string& name,
         const std::vector<std::uint8_t>& bytes);
+    // One copy of the uniform block per frame in flight, bound as a dynamic
+    // uniform buffer: UpdateUniform writes the copy of the frame given to
+    // BeginFrame and GetUniformOffset is its dynamic offset.
     void BuildUniformBuffer(vk::DeviceSize size_bytes);
     void UpdateUniform(const void* data, std::size_t byte_count) const;
+    std::uint32_t GetUniformOffset() const
+    {
+        return static_cast<std::uint32_t>(uniform_stride_ * frame_index_);
+    }
 
     const std::vector<BufferResource>& GetStorageBuffers() const
     {
@@ -66,10 +83,16 @@ class BufferResourceManager
     vk::Device device_;
     GpuMemoryManager* memory_manager_;
     CommandQueue* command_queue_;
+    UploadContext* upload_context_;
     const Logger* logger_;
     std::vector<BufferResource> storage_buffers_;
     std::unordered_map<std::string, std::size_t> storage_buffer_indices_;
+    // size is the one of a copy, the copies are uniform_stride_ apart.
     BufferResource uniform_buffer_;
+    vk::DeviceSize uniform_stride_ = 0;
+    std::size_t frame_count_ = 1;
+    std::size_t frame_index_ = 0;
+    std::unique_ptr<StagingRing> staging_ring_;
 };
 
 } // namespace frame::vulkan
@@ -5,6 +5,7 @@
 
 #include "frame/level.h"
 #include "frame/logger.h"
+#include "frame/profiler.h"
 #include "frame/json/program_catalog.h"
 #include "frame/vulkan/scoped_timer.h"
 #include "frame/vulkan/json/parse_material.h"
@@ -168,6 +169,7 @@ BuiltLevel BuildLevel(
     const frame::json::LevelData& level_data)
 {
     auto& logger = frame::Logger::GetInstance();
+    FRAME_PROFILE_SCOPE("Vulkan BuildLevel");
     ScopedTimer total_timer(logger, "Vulkan BuildLevel");
 
     BuiltLevel built;
@@ -176,6 +178,7 @@ BuiltLevel BuildLevel(
     level->SetDefaultTextureName(level_data.proto.default_texture_name());
 
     {
+        FRAME_PROFILE_SCOPE("Create default meshes");
         ScopedTimer timer(logger, "Create default meshes");
         auto cube_id = CreateCubeStaticMesh(*level);
         if (!cube_id)
@@ -193,6 +196,7 @@ BuiltLevel BuildLevel(
     }
 
     {
+        FRAME_PROFILE_SCOPE("Parse textures");
         ScopedTimer timer(logger, "Parse textures");
         for (const auto& proto_texture : level_data.proto.textures())
         {
@@ -217,6 +221,7 @@ BuiltLevel BuildLevel(
     }
 
     {
+        FRAME_PROFILE_SCOPE("Parse programs");
         ScopedTimer timer(logger, "Parse programs");
         for (const auto& proto_program : level_data.proto.programs())
         {
@@ -232,6 +237,7 @@ BuiltLevel BuildLevel(
     }
 
     {
+        FRAME_PROFILE_SCOPE("Parse materials");
         ScopedTimer timer(logger, "Parse materials");
         for (const auto& proto_material : level_data.proto.materials())
         {
@@ -254,6 +260,7 @@ BuiltLevel BuildLevel(
     ConfigureRenderPassPrograms(*level, level_data.proto);
 
     {
+        FRAME_PROFILE_SCOPE("Parse scene tree");
         ScopedTimer timer(logger, "Parse scene tree");
         if (!json::ParseSceneTree(level_data.proto.scene_tree(), *level))
         {
@@ -0,0 +1,157 @@
+#include "frame/vulkan/descriptor_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace frame::vulkan
+{
+
+namespace
+{
+
+// Share of each descriptor type in a pool, per set.
+constexpr std::array<std::pair<vk::DescriptorType, std::uint32_t>, 5>
+    kPoolRatios = {{
+        {vk::DescriptorType::eCombinedImageSampler, 8},
+        {vk::DescriptorType::eStorageImage, 2},
+        {vk::DescriptorType::eStorageBuffer, 8},
+        {vk::DescriptorType::eUniformBuffer, 2},
+        {vk::DescriptorType::eUniformBufferDynamic, 2},
+    }};
+
+} // namespace
+
+DescriptorLayoutCache::DescriptorLayoutCache(vk::Device device)
+    : device_(device)
+{
+}
+
+vk::DescriptorSetLayout DescriptorLayoutCache::Get(
+    std::span<const vk::DescriptorSetLayoutBinding> bindings,
+    vk::DescriptorSetLayoutCreateFlags flags,
+    std::span<const vk::DescriptorBindingFlags> binding_flags)
+{
+    if (!binding_flags.empty() && binding_flags.size() != bindings.size())
+    {
+        throw std::runtime_error(
+            "Descriptor binding flags do not match the bindings.");
+    }
+    // Sorted by binding, the declaration order does not matter.
+    std::vector<std::size_t> order(bindings.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::ranges::sort(order, {}, [&bindings](std::size_t i) {
+        return bindings[i].binding;
+    });
+    std::vector<std::uint32_t> key;
+    key.reserve(1 + order.size() * 5);
+    key.push_back(static_cast<std::uint32_t>(flags));
+    for (const std::size_t i : order)
+    {
+        key.push_back(bindings[i].binding);
+        key.push_back(static_cast<std::uint32_t>(bindings[i].descriptorType));
+        key.push_back(bindings[i].descriptorCount);
+        key.push_back(static_cast<std::uint32_t>(bindings[i].stageFlags));
+        key.push_back(
+            binding_flags.empty()
+                ? 0
+                : static_cast<std::uint32_t>(binding_flags[i]));
+    }
+
+    auto it = layouts_.find(key);
+    if (it != layouts_.end())
+    {
+        return *it->second;
+    }
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo flags_info(
+        static_cast<std::uint32_t>(binding_flags.size()),
+        binding_flags.data());
+    vk::DescriptorSetLayoutCreateInfo layout_info(
+        flags, static_cast<std::uint32_t>(bindings.size()), bindings.data());
+    if (!binding_flags.empty())
+    {
+        layout_info.setPNext(&flags_info);
+    }
+    auto layout = device_.createDescriptorSetLayoutUnique(layout_info);
+    const vk::DescriptorSetLayout handle = *layout;
+    layouts_.emplace(std::move(key), std::move(layout));
+    return handle;
+}
+
+std::size_t DescriptorLayoutCache::GetSize() const
+{
+    return layouts_.size();
+}
+
+DescriptorAllocator::DescriptorAllocator(vk::Device device)
+    : device_(device)
+{
+}
+
+vk::DescriptorSet DescriptorAllocator::Allocate(
+    vk::DescriptorSetLayout layout)
+{
+    if (!current_pool_)
+    {
+        current_pool_ = GrabPool();
+    }
+    vk::DescriptorSetAllocateInfo alloc_info(current_pool_, 1, &layout);
+    vk::DescriptorSet set;
+    auto result = device_.allocateDescriptorSets(&alloc_info, &set);
+    if (result == vk::Result::eErrorOutOfPoolMemory ||
+        result == vk::Result::eErrorFragmentedPool)
+    {
+        // Full, the next pool takes over (one try, a set larger than a
+        // whole pool cannot be allocated).
+        current_pool_ = GrabPool();
+        alloc_info.descriptorPool = current_pool_;
+        result = device_.allocateDescriptorSets(&alloc_info, &set);
+    }
+    if (result != vk::Result::eSuccess)
+    {
+        throw std::runtime_error(
+            "Failed to allocate a Vulkan descriptor set: " +
+            vk::to_string(result));
+    }
+    return set;
+}
+
+void DescriptorAllocator::Reset()
+{
+    for (auto& pool : used_pools_)
+    {
+        device_.resetDescriptorPool(*pool);
+        free_pools_.push_back(std::move(pool));
+    }
+    used_pools_.clear();
+    current_pool_ = nullptr;
+}
+
+vk::DescriptorPool DescriptorAllocator::GrabPool()
+{
+    if (!free_pools_.empty())
+    {
+        used_pools_.push_back(std::move(free_pools_.back()));
+        free_pools_.pop_back();
+        return *used_pools_.back();
+    }
+    std::array<vk::DescriptorPoolSize, kPoolRatios.size()> pool_sizes;
+    for (std::size_t i = 0; i < kPoolRatios.size(); ++i)
+    {
+        pool_sizes[i] = vk::DescriptorPoolSize(
+            kPoolRatios[i].first, kPoolRatios[i].second * kSetsPerPool);
+    }
+    used_pools_.push_back(
+        device_.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo(
+            {},
+            kSetsPerPool,
+            static_cast<std::uint32_t>(pool_sizes.size()),
+            pool_sizes.data())));
+    return *used_pools_.back();
+}
+
+} // namespace frame::vulkan
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+namespace frame::vulkan
+{
+
+// Descriptor set layouts keyed by their binding signature (binding, type,
+// count, stages and binding flags), programs with the same signature share
+// one layout. The layouts live as long as the cache.
+class DescriptorLayoutCache
+{
+  public:
+    explicit DescriptorLayoutCache(vk::Device device);
+    DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+    DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+    // binding_flags: empty, or one per binding (descriptor indexing).
+    vk::DescriptorSetLayout Get(
+        std::span<const vk::DescriptorSetLayoutBinding> bindings,
+        vk::DescriptorSetLayoutCreateFlags flags = {},
+        std::span<const vk::DescriptorBindingFlags> binding_flags = {});
+    std::size_t GetSize() const;
+
+  private:
+    vk::Device device_;
+    std::map<std::vector<std::uint32_t>, vk::UniqueDescriptorSetLayout>
+        layouts_;
+};
+
+// Hands out descriptor sets from pools of fixed capacity. A full pool is set
+// aside and a new one (or a reset one) takes over; Reset frees every set at
+// once and keeps the pools for the next level.
+class DescriptorAllocator
+{
+  public:
+    static constexpr std::uint32_t kSetsPerPool = 64;
+
+    explicit DescriptorAllocator(vk::Device device);
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    vk::DescriptorSet Allocate(vk::DescriptorSetLayout layout);
+    // The sets must not be in use by the GPU anymore.
+    void Reset();
+
+    std::size_t GetPoolCount() const
+    {
+        return used_pools_.size() + free_pools_.size();
+    }
+
+  private:
+    vk::DescriptorPool GrabPool();
+
+    vk::Device device_;
+    vk::DescriptorPool current_pool_;
+    std::vector<vk::UniqueDescriptorPool> used_pools_;
+    std::vector<vk::UniqueDescriptorPool> free_pools_;
+};
+
+} // namespace frame::vulkan
@@ -8,6 +8,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 #include <filesystem>
 
@@ -16,18 +17,26 @@
 
 #include "frame/bvh.h"
 #include "frame/camera.h"
+#include "frame/file/image.h"
+#include "frame/frustum.h"
+#include "frame/jobs.h"
 #include "frame/json/program_catalog.h"
 #include "frame/level.h"
 #include "frame/common/application.h"
 #include "frame/node_mesh.h"
+#include "frame/profiler.h"
+#include "frame/vulkan/bindless_texture_table.h"
 #include "frame/vulkan/buffer.h"
 #include "frame/vulkan/buffer_resources.h"
 #include "frame/vulkan/build_level.h"
 #include "frame/vulkan/command_resources.h"
 #include "frame/vulkan/command_queue.h"
+#include "frame/vulkan/descriptor_cache.h"
 #include "frame/vulkan/gpu_memory_manager.h"
 #include "frame/vulkan/mesh_resources.h"
 #include "frame/vulkan/mesh_utils.h"
+#include "frame/vulkan/parallel_command_recorder.h"
+#include "frame/vulkan/pipeline_cache.h"
 #include "frame/vulkan/scene_state.h"
 #include "frame/vulkan/scoped_timer.h"
 #include "frame/vulkan/shader_compiler.h"
@@ -35,6 +44,7 @@
 #include "frame/vulkan/sync_resources.h"
 #include "frame/vulkan/texture.h"
 #include "frame/vulkan/texture_resources.h"
+#include "frame/vulkan/upload_context.h"
 #include "frame/vulkan/skinned_mesh.h"
 #include "frame/proto/uniform.pb.h"
 #include <glm/gtc/matrix_transform.hpp>
@@ -46,6 +56,9 @@ namespace frame::vulkan
 namespace
 {
 
+// Fewer draws per secondary buffer cost more to begin than to record.
+constexpr std::size_t kMinSceneDrawsPerChunk = 16;
+
 vk::ShaderStageFlags ToShaderStageFlags(
     const frame::proto::ProgramBinding& binding)
 {
@@ -282,8 +295,11 @@ Device::Device(
             graphics_queue_index = index;
         }
 
+        // Headless (no surface) the graphics queue stands in.
         const bool supports_present =
-            vk_physical_device_.getSurfaceSupportKHR(index, vk_surface_);
+            vk_surface_
+                ? vk_physical_device_.getSurfaceSupportKHR(index, vk_surface_)
+                : supports_graphics;
         if (supports_present && !present_queue_index)
         {
             present_queue_index = index;
@@ -318,11 +334,32 @@ Device::Device(
     graphics_queue_family_index_ = graphics_queue_index.value();
     present_queue_family_index_ = present_queue_index.value();
 
+    // A transfer only family is the copy engine, uploads there run next to
+    // the graphics work.
+    transfer_queue_family_index_ = graphics_queue_family_index_;
+    for (std::uint32_t index = 0; index < queue_families.size(); ++index)
+    {
+        const auto flags = queue_families[index].queueFlags;
+        if ((flags & vk::QueueFlagBits::eTransfer) &&
+            !(flags & (vk::QueueFlagBits::eGraphics |
+                       vk::QueueFlagBits::eCompute)))
+        {
+            transfer_queue_family_index_ = index;
+            break;
+        }
+    }
+
     std::vector<std::uint32_t> unique_queue_indices = {graphics_queue_family_index_};
     if (present_queue_family_index_ != graphics_queue_family_index_)
     {
         unique_queue_indices.push_back(present_queue_family_index_);
     }
+    if (std::ranges::find(
+            unique_queue_indices, transfer_queue_family_index_) ==
+        unique_queue_indices.end())
+    {
+        unique_queue_indices.push_back(transfer_queue_family_index_);
+    }
 
     std::vector<vk::DeviceQueueCreateInfo> queue_create_infos;
     queue_create_infos.reserve(unique_queue_indices.size());
@@ -335,9 +372,13 @@ Device::Device(
             &queue_family_priority_);
     }
 
-    const std::vector<const char*> device_extensions = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-    };
+    // Headless the frames go to offscreen images, the swapchain extension
+    // is not needed (software drivers may not expose it).
+    std::vector<const char*> device_extensions;
+    if (vk_surface_)
+    {
+        device_extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
     const auto supported_features = vk_physical_device_.getFeatures();
     vk::PhysicalDeviceFeatures device_features{};
@@ -363,14 +404,37 @@ Device::Device(
         device_extensions.data());
     device_create_info.setPEnabledFeatures(&device_features);
 
+    // Descriptor indexing (core in 1.2) for the bindless texture table.
+    vk::PhysicalDeviceVulkan12Features vulkan12_features{};
+    if (vk_physical_device_.getProperties().apiVersion >= VK_API_VERSION_1_2)
+    {
+        const auto supported = vk_physical_device_.getFeatures2<
+            vk::PhysicalDeviceFeatures2,
+            vk::PhysicalDeviceVulkan12Features>();
+        bindless_supported_ = BindlessTextureTable::IsSupported(
+            supported.get<vk::PhysicalDeviceVulkan12Features>());
+    }
+    if (bindless_supported_)
+    {
+        BindlessTextureTable::EnableFeatures(vulkan12_features);
+        device_create_info.setPNext(&vulkan12_features);
+    }
+
     vk_unique_device_ = vk_physical_device_.createDeviceUnique(device_create_info);
     graphics_queue_ = vk_unique_device_->getQueue(graphics_queue_family_index_, 0);
     present_queue_ = vk_unique_device_->getQueue(present_queue_family_index_, 0);
+    transfer_queue_ =
+        vk_unique_device_->getQueue(transfer_queue_family_index_, 0);
+    pipeline_cache_ = std::make_unique<PipelineCache>(
+        vk_physical_device_,
+        *vk_unique_device_,
+        PipelineCache::GetDefaultPath(vk_physical_device_));
 
     logger_->info(
-        "Vulkan logical device created (graphics queue family {}, present queue family {}).",
+        "Vulkan logical device created (graphics queue family {}, present queue family {}, transfer queue family {}).",
         graphics_queue_family_index_,
-        present_queue_family_index_);
+        present_queue_family_index_,
+        transfer_queue_family_index_);
 }
 
 Device::~Device()
@@ -402,6 +466,7 @@ void Device::Startup(std::unique_ptr<LevelInterface>&& level)
 
 void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
 {
+    FRAME_PROFILE_SCOPE("Vulkan StartupFromLevelData");
     ScopedTimer total_timer(logger_, "Vulkan StartupFromLevelData");
 
     current_level_data_ = level_data;
@@ -414,6 +479,7 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
     // Prefer programs configured for render passes; otherwise fall back to the
     // first available program.
     {
+        FRAME_PROFILE_SCOPE("Select program");
         ScopedTimer timer(logger_, "Select program");
         auto pick_program = [&]() -> std::optional<frame::json::ProgramInfo> {
             auto find_program_by_name =
@@ -612,6 +678,7 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
     auto previous_level = std::move(level_);
     std::size_t transferred_texture_count = 0;
     {
+        FRAME_PROFILE_SCOPE("BuildLevel");
         ScopedTimer timer(logger_, "BuildLevel");
         auto built = BuildLevel(GetSize(), level_data);
         if (previous_level && built.level)
@@ -763,8 +830,37 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
         command_resources_ = std::make_unique<CommandResources>(
             *vk_unique_device_, graphics_queue_family_index_);
         command_resources_->Create();
+        command_recorder_ = std::make_unique<ParallelCommandRecorder>(
+            *vk_unique_device_,
+            graphics_queue_family_index_,
+            kMaxFramesInFlight);
+        descriptor_layout_cache_ =
+            std::make_unique<DescriptorLayoutCache>(*vk_unique_device_);
+        descriptor_allocator_ =
+            std::make_unique<DescriptorAllocator>(*vk_unique_device_);
+        if (bindless_supported_)
+        {
+            bindless_textures_ = std::make_unique<BindlessTextureTable>(
+                vk_physical_device_,
+                *vk_unique_device_,
+                *descriptor_layout_cache_);
+            logger_->info(
+                "Bindless texture table of {} descriptors.",
+                bindless_textures_->GetCapacity());
+        }
         gpu_memory_manager_ = std::make_unique<GpuMemoryManager>(
             vk_physical_device_, *vk_unique_device_);
+        if (transfer_queue_family_index_ != graphics_queue_family_index_)
+        {
+            gpu_memory_manager_->SetQueueFamilies(
+                {graphics_queue_family_index_, transfer_queue_family_index_});
+        }
+        upload_context_ = std::make_unique<UploadContext>(
+            *vk_unique_device_,
+            *gpu_memory_manager_,
+            transfer_queue_,
+            transfer_queue_family_index_,
+            transfer_queue_family_index_ == graphics_queue_family_index_);
         command_queue_ = std::make_unique<CommandQueue>(
             *vk_unique_device_,
             graphics_queue_,
@@ -773,12 +869,21 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
             *vk_unique_device_,
             *gpu_memory_manager_,
             *command_queue_,
-            logger_);
+            logger_,
+            kMaxFramesInFlight,
+            upload_context_.get());
         mesh_resources_ = std::make_unique<MeshResources>(
             *vk_unique_device_,
             *gpu_memory_manager_,
             *command_queue_,
-            logger_);
+            logger_,
+            upload_context_.get());
+        if (GpuProfiler::IsSupported(
+                vk_physical_device_, graphics_queue_family_index_))
+        {
+            gpu_profiler_ = std::make_unique<GpuProfiler>(
+                vk_physical_device_, *vk_unique_device_, kMaxFramesInFlight);
+        }
     }
     if (!swapchain_resources_)
     {
@@ -788,12 +893,36 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
             vk_surface_,
             graphics_queue_family_index_,
             present_queue_family_index_,
-            logger_);
+            logger_,
+            static_cast<std::uint32_t>(kMaxFramesInFlight));
     }
     if (!shader_compiler_)
     {
         shader_compiler_ = std::make_unique<ShaderCompiler>();
     }
+    {
+        // Compile every module of the level at once, the pipelines then
+        // find them in the memory cache of the compiler.
+        FRAME_PROFILE_SCOPE("Compile level shaders");
+        ScopedTimer timer(logger_, "Compile level shaders");
+        std::vector<ShaderCompileRequest> requests;
+        std::unordered_set<std::string> requested;
+        const auto shader_root = level_data.asset_root / "shader" / "vulkan";
+        auto request = [&](const std::string& file, shaderc_shader_kind kind) {
+            if (!file.empty() && requested.insert(file).second)
+            {
+                requests.push_back({shader_root / file, kind});
+            }
+        };
+        for (const auto& program_info : level_data.programs)
+        {
+            request(program_info.vertex_shader, shaderc_vertex_shader);
+            request(program_info.fragment_shader, shaderc_fragment_shader);
+            request(program_info.compute_shader, shaderc_compute_shader);
+        }
+        shader_compiler_->CompileFiles(
+            requests, absl::GetFlag(FLAGS_shader_compile_threads));
+    }
 
     DestroyComputePipeline();
     DestroyGraphicsPipeline();
@@ -809,14 +938,17 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
     try
     {
         {
+            FRAME_PROFILE_SCOPE("CreateTextureResources");
             ScopedTimer timer(logger_, "CreateTextureResources");
             CreateTextureResources(level_data);
         }
         {
+            FRAME_PROFILE_SCOPE("CreateSwapchainResources");
             ScopedTimer timer(logger_, "CreateSwapchainResources");
             if (swapchain_resources_ && !swapchain_resources_->IsValid())
             {
                 swapchain_resources_->Create(size_);
+                PrepareOffscreenImages();
             }
             if (command_resources_ && command_resources_->GetBuffers().empty())
             {
@@ -825,27 +957,57 @@ void Device::StartupFromLevelData(const frame::json::LevelData& level_data)
             }
         }
         {
+            FRAME_PROFILE_SCOPE("CreateSwapchainPreviewImage");
             ScopedTimer timer(logger_, "CreateSwapchainPreviewImage");
             CreateSwapchainPreviewImage();
         }
         {
+            FRAME_PROFILE_SCOPE("CreateDescriptorResources");
             ScopedTimer timer(logger_, "CreateDescriptorResources");
             CreateDescriptorResources();
         }
         if (mesh_resources_)
         {
+            FRAME_PROFILE_SCOPE("MeshResources Build");
             ScopedTimer timer(logger_, "MeshResources Build");
             mesh_resources_->Build(level_data);
         }
         {
+            FRAME_PROFILE_SCOPE("CreateGraphicsPipeline");
             ScopedTimer timer(logger_, "CreateGraphicsPipeline");
             CreateGraphicsPipeline();
         }
         if (use_compute_raytracing_)
         {
+            FRAME_PROFILE_SCOPE("CreateComputePipeline");
             ScopedTimer timer(logger_, "CreateComputePipeline");
             CreateComputePipeline();
         }
+        if (shader_compiler_)
+        {
+            const auto stats = shader_compiler_->GetCacheStats();
+            logger_->info(
+                "SPIR-V cache: {} memory hits, {} disk hits, {} misses.",
+                stats.memory_hits,
+                stats.disk_hits,
+                stats.misses);
+        }
+        if (gpu_memory_manager_)
+        {
+            const auto stats = gpu_memory_manager_->GetStats();
+            logger_->info(
+                "GPU memory: {} allocations in {} blocks and {} dedicated "
+                "({} of {} device allocations), {} / {} MiB used, "
+                "fragmentation {:.1f}%.",
+                stats.allocation_count,
+                stats.block_count,
+                stats.dedicated_count,
+                stats.device_allocation_count,
+                stats.max_device_allocation_count,
+                stats.used_bytes >> 20,
+                stats.reserved_bytes >> 20,
+                stats.fragmentation * 100.0);
+        }
     }
     catch (const std::exception& ex)
     {
@@ -945,6 +1107,10 @@ void Device::Cleanup()
     }
     plugin_interfaces_.clear();
 
+    if (pipeline_cache_)
+    {
+        pipeline_cache_->Save();
+    }
     DestroyComputePipeline();
     DestroyGraphicsPipeline();
     DestroySwapchainPreviewImage();
@@ -958,6 +1124,10 @@ void Device::Cleanup()
     {
         mesh_resources_->Clear();
     }
+    upload_context_.reset();
+    bindless_textures_.reset();
+    descriptor_allocator_.reset();
+    descriptor_layout_cache_.reset();
     command_queue_.reset();
     buffer_resources_.reset();
     mesh_resources_.reset();
@@ -967,6 +1137,9 @@ void Device::Cleanup()
         command_resources_->Destroy();
         command_resources_.reset();
     }
+    command_recorder_.reset();
+    gpu_profiler_.reset();
+    gpu_frame_times_.clear();
     if (sync_resources_)
     {
         sync_resources_->Destroy();
@@ -1000,6 +1173,7 @@ glm::uvec2 Device::GetSize() const
 
 void Device::UpdateSkinnedRaytraceBuffers()
 {
+    FRAME_PROFILE_SCOPE("Skinning");
     if (!level_ || !buffer_resources_ || !use_compute_raytracing_)
     {
         return;
@@ -1025,26 +1199,12 @@ void Device::UpdateSkinnedRaytraceBuffers()
 
     static std::unordered_map<EntityId, std::array<float, 6>> previous_samples;
     static bool logged_motion = false;
-    std::size_t updated_buffer_count = 0;
-    for (const auto node_id : level_->GetSceneNodes())
+    pending_skinned_buffers_.clear();
+    // The level keeps the list of skinned meshes (only Vulkan meshes in a
+    // Vulkan level) up to date, no need to walk and cast the scene nodes.
+    for (auto* mesh : level_->GetSkinnedMeshes())
     {
-        auto* node_mesh =
-            dynamic_cast<frame::NodeMesh*>(&level_->GetSceneNodeFromId(node_id));
-        if (!node_mesh)
-        {
-            continue;
-        }
-        const auto mesh_id = node_mesh->GetLocalMesh();
-        if (!mesh_id)
-        {
-            continue;
-        }
-        auto* skinned_mesh = dynamic_cast<frame::vulkan::SkinnedMesh*>(
-            &level_->GetMeshFromId(mesh_id));
-        if (!skinned_mesh)
-        {
-            continue;
-        }
+        auto* skinned_mesh = static_cast<frame::vulkan::SkinnedMesh*>(mesh);
 
         const double skinning_time = skinned_mesh->GetSkinningTime(
             static_cast<double>(elapsed_time_seconds_));
@@ -1074,22 +1234,17 @@ void Device::UpdateSkinnedRaytraceBuffers()
                         {
                             logger_->info(
                                 "Detected Vulkan skinned animation updates for mesh '{}'.",
-                                level_->GetNameFromId(mesh_id));
+                                skinned_mesh->GetName());
                             logged_motion = true;
                         }
                     }
                     previous_samples[triangle_buffer_id] = sample;
                 }
 
-                auto& triangle_buffer = dynamic_cast<frame::vulkan::Buffer&>(
+                auto& triangle_buffer = static_cast<frame::vulkan::Buffer&>(
                     level_->GetBufferFromId(triangle_buffer_id));
                 triangle_buffer.Copy(triangles);
-                if (buffer_resources_->UpdateStorageBuffer(
-                    level_->GetNameFromId(triangle_buffer_id),
-                    triangle_buffer.GetRawData()))
-                {
-                    ++updated_buffer_count;
-                }
+                pending_skinned_buffers_.push_back(triangle_buffer_id);
             }
         }
 
@@ -1099,20 +1254,37 @@ void Device::UpdateSkinnedRaytraceBuffers()
             auto bvh_nodes = skinned_mesh->EvaluateRaytraceBvh(skinning_time);
             if (!bvh_nodes.empty())
             {
-                auto& bvh_buffer = dynamic_cast<frame::vulkan::Buffer&>(
+                auto& bvh_buffer = static_cast<frame::vulkan::Buffer&>(
                     level_->GetBufferFromId(bvh_buffer_id));
                 bvh_buffer.Copy(
                     bvh_nodes.size() * sizeof(frame::BVHNode),
                     bvh_nodes.data());
-                if (buffer_resources_->UpdateStorageBuffer(
-                    level_->GetNameFromId(bvh_buffer_id),
-                    bvh_buffer.GetRawData()))
-                {
-                    ++updated_buffer_count;
-                }
+                pending_skinned_buffers_.push_back(bvh_buffer_id);
             }
         }
     }
+}
+
+void Device::UploadSkinnedRaytraceBuffers()
+{
+    FRAME_PROFILE_SCOPE("Upload skinned buffers");
+    if (!level_ || !buffer_resources_)
+    {
+        pending_skinned_buffers_.clear();
+        return;
+    }
+    std::size_t updated_buffer_count = 0;
+    for (const EntityId buffer_id : pending_skinned_buffers_)
+    {
+        const auto& buffer = static_cast<const frame::vulkan::Buffer&>(
+            level_->GetBufferFromId(buffer_id));
+        if (buffer_resources_->UpdateStorageBuffer(
+                level_->GetNameFromId(buffer_id), buffer.GetRawData()))
+        {
+            ++updated_buffer_count;
+        }
+    }
+    pending_skinned_buffers_.clear();
     if (updated_buffer_count > 0)
     {
         // Re-arm transfer->compute visibility barrier after dynamic SSBO writes.
@@ -1155,6 +1327,9 @@ std::optional<vk::DescriptorImageInfo> Device::GetSwapchainPreviewDescriptorInfo
 
 void Device::Display(double dt)
 {
+    // The previous frame ends here, with the plugins and GUI run after it.
+    FRAME_PROFILE_END_FRAME();
+    FRAME_PROFILE_SCOPE("Vulkan Display");
     if (device_lost_)
     {
         return;
@@ -1165,7 +1340,8 @@ void Device::Display(double dt)
     if (level_)
     {
         level_->UpdateLights(static_cast<double>(elapsed_time_seconds_));
-        UpdateSkinnedRaytraceBuffers();
+        level_->UpdateSpatialIndex(
+            static_cast<double>(elapsed_time_seconds_));
     }
 
     if (!vk_unique_device_ || !swapchain_resources_ ||
@@ -1197,6 +1373,36 @@ void Device::Display(double dt)
         return;
     }
 
+    // CPU side of the frame, it overlaps the GPU still rendering the frames
+    // in flight: only the level and the CPU copies of the buffers are
+    // written until the fence of this frame has been waited on.
+    if (level_)
+    {
+        UpdateSkinnedRaytraceBuffers();
+    }
+    std::string preferred_scene_root;
+    if (level_ && active_program_info_ &&
+        active_program_info_->program_id != NullId)
+    {
+        preferred_scene_root =
+            level_->GetProgramFromId(active_program_info_->program_id)
+                .GetTemporarySceneRoot();
+    }
+    const auto extent = swapchain_resources_->GetExtent();
+    const SceneState scene_state =
+        (level_)
+            ? BuildSceneState(
+                  *level_,
+                  frame::Logger::GetInstance(),
+                  {extent.width, extent.height},
+                  elapsed_time_seconds_,
+                  active_program_info_
+                      ? active_program_info_->material_id
+                      : NullId,
+                  !use_compute_raytracing_,
+                  preferred_scene_root)
+            : SceneState{};
+
     const vk::Fence fence = sync_resources_->GetInFlightFence(current_frame_);
     const VkFence fence_handle = static_cast<VkFence>(fence);
     const VkResult wait_result = vkWaitForFences(
@@ -1216,33 +1422,61 @@ void Device::Display(double dt)
         }
         return;
     }
+    if (gpu_profiler_)
+    {
+        if (auto gpu_time = gpu_profiler_->Resolve(current_frame_))
+        {
+            gpu_frame_times_.push_back(*gpu_time);
+        }
+    }
 
-    const auto& swapchain = swapchain_resources_->GetSwapchain();
-    auto acquire = vk_unique_device_->acquireNextImageKHR(
-        *swapchain,
-        std::numeric_limits<std::uint64_t>::max(),
-        sync_resources_->GetImageAvailable(current_frame_),
-        nullptr);
-
-    if (acquire.result == vk::Result::eErrorOutOfDateKHR)
+    // The level uploads overlap the startup, they have to be done before
+    // the first frame uses their resources.
+    if (upload_context_)
     {
-        RecreateSwapchain();
-        return;
+        upload_context_->WaitIdle();
     }
-    if (acquire.result != vk::Result::eSuccess &&
-        acquire.result != vk::Result::eSuboptimalKHR)
+    // The staging region and the uniform copy of this frame are free again,
+    // the skinned buffers are written to it and copied by the frame command
+    // buffer.
+    if (buffer_resources_)
     {
-        logger_->error(
-            "Failed to acquire swapchain image: {}",
-            vk::to_string(acquire.result));
-        if (acquire.result == vk::Result::eErrorDeviceLost)
+        buffer_resources_->BeginFrame(current_frame_);
+    }
+    UploadSkinnedRaytraceBuffers();
+
+    // Offscreen there is one image per frame in flight, the fence above
+    // covers its last use.
+    const bool offscreen = swapchain_resources_->IsOffscreen();
+    std::uint32_t image_index = static_cast<std::uint32_t>(current_frame_);
+    const auto& swapchain = swapchain_resources_->GetSwapchain();
+    if (!offscreen)
+    {
+        auto acquire = vk_unique_device_->acquireNextImageKHR(
+            *swapchain,
+            std::numeric_limits<std::uint64_t>::max(),
+            sync_resources_->GetImageAvailable(current_frame_),
+            nullptr);
+
+        if (acquire.result == vk::Result::eErrorOutOfDateKHR)
         {
-            device_lost_ = true;
+            RecreateSwapchain();
+            return;
         }
-        return;
+        if (acquire.result != vk::Result::eSuccess &&
+            acquire.result != vk::Result::eSuboptimalKHR)
+        {
+            logger_->error(
+                "Failed to acquire swapchain image: {}",
+                vk::to_string(acquire.result));
+            if (acquire.result == vk::Result::eErrorDeviceLost)
+            {
+                device_lost_ = true;
+            }
+            return;
+        }
+        image_index = acquire.value;
     }
-
-    const std::uint32_t image_index = acquire.value;
     const VkResult reset_result = vkResetFences(
         static_cast<VkDevice>(*vk_unique_device_),
         1,
@@ -1262,7 +1496,7 @@ void Device::Display(double dt)
     vk::CommandBuffer command_buffer =
         command_resources_->GetBuffer(current_frame_);
     command_buffer.reset();
-    RecordCommandBuffer(command_buffer, image_index);
+    RecordCommandBuffer(command_buffer, image_index, scene_state);
 
     const vk::Semaphore wait_semaphores[] = {
         sync_resources_->GetImageAvailable(current_frame_)};
@@ -1272,12 +1506,12 @@ void Device::Display(double dt)
         sync_resources_->GetRenderFinished(current_frame_)};
 
     vk::SubmitInfo submit_info(
-        1,
+        offscreen ? 0 : 1,
         wait_semaphores,
         wait_stages,
         1,
         &command_buffer,
-        1,
+        offscreen ? 0 : 1,
         signal_semaphores);
 
     const VkSubmitInfo submit_info_c = submit_info;
@@ -1297,6 +1531,12 @@ void Device::Display(double dt)
         }
         return;
     }
+    ++frame_number_;
+    if (offscreen)
+    {
+        current_frame_ = (current_frame_ + 1) % kMaxFramesInFlight;
+        return;
+    }
 
     vk::PresentInfoKHR present_info(
         1,
@@ -1326,16 +1566,142 @@ void Device::Display(double dt)
     current_frame_ = (current_frame_ + 1) % kMaxFramesInFlight;
 }
 
+std::vector<GpuFrameTime> Device::TakeGpuFrameTimes(bool flush)
+{
+    if (flush && gpu_profiler_)
+    {
+        vk_unique_device_->waitIdle();
+        // Oldest frame first.
+        for (std::size_t i = 0; i < kMaxFramesInFlight; ++i)
+        {
+            if (auto gpu_time = gpu_profiler_->Resolve(
+                    (current_frame_ + i) % kMaxFramesInFlight))
+            {
+                gpu_frame_times_.push_back(*gpu_time);
+            }
+        }
+    }
+    return std::exchange(gpu_frame_times_, {});
+}
+
+std::vector<GpuPassStats> Device::GetGpuPassStats() const
+{
+    return gpu_profiler_ ? gpu_profiler_->GetStats()
+                         : std::vector<GpuPassStats>{};
+}
+
+RenderCallStats Device::GetRenderCallStats() const
+{
+    // The command buffers are recorded without counting the calls.
+    return {};
+}
 
 void Device::Shutdown()
 {
     Cleanup();
+    pipeline_cache_.reset();
     vk_unique_device_.reset();
 }
 
 void Device::ScreenShot(const std::string& file) const
 {
-    logger_->warn("Vulkan screenshot not implemented (requested: {})", file);
+    // A presented swapchain image cannot be read back, only the offscreen
+    // target is supported.
+    if (!swapchain_resources_ || !swapchain_resources_->IsOffscreen() ||
+        !command_queue_ || !gpu_memory_manager_ || frame_number_ == 0)
+    {
+        logger_->warn(
+            "Vulkan screenshot needs a displayed offscreen frame "
+            "(requested: {})",
+            file);
+        return;
+    }
+    vk_unique_device_->waitIdle();
+
+    const auto extent = swapchain_resources_->GetExtent();
+    const vk::Image image = swapchain_resources_->GetImages()
+        [(current_frame_ + kMaxFramesInFlight - 1) % kMaxFramesInFlight];
+    const vk::DeviceSize size =
+        vk::DeviceSize{extent.width} * extent.height * 4;
+    vk::UniqueDeviceMemory memory;
+    auto buffer = gpu_memory_manager_->CreateBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        memory);
+    command_queue_->SubmitOneTime([&](vk::CommandBuffer command_buffer) {
+        // The frame left the image in the present layout (transfer source).
+        const vk::ImageMemoryBarrier to_copy(
+            vk::AccessFlagBits::eColorAttachmentWrite |
+                vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eTransferRead,
+            swapchain_resources_->GetPresentLayout(),
+            swapchain_resources_->GetPresentLayout(),
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            image,
+            {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+        command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eAllCommands,
+            vk::PipelineStageFlagBits::eTransfer,
+            {},
+            nullptr,
+            nullptr,
+            to_copy);
+        const vk::BufferImageCopy region(
+            0,
+            0,
+            0,
+            {vk::ImageAspectFlagBits::eColor, 0, 0, 1},
+            {0, 0, 0},
+            {extent.width, extent.height, 1});
+        command_buffer.copyImageToBuffer(
+            image, swapchain_resources_->GetPresentLayout(), *buffer, region);
+        const vk::BufferMemoryBarrier to_host(
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eHostRead,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            *buffer,
+            0,
+            size);
+        command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eHost,
+            {},
+            nullptr,
+            to_host,
+            nullptr);
+    });
+
+    // To RGBA, rows bottom up as the image writer flips them (OpenGL).
+    const auto* pixels = static_cast<const std::uint8_t*>(
+        vk_unique_device_->mapMemory(*memory, 0, size));
+    const bool bgra =
+        swapchain_resources_->GetImageFormat() == vk::Format::eB8G8R8A8Unorm;
+    const std::size_t row_size = std::size_t{extent.width} * 4;
+    std::vector<std::uint8_t> rgba(static_cast<std::size_t>(size));
+    for (std::uint32_t y = 0; y < extent.height; ++y)
+    {
+        const auto* src = pixels + (extent.height - 1 - y) * row_size;
+        auto* dst = rgba.data() + y * row_size;
+        for (std::uint32_t x = 0; x < extent.width; ++x)
+        {
+            dst[x * 4 + 0] = src[x * 4 + (bgra ? 2 : 0)];
+            dst[x * 4 + 1] = src[x * 4 + 1];
+            dst[x * 4 + 2] = src[x * 4 + (bgra ? 0 : 2)];
+            dst[x * 4 + 3] = src[x * 4 + 3];
+        }
+    }
+    vk_unique_device_->unmapMemory(*memory);
+
+    file::Image output_image(
+        {extent.width, extent.height},
+        json::PixelElementSize_BYTE(),
+        json::PixelStructure_RGB_ALPHA());
+    output_image.SetData(rgba.data());
+    output_image.SaveImageToFile(file);
 }
 
 std::unique_ptr<frame::BufferInterface> Device::CreatePointBuffer(
@@ -1379,6 +1745,7 @@ void Device::RecreateSwapchain()
     command_resources_->FreeBuffers();
 
     swapchain_resources_->Create(size_);
+    PrepareOffscreenImages();
     command_resources_->AllocateBuffers(
         static_cast<std::uint32_t>(kMaxFramesInFlight));
     CreateSwapchainPreviewImage();
@@ -1391,12 +1758,59 @@ void Device::RecreateSwapchain()
     }
 }
 
+void Device::PrepareOffscreenImages()
+{
+    if (!swapchain_resources_ || !swapchain_resources_->IsOffscreen() ||
+        !command_queue_)
+    {
+        return;
+    }
+    command_queue_->SubmitOneTime([this](vk::CommandBuffer command_buffer) {
+        std::vector<vk::ImageMemoryBarrier> barriers;
+        for (const vk::Image image : swapchain_resources_->GetImages())
+        {
+            barriers.emplace_back(
+                vk::AccessFlags{},
+                vk::AccessFlags{},
+                vk::ImageLayout::eUndefined,
+                swapchain_resources_->GetPresentLayout(),
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                image,
+                vk::ImageSubresourceRange(
+                    vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+        }
+        command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            {},
+            nullptr,
+            nullptr,
+            barriers);
+    });
+}
+
 void Device::RecordCommandBuffer(
     vk::CommandBuffer command_buffer,
-    std::uint32_t image_index)
+    std::uint32_t image_index,
+    const SceneState& scene_state)
 {
+    FRAME_PROFILE_SCOPE("Record command buffer");
+    frame_allocator_.BeginFrame();
+    command_recorder_->BeginFrame(current_frame_);
     vk::CommandBufferBeginInfo begin_info;
     command_buffer.begin(begin_info);
+    if (gpu_profiler_)
+    {
+        gpu_profiler_->BeginFrame(
+            command_buffer, current_frame_, frame_number_);
+    }
+    if (buffer_resources_)
+    {
+        GpuProfiler::Scope scope(
+            gpu_profiler_.get(), command_buffer, gpu_pass::kPreRender);
+        buffer_resources_->RecordUploads(command_buffer);
+    }
 
     const auto extent = swapchain_resources_->GetExtent();
     const auto& images = swapchain_resources_->GetImages();
@@ -1405,29 +1819,6 @@ void Device::RecordCommandBuffer(
     const auto& gui_render_pass = swapchain_resources_->GetGuiRenderPass();
     const auto& gui_framebuffers = swapchain_resources_->GetGuiFramebuffers();
 
-    std::string preferred_scene_root;
-    if (level_ && active_program_info_ &&
-        active_program_info_->program_id != NullId)
-    {
-        preferred_scene_root =
-            level_->GetProgramFromId(active_program_info_->program_id)
-                .GetTemporarySceneRoot();
-    }
-
-    const SceneState scene_state =
-        (level_)
-            ? BuildSceneState(
-                  *level_,
-                  frame::Logger::GetInstance(),
-                  {extent.width, extent.height},
-                  elapsed_time_seconds_,
-                  active_program_info_
-                      ? active_program_info_->material_id
-                      : NullId,
-                  !use_compute_raytracing_,
-                  preferred_scene_root)
-            : SceneState{};
-
     auto update_uniform_buffer = [&](const SceneState& state) {
         if (!buffer_resources_)
         {
@@ -1443,6 +1834,10 @@ void Device::RecordCommandBuffer(
             &block, sizeof(UniformBlock));
     };
     update_uniform_buffer(scene_state);
+    const std::uint32_t uniform_offset =
+        buffer_resources_ ? buffer_resources_->GetUniformOffset() : 0;
+    const vk::ArrayProxy<const std::uint32_t> dynamic_offsets(
+        descriptor_dynamic_offset_count_, &uniform_offset);
 
     auto transition_output = [&](vk::ImageLayout old_layout,
                                  vk::ImageLayout new_layout,
@@ -1484,7 +1879,8 @@ void Device::RecordCommandBuffer(
         {
             const auto& storage_buffers =
                 buffer_resources_->GetStorageBuffers();
-            std::vector<vk::BufferMemoryBarrier> buffer_barriers;
+            std::pmr::vector<vk::BufferMemoryBarrier> buffer_barriers(
+                &frame_allocator_);
             buffer_barriers.reserve(storage_buffers.size());
             for (const auto& storage : storage_buffers)
             {
@@ -1508,7 +1904,9 @@ void Device::RecordCommandBuffer(
                     vk::PipelineStageFlagBits::eComputeShader,
                     {},
                     nullptr,
-                    buffer_barriers,
+                    vk::ArrayProxy<const vk::BufferMemoryBarrier>(
+                        static_cast<std::uint32_t>(buffer_barriers.size()),
+                        buffer_barriers.data()),
                     nullptr);
             }
             storage_buffers_ready_ = true;
@@ -1526,6 +1924,8 @@ void Device::RecordCommandBuffer(
             compute_output_in_shader_read_ = false;
         }
 
+        GpuProfiler::Scope scope(
+            gpu_profiler_.get(), command_buffer, gpu_pass::kComputeRaytrace);
         command_buffer.bindPipeline(
             vk::PipelineBindPoint::eCompute,
             *compute_pipeline_);
@@ -1534,7 +1934,7 @@ void Device::RecordCommandBuffer(
             *compute_pipeline_layout_,
             0,
             descriptor_set_,
-            {});
+            dynamic_offsets);
         const std::uint32_t group_x =
             (extent.width + 7) / 8;
         const std::uint32_t group_y =
@@ -1558,12 +1958,111 @@ void Device::RecordCommandBuffer(
         0.1f,
         1.0f});
 
-    auto draw_scene = [&]() -> bool {
-        if (!graphics_pipeline_)
+    culling_stats_ = {};
+    // Matrices and the culled draw list are made here, the secondary buffers
+    // only record them.
+    glm::mat4 projection = scene_state.projection;
+    glm::mat4 view = scene_state.view;
+    glm::mat4 model = scene_state.model;
+
+    const bool needs_scene_matrices =
+        push_constant_size_ > 0 &&
+        !(use_procedural_quad_pipeline_ &&
+          active_program_info_ &&
+          active_program_info_->uses_time_uniform);
+
+    if (needs_scene_matrices && level_)
+    {
+        try
         {
-            return false;
+            Camera camera_for_frame(level_->GetDefaultCamera());
+            auto camera_holder_id = level_->GetDefaultCameraId();
+            if (camera_holder_id != NullId)
+            {
+                auto& node =
+                    level_->GetSceneNodeFromId(camera_holder_id);
+                auto matrix_node = node.GetLocalModel(
+                    static_cast<double>(elapsed_time_seconds_));
+                auto inverse_model = glm::inverse(matrix_node);
+                camera_for_frame.SetFront(
+                    level_->GetDefaultCamera().GetFront() *
+                    glm::mat3(inverse_model));
+                camera_for_frame.SetPosition(
+                    glm::vec3(
+                        glm::vec4(
+                            level_->GetDefaultCamera().GetPosition(), 1.0f) *
+                        inverse_model));
+            }
+
+            if (extent.height != 0)
+            {
+                camera_for_frame.SetAspectRatio(
+                    static_cast<float>(extent.width) /
+                    static_cast<float>(extent.height));
+            }
+            projection = camera_for_frame.ComputeProjection();
+            projection[1][1] *= -1.0f;
+            view = camera_for_frame.ComputeView();
+            glm::mat4 rotation = glm::mat4(1.0f);
+            view = rotation * view;
+
+            // Model of the meshes without a node (fallback quad).
+            const auto mesh_pairs =
+                level_->GetMeshMaterialIds();
+            if (!mesh_pairs.empty())
+            {
+                auto node_id = mesh_pairs.front().first;
+                auto& node = level_->GetSceneNodeFromId(node_id);
+                model = node.GetLocalModel(
+                    static_cast<double>(elapsed_time_seconds_));
+            }
         }
-        command_buffer.bindPipeline(
+        catch (const std::exception& ex)
+        {
+            logger_->warn(
+                "Failed to compute scene matrices: {}", ex.what());
+        }
+    }
+
+    struct SceneDraw
+    {
+        const MeshResource* mesh = nullptr;
+        glm::mat4 model = glm::mat4(1.0f);
+    };
+    std::pmr::vector<SceneDraw> scene_draws(&frame_allocator_);
+    if (graphics_pipeline_ && !use_procedural_quad_pipeline_ &&
+        mesh_resources_)
+    {
+        const Frustum frustum(projection * view);
+        for (const auto& mesh : mesh_resources_->GetMeshes())
+        {
+            glm::mat4 mesh_model = model;
+            if (needs_scene_matrices && level_ && !mesh.name.empty())
+            {
+                const auto node_id = level_->GetIdFromName(mesh.name);
+                if (node_id != NullId)
+                {
+                    mesh_model =
+                        level_->GetSceneNodeFromId(node_id).GetLocalModel(
+                            static_cast<double>(elapsed_time_seconds_));
+                }
+            }
+            // Skip the draw if the mesh is out of the view, the cleared
+            // target is still a valid scene image.
+            if (needs_scene_matrices && mesh.bounding_volume.IsValid() &&
+                !frustum.IsVisible(frame::TransformAABB(
+                    mesh.bounding_volume.aabb, mesh_model)))
+            {
+                ++culling_stats_.culled;
+                continue;
+            }
+            ++culling_stats_.drawn;
+            scene_draws.push_back({&mesh, mesh_model});
+        }
+    }
+    // State a secondary buffer does not inherit from the primary.
+    auto begin_scene = [&](vk::CommandBuffer scene_buffer) {
+        scene_buffer.bindPipeline(
             vk::PipelineBindPoint::eGraphics,
             *graphics_pipeline_);
 
@@ -1574,143 +2073,165 @@ void Device::RecordCommandBuffer(
             static_cast<float>(extent.height),
             0.0f,
             1.0f);
-        command_buffer.setViewport(0, 1, &viewport);
+        scene_buffer.setViewport(0, 1, &viewport);
 
         vk::Rect2D scissor({0, 0}, extent);
-        command_buffer.setScissor(0, 1, &scissor);
+        scene_buffer.setScissor(0, 1, &scissor);
 
         if (descriptor_set_layout_ && descriptor_set_)
         {
-            command_buffer.bindDescriptorSets(
+            scene_buffer.bindDescriptorSets(
                 vk::PipelineBindPoint::eGraphics,
                 *pipeline_layout_,
                 0,
                 descriptor_set_,
-                {});
+                dynamic_offsets);
         }
-
-        glm::mat4 projection = scene_state.projection;
-        glm::mat4 view = scene_state.view;
-        glm::mat4 model = scene_state.model;
-
-        const bool needs_scene_matrices =
-            push_constant_size_ > 0 &&
-            !(use_procedural_quad_pipeline_ &&
-              active_program_info_ &&
-              active_program_info_->uses_time_uniform);
-
-        if (needs_scene_matrices && level_)
+        if (bindless_textures_)
         {
-            try
-            {
-                Camera camera_for_frame(level_->GetDefaultCamera());
-                auto camera_holder_id = level_->GetDefaultCameraId();
-                if (camera_holder_id != NullId)
-                {
-                    auto& node =
-                        level_->GetSceneNodeFromId(camera_holder_id);
-                    auto matrix_node = node.GetLocalModel(
-                        static_cast<double>(elapsed_time_seconds_));
-                    auto inverse_model = glm::inverse(matrix_node);
-                    camera_for_frame.SetFront(
-                        level_->GetDefaultCamera().GetFront() *
-                        glm::mat3(inverse_model));
-                    camera_for_frame.SetPosition(
-                        glm::vec3(
-                            glm::vec4(
-                                level_->GetDefaultCamera().GetPosition(), 1.0f) *
-                            inverse_model));
-                }
-
-                if (extent.height != 0)
-                {
-                    camera_for_frame.SetAspectRatio(
-                        static_cast<float>(extent.width) /
-                        static_cast<float>(extent.height));
-                }
-                projection = camera_for_frame.ComputeProjection();
-                projection[1][1] *= -1.0f;
-                view = camera_for_frame.ComputeView();
-                glm::mat4 rotation = glm::mat4(1.0f);
-                view = rotation * view;
-
-                const auto mesh_pairs =
-                    level_->GetMeshMaterialIds();
-                if (!mesh_pairs.empty())
-                {
-                    auto node_id = mesh_pairs.front().first;
-                    auto& node = level_->GetSceneNodeFromId(node_id);
-                    model = node.GetLocalModel(
-                        static_cast<double>(elapsed_time_seconds_));
-                }
-            }
-            catch (const std::exception& ex)
-            {
-                logger_->warn(
-                    "Failed to compute scene matrices: {}", ex.what());
-            }
+            scene_buffer.bindDescriptorSets(
+                vk::PipelineBindPoint::eGraphics,
+                *pipeline_layout_,
+                1,
+                bindless_textures_->GetSet(),
+                {});
         }
-
-        if (push_constant_size_ > 0)
+    };
+    auto push_scene_constants = [&](vk::CommandBuffer scene_buffer,
+                                    const glm::mat4& draw_model) {
+        if (push_constant_size_ == 0)
         {
-            if (use_procedural_quad_pipeline_ && active_program_info_ &&
-                active_program_info_->uses_time_uniform)
-            {
-                float time = elapsed_time_seconds_;
-                command_buffer.pushConstants(
-                    *pipeline_layout_,
-                    push_constant_stages_,
-                    0,
-                    push_constant_size_,
-                    &time);
-            }
-            else
-            {
-                struct alignas(16) PushConstants
-                {
-                    glm::mat4 projection;
-                    glm::mat4 view;
-                    glm::mat4 model;
-                    float time_s;
-                } push_constants{projection, view, model, elapsed_time_seconds_};
-                command_buffer.pushConstants(
-                    *pipeline_layout_,
-                    push_constant_stages_,
-                    0,
-                    push_constant_size_,
-                    &push_constants);
-            }
+            return;
         }
-
-        if (use_procedural_quad_pipeline_)
+        if (use_procedural_quad_pipeline_ && active_program_info_ &&
+            active_program_info_->uses_time_uniform)
         {
-            command_buffer.draw(6, 1, 0, 0);
-            return true;
+            float time = elapsed_time_seconds_;
+            scene_buffer.pushConstants(
+                *pipeline_layout_,
+                push_constant_stages_,
+                0,
+                push_constant_size_,
+                &time);
         }
-        else if (mesh_resources_ && !mesh_resources_->Empty())
+        else
         {
-            const auto& mesh = mesh_resources_->GetMeshes().front();
-            const vk::DeviceSize offsets[] = {0};
-            command_buffer.bindVertexBuffers(0, *mesh.vertex_buffer, offsets);
-            if (mesh.index_buffer)
-            {
-                command_buffer.bindIndexBuffer(
-                    *mesh.index_buffer, 0, vk::IndexType::eUint32);
-                command_buffer.drawIndexed(mesh.index_count, 1, 0, 0, 0);
-            }
-            else
+            struct alignas(16) PushConstants
             {
-                command_buffer.draw(mesh.index_count, 1, 0, 0);
-            }
-            return true;
+                glm::mat4 projection;
+                glm::mat4 view;
+                glm::mat4 model;
+                float time_s;
+            } push_constants{
+                projection, view, draw_model, elapsed_time_seconds_};
+            scene_buffer.pushConstants(
+                *pipeline_layout_,
+                push_constant_stages_,
+                0,
+                push_constant_size_,
+                &push_constants);
+        }
+    };
+    auto draw_mesh = [&](vk::CommandBuffer scene_buffer,
+                         const SceneDraw& draw) {
+        push_scene_constants(scene_buffer, draw.model);
+        const auto& mesh = *draw.mesh;
+        const vk::DeviceSize offsets[] = {0};
+        scene_buffer.bindVertexBuffers(0, *mesh.vertex_buffer, offsets);
+        if (mesh.index_buffer)
+        {
+            scene_buffer.bindIndexBuffer(
+                *mesh.index_buffer, 0, vk::IndexType::eUint32);
+            scene_buffer.drawIndexed(mesh.index_count, 1, 0, 0, 0);
+        }
+        else
+        {
+            scene_buffer.draw(mesh.index_count, 1, 0, 0);
         }
-        return false;
     };
 
-    bool scene_pass_executed = false;
-    bool scene_content_rendered = false;
-    if (render_pass && image_index < framebuffers.size())
-    {
+    // The content of the passes goes to secondary command buffers, recorded
+    // in parallel, the primary only executes them. The scene draw list is
+    // split in contiguous chunks, one per thread, executed in order.
+    const bool scene_pass_executed =
+        render_pass && image_index < framebuffers.size();
+    const bool gui_pass_executed = gui_render_callback_ && gui_render_pass &&
+                                   image_index < gui_framebuffers.size();
+    const bool scene_content_rendered =
+        scene_pass_executed && graphics_pipeline_ &&
+        (use_procedural_quad_pipeline_ ||
+         (mesh_resources_ && !mesh_resources_->Empty()));
+    std::pmr::vector<SecondaryCommandTask> secondary_tasks(&frame_allocator_);
+    std::size_t scene_task_index = 0;
+    std::size_t scene_task_count = 0;
+    std::size_t gui_task_index = 0;
+    if (scene_pass_executed && scene_draws.empty())
+    {
+        scene_task_index = secondary_tasks.size();
+        secondary_tasks.push_back(
+            {"scene",
+             *render_pass,
+             *framebuffers[image_index],
+             [&](vk::CommandBuffer scene_buffer) {
+                 if (graphics_pipeline_ && use_procedural_quad_pipeline_)
+                 {
+                     begin_scene(scene_buffer);
+                     push_scene_constants(scene_buffer, model);
+                     scene_buffer.draw(6, 1, 0, 0);
+                 }
+             }});
+        scene_task_count = 1;
+    }
+    else if (scene_pass_executed)
+    {
+        scene_task_index = secondary_tasks.size();
+        scene_task_count = GetChunkCount(
+            scene_draws.size(),
+            jobs::Scheduler::GetInstance().GetWorkerCount() + 1,
+            kMinSceneDrawsPerChunk);
+        for (std::size_t chunk = 0; chunk < scene_task_count; ++chunk)
+        {
+            const auto range =
+                GetChunkRange(scene_draws.size(), scene_task_count, chunk);
+            secondary_tasks.push_back(
+                {"scene",
+                 *render_pass,
+                 *framebuffers[image_index],
+                 [&, range](vk::CommandBuffer scene_buffer) {
+                     begin_scene(scene_buffer);
+                     for (std::size_t i = range.first; i < range.second; ++i)
+                     {
+                         draw_mesh(scene_buffer, scene_draws[i]);
+                     }
+                 }});
+        }
+    }
+    if (gui_pass_executed)
+    {
+        gui_task_index = secondary_tasks.size();
+        secondary_tasks.push_back(
+            {"gui",
+             *gui_render_pass,
+             *gui_framebuffers[image_index],
+             [&](vk::CommandBuffer gui_buffer) {
+                 try
+                 {
+                     gui_render_callback_(gui_buffer);
+                 }
+                 catch (const std::exception& ex)
+                 {
+                     logger_->error(
+                         "Failed to render Vulkan GUI: {}", ex.what());
+                 }
+             }});
+    }
+    const auto secondary_buffers =
+        command_recorder_->Record(secondary_tasks);
+
+    if (scene_pass_executed)
+    {
+        GpuProfiler::Scope scope(
+            gpu_profiler_.get(), command_buffer, gpu_pass::kScene);
         vk::RenderPassBeginInfo render_pass_info(
             *render_pass,
             *framebuffers[image_index],
@@ -1720,10 +2241,12 @@ void Device::RecordCommandBuffer(
 
         command_buffer.beginRenderPass(
             render_pass_info,
-            vk::SubpassContents::eInline);
-        scene_content_rendered = draw_scene();
+            vk::SubpassContents::eSecondaryCommandBuffers);
+        command_buffer.executeCommands(
+            vk::ArrayProxy<const vk::CommandBuffer>(
+                static_cast<std::uint32_t>(scene_task_count),
+                secondary_buffers.data() + scene_task_index));
         command_buffer.endRenderPass();
-        scene_pass_executed = true;
     }
 
     if (!scene_pass_executed && image_index < images.size())
@@ -1732,7 +2255,7 @@ void Device::RecordCommandBuffer(
         vk::ImageMemoryBarrier to_transfer_src(
             {},
             vk::AccessFlagBits::eTransferRead,
-            vk::ImageLayout::ePresentSrcKHR,
+            swapchain_resources_->GetPresentLayout(),
             vk::ImageLayout::eTransferSrcOptimal,
             VK_QUEUE_FAMILY_IGNORED,
             VK_QUEUE_FAMILY_IGNORED,
@@ -1751,6 +2274,9 @@ void Device::RecordCommandBuffer(
         image_index < images.size() &&
         extent.width > 0 && extent.height > 0)
     {
+        // The scene copied to the preview the GUI shows.
+        GpuProfiler::Scope scope(
+            gpu_profiler_.get(), command_buffer, gpu_pass::kPostProcess);
         const vk::Image swapchain_image = images[image_index];
 
         std::array<vk::ImageMemoryBarrier, 2> to_copy_barriers = {
@@ -1831,9 +2357,10 @@ void Device::RecordCommandBuffer(
         swapchain_preview_in_shader_read_ = true;
     }
 
-    if (gui_render_callback_ && gui_render_pass &&
-        image_index < gui_framebuffers.size())
+    if (gui_pass_executed)
     {
+        GpuProfiler::Scope scope(
+            gpu_profiler_.get(), command_buffer, gpu_pass::kGui);
         vk::RenderPassBeginInfo gui_pass_info(
             *gui_render_pass,
             *gui_framebuffers[image_index],
@@ -1842,15 +2369,8 @@ void Device::RecordCommandBuffer(
             nullptr);
         command_buffer.beginRenderPass(
             gui_pass_info,
-            vk::SubpassContents::eInline);
-        try
-        {
-            gui_render_callback_(command_buffer);
-        }
-        catch (const std::exception& ex)
-        {
-            logger_->error("Failed to render Vulkan GUI: {}", ex.what());
-        }
+            vk::SubpassContents::eSecondaryCommandBuffers);
+        command_buffer.executeCommands(secondary_buffers[gui_task_index]);
         command_buffer.endRenderPass();
     }
     else if (image_index < images.size())
@@ -1860,7 +2380,7 @@ void Device::RecordCommandBuffer(
             vk::AccessFlagBits::eTransferRead,
             {},
             vk::ImageLayout::eTransferSrcOptimal,
-            vk::ImageLayout::ePresentSrcKHR,
+            swapchain_resources_->GetPresentLayout(),
             VK_QUEUE_FAMILY_IGNORED,
             VK_QUEUE_FAMILY_IGNORED,
             swapchain_image,
@@ -1874,6 +2394,10 @@ void Device::RecordCommandBuffer(
             to_present);
     }
 
+    if (gpu_profiler_)
+    {
+        gpu_profiler_->EndFrame(command_buffer);
+    }
     command_buffer.end();
 }
 
@@ -2054,7 +2578,16 @@ void Device::CreateGraphicsPipeline()
     std::vector<vk::DescriptorSetLayout> set_layouts;
     if (descriptor_set_layout_)
     {
-        set_layouts.push_back(*descriptor_set_layout_);
+        set_layouts.push_back(descriptor_set_layout_);
+    }
+    if (bindless_textures_)
+    {
+        // Set 1, after an empty set 0 if the program has no bindings.
+        if (set_layouts.empty())
+        {
+            set_layouts.push_back(descriptor_layout_cache_->Get({}));
+        }
+        set_layouts.push_back(bindless_textures_->GetLayout());
     }
 
     std::vector<vk::PushConstantRange> push_constant_ranges;
@@ -2089,7 +2622,8 @@ void Device::CreateGraphicsPipeline()
         *render_pass);
 
     auto pipeline_result =
-        vk_unique_device_->createGraphicsPipelineUnique(nullptr, pipeline_info);
+        vk_unique_device_->createGraphicsPipelineUnique(
+            pipeline_cache_->Get(), pipeline_info);
     if (pipeline_result.result != vk::Result::eSuccess)
     {
         throw std::runtime_error("Failed to create Vulkan graphics pipeline.");
@@ -2155,7 +2689,7 @@ void Device::CreateComputePipeline()
         *compute_module,
         "main");
 
-    const vk::DescriptorSetLayout layouts[] = {*descriptor_set_layout_};
+    const vk::DescriptorSetLayout layouts[] = {descriptor_set_layout_};
     vk::PipelineLayoutCreateInfo layout_info(
         vk::PipelineLayoutCreateFlags{},
         1,
@@ -2169,7 +2703,8 @@ void Device::CreateComputePipeline()
         *compute_pipeline_layout_);
 
     auto pipeline_result =
-        vk_unique_device_->createComputePipelineUnique(nullptr, pipeline_info);
+        vk_unique_device_->createComputePipelineUnique(
+            pipeline_cache_->Get(), pipeline_info);
     if (pipeline_result.result != vk::Result::eSuccess)
     {
         throw std::runtime_error("Failed to create Vulkan compute pipeline.");
@@ -2243,8 +2778,13 @@ void Device::DestroyTextureResources()
 void Device::DestroyDescriptorResources()
 {
     descriptor_set_ = VK_NULL_HANDLE;
-    descriptor_pool_.reset();
-    descriptor_set_layout_.reset();
+    // The layout stays in the cache for the next program.
+    descriptor_set_layout_ = VK_NULL_HANDLE;
+    descriptor_dynamic_offset_count_ = 0;
+    if (descriptor_allocator_)
+    {
+        descriptor_allocator_->Reset();
+    }
     if (buffer_resources_)
     {
         buffer_resources_->Clear();
@@ -2489,11 +3029,16 @@ void Device::CreateTextureResources(
 void Device::CreateDescriptorResources()
 {
     descriptor_set_ = VK_NULL_HANDLE;
-    descriptor_pool_.reset();
-    descriptor_set_layout_.reset();
+    descriptor_set_layout_ = VK_NULL_HANDLE;
+    descriptor_dynamic_offset_count_ = 0;
+    if (descriptor_allocator_)
+    {
+        descriptor_allocator_->Reset();
+    }
     storage_buffers_ready_ = false;
 
-    if (!active_program_info_ || !buffer_resources_ || !texture_resources_)
+    if (!active_program_info_ || !buffer_resources_ || !texture_resources_ ||
+        !descriptor_allocator_)
     {
         return;
     }
@@ -2601,7 +3146,8 @@ void Device::CreateDescriptorResources()
             }
             break;
         case frame::proto::ProgramBinding::UNIFORM_BUFFER:
-            descriptor_type = vk::DescriptorType::eUniformBuffer;
+            // Dynamic, the offset picks the copy of the frame.
+            descriptor_type = vk::DescriptorType::eUniformBufferDynamic;
             uniform_bindings.push_back(binding.binding);
             break;
         case frame::proto::ProgramBinding::BINDING_INVALID:
@@ -2736,60 +3282,8 @@ void Device::CreateDescriptorResources()
         }
     }
 
-    vk::DescriptorSetLayoutCreateInfo layout_info(
-        vk::DescriptorSetLayoutCreateFlags{},
-        static_cast<std::uint32_t>(layout_bindings.size()),
-        layout_bindings.data());
-    descriptor_set_layout_ =
-        vk_unique_device_->createDescriptorSetLayoutUnique(layout_info);
-
-    std::vector<vk::DescriptorPoolSize> pool_sizes;
-    const std::uint32_t combined_count =
-        static_cast<std::uint32_t>(texture_bindings.size() +
-                                   output_sampler_bindings.size());
-    if (combined_count > 0)
-    {
-        pool_sizes.emplace_back(
-            vk::DescriptorType::eCombinedImageSampler,
-            combined_count);
-    }
-    if (!output_image_bindings.empty())
-    {
-        pool_sizes.emplace_back(
-            vk::DescriptorType::eStorageImage,
-            static_cast<std::uint32_t>(output_image_bindings.size()));
-    }
-    if (!storage_bindings.empty())
-    {
-        pool_sizes.emplace_back(
-            vk::DescriptorType::eStorageBuffer,
-            static_cast<std::uint32_t>(storage_bindings.size()));
-    }
-    if (!uniform_bindings.empty())
-    {
-        pool_sizes.emplace_back(
-            vk::DescriptorType::eUniformBuffer,
-            static_cast<std::uint32_t>(uniform_bindings.size()));
-    }
-    if (pool_sizes.empty())
-    {
-        return;
-    }
-
-    vk::DescriptorPoolCreateInfo pool_info(
-        vk::DescriptorPoolCreateFlags{},
-        1,
-        static_cast<std::uint32_t>(pool_sizes.size()),
-        pool_sizes.data());
-    descriptor_pool_ = vk_unique_device_->createDescriptorPoolUnique(pool_info);
-
-    const vk::DescriptorSetLayout layouts[] = {*descriptor_set_layout_};
-    vk::DescriptorSetAllocateInfo alloc_info(
-        *descriptor_pool_,
-        1,
-        layouts);
-    descriptor_set_ =
-        vk_unique_device_->allocateDescriptorSets(alloc_info).front();
+    descriptor_set_layout_ = descriptor_layout_cache_->Get(layout_bindings);
+    descriptor_set_ = descriptor_allocator_->Allocate(descriptor_set_layout_);
 
     std::vector<vk::DescriptorImageInfo> output_image_infos;
     std::vector<vk::DescriptorImageInfo> output_sampler_infos;
@@ -2870,9 +3364,10 @@ void Device::CreateDescriptorResources()
             uniform_bindings.front(),
             0,
             1,
-            vk::DescriptorType::eUniformBuffer,
+            vk::DescriptorType::eUniformBufferDynamic,
             nullptr,
             &uniform_infos.back());
+        descriptor_dynamic_offset_count_ = 1;
     }
 
     vk_unique_device_->updateDescriptorSets(
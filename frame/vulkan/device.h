@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
@@ -13,9 +14,12 @@
 
 #include "frame/camera.h"
 #include "frame/device_interface.h"
+#include "frame/frame_allocator.h"
+#include "frame/frustum.h"
 #include "frame/texture_interface.h"
 #include "frame/logger.h"
 #include "frame/vulkan/buffer_resources.h"
+#include "frame/vulkan/gpu_profiler.h"
 #include "frame/vulkan/mesh_resources.h"
 #include "frame/vulkan/vulkan_dispatch.h"
  
@@ -23,11 +27,18 @@ namespace frame::vulkan
 {
 
 class CommandResources;
+class PipelineCache;
 class ShaderCompiler;
 class SwapchainResources;
 class SyncResources;
 class Texture;
 class TextureResources;
+class BindlessTextureTable;
+class DescriptorAllocator;
+class DescriptorLayoutCache;
+class ParallelCommandRecorder;
+class UploadContext;
+struct SceneState;
 
 /**
  * @class Device
@@ -72,6 +83,8 @@ class Device : public DeviceInterface
         std::vector<std::uint32_t>&& vector) final;
     std::unique_ptr<MeshInterface> CreateMesh(
         const MeshParameter& mesh_parameter) final;
+    std::vector<GpuPassStats> GetGpuPassStats() const final;
+    RenderCallStats GetRenderCallStats() const final;
 
   public:
     LevelInterface& GetLevel() final
@@ -130,8 +143,26 @@ class Device : public DeviceInterface
     {
         return command_resources_.get();
     }
+    // CPU time spent recording each pass of the last frame.
+    const ParallelCommandRecorder* GetCommandRecorder() const
+    {
+        return command_recorder_.get();
+    }
     std::optional<vk::DescriptorImageInfo> GetComputeOutputDescriptorInfo() const;
     std::optional<vk::DescriptorImageInfo> GetSwapchainPreviewDescriptorInfo() const;
+    CullingStats GetCullingStats() const
+    {
+        return culling_stats_;
+    }
+    // Frames displayed so far, numbers the GpuFrameTime entries.
+    std::uint64_t GetFrameNumber() const
+    {
+        return frame_number_;
+    }
+    // GPU times of the frames finished since the last call, they come a few
+    // frames late. flush waits for the frames still in flight. Empty when the
+    // queue has no timestamp support.
+    std::vector<GpuFrameTime> TakeGpuFrameTimes(bool flush = false);
 
   private:
     friend class TextureResources;
@@ -144,16 +175,23 @@ class Device : public DeviceInterface
     void CreateSwapchainPreviewImage();
     void DestroySwapchainPreviewImage();
     void RecreateSwapchain();
+    // Headless: move the offscreen images to the layout the frames expect.
+    void PrepareOffscreenImages();
     vk::UniqueShaderModule CreateShaderModule(
         const std::vector<std::uint32_t>& code) const;
+    // scene_state is prepared before waiting on the frame fence.
     void RecordCommandBuffer(
         vk::CommandBuffer command_buffer,
-        std::uint32_t image_index);
+        std::uint32_t image_index,
+        const SceneState& scene_state);
     void CreateTextureResources(const frame::json::LevelData& level_data);
     void DestroyTextureResources();
     void CreateDescriptorResources();
     void DestroyDescriptorResources();
+    // Evaluates the skinned raytracing buffers into the level (CPU, before
+    // the frame fence), the upload then stages them for the frame.
     void UpdateSkinnedRaytraceBuffers();
+    void UploadSkinnedRaytraceBuffers();
     void CopyBuffer(vk::Buffer src, vk::Buffer dst, vk::DeviceSize size);
     void TransitionImageLayout(
         vk::Image image,
@@ -178,8 +216,10 @@ class Device : public DeviceInterface
     vk::UniqueDevice vk_unique_device_;
     std::uint32_t graphics_queue_family_index_ = 0;
     std::uint32_t present_queue_family_index_ = 0;
+    std::uint32_t transfer_queue_family_index_ = 0;
     vk::Queue graphics_queue_;
     vk::Queue present_queue_;
+    vk::Queue transfer_queue_;
     vk::SurfaceKHR& vk_surface_;
     glm::uvec2 size_ = {0, 0};
     const proto::PixelElementSize pixel_element_size_ =
@@ -192,22 +232,38 @@ class Device : public DeviceInterface
 
     std::unique_ptr<SwapchainResources> swapchain_resources_;
     std::unique_ptr<CommandResources> command_resources_;
+    std::unique_ptr<ParallelCommandRecorder> command_recorder_;
     std::unique_ptr<SyncResources> sync_resources_;
     std::unique_ptr<ShaderCompiler> shader_compiler_;
+    std::unique_ptr<PipelineCache> pipeline_cache_;
     vk::UniquePipelineLayout pipeline_layout_;
     vk::UniquePipeline graphics_pipeline_;
     vk::UniquePipeline compute_pipeline_;
     vk::UniquePipelineLayout compute_pipeline_layout_;
     std::unique_ptr<class GpuMemoryManager> gpu_memory_manager_;
+    std::unique_ptr<UploadContext> upload_context_;
     std::unique_ptr<class CommandQueue> command_queue_;
     std::unique_ptr<class BufferResourceManager> buffer_resources_;
     std::unique_ptr<class MeshResources> mesh_resources_;
-    vk::UniqueDescriptorSetLayout descriptor_set_layout_;
-    vk::UniqueDescriptorPool descriptor_pool_;
+    std::unique_ptr<DescriptorLayoutCache> descriptor_layout_cache_;
+    std::unique_ptr<DescriptorAllocator> descriptor_allocator_;
+    // Null without descriptor indexing support.
+    std::unique_ptr<BindlessTextureTable> bindless_textures_;
+    bool bindless_supported_ = false;
+    // Owned by the layout cache.
+    vk::DescriptorSetLayout descriptor_set_layout_ = VK_NULL_HANDLE;
     vk::DescriptorSet descriptor_set_ = VK_NULL_HANDLE;
+    // 1 when the set has the (dynamic) uniform block binding.
+    std::uint32_t descriptor_dynamic_offset_count_ = 0;
     std::unique_ptr<TextureResources> texture_resources_;
     static constexpr std::size_t kMaxFramesInFlight = 2;
     std::size_t current_frame_ = 0;
+    std::uint64_t frame_number_ = 0;
+    // Timestamps of the passes, null when the queue has none.
+    std::unique_ptr<GpuProfiler> gpu_profiler_;
+    std::vector<GpuFrameTime> gpu_frame_times_;
+    // Transient CPU data of the command buffer recording.
+    FrameAllocator frame_allocator_{64 * 1024, kMaxFramesInFlight};
     bool framebuffer_resized_ = false;
     bool use_compute_raytracing_ = false;
     vk::UniqueImage compute_output_image_;
@@ -223,6 +279,8 @@ class Device : public DeviceInterface
     vk::Format swapchain_preview_format_ = vk::Format::eUndefined;
     glm::uvec2 swapchain_preview_size_ = {0, 0};
     bool storage_buffers_ready_ = false;
+    // Skinned buffers evaluated for the next frame, waiting for its upload.
+    std::vector<EntityId> pending_skinned_buffers_;
     vk::Format compute_output_format_ = vk::Format::eR16G16B16A16Sfloat;
     bool device_lost_ = false;
     struct ProgramPipelineInfo
@@ -254,6 +312,8 @@ class Device : public DeviceInterface
     std::optional<ProgramPipelineInfo> active_program_info_;
     bool use_procedural_quad_pipeline_ = false;
     float elapsed_time_seconds_ = 0.0f;
+    // Frustum culling counters of the last recorded frame.
+    CullingStats culling_stats_ = {};
     vk::ShaderStageFlags push_constant_stages_ = {};
     std::uint32_t push_constant_size_ = 0;
     GuiRenderCallback gui_render_callback_;
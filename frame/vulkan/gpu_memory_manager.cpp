@@ -1,18 +1,118 @@
 #include "frame/vulkan/gpu_memory_manager.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <format>
 #include <stdexcept>
+#include <utility>
 
 namespace frame::vulkan
 {
 
+namespace
+{
+
+// Smallest buddy range, also its alignment.
+constexpr vk::DeviceSize kMinRangeSize = 256;
+constexpr std::uint32_t kPoolKindCount = 3;
+
+} // namespace
+
+GpuAllocation::~GpuAllocation()
+{
+    Reset();
+}
+
+GpuAllocation::GpuAllocation(GpuAllocation&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+GpuAllocation& GpuAllocation::operator=(GpuAllocation&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();
+        owner_ = std::exchange(other.owner_, nullptr);
+        block_ = std::exchange(other.block_, nullptr);
+        memory_ = std::exchange(other.memory_, nullptr);
+        offset_ = std::exchange(other.offset_, 0);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, nullptr);
+        pool_index_ = std::exchange(other.pool_index_, 0);
+        order_ = std::exchange(other.order_, 0);
+    }
+    return *this;
+}
+
+void GpuAllocation::Reset()
+{
+    if (owner_)
+    {
+        owner_->Free(*this);
+    }
+    owner_ = nullptr;
+    block_ = nullptr;
+    memory_ = nullptr;
+    offset_ = 0;
+    size_ = 0;
+    mapped_ = nullptr;
+    pool_index_ = 0;
+    order_ = 0;
+}
+
+GpuMemoryManager::GpuMemoryManager(
+    vk::PhysicalDevice physical_device,
+    vk::Device device,
+    vk::DeviceSize block_size)
+    : physical_device_(physical_device),
+      device_(device),
+      memory_properties_(physical_device.getMemoryProperties()),
+      max_allocation_count_(
+          physical_device.getProperties().limits.maxMemoryAllocationCount)
+{
+    block_size = std::bit_floor(std::max(block_size, kMinRangeSize));
+    pools_.resize(memory_properties_.memoryTypeCount * kPoolKindCount);
+    for (std::uint32_t i = 0; i < pools_.size(); ++i)
+    {
+        auto& pool = pools_[i];
+        pool.memory_type = i / kPoolKindCount;
+        pool.linear = (i % kPoolKindCount) ==
+                      static_cast<std::uint32_t>(GpuMemoryPool::eTransient);
+        // Same rule of thumb as VMA, an eighth of a small heap.
+        const auto heap_size =
+            memory_properties_
+                .memoryHeaps[memory_properties_.memoryTypes[pool.memory_type]
+                                 .heapIndex]
+                .size;
+        pool.block_size = std::clamp(
+            std::bit_floor(heap_size / 8), kMinRangeSize, block_size);
+    }
+}
+
+GpuMemoryManager::~GpuMemoryManager()
+{
+    for (auto& pool : pools_)
+    {
+        for (auto& block : pool.blocks)
+        {
+            if (block->mapped)
+            {
+                device_.unmapMemory(block->memory);
+            }
+            device_.freeMemory(block->memory);
+        }
+    }
+}
+
 std::uint32_t GpuMemoryManager::FindMemoryType(
     std::uint32_t type_filter, vk::MemoryPropertyFlags properties) const
 {
-    auto mem_properties = physical_device_.getMemoryProperties();
-    for (std::uint32_t i = 0; i < mem_properties.memoryTypeCount; ++i)
+    for (std::uint32_t i = 0; i < memory_properties_.memoryTypeCount; ++i)
     {
         if ((type_filter & (1u << i)) &&
-            (mem_properties.memoryTypes[i].propertyFlags & properties) ==
+            (memory_properties_.memoryTypes[i].propertyFlags & properties) ==
                 properties)
         {
             return i;
@@ -32,6 +132,11 @@ vk::UniqueBuffer GpuMemoryManager::CreateBuffer(
         size,
         usage,
         vk::SharingMode::eExclusive);
+    if (queue_families_.size() > 1)
+    {
+        buffer_info.setSharingMode(vk::SharingMode::eConcurrent)
+            .setQueueFamilyIndices(queue_families_);
+    }
     auto buffer = device_.createBufferUnique(buffer_info);
     auto requirements = device_.getBufferMemoryRequirements(*buffer);
     vk::MemoryAllocateInfo allocate_info(
@@ -42,4 +147,336 @@ vk::UniqueBuffer GpuMemoryManager::CreateBuffer(
     return buffer;
 }
 
+vk::UniqueBuffer GpuMemoryManager::CreateBuffer(
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    vk::MemoryPropertyFlags properties,
+    GpuAllocation& out_allocation,
+    GpuMemoryPool pool)
+{
+    vk::BufferCreateInfo buffer_info(
+        vk::BufferCreateFlags{},
+        size,
+        usage,
+        vk::SharingMode::eExclusive);
+    if (queue_families_.size() > 1)
+    {
+        buffer_info.setSharingMode(vk::SharingMode::eConcurrent)
+            .setQueueFamilyIndices(queue_families_);
+    }
+    auto buffer = device_.createBufferUnique(buffer_info);
+    out_allocation = Allocate(
+        device_.getBufferMemoryRequirements(*buffer), properties, pool);
+    device_.bindBufferMemory(
+        *buffer, out_allocation.GetMemory(), out_allocation.GetOffset());
+    return buffer;
+}
+
+GpuAllocation GpuMemoryManager::AllocateImage(
+    vk::Image image, vk::MemoryPropertyFlags properties)
+{
+    auto allocation = Allocate(
+        device_.getImageMemoryRequirements(image),
+        properties,
+        GpuMemoryPool::eImage);
+    device_.bindImageMemory(
+        image, allocation.GetMemory(), allocation.GetOffset());
+    return allocation;
+}
+
+GpuAllocation GpuMemoryManager::Allocate(
+    const vk::MemoryRequirements& requirements,
+    vk::MemoryPropertyFlags properties,
+    GpuMemoryPool pool_kind)
+{
+    const std::uint32_t pool_index =
+        FindMemoryType(requirements.memoryTypeBits, properties) *
+            kPoolKindCount +
+        static_cast<std::uint32_t>(pool_kind);
+    const vk::DeviceSize alignment =
+        std::max<vk::DeviceSize>(requirements.alignment, 1);
+    std::scoped_lock lock(mutex_);
+    auto& pool = pools_[pool_index];
+    // The owner is only set on success, a throwing path must not release.
+    GpuAllocation allocation;
+    allocation.pool_index_ = pool_index;
+
+    // A buddy range rounds up to a power of two, large resources would waste
+    // too much of a block.
+    if (requirements.size > pool.block_size / 2)
+    {
+        auto& block = CreateBlock(pool, requirements.size, true);
+        block.live_count = 1;
+        block.used_bytes = requirements.size;
+        block.allocated_bytes = requirements.size;
+        allocation.block_ = &block;
+        allocation.memory_ = block.memory;
+        allocation.size_ = requirements.size;
+        allocation.mapped_ = block.mapped;
+        allocation.owner_ = this;
+        return allocation;
+    }
+    for (auto& block : pool.blocks)
+    {
+        if (!block->dedicated &&
+            TryAllocate(
+                *block,
+                pool.linear,
+                requirements.size,
+                alignment,
+                allocation))
+        {
+            allocation.owner_ = this;
+            return allocation;
+        }
+    }
+    auto& block = CreateBlock(pool, pool.block_size, false);
+    if (!TryAllocate(
+            block, pool.linear, requirements.size, alignment, allocation))
+    {
+        throw std::runtime_error(std::format(
+            "Unable to fit {} bytes in a new Vulkan memory block.",
+            requirements.size));
+    }
+    allocation.owner_ = this;
+    return allocation;
+}
+
+GpuMemoryStats GpuMemoryManager::GetStats() const
+{
+    std::scoped_lock lock(mutex_);
+    GpuMemoryStats stats{};
+    stats.device_allocation_count = device_allocation_count_;
+    stats.max_device_allocation_count = max_allocation_count_;
+    vk::DeviceSize free_bytes = 0;
+    for (const auto& pool : pools_)
+    {
+        for (const auto& block : pool.blocks)
+        {
+            ++(block->dedicated ? stats.dedicated_count : stats.block_count);
+            stats.allocation_count += block->live_count;
+            stats.reserved_bytes += block->size;
+            stats.allocated_bytes += block->allocated_bytes;
+            stats.used_bytes += block->used_bytes;
+            if (block->dedicated)
+            {
+                continue;
+            }
+            if (pool.linear)
+            {
+                const vk::DeviceSize tail = block->size - block->offset;
+                free_bytes += tail;
+                stats.largest_free_range =
+                    std::max(stats.largest_free_range, tail);
+                continue;
+            }
+            for (std::size_t order = 0; order < block->free_ranges.size();
+                 ++order)
+            {
+                const auto& ranges = block->free_ranges[order];
+                if (ranges.empty())
+                {
+                    continue;
+                }
+                const vk::DeviceSize range_size = kMinRangeSize << order;
+                free_bytes += range_size * ranges.size();
+                stats.largest_free_range =
+                    std::max(stats.largest_free_range, range_size);
+            }
+        }
+    }
+    if (free_bytes > 0)
+    {
+        stats.fragmentation =
+            1.0 - static_cast<double>(stats.largest_free_range) /
+                      static_cast<double>(free_bytes);
+    }
+    return stats;
+}
+
+void GpuMemoryManager::Free(GpuAllocation& allocation)
+{
+    std::scoped_lock lock(mutex_);
+    auto& pool = pools_[allocation.pool_index_];
+    auto* block = static_cast<Block*>(allocation.block_);
+    --block->live_count;
+    block->used_bytes -= allocation.size_;
+    if (block->dedicated)
+    {
+        DestroyBlock(pool, block);
+        return;
+    }
+    if (pool.linear)
+    {
+        block->allocated_bytes -= allocation.size_;
+        if (block->live_count == 0)
+        {
+            block->offset = 0;
+        }
+    }
+    else
+    {
+        // Merge with the buddy as long as it is free too.
+        std::uint32_t order = allocation.order_;
+        vk::DeviceSize offset = allocation.offset_;
+        block->allocated_bytes -= kMinRangeSize << order;
+        while (order + 1 < block->free_ranges.size())
+        {
+            const vk::DeviceSize buddy = offset ^ (kMinRangeSize << order);
+            if (!block->free_ranges[order].erase(buddy))
+            {
+                break;
+            }
+            offset = std::min(offset, buddy);
+            ++order;
+        }
+        block->free_ranges[order].insert(offset);
+    }
+    if (block->live_count > 0)
+    {
+        return;
+    }
+    // Keep a single empty block per pool, so a load/unload cycle does not
+    // go back to the driver every time.
+    const auto empty_count = std::ranges::count_if(
+        pool.blocks, [](const auto& other) { return other->live_count == 0; });
+    if (empty_count > 1)
+    {
+        DestroyBlock(pool, block);
+    }
+}
+
+bool GpuMemoryManager::TryAllocate(
+    Block& block,
+    bool linear,
+    vk::DeviceSize size,
+    vk::DeviceSize alignment,
+    GpuAllocation& allocation)
+{
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize allocated_size = size;
+    if (linear)
+    {
+        offset = (block.offset + alignment - 1) / alignment * alignment;
+        if (offset + size > block.size)
+        {
+            return false;
+        }
+        block.offset = offset + size;
+    }
+    else
+    {
+        // Ranges of an order are aligned on their size.
+        allocated_size =
+            std::bit_ceil(std::max({size, alignment, kMinRangeSize}));
+        const auto order = static_cast<std::uint32_t>(
+            std::countr_zero(allocated_size / kMinRangeSize));
+        auto level = order;
+        while (level < block.free_ranges.size() &&
+               block.free_ranges[level].empty())
+        {
+            ++level;
+        }
+        if (level >= block.free_ranges.size())
+        {
+            return false;
+        }
+        auto& ranges = block.free_ranges[level];
+        offset = *ranges.begin();
+        ranges.erase(ranges.begin());
+        // Split down, the upper halves go back to the free lists.
+        while (level > order)
+        {
+            --level;
+            block.free_ranges[level].insert(offset + (kMinRangeSize << level));
+        }
+        allocation.order_ = order;
+    }
+    ++block.live_count;
+    block.used_bytes += size;
+    block.allocated_bytes += allocated_size;
+    allocation.block_ = &block;
+    allocation.memory_ = block.memory;
+    allocation.offset_ = offset;
+    allocation.size_ = size;
+    allocation.mapped_ =
+        block.mapped ? static_cast<std::byte*>(block.mapped) + offset
+                     : nullptr;
+    return true;
+}
+
+GpuMemoryManager::Block& GpuMemoryManager::CreateBlock(
+    Pool& pool, vk::DeviceSize size, bool dedicated)
+{
+    if (device_allocation_count_ >= max_allocation_count_ &&
+        !ReleaseEmptyBlocks())
+    {
+        throw std::runtime_error(std::format(
+            "Vulkan memory allocation count limit ({}) reached.",
+            max_allocation_count_));
+    }
+    auto block = std::make_unique<Block>();
+    block->memory =
+        device_.allocateMemory(vk::MemoryAllocateInfo(size, pool.memory_type));
+    ++device_allocation_count_;
+    block->size = size;
+    block->dedicated = dedicated;
+    if (memory_properties_.memoryTypes[pool.memory_type].propertyFlags &
+        vk::MemoryPropertyFlagBits::eHostVisible)
+    {
+        try
+        {
+            block->mapped = device_.mapMemory(block->memory, 0, VK_WHOLE_SIZE);
+        }
+        catch (...)
+        {
+            device_.freeMemory(block->memory);
+            --device_allocation_count_;
+            throw;
+        }
+    }
+    if (!dedicated && !pool.linear)
+    {
+        block->free_ranges.resize(std::countr_zero(size / kMinRangeSize) + 1);
+        block->free_ranges.back().insert(0);
+    }
+    pool.blocks.push_back(std::move(block));
+    return *pool.blocks.back();
+}
+
+void GpuMemoryManager::DestroyBlock(Pool& pool, const Block* block)
+{
+    auto it = std::ranges::find_if(pool.blocks, [block](const auto& other) {
+        return other.get() == block;
+    });
+    if (it == pool.blocks.end())
+    {
+        return;
+    }
+    if (block->mapped)
+    {
+        device_.unmapMemory(block->memory);
+    }
+    device_.freeMemory(block->memory);
+    --device_allocation_count_;
+    pool.blocks.erase(it);
+}
+
+bool GpuMemoryManager::ReleaseEmptyBlocks()
+{
+    bool released = false;
+    for (auto& pool : pools_)
+    {
+        for (std::size_t i = pool.blocks.size(); i-- > 0;)
+        {
+            if (pool.blocks[i]->live_count == 0)
+            {
+                DestroyBlock(pool, pool.blocks[i].get());
+                released = true;
+            }
+        }
+    }
+    return released;
+}
+
 } // namespace frame::vulkan
@@ -1,32 +1,194 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include "frame/vulkan/vulkan_dispatch.h"
 
 namespace frame::vulkan
 {
 
-class GpuMemoryManager
+class GpuMemoryManager;
+
+// Pools are kept apart so buffers and optimal images never share a page
+// (bufferImageGranularity). Transient ones (staging) are linear and rewind
+// once all their allocations are released.
+enum class GpuMemoryPool : std::uint32_t
+{
+    eBuffer = 0,
+    eImage,
+    eTransient,
+};
+
+// Range of a device memory block, returned to its pool on destruction.
+class GpuAllocation
 {
   public:
-    GpuMemoryManager(vk::PhysicalDevice physical_device, vk::Device device)
-        : physical_device_(physical_device), device_(device)
+    GpuAllocation() = default;
+    ~GpuAllocation();
+    GpuAllocation(GpuAllocation&& other) noexcept;
+    GpuAllocation& operator=(GpuAllocation&& other) noexcept;
+    GpuAllocation(const GpuAllocation&) = delete;
+    GpuAllocation& operator=(const GpuAllocation&) = delete;
+
+    vk::DeviceMemory GetMemory() const
     {
+        return memory_;
     }
+    vk::DeviceSize GetOffset() const
+    {
+        return offset_;
+    }
+    vk::DeviceSize GetSize() const
+    {
+        return size_;
+    }
+    // Host visible blocks stay mapped, null for device local memory.
+    void* GetMappedData() const
+    {
+        return mapped_;
+    }
+    explicit operator bool() const
+    {
+        return static_cast<bool>(memory_);
+    }
+    void Reset();
+
+  private:
+    friend class GpuMemoryManager;
+
+    GpuMemoryManager* owner_ = nullptr;
+    void* block_ = nullptr;
+    vk::DeviceMemory memory_;
+    vk::DeviceSize offset_ = 0;
+    vk::DeviceSize size_ = 0;
+    void* mapped_ = nullptr;
+    std::uint32_t pool_index_ = 0;
+    // Buddy order of the range (unused by linear and dedicated blocks).
+    std::uint32_t order_ = 0;
+};
+
+struct GpuMemoryStats
+{
+    // Live vkAllocateMemory calls, against maxMemoryAllocationCount.
+    std::uint32_t device_allocation_count = 0;
+    std::uint32_t max_device_allocation_count = 0;
+    std::uint32_t block_count = 0;
+    std::uint32_t dedicated_count = 0;
+    std::uint64_t allocation_count = 0;
+    // Bytes held by the blocks, handed out (rounded to the buddy size) and
+    // asked for by the live allocations.
+    vk::DeviceSize reserved_bytes = 0;
+    vk::DeviceSize allocated_bytes = 0;
+    vk::DeviceSize used_bytes = 0;
+    vk::DeviceSize largest_free_range = 0;
+    // 1 - largest free range / free bytes, 0 when the free space is in one
+    // piece.
+    double fragmentation = 0.0;
+};
+
+class GpuMemoryManager
+{
+  public:
+    static constexpr vk::DeviceSize kDefaultBlockSize = 64ull << 20;
+
+    GpuMemoryManager(
+        vk::PhysicalDevice physical_device,
+        vk::Device device,
+        vk::DeviceSize block_size = kDefaultBlockSize);
+    // All the allocations have to be released before.
+    ~GpuMemoryManager();
+    GpuMemoryManager(const GpuMemoryManager&) = delete;
+    GpuMemoryManager& operator=(const GpuMemoryManager&) = delete;
 
     std::uint32_t FindMemoryType(
         std::uint32_t type_filter, vk::MemoryPropertyFlags properties) const;
+    // Queue families using the resources, with more than one the buffers
+    // are created with concurrent sharing (no ownership transfers).
+    void SetQueueFamilies(std::vector<std::uint32_t> queue_families)
+    {
+        queue_families_ = std::move(queue_families);
+    }
+    const std::vector<std::uint32_t>& GetQueueFamilies() const
+    {
+        return queue_families_;
+    }
 
+    // Dedicated allocation, for callers that map the memory themselves.
     vk::UniqueBuffer CreateBuffer(
         vk::DeviceSize size,
         vk::BufferUsageFlags usage,
         vk::MemoryPropertyFlags properties,
         vk::UniqueDeviceMemory& out_memory) const;
+    // Buffer bound to a range of a pool block.
+    vk::UniqueBuffer CreateBuffer(
+        vk::DeviceSize size,
+        vk::BufferUsageFlags usage,
+        vk::MemoryPropertyFlags properties,
+        GpuAllocation& out_allocation,
+        GpuMemoryPool pool = GpuMemoryPool::eBuffer);
+    // Allocate and bind the memory of an optimal tiling image.
+    GpuAllocation AllocateImage(
+        vk::Image image, vk::MemoryPropertyFlags properties);
+    GpuAllocation Allocate(
+        const vk::MemoryRequirements& requirements,
+        vk::MemoryPropertyFlags properties,
+        GpuMemoryPool pool);
+
+    GpuMemoryStats GetStats() const;
 
   private:
+    friend class GpuAllocation;
+
+    struct Block
+    {
+        vk::DeviceMemory memory;
+        void* mapped = nullptr;
+        vk::DeviceSize size = 0;
+        bool dedicated = false;
+        // Buddy blocks: free range offsets per order, order 0 being
+        // kMinRangeSize.
+        std::vector<std::set<vk::DeviceSize>> free_ranges;
+        // Linear blocks: next offset, rewound when the last range goes.
+        vk::DeviceSize offset = 0;
+        std::uint32_t live_count = 0;
+        vk::DeviceSize used_bytes = 0;
+        vk::DeviceSize allocated_bytes = 0;
+    };
+    struct Pool
+    {
+        std::uint32_t memory_type = 0;
+        bool linear = false;
+        // Power of two, smaller than the default on small heaps.
+        vk::DeviceSize block_size = 0;
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    void Free(GpuAllocation& allocation);
+    static bool TryAllocate(
+        Block& block,
+        bool linear,
+        vk::DeviceSize size,
+        vk::DeviceSize alignment,
+        GpuAllocation& allocation);
+    Block& CreateBlock(Pool& pool, vk::DeviceSize size, bool dedicated);
+    void DestroyBlock(Pool& pool, const Block* block);
+    // Free empty blocks kept around, to make room under the allocation
+    // count limit.
+    bool ReleaseEmptyBlocks();
+
     vk::PhysicalDevice physical_device_;
     vk::Device device_;
+    vk::PhysicalDeviceMemoryProperties memory_properties_;
+    std::uint32_t max_allocation_count_ = 0;
+    std::uint32_t device_allocation_count_ = 0;
+    std::vector<Pool> pools_;
+    std::vector<std::uint32_t> queue_families_;
+    mutable std::mutex mutex_;
 };
 
 } // namespace frame::vulkan
@@ -0,0 +1,120 @@
+#include "frame/vulkan/gpu_profiler.h"
+
+#include <utility>
+
+namespace frame::vulkan
+{
+
+GpuProfiler::GpuProfiler(
+    vk::PhysicalDevice physical_device,
+    vk::Device device,
+    std::size_t frame_count)
+    : device_(device), slots_(frame_count)
+{
+    query_pool_ = device_.createQueryPoolUnique(vk::QueryPoolCreateInfo(
+        {},
+        vk::QueryType::eTimestamp,
+        static_cast<std::uint32_t>(frame_count * kMaxScopes * 2)));
+    timestamp_period_ns_ = static_cast<double>(
+        physical_device.getProperties().limits.timestampPeriod);
+    for (auto& slot : slots_)
+    {
+        slot.names.reserve(kMaxScopes);
+        slot.timestamps.resize(kMaxScopes * 2);
+    }
+}
+
+bool GpuProfiler::IsSupported(
+    vk::PhysicalDevice physical_device, std::uint32_t queue_family_index)
+{
+    const auto queue_families = physical_device.getQueueFamilyProperties();
+    return queue_family_index < queue_families.size() &&
+           queue_families[queue_family_index].timestampValidBits != 0;
+}
+
+void GpuProfiler::BeginFrame(
+    vk::CommandBuffer command_buffer,
+    std::size_t frame_index,
+    std::uint64_t frame_number)
+{
+    current_ = frame_index;
+    auto& slot = slots_[current_];
+    slot.names.clear();
+    slot.frame_number = frame_number;
+    command_buffer.resetQueryPool(
+        *query_pool_, FirstQuery(current_), kMaxScopes * 2);
+    frame_scope_ = BeginScope(command_buffer, gpu_pass::kFrame);
+}
+
+void GpuProfiler::EndFrame(vk::CommandBuffer command_buffer)
+{
+    EndScope(command_buffer, std::exchange(frame_scope_, kInvalidScope));
+}
+
+std::uint32_t GpuProfiler::BeginScope(
+    vk::CommandBuffer command_buffer, const char* name)
+{
+    auto& slot = slots_[current_];
+    if (slot.names.size() == kMaxScopes)
+    {
+        return kInvalidScope;
+    }
+    const auto scope = static_cast<std::uint32_t>(slot.names.size());
+    slot.names.push_back(name);
+    command_buffer.writeTimestamp(
+        vk::PipelineStageFlagBits::eTopOfPipe,
+        *query_pool_,
+        FirstQuery(current_) + scope * 2);
+    return scope;
+}
+
+void GpuProfiler::EndScope(
+    vk::CommandBuffer command_buffer, std::uint32_t scope)
+{
+    if (scope == kInvalidScope)
+    {
+        return;
+    }
+    command_buffer.writeTimestamp(
+        vk::PipelineStageFlagBits::eBottomOfPipe,
+        *query_pool_,
+        FirstQuery(current_) + scope * 2 + 1);
+}
+
+std::optional<GpuFrameTime> GpuProfiler::Resolve(std::size_t frame_index)
+{
+    auto& slot = slots_[frame_index];
+    const auto frame_number = std::exchange(slot.frame_number, std::nullopt);
+    if (!frame_number || slot.names.empty())
+    {
+        return std::nullopt;
+    }
+    const auto query_count = static_cast<std::uint32_t>(slot.names.size() * 2);
+    const vk::Result result = device_.getQueryPoolResults(
+        *query_pool_,
+        FirstQuery(frame_index),
+        query_count,
+        query_count * sizeof(std::uint64_t),
+        slot.timestamps.data(),
+        sizeof(std::uint64_t),
+        vk::QueryResultFlagBits::e64);
+    // Not ready: the command buffer of the frame was never submitted.
+    if (result != vk::Result::eSuccess)
+    {
+        return std::nullopt;
+    }
+    auto elapsed_ms = [&](std::size_t scope) {
+        return static_cast<double>(
+                   slot.timestamps[scope * 2 + 1] -
+                   slot.timestamps[scope * 2]) *
+               timestamp_period_ns_ * 1e-6;
+    };
+    for (std::size_t i = 0; i < slot.names.size(); ++i)
+    {
+        history_.AddSample(slot.names[i], elapsed_ms(i));
+    }
+    history_.EndFrame();
+    return GpuFrameTime{*frame_number, elapsed_ms(0)};
+}
+
+} // namespace frame::vulkan
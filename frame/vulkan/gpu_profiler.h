@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+#include "frame/gpu_pass_stats.h"
+
+namespace frame::vulkan
+{
+
+// GPU time of a frame, between timestamps at both ends of its command buffer.
+struct GpuFrameTime
+{
+    std::uint64_t frame = 0;
+    double gpu_ms = 0.0;
+};
+
+// Named GPU scopes timed with a pair of timestamps each. Every frame in
+// flight has its own range of queries, read back by Resolve once the fence
+// of the frame is signaled (kMaxFramesInFlight frames later), so reading
+// never waits on the GPU. Scopes nest, the first one of a frame is the
+// whole frame (gpu_pass::kFrame). Only the primary command buffer records
+// scopes, the secondary buffers are recorded on worker threads.
+class GpuProfiler
+{
+  public:
+    static constexpr std::uint32_t kMaxScopes = 32;
+    static constexpr std::uint32_t kInvalidScope = ~0u;
+
+    GpuProfiler(
+        vk::PhysicalDevice physical_device,
+        vk::Device device,
+        std::size_t frame_count);
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // The queue family writes timestamps.
+    static bool IsSupported(
+        vk::PhysicalDevice physical_device, std::uint32_t queue_family_index);
+
+    // Start recording the frame slot (already resolved), its queries are
+    // reset and the frame scope is opened.
+    void BeginFrame(
+        vk::CommandBuffer command_buffer,
+        std::size_t frame_index,
+        std::uint64_t frame_number);
+    // Close the frame scope.
+    void EndFrame(vk::CommandBuffer command_buffer);
+    // Scope index, kInvalidScope when the frame has no more queries.
+    std::uint32_t BeginScope(
+        vk::CommandBuffer command_buffer, const char* name);
+    void EndScope(vk::CommandBuffer command_buffer, std::uint32_t scope);
+    // Read the queries of a frame slot whose fence is signaled, the time of
+    // the whole frame is returned (nothing if the frame was not submitted).
+    std::optional<GpuFrameTime> Resolve(std::size_t frame_index);
+
+    std::vector<GpuPassStats> GetStats() const
+    {
+        return history_.GetStats();
+    }
+    // Forget the statistics (level reload).
+    void Clear()
+    {
+        history_.Clear();
+    }
+
+    // Time the commands recorded during the lifetime of the object, does
+    // nothing with a null profiler.
+    class Scope
+    {
+      public:
+        Scope(
+            GpuProfiler* profiler,
+            vk::CommandBuffer command_buffer,
+            const char* name)
+            : profiler_(profiler), command_buffer_(command_buffer)
+        {
+            if (profiler_)
+            {
+                scope_ = profiler_->BeginScope(command_buffer_, name);
+            }
+        }
+        ~Scope()
+        {
+            if (profiler_)
+            {
+                profiler_->EndScope(command_buffer_, scope_);
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        GpuProfiler* profiler_ = nullptr;
+        vk::CommandBuffer command_buffer_;
+        std::uint32_t scope_ = kInvalidScope;
+    };
+
+  private:
+    struct Slot
+    {
+        // Frame recorded in the slot, reset once resolved.
+        std::optional<std::uint64_t> frame_number;
+        // Scope i uses the queries 2 * i and 2 * i + 1 of the slot.
+        std::vector<const char*> names;
+        std::vector<std::uint64_t> timestamps;
+    };
+
+    std::uint32_t FirstQuery(std::size_t frame_index) const
+    {
+        return static_cast<std::uint32_t>(frame_index * kMaxScopes * 2);
+    }
+
+    vk::Device device_;
+    vk::UniqueQueryPool query_pool_;
+    double timestamp_period_ns_ = 0.0;
+    std::vector<Slot> slots_;
+    // Slot being recorded.
+    std::size_t current_ = 0;
+    std::uint32_t frame_scope_ = kInvalidScope;
+    GpuPassHistory history_;
+};
+
+} // namespace frame::vulkan
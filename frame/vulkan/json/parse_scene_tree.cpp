@@ -1411,6 +1411,8 @@ bool ParseNodeMeshFromEnum(
     node->GetData().set_render_time_enum(proto_mesh.render_time_enum());
     node->GetData().set_acceleration_structure_enum(
         proto_mesh.acceleration_structure_enum());
+    node->GetData().set_clear_depth_buffer(
+        proto_mesh.clear_depth_buffer());
     node->GetData().set_play_animation(proto_mesh.play_animation());
     if (proto_mesh.has_animation_speed())
     {
@@ -1445,6 +1447,8 @@ bool ParseNodeMeshCleanBuffer(
     node->GetData().set_render_time_enum(proto_mesh.render_time_enum());
     node->GetData().set_acceleration_structure_enum(
         proto_mesh.acceleration_structure_enum());
+    node->GetData().set_clear_depth_buffer(
+        proto_mesh.clear_depth_buffer());
     node->GetData().set_play_animation(proto_mesh.play_animation());
     if (proto_mesh.has_animation_speed())
     {
@@ -2254,6 +2258,8 @@ bool ParseNodeMesh(
                     ? std::format("{}.mesh", proto_mesh.name())
                     : std::format("{}.{}.mesh", proto_mesh.name(), counter);
             mesh_interface->SetName(mesh_name);
+            mesh_interface->SetBoundingVolume(
+                frame::ComputeBoundingVolume(points));
             mesh_interface->GetData().set_file_name(proto_mesh.file_name());
             mesh_interface->GetData().set_render_primitive_enum(
                 proto_mesh.render_primitive_enum());
@@ -2363,6 +2369,8 @@ bool ParseNodeMesh(
             node->GetData().set_acceleration_structure_enum(
                 proto_mesh.acceleration_structure_enum());
             node->GetData().set_file_name(proto_mesh.file_name());
+            node->GetData().set_clear_depth_buffer(
+                proto_mesh.clear_depth_buffer());
             node->GetData().set_play_animation(proto_mesh.play_animation());
             if (proto_mesh.has_animation_speed())
             {
@@ -11,17 +11,19 @@ MeshResources::MeshResources(
     vk::Device device,
     GpuMemoryManager& memory_manager,
     CommandQueue& command_queue,
-    const Logger& logger)
+    const Logger& logger,
+    UploadContext* upload_context)
     : device_(device),
       memory_manager_(&memory_manager),
       command_queue_(&command_queue),
+      upload_context_(upload_context),
       logger_(&logger)
 {
 }
 
 void MeshResources::Build(const frame::json::LevelData& level_data)
 {
-    meshes_.clear();
+    Clear();
 
     std::vector<frame::json::StaticMeshInfo> mesh_infos = level_data.meshes;
     if (mesh_infos.empty())
@@ -43,10 +45,19 @@ void MeshResources::Build(const frame::json::LevelData& level_data)
                 ex.what());
         }
     }
+    if (upload_context_)
+    {
+        // Waited on before the first frame, not here.
+        upload_context_->Submit();
+    }
 }
 
 void MeshResources::Clear()
 {
+    if (upload_context_)
+    {
+        upload_context_->WaitIdle();
+    }
     meshes_.clear();
 }
 
@@ -78,60 +89,30 @@ MeshResource MeshResources::BuildMeshResource(
     }
 
     MeshResource resource;
+    resource.name = mesh_info.name;
+    resource.bounding_volume =
+        frame::ComputeBoundingVolume(mesh_info.positions);
     const vk::DeviceSize vertex_size =
         static_cast<vk::DeviceSize>(vertices.size() * sizeof(MeshVertex));
 
-    vk::UniqueDeviceMemory staging_vertex_memory;
-    auto staging_vertex_buffer = memory_manager_->CreateBuffer(
-        vertex_size,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible |
-            vk::MemoryPropertyFlagBits::eHostCoherent,
-        staging_vertex_memory);
-
-    void* mapped_vertices =
-        device_.mapMemory(*staging_vertex_memory, 0, vertex_size);
-    std::memcpy(mapped_vertices, vertices.data(), vertex_size);
-    device_.unmapMemory(*staging_vertex_memory);
-
-    auto vertex_buffer = memory_manager_->CreateBuffer(
+    resource.vertex_buffer = memory_manager_->CreateBuffer(
         vertex_size,
         vk::BufferUsageFlagBits::eTransferDst |
             vk::BufferUsageFlagBits::eVertexBuffer,
         vk::MemoryPropertyFlagBits::eDeviceLocal,
-        resource.vertex_memory);
-    command_queue_->CopyBuffer(
-        *staging_vertex_buffer, *vertex_buffer, vertex_size);
-    resource.vertex_buffer = std::move(vertex_buffer);
+        resource.vertex_allocation);
 
     const auto& indices = mesh_info.indices;
+    const vk::DeviceSize index_size =
+        static_cast<vk::DeviceSize>(indices.size() * sizeof(std::uint32_t));
     if (!indices.empty())
     {
-        const vk::DeviceSize index_size =
-            static_cast<vk::DeviceSize>(
-                indices.size() * sizeof(std::uint32_t));
-        vk::UniqueDeviceMemory staging_index_memory;
-        auto staging_index_buffer = memory_manager_->CreateBuffer(
-            index_size,
-            vk::BufferUsageFlagBits::eTransferSrc,
-            vk::MemoryPropertyFlagBits::eHostVisible |
-                vk::MemoryPropertyFlagBits::eHostCoherent,
-            staging_index_memory);
-
-        void* mapped_indices =
-            device_.mapMemory(*staging_index_memory, 0, index_size);
-        std::memcpy(mapped_indices, indices.data(), index_size);
-        device_.unmapMemory(*staging_index_memory);
-
-        auto index_buffer = memory_manager_->CreateBuffer(
+        resource.index_buffer = memory_manager_->CreateBuffer(
             index_size,
             vk::BufferUsageFlagBits::eTransferDst |
                 vk::BufferUsageFlagBits::eIndexBuffer,
             vk::MemoryPropertyFlagBits::eDeviceLocal,
-            resource.index_memory);
-        command_queue_->CopyBuffer(
-            *staging_index_buffer, *index_buffer, index_size);
-        resource.index_buffer = std::move(index_buffer);
+            resource.index_allocation);
         resource.index_count = static_cast<std::uint32_t>(indices.size());
     }
     else
@@ -139,7 +120,34 @@ MeshResource MeshResources::BuildMeshResource(
         resource.index_count = static_cast<std::uint32_t>(vertices.size());
     }
 
+    // Recorded once both buffers exist, a throw cannot leave a copy to a
+    // destroyed buffer in the batch.
+    Upload(vertices.data(), vertex_size, *resource.vertex_buffer);
+    if (!indices.empty())
+    {
+        Upload(indices.data(), index_size, *resource.index_buffer);
+    }
     return resource;
 }
 
+void MeshResources::Upload(
+    const void* data, vk::DeviceSize size, vk::Buffer destination)
+{
+    if (upload_context_)
+    {
+        upload_context_->CopyToBuffer(data, size, destination);
+        return;
+    }
+    GpuAllocation staging_allocation;
+    auto staging_buffer = memory_manager_->CreateBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        staging_allocation,
+        GpuMemoryPool::eTransient);
+    std::memcpy(staging_allocation.GetMappedData(), data, size);
+    command_queue_->CopyBuffer(*staging_buffer, destination, size);
+}
+
 } // namespace frame::vulkan
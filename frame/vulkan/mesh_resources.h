@@ -1,25 +1,32 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "frame/vulkan/vulkan_dispatch.h"
 
+#include "frame/bounding_volume.h"
 #include "frame/json/level_data.h"
 #include "frame/logger.h"
 #include "frame/vulkan/command_queue.h"
 #include "frame/vulkan/gpu_memory_manager.h"
 #include "frame/vulkan/mesh_utils.h"
+#include "frame/vulkan/upload_context.h"
 
 namespace frame::vulkan
 {
 
 struct MeshResource
 {
+    // Scene node of the mesh, empty for the fallback quad.
+    std::string name;
     vk::UniqueBuffer vertex_buffer;
-    vk::UniqueDeviceMemory vertex_memory;
+    GpuAllocation vertex_allocation;
     vk::UniqueBuffer index_buffer;
-    vk::UniqueDeviceMemory index_memory;
+    GpuAllocation index_allocation;
     std::uint32_t index_count = 0;
+    // Local space bounds used for frustum culling.
+    frame::BoundingVolume bounding_volume = {};
 };
 
 class MeshResources
@@ -29,7 +36,8 @@ class MeshResources
         vk::Device device,
         GpuMemoryManager& memory_manager,
         CommandQueue& command_queue,
-        const Logger& logger);
+        const Logger& logger,
+        UploadContext* upload_context = nullptr);
 
     void Build(const frame::json::LevelData& level_data);
     void Clear();
@@ -48,10 +56,13 @@ class MeshResources
     MeshResource BuildMeshResource(
         const frame::json::StaticMeshInfo& mesh_info);
     static frame::json::StaticMeshInfo MakeFallbackQuad();
+    // Through the upload context when there is one, else upload and wait.
+    void Upload(const void* data, vk::DeviceSize size, vk::Buffer destination);
 
     vk::Device device_;
     GpuMemoryManager* memory_manager_;
     CommandQueue* command_queue_;
+    UploadContext* upload_context_;
     const Logger* logger_;
     std::vector<MeshResource> meshes_;
 };
@@ -0,0 +1,126 @@
+#include "frame/vulkan/parallel_command_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+#include "frame/jobs.h"
+#include "frame/profiler.h"
+
+namespace frame::vulkan
+{
+
+std::size_t GetChunkCount(
+    std::size_t count,
+    std::size_t max_chunk_count,
+    std::size_t min_chunk_size)
+{
+    const std::size_t chunk_count = std::min(
+        max_chunk_count, count / std::max<std::size_t>(min_chunk_size, 1));
+    return std::max<std::size_t>(chunk_count, 1);
+}
+
+std::pair<std::size_t, std::size_t> GetChunkRange(
+    std::size_t count, std::size_t chunk_count, std::size_t chunk_index)
+{
+    // The first count % chunk_count chunks get one more item.
+    const std::size_t size = count / chunk_count;
+    const std::size_t extra = count % chunk_count;
+    const std::size_t begin =
+        chunk_index * size + std::min(chunk_index, extra);
+    return {begin, begin + size + (chunk_index < extra ? 1 : 0)};
+}
+
+ParallelCommandRecorder::ParallelCommandRecorder(
+    vk::Device device,
+    std::uint32_t queue_family_index,
+    std::size_t frame_count)
+    : device_(device),
+      queue_family_index_(queue_family_index),
+      frames_(std::max<std::size_t>(frame_count, 1))
+{
+}
+
+void ParallelCommandRecorder::BeginFrame(std::size_t frame_index)
+{
+    frame_index_ = frame_index % frames_.size();
+    for (auto& command_pool : frames_[frame_index_])
+    {
+        device_.resetCommandPool(*command_pool.pool);
+        command_pool.used = 0;
+    }
+}
+
+std::vector<vk::CommandBuffer> ParallelCommandRecorder::Record(
+    std::span<const SecondaryCommandTask> tasks)
+{
+    // Pools are created here, the jobs only touch the one of their task.
+    auto& command_pools = frames_[frame_index_];
+    while (command_pools.size() < tasks.size())
+    {
+        ThreadCommandPool command_pool;
+        command_pool.pool =
+            device_.createCommandPoolUnique(vk::CommandPoolCreateInfo(
+                vk::CommandPoolCreateFlagBits::eTransient,
+                queue_family_index_));
+        command_pools.push_back(std::move(command_pool));
+    }
+
+    std::vector<vk::CommandBuffer> command_buffers(tasks.size());
+    std::vector<std::exception_ptr> errors(tasks.size());
+    record_times_.resize(tasks.size());
+    auto record = [&](std::size_t index) {
+        FRAME_PROFILE_SCOPE("Record secondary buffer");
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        try
+        {
+            const auto& task = tasks[index];
+            auto command_buffer = Begin(command_pools[index], task);
+            task.record(command_buffer);
+            command_buffer.end();
+            command_buffers[index] = command_buffer;
+        }
+        catch (...)
+        {
+            errors[index] = std::current_exception();
+        }
+        record_times_[index] = {
+            tasks[index].name,
+            jobs::Scheduler::GetThreadIndex(),
+            std::chrono::duration<double, std::milli>(Clock::now() - start)
+                .count()};
+    };
+    jobs::Scheduler::GetInstance().ParallelFor(tasks.size(), record, 1);
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    return command_buffers;
+}
+
+vk::CommandBuffer ParallelCommandRecorder::Begin(
+    ThreadCommandPool& command_pool, const SecondaryCommandTask& task)
+{
+    if (command_pool.used == command_pool.buffers.size())
+    {
+        command_pool.buffers.push_back(
+            device_
+                .allocateCommandBuffers(vk::CommandBufferAllocateInfo(
+                    *command_pool.pool, vk::CommandBufferLevel::eSecondary, 1))
+                .front());
+    }
+    auto command_buffer = command_pool.buffers[command_pool.used++];
+    const vk::CommandBufferInheritanceInfo inheritance_info(
+        task.render_pass, 0, task.framebuffer);
+    command_buffer.begin(vk::CommandBufferBeginInfo(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+            vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+        &inheritance_info));
+    return command_buffer;
+}
+
+} // namespace frame::vulkan
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+namespace frame::vulkan
+{
+
+// Content of a render pass (or a part of it), recorded into a secondary
+// command buffer.
+struct SecondaryCommandTask
+{
+    std::string name;
+    vk::RenderPass render_pass;
+    vk::Framebuffer framebuffer;
+    std::function<void(vk::CommandBuffer)> record;
+};
+
+// Number of chunks to split count items in, up to max_chunk_count with at
+// least min_chunk_size items each (one chunk if there are fewer items).
+std::size_t GetChunkCount(
+    std::size_t count,
+    std::size_t max_chunk_count,
+    std::size_t min_chunk_size = 1);
+// [begin, end) items of a chunk, the chunks are contiguous, in order and
+// differ by one item at most.
+std::pair<std::size_t, std::size_t> GetChunkRange(
+    std::size_t count, std::size_t chunk_count, std::size_t chunk_index);
+
+// CPU time of a task in the last recorded frame.
+struct SecondaryRecordTime
+{
+    std::string name;
+    // Thread that recorded it, see jobs::Scheduler::GetThreadIndex.
+    std::size_t thread_index = 0;
+    double cpu_ms = 0.0;
+};
+
+// Records secondary command buffers in parallel, one job per task on the
+// engine scheduler. Every task has its own command pool per frame in
+// flight, so no pool is ever shared between threads or reset while the GPU
+// still reads it.
+class ParallelCommandRecorder
+{
+  public:
+    ParallelCommandRecorder(
+        vk::Device device,
+        std::uint32_t queue_family_index,
+        std::size_t frame_count);
+    ParallelCommandRecorder(const ParallelCommandRecorder&) = delete;
+    ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) =
+        delete;
+
+    // Reset the pools of the frame, its fence has to be signaled.
+    void BeginFrame(std::size_t frame_index);
+    // Record the tasks (the calling thread helps while it waits) and return
+    // their command buffers in order, ready for executeCommands. Rethrows
+    // the first exception of a task.
+    std::vector<vk::CommandBuffer> Record(
+        std::span<const SecondaryCommandTask> tasks);
+
+    const std::vector<SecondaryRecordTime>& GetRecordTimes() const
+    {
+        return record_times_;
+    }
+
+  private:
+    struct ThreadCommandPool
+    {
+        vk::UniqueCommandPool pool;
+        // Allocated once, reused every time the frame comes back.
+        std::vector<vk::CommandBuffer> buffers;
+        std::size_t used = 0;
+    };
+
+    vk::CommandBuffer Begin(
+        ThreadCommandPool& command_pool, const SecondaryCommandTask& task);
+
+    vk::Device device_;
+    std::uint32_t queue_family_index_ = 0;
+    std::size_t frame_index_ = 0;
+    // Per frame in flight, per thread.
+    std::vector<std::vector<ThreadCommandPool>> frames_;
+    std::vector<SecondaryRecordTime> record_times_;
+};
+
+} // namespace frame::vulkan
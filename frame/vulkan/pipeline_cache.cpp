@@ -0,0 +1,177 @@
+#include "frame/vulkan/pipeline_cache.h"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "frame/file/file_system.h"
+
+namespace frame::vulkan
+{
+
+namespace
+{
+
+// VkPipelineCacheHeaderVersionOne, read field by field (no padding).
+constexpr std::size_t kHeaderSize = 16 + VK_UUID_SIZE;
+
+std::uint32_t ReadUint32(const std::vector<std::uint8_t>& data, std::size_t at)
+{
+    std::uint32_t value = 0;
+    std::memcpy(&value, data.data() + at, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+PipelineCache::PipelineCache(
+    vk::PhysicalDevice physical_device,
+    vk::Device device,
+    std::filesystem::path path)
+    : properties_(physical_device.getProperties()),
+      device_(device),
+      path_(std::move(path))
+{
+    const auto data = LoadData();
+    vk::PipelineCacheCreateInfo create_info({}, data.size(), data.data());
+    try
+    {
+        pipeline_cache_ = device_.createPipelineCacheUnique(create_info);
+    }
+    catch (const vk::SystemError& ex)
+    {
+        logger_->warn(
+            "Vulkan pipeline cache {} rejected ({}), starting empty.",
+            path_.string(),
+            ex.what());
+        pipeline_cache_ = device_.createPipelineCacheUnique({});
+    }
+    if (!data.empty())
+    {
+        logger_->info(
+            "Loaded Vulkan pipeline cache {} ({} bytes).",
+            path_.string(),
+            data.size());
+    }
+}
+
+std::vector<std::uint8_t> PipelineCache::LoadData() const
+{
+    std::error_code error;
+    if (path_.empty() || !std::filesystem::exists(path_, error) || error)
+    {
+        return {};
+    }
+    std::ifstream file(path_, std::ios::binary);
+    std::vector<std::uint8_t> data(
+        (std::istreambuf_iterator<char>(file)), {});
+    if (data.size() < kHeaderSize)
+    {
+        logger_->info(
+            "Ignoring Vulkan pipeline cache {}: truncated header.",
+            path_.string());
+        return {};
+    }
+    const std::uint32_t header_size = ReadUint32(data, 0);
+    const std::uint32_t header_version = ReadUint32(data, 4);
+    const std::uint32_t vendor_id = ReadUint32(data, 8);
+    const std::uint32_t device_id = ReadUint32(data, 12);
+    if (header_size < kHeaderSize || header_size > data.size() ||
+        header_version != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        vendor_id != properties_.vendorID ||
+        device_id != properties_.deviceID ||
+        std::memcmp(
+            data.data() + 16,
+            properties_.pipelineCacheUUID.data(),
+            VK_UUID_SIZE) != 0)
+    {
+        logger_->info(
+            "Ignoring Vulkan pipeline cache {}: other device or driver.",
+            path_.string());
+        return {};
+    }
+    return data;
+}
+
+void PipelineCache::Save() const
+{
+    if (path_.empty())
+    {
+        return;
+    }
+    std::vector<std::uint8_t> data;
+    try
+    {
+        data = device_.getPipelineCacheData(*pipeline_cache_);
+    }
+    catch (const vk::SystemError& ex)
+    {
+        logger_->warn(
+            "Failed to get Vulkan pipeline cache data: {}", ex.what());
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(path_.parent_path(), error);
+    if (error)
+    {
+        logger_->warn(
+            "Failed to create Vulkan pipeline cache directory {}: {}",
+            path_.parent_path().string(),
+            error.message());
+        return;
+    }
+    // Write then rename, a crash never leaves a partial cache behind.
+    auto temporary_path = path_;
+    temporary_path += ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file.write(
+                reinterpret_cast<const char*>(data.data()),
+                static_cast<std::streamsize>(data.size())))
+        {
+            logger_->warn(
+                "Failed to write Vulkan pipeline cache {}.",
+                temporary_path.string());
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, path_, error);
+    if (error)
+    {
+        logger_->warn(
+            "Failed to save Vulkan pipeline cache {}: {}",
+            path_.string(),
+            error.message());
+        return;
+    }
+    logger_->info(
+        "Saved Vulkan pipeline cache {} ({} bytes).",
+        path_.string(),
+        data.size());
+}
+
+std::filesystem::path PipelineCache::GetDefaultPath(
+    vk::PhysicalDevice physical_device)
+{
+    const auto properties = physical_device.getProperties();
+    try
+    {
+        return (frame::file::FindDirectory("asset") / "cache" / "shader" /
+                "vulkan" /
+                std::format(
+                    "pipeline_{:04x}_{:04x}.cache",
+                    properties.vendorID,
+                    properties.deviceID))
+            .lexically_normal();
+    }
+    catch (const std::exception& ex)
+    {
+        Logger::GetInstance()->warn(
+            "Vulkan pipeline cache kept in memory only: {}", ex.what());
+        return {};
+    }
+}
+
+} // namespace frame::vulkan
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "frame/logger.h"
+#include "frame/vulkan/vulkan_dispatch.h"
+
+namespace frame::vulkan
+{
+
+// Driver pipeline cache kept across runs, the data is stored next to the
+// SPIR-V cache and only reused when its header matches the physical device
+// (vendor, device and pipeline cache UUID).
+class PipelineCache
+{
+  public:
+    // path: file of the cache data, in memory only if empty.
+    PipelineCache(
+        vk::PhysicalDevice physical_device,
+        vk::Device device,
+        std::filesystem::path path);
+
+    vk::PipelineCache Get() const
+    {
+        return *pipeline_cache_;
+    }
+    // Write the cache data to the file (at shutdown).
+    void Save() const;
+
+    // Default file for a device: asset/cache/shader/vulkan/
+    // pipeline_<vendor>_<device>.cache, empty if there is no asset directory.
+    static std::filesystem::path GetDefaultPath(
+        vk::PhysicalDevice physical_device);
+
+  private:
+    std::vector<std::uint8_t> LoadData() const;
+
+  private:
+    vk::PhysicalDeviceProperties properties_;
+    vk::Device device_;
+    std::filesystem::path path_;
+    vk::UniquePipelineCache pipeline_cache_;
+    const Logger& logger_ = Logger::GetInstance();
+};
+
+} // namespace frame::vulkan
@@ -83,9 +83,9 @@ void Program::Use(
     const LevelInterface* /*level*/)
 {
     is_used_ = true;
-    const auto uniform_names = uniform_collection_interface.GetUniformNames();
-    for (const auto& name : uniform_names)
+    for (const auto& value : uniform_collection_interface.GetUniformValues())
     {
+        const auto& name = value.GetName();
         const UniformInterface* uniform_ptr = nullptr;
         try
         {
@@ -7,6 +7,7 @@
 #include <glm/gtc/matrix_inverse.hpp>
 
 #include "frame/camera.h"
+#include "frame/profiler.h"
 
 namespace frame::vulkan
 {
@@ -49,6 +50,7 @@ SceneState BuildSceneState(
     bool flip_projection_y,
     const std::string& preferred_scene_root)
 {
+    FRAME_PROFILE_SCOPE("Build scene state");
     SceneState state;
 
     try
@@ -1,99 +1,248 @@
 #include "frame/vulkan/shader_compiler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <optional>
 #include <sstream>
 #include <system_error>
+#include <thread>
 
 #include <shaderc/shaderc.hpp>
 
+#include "frame/file/file_system.h"
+#include "frame/jobs.h"
+#include "frame/logger.h"
+#include "frame/profiler.h"
+
 namespace frame::vulkan
 {
 
-std::vector<std::uint32_t> ShaderCompiler::CompileFile(
-    const std::filesystem::path& path,
-    shaderc_shader_kind kind) const
+namespace
 {
-    auto resolve_spv_path = [](const std::filesystem::path& source_path) {
-        const auto parent = source_path.parent_path();
-        if (!parent.empty() && parent.filename() == "vulkan")
-        {
-            const auto asset_root = parent.parent_path().parent_path();
-            return asset_root / "cache" / "shader" / "vulkan" /
-                (source_path.filename().string() + ".spv");
-        }
-        return std::filesystem::path(source_path.string() + ".spv");
-    };
 
-    const std::filesystem::path spv_path = resolve_spv_path(path);
-    const std::filesystem::path legacy_spv_path = path.string() + ".spv";
-    std::error_code source_error;
-    const bool source_exists =
-        std::filesystem::exists(path, source_error) && !source_error;
-    std::optional<std::filesystem::file_time_type> source_time;
-    if (source_exists)
+constexpr std::uint32_t kSpirvMagic = 0x07230203;
+// Part of the cache key, change it with the options in MakeCompileOptions.
+constexpr const char* kOptionsSignature =
+    "optimization=performance;entry=main;includer=relative";
+
+// Resolve #include "file" relative to the including file, the files opened
+// are added to included (if any).
+class RelativeIncluder : public shaderc::CompileOptions::IncluderInterface
+{
+  public:
+    explicit RelativeIncluder(std::vector<std::filesystem::path>* included)
+        : included_(included)
     {
-        auto time = std::filesystem::last_write_time(path, source_error);
-        if (!source_error)
-        {
-            source_time = time;
-        }
     }
 
-    auto try_load_spv = [&](const std::filesystem::path& candidate)
-        -> std::optional<std::vector<std::uint32_t>> {
-        std::error_code cache_error;
-        if (!std::filesystem::exists(candidate, cache_error) || cache_error)
-        {
-            return std::nullopt;
-        }
-        if (source_time)
+    shaderc_include_result* GetInclude(
+        const char* requested_source,
+        shaderc_include_type /*type*/,
+        const char* requesting_source,
+        std::size_t /*include_depth*/) override
+    {
+        auto* include = new Include();
+        const auto path =
+            (std::filesystem::path(requesting_source).parent_path() /
+             requested_source)
+                .lexically_normal();
+        std::ifstream file(path);
+        if (file)
         {
-            const auto cache_time =
-                std::filesystem::last_write_time(candidate, cache_error);
-            if (!cache_error && cache_time < *source_time)
+            std::ostringstream stream;
+            stream << file.rdbuf();
+            include->name = path.string();
+            include->content = stream.str();
+            if (included_)
             {
-                return std::nullopt;
+                included_->push_back(path);
             }
         }
-        std::ifstream cache_file(candidate, std::ios::binary);
-        if (!cache_file)
-        {
-            return std::nullopt;
-        }
-        cache_file.seekg(0, std::ios::end);
-        const std::streamsize cache_size = cache_file.tellg();
-        cache_file.seekg(0, std::ios::beg);
-        if (cache_size > 0 && (cache_size % 4) == 0)
+        else
         {
-            std::vector<std::uint32_t> cached(
-                static_cast<std::size_t>(cache_size / 4));
-            if (cache_file.read(
-                    reinterpret_cast<char*>(cached.data()),
-                    cache_size))
-            {
-                return cached;
-            }
+            // An empty name tells shaderc the include failed.
+            include->content =
+                std::format("Unable to open include file {}", path.string());
         }
-        return std::nullopt;
+        include->result.source_name = include->name.c_str();
+        include->result.source_name_length = include->name.size();
+        include->result.content = include->content.c_str();
+        include->result.content_length = include->content.size();
+        include->result.user_data = include;
+        return &include->result;
+    }
+
+    void ReleaseInclude(shaderc_include_result* data) override
+    {
+        delete static_cast<Include*>(data->user_data);
+    }
+
+  private:
+    struct Include
+    {
+        shaderc_include_result result = {};
+        std::string name;
+        std::string content;
     };
+    std::vector<std::filesystem::path>* included_ = nullptr;
+};
+
+shaderc::CompileOptions MakeCompileOptions(
+    std::vector<std::filesystem::path>* included = nullptr)
+{
+    shaderc::CompileOptions options;
+    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    options.SetIncluder(std::make_unique<RelativeIncluder>(included));
+    return options;
+}
 
-    if (auto cached = try_load_spv(spv_path))
+// FNV-1a, stable across runs and standard libraries (unlike std::hash).
+std::uint64_t HashBytes(std::uint64_t hash, const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
     {
-        return *cached;
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+template <typename T>
+std::uint64_t HashValue(std::uint64_t hash, const T& value)
+{
+    return HashBytes(hash, &value, sizeof(T));
+}
+
+std::uint64_t HashString(std::uint64_t hash, std::string_view value)
+{
+    hash = HashValue(hash, value.size());
+    return HashBytes(hash, value.data(), value.size());
+}
+
+constexpr std::uint64_t kHashBasis = 0xcbf29ce484222325ull;
+
+std::optional<std::vector<std::uint32_t>> ReadSpv(
+    const std::filesystem::path& path)
+{
+    std::error_code error;
+    if (!std::filesystem::exists(path, error) || error)
+    {
+        return std::nullopt;
     }
-    if (spv_path != legacy_spv_path)
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
     {
-        if (auto cached = try_load_spv(legacy_spv_path))
+        return std::nullopt;
+    }
+    file.seekg(0, std::ios::end);
+    const std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size <= 0 || (size % 4) != 0)
+    {
+        return std::nullopt;
+    }
+    std::vector<std::uint32_t> code(static_cast<std::size_t>(size / 4));
+    if (!file.read(reinterpret_cast<char*>(code.data()), size) ||
+        code.front() != kSpirvMagic)
+    {
+        return std::nullopt;
+    }
+    return code;
+}
+
+void WriteSpv(
+    const std::filesystem::path& path, const std::vector<std::uint32_t>& code)
+{
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    // Write then rename so a concurrent reader never sees a partial module.
+    std::ostringstream suffix;
+    suffix << ".tmp" << std::this_thread::get_id();
+    auto temporary_path = path;
+    temporary_path += suffix.str();
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file)
         {
-            return *cached;
+            return;
         }
+        file.write(
+            reinterpret_cast<const char*>(code.data()),
+            static_cast<std::streamsize>(code.size() * sizeof(std::uint32_t)));
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary_path, error);
+    }
+}
+
+// Module produced by the build (glslc) or by older versions, used when the
+// source is not shipped.
+std::filesystem::path GetNamedSpvPath(const std::filesystem::path& source)
+{
+    const auto parent = source.parent_path();
+    if (!parent.empty() && parent.filename() == "vulkan")
+    {
+        const auto asset_root = parent.parent_path().parent_path();
+        return asset_root / "cache" / "shader" / "vulkan" /
+               (source.filename().string() + ".spv");
+    }
+    return std::filesystem::path(source.string() + ".spv");
+}
+
+double GetElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+} // namespace
+
+ShaderCompiler::ShaderCompiler(
+    std::filesystem::path cache_directory, std::size_t memory_capacity)
+    : cache_directory_(std::move(cache_directory)),
+      memory_capacity_(memory_capacity)
+{
+    if (!cache_directory_.empty())
+    {
+        return;
+    }
+    try
+    {
+        cache_directory_ = (frame::file::FindDirectory("asset") / "cache" /
+                            "shader" / "vulkan")
+                               .lexically_normal();
+    }
+    catch (const std::exception& ex)
+    {
+        Logger::GetInstance()->warn(
+            "SPIR-V disk cache disabled: {}", ex.what());
     }
+}
 
-    if (!source_exists)
+std::vector<std::uint32_t> ShaderCompiler::CompileFile(
+    const std::filesystem::path& path,
+    shaderc_shader_kind kind) const
+{
+    const std::filesystem::path named_spv_path = GetNamedSpvPath(path);
+    std::error_code source_error;
+    if (!std::filesystem::exists(path, source_error) || source_error)
     {
+        if (auto cached = ReadSpv(named_spv_path))
+        {
+            return *cached;
+        }
+        if (auto cached = ReadSpv(path.string() + ".spv"))
+        {
+            return *cached;
+        }
         throw std::runtime_error(std::format(
             "Unable to open shader file {} (no SPV cache found)",
             path.string()));
@@ -107,58 +256,258 @@ std::vector<std::uint32_t> ShaderCompiler::CompileFile(
     }
     std::ostringstream stream;
     stream << file.rdbuf();
-    const std::string shader_source = stream.str();
+    auto code = CompileSource(stream.str(), kind, path.string());
 
-    shaderc::Compiler compiler;
-    shaderc::CompileOptions options;
-    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    // Keep the named module current for deployments without the sources.
+    const auto source_time =
+        std::filesystem::last_write_time(path, source_error);
+    std::error_code named_error;
+    const auto named_time =
+        std::filesystem::last_write_time(named_spv_path, named_error);
+    if (!source_error && (named_error || named_time < source_time))
+    {
+        WriteSpv(named_spv_path, code);
+    }
+    return code;
+}
+
+std::vector<std::uint32_t> ShaderCompiler::CompileSource(
+    const std::string& source,
+    shaderc_shader_kind kind,
+    const std::string& identifier) const
+{
+    FRAME_PROFILE_SCOPE("Compile shader");
+    auto& logger = Logger::GetInstance();
+    const auto start = std::chrono::steady_clock::now();
+    // Same raw source, kind and identifier as an earlier call whose includes
+    // did not change: the module is looked up without preprocessing.
+    const std::uint64_t source_hash = HashString(
+        HashString(
+            HashValue(kHashBasis, static_cast<std::int32_t>(kind)),
+            identifier),
+        source);
+    if (auto source_key = FindSourceKey(source_hash))
+    {
+        if (auto cached = FindInMemory(*source_key))
+        {
+            logger->debug("SPIR-V cache memory hit for {}.", identifier);
+            return *cached;
+        }
+    }
+    std::vector<IncludedFile> includes;
+    const std::uint64_t key = MakeKey(source, kind, identifier, includes);
+    {
+        std::scoped_lock lock(mutex_);
+        source_keys_[source_hash] = {key, std::move(includes)};
+    }
+    if (auto cached = FindInMemory(key))
+    {
+        logger->debug("SPIR-V cache memory hit for {}.", identifier);
+        return *cached;
+    }
+    const auto cache_path = GetCachePath(key);
+    if (!cache_path.empty())
+    {
+        if (auto cached = ReadSpv(cache_path))
+        {
+            {
+                std::scoped_lock lock(mutex_);
+                ++stats_.disk_hits;
+            }
+            StoreInMemory(key, *cached);
+            logger->debug(
+                "SPIR-V cache disk hit for {} ({:.2f} ms).",
+                identifier,
+                GetElapsedMs(start));
+            return *cached;
+        }
+    }
 
+    shaderc::Compiler compiler;
     auto result = compiler.CompileGlslToSpv(
-        shader_source,
+        source,
         kind,
-        path.string().c_str(),
+        identifier.c_str(),
         "main",
-        options);
-
+        MakeCompileOptions());
     if (result.GetCompilationStatus() != shaderc_compilation_status_success)
     {
         throw std::runtime_error(result.GetErrorMessage());
     }
-
     std::vector<std::uint32_t> compiled{result.cbegin(), result.cend()};
-    std::error_code write_error;
-    std::filesystem::create_directories(
-        spv_path.parent_path(), write_error);
-    std::ofstream cache_out(spv_path, std::ios::binary | std::ios::trunc);
-    if (cache_out)
     {
-        cache_out.write(
-            reinterpret_cast<const char*>(compiled.data()),
-            static_cast<std::streamsize>(
-                compiled.size() * sizeof(std::uint32_t)));
+        std::scoped_lock lock(mutex_);
+        ++stats_.misses;
+    }
+    StoreInMemory(key, compiled);
+    if (!cache_path.empty())
+    {
+        WriteSpv(cache_path, compiled);
     }
+    logger->info(
+        "SPIR-V cache miss for {}, compiled in {:.2f} ms.",
+        identifier,
+        GetElapsedMs(start));
     return compiled;
 }
 
-std::vector<std::uint32_t> ShaderCompiler::CompileSource(
+void ShaderCompiler::CompileFiles(
+    const std::vector<ShaderCompileRequest>& requests,
+    std::size_t thread_count) const
+{
+    FRAME_PROFILE_SCOPE("Compile shaders");
+    auto& scheduler = jobs::Scheduler::GetInstance();
+    if (thread_count == 0)
+    {
+        thread_count = scheduler.GetWorkerCount() + 1;
+    }
+    thread_count = std::min(thread_count, requests.size());
+    // Each job compiles until the list is exhausted, so no more than
+    // thread_count modules are compiled at once.
+    std::atomic<std::size_t> next = 0;
+    auto compile = [this, &requests, &next] {
+        for (std::size_t i = next++; i < requests.size(); i = next++)
+        {
+            try
+            {
+                CompileFile(requests[i].path, requests[i].kind);
+            }
+            catch (const std::exception& ex)
+            {
+                Logger::GetInstance()->warn(
+                    "Failed to compile shader {}: {}",
+                    requests[i].path.string(),
+                    ex.what());
+            }
+        }
+    };
+    jobs::Counter counter;
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        scheduler.Run(compile, counter);
+    }
+    // The calling thread runs jobs while it waits.
+    scheduler.Wait(counter);
+}
+
+ShaderCacheStats ShaderCompiler::GetCacheStats() const
+{
+    std::scoped_lock lock(mutex_);
+    return stats_;
+}
+
+std::uint64_t ShaderCompiler::MakeKey(
     const std::string& source,
     shaderc_shader_kind kind,
-    const std::string& identifier) const
+    const std::string& identifier,
+    std::vector<IncludedFile>& includes) const
 {
+    // Preprocessing expands the includes, so the key follows what the
+    // compiler actually sees.
+    std::vector<std::filesystem::path> included;
     shaderc::Compiler compiler;
-    shaderc::CompileOptions options;
-    options.SetOptimizationLevel(shaderc_optimization_level_performance);
-    auto result = compiler.CompileGlslToSpv(
-        source,
-        kind,
-        identifier.c_str(),
-        "main",
-        options);
+    auto result = compiler.PreprocessGlsl(
+        source, kind, identifier.c_str(), MakeCompileOptions(&included));
+    {
+        std::scoped_lock lock(mutex_);
+        ++stats_.preprocessed;
+    }
     if (result.GetCompilationStatus() != shaderc_compilation_status_success)
     {
         throw std::runtime_error(result.GetErrorMessage());
     }
-    return {result.cbegin(), result.cend()};
+    includes.clear();
+    for (auto& path : included)
+    {
+        std::error_code error;
+        IncludedFile file;
+        file.time = std::filesystem::last_write_time(path, error);
+        file.size = std::filesystem::file_size(path, error);
+        file.path = std::move(path);
+        includes.push_back(std::move(file));
+    }
+    unsigned int spv_version = 0;
+    unsigned int spv_revision = 0;
+    shaderc_get_spv_version(&spv_version, &spv_revision);
+    const std::string preprocessed(result.cbegin(), result.cend());
+    std::uint64_t hash = kHashBasis;
+    hash = HashString(hash, preprocessed);
+    hash = HashValue(hash, static_cast<std::int32_t>(kind));
+    hash = HashString(hash, kOptionsSignature);
+    hash = HashValue(hash, spv_version);
+    return HashValue(hash, spv_revision);
+}
+
+std::optional<std::uint64_t> ShaderCompiler::FindSourceKey(
+    std::uint64_t source_hash) const
+{
+    SourceKey source_key;
+    {
+        std::scoped_lock lock(mutex_);
+        auto it = source_keys_.find(source_hash);
+        if (it == source_keys_.end())
+        {
+            return std::nullopt;
+        }
+        source_key = it->second;
+    }
+    // An included file that changed (or is gone) needs a new key.
+    for (const auto& file : source_key.includes)
+    {
+        std::error_code error;
+        const auto time = std::filesystem::last_write_time(file.path, error);
+        if (error || time != file.time ||
+            std::filesystem::file_size(file.path, error) != file.size ||
+            error)
+        {
+            return std::nullopt;
+        }
+    }
+    return source_key.key;
+}
+
+std::optional<std::vector<std::uint32_t>> ShaderCompiler::FindInMemory(
+    std::uint64_t key) const
+{
+    std::scoped_lock lock(mutex_);
+    auto it = entry_map_.find(key);
+    if (it == entry_map_.end())
+    {
+        return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    ++stats_.memory_hits;
+    return it->second->code;
+}
+
+void ShaderCompiler::StoreInMemory(
+    std::uint64_t key, const std::vector<std::uint32_t>& code) const
+{
+    if (memory_capacity_ == 0)
+    {
+        return;
+    }
+    std::scoped_lock lock(mutex_);
+    if (entry_map_.contains(key))
+    {
+        return;
+    }
+    entries_.push_front({key, code});
+    entry_map_[key] = entries_.begin();
+    while (entries_.size() > memory_capacity_)
+    {
+        entry_map_.erase(entries_.back().key);
+        entries_.pop_back();
+    }
+}
+
+std::filesystem::path ShaderCompiler::GetCachePath(std::uint64_t key) const
+{
+    if (cache_directory_.empty())
+    {
+        return {};
+    }
+    return cache_directory_ / std::format("{:016x}.spv", key);
 }
 
 } // namespace frame::vulkan
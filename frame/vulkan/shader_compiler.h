@@ -2,7 +2,11 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <shaderc/shaderc.h>
@@ -10,9 +14,38 @@
 namespace frame::vulkan
 {
 
+// Lookups of the SPIR-V cache since the compiler was created.
+struct ShaderCacheStats
+{
+    std::uint32_t memory_hits = 0;
+    std::uint32_t disk_hits = 0;
+    std::uint32_t misses = 0;
+    // Sources run through the preprocessor to build their key.
+    std::uint32_t preprocessed = 0;
+};
+
+struct ShaderCompileRequest
+{
+    std::filesystem::path path;
+    shaderc_shader_kind kind = shaderc_glsl_infer_from_source;
+};
+
+// GLSL to SPIR-V with a content addressed cache: the key hashes the
+// preprocessed source (includes expanded), the shader kind, the compile
+// options and the shaderc SPIR-V version. Recent modules stay in memory
+// (LRU) and every module is stored on disk as <key>.spv, so level reloads
+// and restarts skip compilation. The key of a raw source is remembered with
+// the files it included, a memory hit only preprocesses again if one of
+// them changed. Thread safe.
 class ShaderCompiler
 {
   public:
+    // cache_directory: disk store, asset/cache/shader/vulkan if empty.
+    // memory_capacity: modules kept in memory.
+    explicit ShaderCompiler(
+        std::filesystem::path cache_directory = {},
+        std::size_t memory_capacity = 64);
+
     std::vector<std::uint32_t> CompileFile(
         const std::filesystem::path& path,
         shaderc_shader_kind kind) const;
@@ -20,6 +53,56 @@ class ShaderCompiler
         const std::string& source,
         shaderc_shader_kind kind,
         const std::string& identifier) const;
+    // Compile (or find in the cache) the modules with up to thread_count
+    // jobs of the scheduler (0: one per thread of the pool), the pipelines
+    // then hit the memory cache.
+    // Failures are logged and reported again by CompileFile.
+    void CompileFiles(
+        const std::vector<ShaderCompileRequest>& requests,
+        std::size_t thread_count) const;
+    ShaderCacheStats GetCacheStats() const;
+
+  private:
+    struct CacheEntry
+    {
+        std::uint64_t key = 0;
+        std::vector<std::uint32_t> code;
+    };
+    struct IncludedFile
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type time;
+        std::uintmax_t size = 0;
+    };
+    // Key of a raw source and the files it included when it was made.
+    struct SourceKey
+    {
+        std::uint64_t key = 0;
+        std::vector<IncludedFile> includes;
+    };
+    std::uint64_t MakeKey(
+        const std::string& source,
+        shaderc_shader_kind kind,
+        const std::string& identifier,
+        std::vector<IncludedFile>& includes) const;
+    std::optional<std::uint64_t> FindSourceKey(std::uint64_t source_hash) const;
+    std::optional<std::vector<std::uint32_t>> FindInMemory(
+        std::uint64_t key) const;
+    void StoreInMemory(
+        std::uint64_t key, const std::vector<std::uint32_t>& code) const;
+    std::filesystem::path GetCachePath(std::uint64_t key) const;
+
+  private:
+    std::filesystem::path cache_directory_;
+    std::size_t memory_capacity_ = 0;
+    mutable std::mutex mutex_;
+    // Most recently used first.
+    mutable std::list<CacheEntry> entries_;
+    mutable std::unordered_map<std::uint64_t, std::list<CacheEntry>::iterator>
+        entry_map_;
+    // Raw source hash (with the kind and the identifier) to its key.
+    mutable std::unordered_map<std::uint64_t, SourceKey> source_keys_;
+    mutable ShaderCacheStats stats_ = {};
 };
 
 } // namespace frame::vulkan
@@ -22,6 +22,11 @@ class SkinnedMesh : public StaticMesh
     }
     ~SkinnedMesh() override = default;
 
+    frame::MeshTypeEnum GetMeshType() const override
+    {
+        return frame::MeshTypeEnum::SKINNED_MESH;
+    }
+
     void SetSkinningAnimation(bool enabled, float speed = 1.0f)
     {
         skinning_animation_enabled_ = enabled;
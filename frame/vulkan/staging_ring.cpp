@@ -0,0 +1,121 @@
+#include "frame/vulkan/staging_ring.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace frame::vulkan
+{
+
+namespace
+{
+
+constexpr vk::DeviceSize kUploadAlignment = 16;
+
+} // namespace
+
+StagingRing::StagingRing(
+    GpuMemoryManager& memory_manager,
+    std::size_t frame_count,
+    vk::DeviceSize frame_size)
+    : memory_manager_(&memory_manager),
+      regions_(std::max<std::size_t>(frame_count, 1))
+{
+    for (auto& region : regions_)
+    {
+        CreateRegion(region, frame_size);
+    }
+}
+
+void StagingRing::BeginFrame(std::size_t frame_index)
+{
+    current_ = frame_index % regions_.size();
+    auto& region = regions_[current_];
+    if (region.requested > region.capacity)
+    {
+        CreateRegion(
+            region,
+            std::max(std::bit_ceil(region.requested), region.capacity * 2));
+    }
+    region.offset = 0;
+    region.requested = 0;
+    region.copies.clear();
+}
+
+bool StagingRing::Upload(
+    const void* data,
+    vk::DeviceSize size,
+    vk::Buffer destination,
+    vk::DeviceSize destination_offset)
+{
+    auto& region = regions_[current_];
+    const vk::DeviceSize offset =
+        (region.offset + kUploadAlignment - 1) & ~(kUploadAlignment - 1);
+    region.requested += size + kUploadAlignment;
+    if (offset + size > region.capacity)
+    {
+        return false;
+    }
+    std::memcpy(
+        static_cast<std::byte*>(region.allocation.GetMappedData()) + offset,
+        data,
+        size);
+    region.offset = offset + size;
+    region.copies.push_back(
+        {destination, vk::BufferCopy(offset, destination_offset, size)});
+    return true;
+}
+
+std::size_t StagingRing::RecordCopies(vk::CommandBuffer command_buffer)
+{
+    auto& region = regions_[current_];
+    if (region.copies.empty())
+    {
+        return 0;
+    }
+    // The destinations may still be read by the previous frames.
+    command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eAllCommands,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        nullptr,
+        nullptr,
+        nullptr);
+    for (const auto& copy : region.copies)
+    {
+        command_buffer.copyBuffer(
+            *region.buffer, copy.destination, copy.region);
+    }
+    const std::size_t copy_count = region.copies.size();
+    region.copies.clear();
+    return copy_count;
+}
+
+void StagingRing::DiscardCopies()
+{
+    for (auto& region : regions_)
+    {
+        region.copies.clear();
+    }
+}
+
+vk::DeviceSize StagingRing::GetCapacity(std::size_t frame_index) const
+{
+    return regions_[frame_index % regions_.size()].capacity;
+}
+
+void StagingRing::CreateRegion(Region& region, vk::DeviceSize size)
+{
+    // Release the old memory first so it can be reused.
+    region.buffer.reset();
+    region.allocation.Reset();
+    region.buffer = memory_manager_->CreateBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        region.allocation);
+    region.capacity = size;
+}
+
+} // namespace frame::vulkan
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+#include "frame/vulkan/gpu_memory_manager.h"
+
+namespace frame::vulkan
+{
+
+// Persistently mapped staging memory for the uploads of a frame, one region
+// per frame in flight. A region is only reused once the fence of its frame
+// has been waited on, so BeginFrame has to be called after that wait.
+class StagingRing
+{
+  public:
+    StagingRing(
+        GpuMemoryManager& memory_manager,
+        std::size_t frame_count,
+        vk::DeviceSize frame_size = 1ull << 20);
+
+    // Rewind the region of the frame, grown if it overflowed the last time.
+    void BeginFrame(std::size_t frame_index);
+    // Copy the data to the region and queue a copy to the destination.
+    // Returns false when the region is full, the caller has to upload it
+    // another way for this frame.
+    bool Upload(
+        const void* data,
+        vk::DeviceSize size,
+        vk::Buffer destination,
+        vk::DeviceSize destination_offset = 0);
+    // Record the queued copies in the command buffer of the frame.
+    std::size_t RecordCopies(vk::CommandBuffer command_buffer);
+    // Forget the queued copies (their destinations are going away).
+    void DiscardCopies();
+    vk::DeviceSize GetCapacity(std::size_t frame_index) const;
+
+  private:
+    struct Copy
+    {
+        vk::Buffer destination;
+        vk::BufferCopy region;
+    };
+    struct Region
+    {
+        vk::UniqueBuffer buffer;
+        GpuAllocation allocation;
+        vk::DeviceSize capacity = 0;
+        vk::DeviceSize offset = 0;
+        // Bytes asked for during the frame, including the ones that did not
+        // fit.
+        vk::DeviceSize requested = 0;
+        std::vector<Copy> copies;
+    };
+
+    void CreateRegion(Region& region, vk::DeviceSize size);
+
+    GpuMemoryManager* memory_manager_;
+    std::vector<Region> regions_;
+    std::size_t current_ = 0;
+};
+
+} // namespace frame::vulkan
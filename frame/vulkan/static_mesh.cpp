@@ -79,6 +79,7 @@ frame::EntityId CreateQuadStaticMesh(frame::LevelInterface& level)
         frame::proto::NodeMesh::TRIANGLE_PRIMITIVE;
 
     auto mesh = std::make_unique<StaticMesh>(parameter, true);
+    mesh->SetBoundingVolume(frame::ComputeBoundingVolume(points));
     mesh->SetName(std::format("QuadMesh.{}", count));
     mesh->SetIndexSize(indices.size() * sizeof(std::uint32_t));
     return level.AddMesh(std::move(mesh));
@@ -224,6 +225,7 @@ frame::EntityId CreateCubeStaticMesh(frame::LevelInterface& level)
         frame::proto::NodeMesh::TRIANGLE_PRIMITIVE;
 
     auto mesh = std::make_unique<StaticMesh>(parameter, true);
+    mesh->SetBoundingVolume(frame::ComputeBoundingVolume(points));
     mesh->SetName(std::format("CubeMesh.{}", count));
     mesh->SetIndexSize(indices.size() * sizeof(std::uint32_t));
     return level.AddMesh(std::move(mesh));
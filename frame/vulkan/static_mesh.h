@@ -52,11 +52,25 @@ class StaticMesh : public frame::MeshInterface
     {
         return clear_buffer_;
     }
+    const frame::BoundingVolume& GetBoundingVolume() const override
+    {
+        return bounding_volume_;
+    }
+    void SetBoundingVolume(
+        const frame::BoundingVolume& bounding_volume) override
+    {
+        bounding_volume_ = bounding_volume;
+    }
+    frame::MeshTypeEnum GetMeshType() const override
+    {
+        return frame::MeshTypeEnum::STATIC_MESH;
+    }
 
   private:
     frame::MeshParameter parameter_ = {};
     std::size_t index_size_ = 0;
     bool clear_buffer_ = true;
+    frame::BoundingVolume bounding_volume_ = {};
 };
 
 frame::EntityId CreateQuadStaticMesh(frame::LevelInterface& level);
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <limits>
+#include <stdexcept>
 
 namespace frame::vulkan
 {
@@ -13,13 +14,15 @@ SwapchainResources::SwapchainResources(
     vk::SurfaceKHR surface,
     std::uint32_t graphics_queue_family_index,
     std::uint32_t present_queue_family_index,
-    const Logger& logger)
+    const Logger& logger,
+    std::uint32_t offscreen_image_count)
     : physical_device_(physical_device),
       device_(device),
       surface_(surface),
       graphics_queue_family_index_(graphics_queue_family_index),
       present_queue_family_index_(present_queue_family_index),
-      logger_(logger)
+      logger_(logger),
+      offscreen_image_count_(std::max(offscreen_image_count, 1u))
 {
 }
 
@@ -27,63 +30,15 @@ void SwapchainResources::Create(glm::uvec2 size)
 {
     Destroy();
 
-    const auto capabilities =
-        physical_device_.getSurfaceCapabilitiesKHR(surface_);
-    const auto formats =
-        physical_device_.getSurfaceFormatsKHR(surface_);
-    const auto present_modes =
-        physical_device_.getSurfacePresentModesKHR(surface_);
-
-    const vk::SurfaceFormatKHR surface_format =
-        SelectSurfaceFormat(formats);
-    const vk::PresentModeKHR present_mode =
-        SelectPresentMode(present_modes);
-    const vk::Extent2D extent = SelectSwapExtent(capabilities, size);
-
-    std::uint32_t image_count = capabilities.minImageCount + 1;
-    if (capabilities.maxImageCount > 0 &&
-        image_count > capabilities.maxImageCount)
-    {
-        image_count = capabilities.maxImageCount;
-    }
-
-    vk::SwapchainCreateInfoKHR swapchain_info(
-        {},
-        surface_,
-        image_count,
-        surface_format.format,
-        surface_format.colorSpace,
-        extent,
-        1,
-        vk::ImageUsageFlagBits::eColorAttachment |
-            vk::ImageUsageFlagBits::eTransferSrc);
-
-    std::array<std::uint32_t, 2> queue_family_indices = {
-        graphics_queue_family_index_,
-        present_queue_family_index_};
-    if (graphics_queue_family_index_ != present_queue_family_index_)
+    if (IsOffscreen())
     {
-        swapchain_info.imageSharingMode = vk::SharingMode::eConcurrent;
-        swapchain_info.queueFamilyIndexCount = 2;
-        swapchain_info.pQueueFamilyIndices = queue_family_indices.data();
+        CreateOffscreenImages(size);
     }
     else
     {
-        swapchain_info.imageSharingMode = vk::SharingMode::eExclusive;
-        swapchain_info.queueFamilyIndexCount = 0;
-        swapchain_info.pQueueFamilyIndices = nullptr;
+        CreateSwapchain(size);
     }
 
-    swapchain_info.preTransform = capabilities.currentTransform;
-    swapchain_info.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque;
-    swapchain_info.presentMode = present_mode;
-    swapchain_info.clipped = VK_TRUE;
-
-    swapchain_ = device_.createSwapchainKHRUnique(swapchain_info);
-    images_ = device_.getSwapchainImagesKHR(*swapchain_);
-    image_format_ = surface_format.format;
-    extent_ = extent;
-
     image_views_.clear();
     image_views_.reserve(images_.size());
     for (const auto& image : images_)
@@ -107,7 +62,7 @@ void SwapchainResources::Create(glm::uvec2 size)
         vk::AttachmentStoreOp::eStore,
         vk::AttachmentLoadOp::eDontCare,
         vk::AttachmentStoreOp::eDontCare,
-        ScenePassInitialLayout(),
+        GetPresentLayout(),
         ScenePassFinalLayout());
 
     vk::AttachmentReference color_ref(
@@ -169,7 +124,7 @@ void SwapchainResources::Create(glm::uvec2 size)
         vk::AttachmentLoadOp::eDontCare,
         vk::AttachmentStoreOp::eDontCare,
         GuiPassInitialLayout(),
-        GuiPassFinalLayout());
+        GetPresentLayout());
 
     vk::AttachmentReference gui_color_ref(
         0, vk::ImageLayout::eColorAttachmentOptimal);
@@ -229,7 +184,8 @@ void SwapchainResources::Create(glm::uvec2 size)
     }
 
     logger_->info(
-        "Created Vulkan swapchain ({}x{}, {} images).",
+        "Created Vulkan {} ({}x{}, {} images).",
+        IsOffscreen() ? "offscreen target" : "swapchain",
         extent_.width,
         extent_.height,
         static_cast<unsigned int>(images_.size()));
@@ -243,6 +199,8 @@ void SwapchainResources::Destroy()
     render_pass_.reset();
     image_views_.clear();
     images_.clear();
+    offscreen_images_.clear();
+    offscreen_memory_.clear();
     swapchain_.reset();
 }
 
@@ -252,6 +210,127 @@ void SwapchainResources::Recreate(glm::uvec2 size)
     Create(size);
 }
 
+void SwapchainResources::CreateSwapchain(glm::uvec2 size)
+{
+    const auto capabilities =
+        physical_device_.getSurfaceCapabilitiesKHR(surface_);
+    const auto formats =
+        physical_device_.getSurfaceFormatsKHR(surface_);
+    const auto present_modes =
+        physical_device_.getSurfacePresentModesKHR(surface_);
+
+    const vk::SurfaceFormatKHR surface_format =
+        SelectSurfaceFormat(formats);
+    const vk::PresentModeKHR present_mode =
+        SelectPresentMode(present_modes);
+    const vk::Extent2D extent = SelectSwapExtent(capabilities, size);
+
+    std::uint32_t image_count = capabilities.minImageCount + 1;
+    if (capabilities.maxImageCount > 0 &&
+        image_count > capabilities.maxImageCount)
+    {
+        image_count = capabilities.maxImageCount;
+    }
+
+    vk::SwapchainCreateInfoKHR swapchain_info(
+        {},
+        surface_,
+        image_count,
+        surface_format.format,
+        surface_format.colorSpace,
+        extent,
+        1,
+        vk::ImageUsageFlagBits::eColorAttachment |
+            vk::ImageUsageFlagBits::eTransferSrc);
+
+    std::array<std::uint32_t, 2> queue_family_indices = {
+        graphics_queue_family_index_,
+        present_queue_family_index_};
+    if (graphics_queue_family_index_ != present_queue_family_index_)
+    {
+        swapchain_info.imageSharingMode = vk::SharingMode::eConcurrent;
+        swapchain_info.queueFamilyIndexCount = 2;
+        swapchain_info.pQueueFamilyIndices = queue_family_indices.data();
+    }
+    else
+    {
+        swapchain_info.imageSharingMode = vk::SharingMode::eExclusive;
+        swapchain_info.queueFamilyIndexCount = 0;
+        swapchain_info.pQueueFamilyIndices = nullptr;
+    }
+
+    swapchain_info.preTransform = capabilities.currentTransform;
+    swapchain_info.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque;
+    swapchain_info.presentMode = present_mode;
+    swapchain_info.clipped = VK_TRUE;
+
+    swapchain_ = device_.createSwapchainKHRUnique(swapchain_info);
+    images_ = device_.getSwapchainImagesKHR(*swapchain_);
+    image_format_ = surface_format.format;
+    extent_ = extent;
+}
+
+void SwapchainResources::CreateOffscreenImages(glm::uvec2 size)
+{
+    // Same format as the preferred surface one, the pipelines do not depend
+    // on the target.
+    const vk::FormatFeatureFlags required_features =
+        vk::FormatFeatureFlagBits::eColorAttachment |
+        vk::FormatFeatureFlagBits::eTransferSrc;
+    image_format_ = vk::Format::eB8G8R8A8Unorm;
+    if ((physical_device_.getFormatProperties(image_format_)
+             .optimalTilingFeatures &
+         required_features) != required_features)
+    {
+        image_format_ = vk::Format::eR8G8B8A8Unorm;
+    }
+    extent_ = vk::Extent2D{std::max(size.x, 1u), std::max(size.y, 1u)};
+
+    const auto memory_properties = physical_device_.getMemoryProperties();
+    for (std::uint32_t i = 0; i < offscreen_image_count_; ++i)
+    {
+        vk::ImageCreateInfo image_info(
+            {},
+            vk::ImageType::e2D,
+            image_format_,
+            vk::Extent3D{extent_.width, extent_.height, 1},
+            1,
+            1,
+            vk::SampleCountFlagBits::e1,
+            vk::ImageTiling::eOptimal,
+            vk::ImageUsageFlagBits::eColorAttachment |
+                vk::ImageUsageFlagBits::eTransferSrc,
+            vk::SharingMode::eExclusive);
+        auto image = device_.createImageUnique(image_info);
+
+        const auto requirements = device_.getImageMemoryRequirements(*image);
+        std::uint32_t memory_type = std::numeric_limits<std::uint32_t>::max();
+        for (std::uint32_t type = 0; type < memory_properties.memoryTypeCount;
+             ++type)
+        {
+            if ((requirements.memoryTypeBits & (1u << type)) &&
+                (memory_properties.memoryTypes[type].propertyFlags &
+                 vk::MemoryPropertyFlagBits::eDeviceLocal))
+            {
+                memory_type = type;
+                break;
+            }
+        }
+        if (memory_type == std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::runtime_error(
+                "No device local memory for the offscreen images.");
+        }
+        auto memory = device_.allocateMemoryUnique(
+            vk::MemoryAllocateInfo(requirements.size, memory_type));
+        device_.bindImageMemory(*image, *memory, 0);
+
+        images_.push_back(*image);
+        offscreen_images_.push_back(std::move(image));
+        offscreen_memory_.push_back(std::move(memory));
+    }
+}
+
 vk::SurfaceFormatKHR SwapchainResources::SelectSurfaceFormat(
     const std::vector<vk::SurfaceFormatKHR>& formats) const
 {
@@ -11,6 +11,9 @@
 namespace frame::vulkan
 {
 
+// Swapchain of the surface, or without a surface (headless) a ring of
+// offscreen images rendered to the same way and read back instead of being
+// presented.
 class SwapchainResources
 {
   public:
@@ -37,7 +40,8 @@ class SwapchainResources
         vk::SurfaceKHR surface,
         std::uint32_t graphics_queue_family_index,
         std::uint32_t present_queue_family_index,
-        const Logger& logger);
+        const Logger& logger,
+        std::uint32_t offscreen_image_count = 2);
 
     void Create(glm::uvec2 size);
     void Destroy();
@@ -45,7 +49,18 @@ class SwapchainResources
 
     bool IsValid() const
     {
-        return static_cast<bool>(swapchain_);
+        return static_cast<bool>(swapchain_) || !offscreen_images_.empty();
+    }
+    bool IsOffscreen() const
+    {
+        return !surface_;
+    }
+    // Layout of the images between frames: presentable, or ready to be
+    // copied out when offscreen (ePresentSrcKHR needs the swapchain).
+    vk::ImageLayout GetPresentLayout() const
+    {
+        return IsOffscreen() ? vk::ImageLayout::eTransferSrcOptimal
+                             : vk::ImageLayout::ePresentSrcKHR;
     }
 
     const vk::UniqueSwapchainKHR& GetSwapchain() const
@@ -92,6 +107,8 @@ class SwapchainResources
     }
 
   private:
+    void CreateSwapchain(glm::uvec2 size);
+    void CreateOffscreenImages(glm::uvec2 size);
     vk::SurfaceFormatKHR SelectSurfaceFormat(
         const std::vector<vk::SurfaceFormatKHR>& formats) const;
     vk::PresentModeKHR SelectPresentMode(
@@ -106,10 +123,14 @@ class SwapchainResources
     std::uint32_t graphics_queue_family_index_ = 0;
     std::uint32_t present_queue_family_index_ = 0;
     const Logger& logger_;
+    std::uint32_t offscreen_image_count_ = 2;
     vk::Format image_format_ = vk::Format::eUndefined;
     vk::Extent2D extent_{};
     vk::UniqueSwapchainKHR swapchain_;
     std::vector<vk::Image> images_;
+    // Owned images and their memory when offscreen.
+    std::vector<vk::UniqueImage> offscreen_images_;
+    std::vector<vk::UniqueDeviceMemory> offscreen_memory_;
     std::vector<vk::UniqueImageView> image_views_;
     vk::UniqueRenderPass render_pass_;
     std::vector<vk::UniqueFramebuffer> framebuffers_;
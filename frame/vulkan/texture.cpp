@@ -208,7 +208,7 @@ void Texture::SetGpuResources(
     vk::Format format,
     vk::ImageViewType view_type,
     vk::UniqueImage image,
-    vk::UniqueDeviceMemory memory,
+    GpuAllocation memory,
     vk::UniqueImageView view,
     vk::UniqueSampler sampler)
 {
@@ -7,6 +7,7 @@
 #include "frame/vulkan/vulkan_dispatch.h"
 
 #include "frame/texture_interface.h"
+#include "frame/vulkan/gpu_memory_manager.h"
 
 namespace frame::vulkan
 {
@@ -55,7 +56,7 @@ class Texture : public frame::TextureInterface
         vk::Format format,
         vk::ImageViewType view_type,
         vk::UniqueImage image,
-        vk::UniqueDeviceMemory memory,
+        GpuAllocation memory,
         vk::UniqueImageView view,
         vk::UniqueSampler sampler);
     bool MoveGpuResourcesTo(Texture& target);
@@ -76,7 +77,7 @@ class Texture : public frame::TextureInterface
     vk::Format gpu_format_ = vk::Format::eUndefined;
     vk::ImageViewType view_type_ = vk::ImageViewType::e2D;
     vk::UniqueImage image_;
-    vk::UniqueDeviceMemory memory_;
+    GpuAllocation memory_;
     vk::UniqueImageView view_;
     vk::UniqueSampler sampler_;
 };
@@ -10,9 +10,11 @@
 #include <glm/gtc/packing.hpp>
 
 #include "frame/level.h"
+#include "frame/vulkan/bindless_texture_table.h"
 #include "frame/vulkan/command_queue.h"
 #include "frame/vulkan/device.h"
 #include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/upload_context.h"
 
 namespace frame::vulkan
 {
@@ -54,6 +56,12 @@ void TextureResources::Build(
                 UploadTexture(texture_id, *texture_ptr);
             }
             textures_[texture_id] = texture_ptr;
+            if (owner_.bindless_textures_)
+            {
+                bindless_indices_[texture_id] =
+                    owner_.bindless_textures_->Add(
+                        texture_ptr->GetDescriptorInfo());
+            }
             ++uploaded_count;
             const auto elapsed =
                 std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -80,6 +88,9 @@ void TextureResources::Build(
         }
     }
 
+    // Waited on before the first frame, not here.
+    owner_.upload_context_->Submit();
+
     const auto total_elapsed =
         std::chrono::duration_cast<std::chrono::milliseconds>(
             Clock::now() - total_start);
@@ -91,6 +102,11 @@ void TextureResources::Build(
 
 void TextureResources::Destroy()
 {
+    // The images may still be written by the transfer queue.
+    if (owner_.upload_context_)
+    {
+        owner_.upload_context_->WaitIdle();
+    }
     for (auto& [id, texture_ptr] : textures_)
     {
         if (texture_ptr)
@@ -99,6 +115,18 @@ void TextureResources::Destroy()
         }
     }
     textures_.clear();
+    bindless_indices_.clear();
+    if (owner_.bindless_textures_)
+    {
+        owner_.bindless_textures_->Clear();
+    }
+}
+
+std::uint32_t TextureResources::GetBindlessIndex(EntityId id) const
+{
+    const auto it = bindless_indices_.find(id);
+    return it != bindless_indices_.end() ? it->second
+                                         : BindlessTextureTable::kInvalidIndex;
 }
 
 bool TextureResources::CollectDescriptorInfos(
@@ -374,19 +402,6 @@ void TextureResources::UploadTexture(
         throw std::runtime_error("Texture upload buffer is empty.");
     }
 
-    vk::UniqueDeviceMemory staging_memory;
-    auto staging_buffer = owner_.gpu_memory_manager_->CreateBuffer(
-        upload_data->size(),
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible |
-            vk::MemoryPropertyFlagBits::eHostCoherent,
-        staging_memory);
-    void* mapped_data =
-        owner_.vk_unique_device_->mapMemory(
-            *staging_memory, 0, upload_data->size());
-    std::memcpy(mapped_data, upload_data->data(), upload_data->size());
-    owner_.vk_unique_device_->unmapMemory(*staging_memory);
-
     const std::uint32_t layer_count = static_cast<std::uint32_t>(face_count);
 
     vk::ImageCreateInfo image_info(
@@ -401,93 +416,18 @@ void TextureResources::UploadTexture(
         vk::ImageUsageFlagBits::eTransferDst |
             (is_depth ? vk::ImageUsageFlagBits::eDepthStencilAttachment
                       : vk::ImageUsageFlagBits::eSampled));
+    // Written by the transfer queue, sampled by the graphics one.
+    const auto& queue_families =
+        owner_.gpu_memory_manager_->GetQueueFamilies();
+    if (queue_families.size() > 1)
+    {
+        image_info.setSharingMode(vk::SharingMode::eConcurrent)
+            .setQueueFamilyIndices(queue_families);
+    }
 
     auto image = owner_.vk_unique_device_->createImageUnique(image_info);
-    auto requirements = owner_.vk_unique_device_->getImageMemoryRequirements(*image);
-    vk::MemoryAllocateInfo allocate_info(
-        requirements.size,
-        owner_.gpu_memory_manager_->FindMemoryType(
-            requirements.memoryTypeBits,
-            vk::MemoryPropertyFlagBits::eDeviceLocal));
-    auto image_memory = owner_.vk_unique_device_->allocateMemoryUnique(allocate_info);
-    owner_.vk_unique_device_->bindImageMemory(*image, *image_memory, 0);
-
-    owner_.command_queue_->SubmitOneTime([&](vk::CommandBuffer command_buffer) {
-        auto record_transition = [&](vk::ImageLayout old_layout,
-                                     vk::ImageLayout new_layout) {
-            vk::ImageMemoryBarrier barrier(
-                {},
-                {},
-                old_layout,
-                new_layout,
-                VK_QUEUE_FAMILY_IGNORED,
-                VK_QUEUE_FAMILY_IGNORED,
-                *image,
-                {vk::ImageAspectFlagBits::eColor, 0, 1, 0, layer_count});
-
-            vk::PipelineStageFlags src_stage;
-            vk::PipelineStageFlags dst_stage;
-
-            if (old_layout == vk::ImageLayout::eUndefined &&
-                new_layout == vk::ImageLayout::eTransferDstOptimal)
-            {
-                barrier.srcAccessMask = {};
-                barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-                src_stage = vk::PipelineStageFlagBits::eTopOfPipe;
-                dst_stage = vk::PipelineStageFlagBits::eTransfer;
-            }
-            else if (old_layout == vk::ImageLayout::eTransferDstOptimal &&
-                     new_layout == vk::ImageLayout::eShaderReadOnlyOptimal)
-            {
-                barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-                barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-                src_stage = vk::PipelineStageFlagBits::eTransfer;
-                dst_stage = vk::PipelineStageFlagBits::eFragmentShader;
-            }
-            else
-            {
-                throw std::runtime_error(
-                    "Unsupported Vulkan image layout transition for texture upload.");
-            }
-
-            command_buffer.pipelineBarrier(
-                src_stage,
-                dst_stage,
-                {},
-                nullptr,
-                nullptr,
-                barrier);
-        };
-
-        record_transition(
-            vk::ImageLayout::eUndefined,
-            vk::ImageLayout::eTransferDstOptimal);
-
-        std::vector<vk::BufferImageCopy> copies;
-        copies.reserve(layer_count);
-        const std::size_t stride = upload_data->size() / layer_count;
-        for (std::uint32_t layer = 0; layer < layer_count; ++layer)
-        {
-            copies.emplace_back(
-                stride * layer,
-                0,
-                0,
-                vk::ImageSubresourceLayers{
-                    vk::ImageAspectFlagBits::eColor, 0, layer, 1},
-                vk::Offset3D{0, 0, 0},
-                vk::Extent3D{size.x, size.y, 1});
-        }
-
-        command_buffer.copyBufferToImage(
-            *staging_buffer,
-            *image,
-            vk::ImageLayout::eTransferDstOptimal,
-            copies);
-
-        record_transition(
-            vk::ImageLayout::eTransferDstOptimal,
-            vk::ImageLayout::eShaderReadOnlyOptimal);
-    });
+    auto image_memory = owner_.gpu_memory_manager_->AllocateImage(
+        *image, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
     vk::ImageViewCreateInfo view_info(
         vk::ImageViewCreateFlags{},
@@ -517,6 +457,14 @@ void TextureResources::UploadTexture(
         VK_FALSE);
     auto sampler = owner_.vk_unique_device_->createSamplerUnique(sampler_info);
 
+    // Recorded last, no failure can destroy the image under the copy.
+    owner_.upload_context_->CopyToImage(
+        upload_data->data(),
+        upload_data->size(),
+        *image,
+        {size.x, size.y},
+        layer_count);
+
     texture_interface.SetGpuResources(
         image_format,
         texture_interface.GetViewType(),
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
@@ -29,12 +30,16 @@ class TextureResources
     {
         return textures_.empty();
     }
+    // Index of the texture in the bindless table, kInvalidIndex without
+    // descriptor indexing support.
+    std::uint32_t GetBindlessIndex(EntityId id) const;
 
   private:
     void UploadTexture(EntityId id, frame::vulkan::Texture& texture);
 
     Device& owner_;
     std::unordered_map<EntityId, frame::vulkan::Texture*> textures_;
+    std::unordered_map<EntityId, std::uint32_t> bindless_indices_;
 };
 
 } // namespace frame::vulkan
@@ -0,0 +1,258 @@
+#include "frame/vulkan/upload_context.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "frame/logger.h"
+#include "frame/profiler.h"
+
+namespace frame::vulkan
+{
+
+struct UploadSubmission
+{
+    struct Staging
+    {
+        vk::UniqueBuffer buffer;
+        GpuAllocation allocation;
+    };
+
+    vk::Device device;
+    vk::CommandBuffer command_buffer;
+    vk::UniqueFence fence;
+    std::vector<Staging> staging;
+};
+
+bool UploadFuture::IsReady() const
+{
+    return !submission_ || submission_->device.getFenceStatus(
+                               *submission_->fence) == vk::Result::eSuccess;
+}
+
+void UploadFuture::Wait() const
+{
+    if (!submission_)
+    {
+        return;
+    }
+    const auto result = submission_->device.waitForFences(
+        *submission_->fence,
+        VK_TRUE,
+        std::numeric_limits<std::uint64_t>::max());
+    if (result != vk::Result::eSuccess)
+    {
+        throw std::runtime_error(
+            "Failed waiting for a Vulkan upload: " + vk::to_string(result));
+    }
+}
+
+UploadContext::UploadContext(
+    vk::Device device,
+    GpuMemoryManager& memory_manager,
+    vk::Queue queue,
+    std::uint32_t queue_family_index,
+    bool graphics_queue)
+    : device_(device),
+      memory_manager_(&memory_manager),
+      queue_(queue),
+      queue_family_index_(queue_family_index),
+      graphics_queue_(graphics_queue)
+{
+    command_pool_ = device_.createCommandPoolUnique(vk::CommandPoolCreateInfo(
+        vk::CommandPoolCreateFlagBits::eTransient, queue_family_index_));
+}
+
+UploadContext::~UploadContext()
+{
+    try
+    {
+        WaitIdle();
+    }
+    catch (const std::exception& ex)
+    {
+        Logger::GetInstance()->warn(
+            "Pending Vulkan uploads failed: {}", ex.what());
+    }
+}
+
+void UploadContext::CopyToBuffer(
+    const void* data,
+    vk::DeviceSize size,
+    vk::Buffer destination,
+    vk::DeviceSize destination_offset)
+{
+    FRAME_PROFILE_SCOPE("Stage buffer upload");
+    if (size == 0)
+    {
+        return;
+    }
+    const vk::Buffer staging = Stage(data, size);
+    GetRecordingBuffer().copyBuffer(
+        staging, destination, vk::BufferCopy(0, destination_offset, size));
+}
+
+void UploadContext::CopyToImage(
+    const void* data,
+    vk::DeviceSize size,
+    vk::Image image,
+    vk::Extent2D extent,
+    std::uint32_t layer_count)
+{
+    FRAME_PROFILE_SCOPE("Stage image upload");
+    const vk::Buffer staging = Stage(data, size);
+    auto command_buffer = GetRecordingBuffer();
+    const vk::ImageSubresourceRange range(
+        vk::ImageAspectFlagBits::eColor, 0, 1, 0, layer_count);
+
+    vk::ImageMemoryBarrier to_transfer(
+        {},
+        vk::AccessFlagBits::eTransferWrite,
+        vk::ImageLayout::eUndefined,
+        vk::ImageLayout::eTransferDstOptimal,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        image,
+        range);
+    command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTopOfPipe,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        nullptr,
+        nullptr,
+        to_transfer);
+
+    std::vector<vk::BufferImageCopy> copies;
+    copies.reserve(layer_count);
+    const vk::DeviceSize stride = size / layer_count;
+    for (std::uint32_t layer = 0; layer < layer_count; ++layer)
+    {
+        copies.emplace_back(
+            stride * layer,
+            0,
+            0,
+            vk::ImageSubresourceLayers{
+                vk::ImageAspectFlagBits::eColor, 0, layer, 1},
+            vk::Offset3D{0, 0, 0},
+            vk::Extent3D{extent.width, extent.height, 1});
+    }
+    command_buffer.copyBufferToImage(
+        staging, image, vk::ImageLayout::eTransferDstOptimal, copies);
+
+    // A transfer only queue knows nothing of the shader stages, the fence
+    // orders the upload with the graphics work then.
+    vk::ImageMemoryBarrier to_shader(
+        vk::AccessFlagBits::eTransferWrite,
+        graphics_queue_ ? vk::AccessFlagBits::eShaderRead : vk::AccessFlags{},
+        vk::ImageLayout::eTransferDstOptimal,
+        vk::ImageLayout::eShaderReadOnlyOptimal,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        image,
+        range);
+    command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        graphics_queue_ ? vk::PipelineStageFlagBits::eFragmentShader |
+                              vk::PipelineStageFlagBits::eComputeShader
+                        : vk::PipelineStageFlagBits::eBottomOfPipe,
+        {},
+        nullptr,
+        nullptr,
+        to_shader);
+}
+
+UploadFuture UploadContext::Submit()
+{
+    FRAME_PROFILE_SCOPE("Submit uploads");
+    Collect();
+    if (!recording_)
+    {
+        return {};
+    }
+    auto command_buffer = recording_->command_buffer;
+    if (graphics_queue_)
+    {
+        // Buffers are read by whatever comes next on the same queue.
+        vk::MemoryBarrier barrier(
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eMemoryRead);
+        command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eAllCommands,
+            {},
+            barrier,
+            nullptr,
+            nullptr);
+    }
+    command_buffer.end();
+    recording_->fence = device_.createFenceUnique(vk::FenceCreateInfo{});
+    vk::SubmitInfo submit_info(0, nullptr, nullptr, 1, &command_buffer);
+    queue_.submit(submit_info, *recording_->fence);
+    in_flight_.push_back(recording_);
+    return UploadFuture(std::move(recording_));
+}
+
+void UploadContext::WaitIdle()
+{
+    Submit();
+    for (const auto& submission : in_flight_)
+    {
+        UploadFuture(submission).Wait();
+    }
+    Collect();
+}
+
+vk::CommandBuffer UploadContext::GetRecordingBuffer()
+{
+    if (!recording_)
+    {
+        auto submission = std::make_shared<UploadSubmission>();
+        submission->device = device_;
+        submission->command_buffer =
+            device_
+                .allocateCommandBuffers(vk::CommandBufferAllocateInfo(
+                    *command_pool_, vk::CommandBufferLevel::ePrimary, 1))
+                .front();
+        submission->command_buffer.begin(vk::CommandBufferBeginInfo(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        recording_ = std::move(submission);
+    }
+    return recording_->command_buffer;
+}
+
+vk::Buffer UploadContext::Stage(const void* data, vk::DeviceSize size)
+{
+    GetRecordingBuffer();
+    UploadSubmission::Staging staging;
+    staging.buffer = memory_manager_->CreateBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        staging.allocation,
+        GpuMemoryPool::eTransient);
+    std::memcpy(staging.allocation.GetMappedData(), data, size);
+    const vk::Buffer buffer = *staging.buffer;
+    recording_->staging.push_back(std::move(staging));
+    return buffer;
+}
+
+void UploadContext::Collect()
+{
+    std::erase_if(in_flight_, [this](const auto& submission) {
+        if (submission->device.getFenceStatus(*submission->fence) !=
+            vk::Result::eSuccess)
+        {
+            return false;
+        }
+        device_.freeCommandBuffers(
+            *command_pool_, submission->command_buffer);
+        submission->command_buffer = nullptr;
+        // Futures may keep the submission (and its fence) alive, not the
+        // staging memory.
+        submission->staging.clear();
+        return true;
+    });
+}
+
+} // namespace frame::vulkan
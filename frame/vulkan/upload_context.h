@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+#include "frame/vulkan/gpu_memory_manager.h"
+
+namespace frame::vulkan
+{
+
+struct UploadSubmission;
+
+// Completion of a batch of uploads, signaled by a fence.
+class UploadFuture
+{
+  public:
+    UploadFuture() = default;
+
+    bool IsReady() const;
+    void Wait() const;
+
+  private:
+    friend class UploadContext;
+
+    explicit UploadFuture(std::shared_ptr<const UploadSubmission> submission)
+        : submission_(std::move(submission))
+    {
+    }
+
+    std::shared_ptr<const UploadSubmission> submission_;
+};
+
+// Records uploads (staging copy included) into one command buffer and
+// submits them together, on a dedicated transfer queue when the device has
+// one. Nothing waits on the queue: the staging memory of a batch is released
+// once its fence has signaled. Not thread safe.
+class UploadContext
+{
+  public:
+    // graphics_queue: the queue also does graphics, the final barriers can
+    // target the shader stages directly.
+    UploadContext(
+        vk::Device device,
+        GpuMemoryManager& memory_manager,
+        vk::Queue queue,
+        std::uint32_t queue_family_index,
+        bool graphics_queue);
+    // Wait for the batches in flight.
+    ~UploadContext();
+    UploadContext(const UploadContext&) = delete;
+    UploadContext& operator=(const UploadContext&) = delete;
+
+    void CopyToBuffer(
+        const void* data,
+        vk::DeviceSize size,
+        vk::Buffer destination,
+        vk::DeviceSize destination_offset = 0);
+    // Copy tightly packed layers to a color image, which ends up in the
+    // shader read only layout.
+    void CopyToImage(
+        const void* data,
+        vk::DeviceSize size,
+        vk::Image image,
+        vk::Extent2D extent,
+        std::uint32_t layer_count = 1);
+    // Submit what was recorded since the last call (a ready future if
+    // nothing was).
+    UploadFuture Submit();
+    // Submit and wait for every batch.
+    void WaitIdle();
+
+    std::uint32_t GetQueueFamilyIndex() const
+    {
+        return queue_family_index_;
+    }
+
+  private:
+    vk::CommandBuffer GetRecordingBuffer();
+    vk::Buffer Stage(const void* data, vk::DeviceSize size);
+    // Release the batches whose fence has signaled.
+    void Collect();
+
+    vk::Device device_;
+    GpuMemoryManager* memory_manager_;
+    vk::Queue queue_;
+    std::uint32_t queue_family_index_ = 0;
+    bool graphics_queue_ = true;
+    vk::UniqueCommandPool command_pool_;
+    std::shared_ptr<UploadSubmission> recording_;
+    std::vector<std::shared_ptr<UploadSubmission>> in_flight_;
+};
+
+} // namespace frame::vulkan
@@ -0,0 +1,286 @@
+#include "frame/vulkan/vulkan_offscreen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "absl/flags/flag.h"
+
+#include "frame/common/application.h"
+#include "frame/profiler.h"
+#include "frame/vulkan/debug_callback.h"
+#include "frame/vulkan/device.h"
+
+namespace frame::vulkan
+{
+namespace
+{
+constexpr const char* kValidationLayerName = "VK_LAYER_KHRONOS_validation";
+// Fixed time step, animated levels give the same frames on every run.
+constexpr double kFrameTime = 1.0 / 60.0;
+
+bool HasExtension(
+    const std::vector<vk::ExtensionProperties>& extensions,
+    const char* name)
+{
+    for (const auto& ext : extensions)
+    {
+        if (std::strcmp(ext.extensionName, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HasLayer(
+    const std::vector<vk::LayerProperties>& layers,
+    const char* name)
+{
+    for (const auto& layer : layers)
+    {
+        if (std::strcmp(layer.layerName, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+VulkanOffscreen::VulkanOffscreen(glm::uvec2 size) : size_(size)
+{
+    // The loader linked in, no window system to ask.
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(vkGetInstanceProcAddr);
+
+    std::vector<const char*> extensions;
+    const auto available_extensions =
+        vk::enumerateInstanceExtensionProperties();
+    const bool want_validation = absl::GetFlag(FLAGS_vk_validation);
+    const bool has_debug_utils =
+        HasExtension(available_extensions, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    if (want_validation && has_debug_utils)
+    {
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
+
+    std::vector<const char*> layers;
+    if (want_validation)
+    {
+        const auto available_layers = vk::enumerateInstanceLayerProperties();
+        if (HasLayer(available_layers, kValidationLayerName))
+        {
+            layers.push_back(kValidationLayerName);
+        }
+        else
+        {
+            logger_->warn("Vulkan validation layer not found.");
+        }
+    }
+
+    vk::ApplicationInfo application_info(
+        "Frame",
+        VK_MAKE_VERSION(0, 5, 1),
+        "Vulkan - Offscreen",
+        VK_MAKE_VERSION(0, 5, 1),
+        VK_API_VERSION_1_4);
+    vk::InstanceCreateInfo instance_create_info(
+        {},
+        &application_info,
+        static_cast<std::uint32_t>(layers.size()),
+        layers.data(),
+        static_cast<std::uint32_t>(extensions.size()),
+        extensions.data());
+
+    vk::DebugUtilsMessengerCreateInfoEXT debug_info{};
+    if (want_validation && has_debug_utils)
+    {
+        debug_info.messageSeverity =
+            vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning |
+            vk::DebugUtilsMessageSeverityFlagBitsEXT::eError |
+            vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo;
+        debug_info.messageType =
+            vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral |
+            vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation |
+            vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance;
+        debug_info.pfnUserCallback =
+            reinterpret_cast<vk::PFN_DebugUtilsMessengerCallbackEXT>(
+                DebugCallback);
+        instance_create_info.setPNext(&debug_info);
+    }
+
+    vk_unique_instance_ = vk::createInstanceUnique(instance_create_info);
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(
+        *vk_unique_instance_, vkGetInstanceProcAddr);
+    if (want_validation && has_debug_utils)
+    {
+        debug_messenger_ =
+            vk_unique_instance_->createDebugUtilsMessengerEXTUnique(debug_info);
+    }
+}
+
+VulkanOffscreen::~VulkanOffscreen()
+{
+    device_.reset();
+    debug_messenger_.reset();
+    vk_unique_instance_.reset();
+}
+
+WindowReturnEnum VulkanOffscreen::Run(std::function<bool()> lambda)
+{
+    if (!device_)
+    {
+        return lambda() ? WindowReturnEnum::UKNOWN : WindowReturnEnum::RESTART;
+    }
+    for (const auto& plugin_interface : device_->GetPluginPtrs())
+    {
+        if (plugin_interface)
+        {
+            plugin_interface->Startup(size_);
+        }
+    }
+
+    auto* vulkan_device = dynamic_cast<Device*>(device_.get());
+    const std::uint32_t frame_count =
+        std::max(absl::GetFlag(FLAGS_offscreen_frames), 1u);
+    std::vector<FrameTime> frame_times;
+    frame_times.reserve(frame_count);
+    WindowReturnEnum return_enum = WindowReturnEnum::UKNOWN;
+    for (std::uint32_t i = 0; i < frame_count; ++i)
+    {
+        if (input_interface_)
+        {
+            input_interface_->NextFrame();
+        }
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        if (!lambda())
+        {
+            return_enum = WindowReturnEnum::RESTART;
+            break;
+        }
+        for (const auto& plugin_interface : device_->GetPluginPtrs())
+        {
+            if (plugin_interface)
+            {
+                plugin_interface->Update(*device_, kFrameTime);
+            }
+        }
+        const std::uint64_t frame =
+            vulkan_device ? vulkan_device->GetFrameNumber() : i;
+        try
+        {
+            device_->Display(kFrameTime);
+        }
+        catch (const std::exception& ex)
+        {
+            logger_->error("Vulkan Display failed: {}", ex.what());
+            return_enum = WindowReturnEnum::QUIT;
+            break;
+        }
+        frame_times.push_back(
+            {frame,
+             std::chrono::duration<double, std::milli>(Clock::now() - start)
+                 .count()});
+    }
+
+    if (vulkan_device)
+    {
+        // The GPU times come in once the frames are done.
+        std::unordered_map<std::uint64_t, FrameTime*> by_frame;
+        for (auto& frame_time : frame_times)
+        {
+            by_frame[frame_time.frame] = &frame_time;
+        }
+        for (const auto& gpu_time : vulkan_device->TakeGpuFrameTimes(true))
+        {
+            if (auto it = by_frame.find(gpu_time.frame); it != by_frame.end())
+            {
+                it->second->gpu_ms = gpu_time.gpu_ms;
+            }
+        }
+    }
+    if (!absl::GetFlag(FLAGS_offscreen_output).empty())
+    {
+        WriteOutput(frame_times);
+    }
+    return return_enum;
+}
+
+void VulkanOffscreen::WriteOutput(
+    const std::vector<FrameTime>& frame_times) const
+{
+    const std::filesystem::path output_dir =
+        absl::GetFlag(FLAGS_offscreen_output);
+    std::filesystem::create_directories(output_dir);
+
+    const auto timings_path = output_dir / "frame_timings.csv";
+    std::ofstream timings(timings_path);
+    if (!timings)
+    {
+        throw std::runtime_error(
+            std::format("Couldn't write {}", timings_path.string()));
+    }
+    // gpu_ms is empty for frames without a timestamp.
+    timings << "frame,cpu_ms,gpu_ms\n";
+    double cpu_total = 0.0;
+    for (const auto& frame_time : frame_times)
+    {
+        timings << std::format(
+            "{},{:.4f},", frame_time.frame, frame_time.cpu_ms);
+        if (frame_time.gpu_ms >= 0.0)
+        {
+            timings << std::format("{:.4f}", frame_time.gpu_ms);
+        }
+        timings << "\n";
+        cpu_total += frame_time.cpu_ms;
+    }
+    logger_->info(
+        "Offscreen run: {} frames, {:.3f} ms CPU per frame, timings in {}.",
+        frame_times.size(),
+        frame_times.empty() ? 0.0 : cpu_total / frame_times.size(),
+        timings_path.string());
+
+    // Per pass, over the last frames of the run.
+    const auto passes_path = output_dir / "gpu_passes.csv";
+    std::ofstream passes(passes_path);
+    if (!passes)
+    {
+        throw std::runtime_error(
+            std::format("Couldn't write {}", passes_path.string()));
+    }
+    passes << "pass,frames,last_ms,min_ms,avg_ms,max_ms\n";
+    for (const auto& stats : device_->GetGpuPassStats())
+    {
+        passes << std::format(
+            "{},{},{:.4f},{:.4f},{:.4f},{:.4f}\n",
+            stats.name,
+            stats.sample_count,
+            stats.last_ms,
+            stats.min_ms,
+            stats.avg_ms,
+            stats.max_ms);
+        logger_->info(
+            "GPU {}: {:.3f} ms avg ({:.3f} - {:.3f}).",
+            stats.name,
+            stats.avg_ms,
+            stats.min_ms,
+            stats.max_ms);
+    }
+
+    Profiler::GetInstance().WriteChromeTrace(
+        (output_dir / "cpu_trace.json").string());
+    device_->ScreenShot((output_dir / "final_frame.png").string());
+}
+
+void* VulkanOffscreen::GetGraphicContext() const
+{
+    return vk_unique_instance_.get();
+}
+
+} // namespace frame::vulkan
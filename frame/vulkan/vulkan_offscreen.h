@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame/vulkan/vulkan_dispatch.h"
+
+#include "frame/logger.h"
+#include "frame/window_interface.h"
+
+namespace frame::vulkan
+{
+
+// Headless target without SDL nor surface: the device renders to offscreen
+// images (works on software drivers like lavapipe). Each Run renders
+// --offscreen_frames frames and, with --offscreen_output, writes the CPU and
+// GPU time of every frame, the GPU time of the passes, the CPU trace and the
+// last frame to that directory.
+class VulkanOffscreen : public WindowInterface
+{
+  public:
+    explicit VulkanOffscreen(glm::uvec2 size);
+    ~VulkanOffscreen() override;
+
+  public:
+    WindowReturnEnum Run(std::function<bool()> lambda) override;
+    void* GetGraphicContext() const override;
+
+  public:
+    void SetInputInterface(
+        std::unique_ptr<InputInterface> input_interface) override
+    {
+        input_interface_ = std::move(input_interface);
+    }
+    void AddKeyCallback(std::int32_t key, std::function<bool()> func) override
+    {
+        key_callbacks_[key] = func;
+    }
+    void RemoveKeyCallback(std::int32_t key) override
+    {
+        key_callbacks_.erase(key);
+    }
+    void SetUniqueDevice(std::unique_ptr<DeviceInterface> device) override
+    {
+        device_ = std::move(device);
+    }
+    DeviceInterface& GetDevice() override
+    {
+        return *device_.get();
+    }
+    glm::uvec2 GetSize() const override
+    {
+        return size_;
+    }
+    glm::vec2 GetPixelPerInch(std::uint32_t screen = 0) const override
+    {
+        return glm::vec2(96.0f, 96.0f);
+    }
+    glm::uvec2 GetDesktopSize() const override
+    {
+        return {0, 0};
+    }
+    void* GetWindowContext() const override
+    {
+        return nullptr;
+    }
+    void SetWindowTitle(const std::string& /*title*/) const override
+    {
+    }
+    void SetOpenFileName(const std::string& file_name) override
+    {
+        open_file_name_ = file_name;
+    }
+    const std::string& GetOpenFileName() const override
+    {
+        return open_file_name_;
+    }
+    void Resize(glm::uvec2 size, FullScreenEnum /*fullscreen_enum*/) override
+    {
+        size_ = size;
+        if (device_)
+        {
+            device_->Resize(size);
+        }
+    }
+    FullScreenEnum GetFullScreenEnum() const override
+    {
+        return FullScreenEnum::WINDOW;
+    }
+    DrawingTargetEnum GetDrawingTargetEnum() const override
+    {
+        return DrawingTargetEnum::NONE;
+    }
+
+  public:
+    // Always null, the device then renders offscreen.
+    vk::SurfaceKHR& GetVulkanSurfaceKHR()
+    {
+        return vk_surface_;
+    }
+
+  private:
+    struct FrameTime
+    {
+        std::uint64_t frame = 0;
+        double cpu_ms = 0.0;
+        double gpu_ms = -1.0;
+    };
+
+    void WriteOutput(const std::vector<FrameTime>& frame_times) const;
+
+    glm::uvec2 size_;
+    std::unique_ptr<DeviceInterface> device_ = nullptr;
+    std::unique_ptr<InputInterface> input_interface_ = nullptr;
+    std::map<std::int32_t, std::function<bool()>> key_callbacks_;
+    std::string open_file_name_ = "";
+    frame::Logger& logger_ = frame::Logger::GetInstance();
+    vk::UniqueInstance vk_unique_instance_;
+    vk::UniqueDebugUtilsMessengerEXT debug_messenger_;
+    vk::SurfaceKHR vk_surface_ = VK_NULL_HANDLE;
+};
+
+} // namespace frame::vulkan
@@ -13,6 +13,7 @@
 #include "frame/vulkan/device.h"
 #include "frame/vulkan/sdl_vulkan_none.h"
 #include "frame/vulkan/sdl_vulkan_window.h"
+#include "frame/vulkan/vulkan_offscreen.h"
 
 namespace frame::vulkan
 {
@@ -43,6 +44,19 @@ std::unique_ptr<WindowInterface> CreateSDLVulkanNone(glm::uvec2 size)
     return window;
 }
 
+std::unique_ptr<WindowInterface> CreateVulkanOffscreen(glm::uvec2 size)
+{
+    auto window = std::make_unique<VulkanOffscreen>(size);
+    auto context = window->GetGraphicContext();
+    auto& surface = window->GetVulkanSurfaceKHR();
+    if (!context)
+    {
+        return nullptr;
+    }
+    window->SetUniqueDevice(std::make_unique<Device>(context, size, surface));
+    return window;
+}
+
 } // End namespace frame::vulkan.
 
 namespace
@@ -61,7 +75,7 @@ void EnsureWindowFactoryRegistered()
         frame::RegisterVulkanWindowFactory(
             frame::VulkanWindowFactory{
                 frame::vulkan::CreateSDLVulkanWindow,
-                frame::vulkan::CreateSDLVulkanNone});
+                frame::vulkan::CreateVulkanOffscreen});
     });
 }
 
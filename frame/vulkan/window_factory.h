@@ -20,6 +20,13 @@ std::unique_ptr<WindowInterface> CreateSDLVulkanWindow(glm::uvec2 size);
  * @return A unique pointer to a fake window object.
  */
 std::unique_ptr<WindowInterface> CreateSDLVulkanNone(glm::uvec2 size);
+/**
+ * @brief Create a headless target without SDL nor surface, the device
+ * renders to offscreen images (benchmarks, CI on software drivers).
+ * @param size: Size of the output image.
+ * @return A unique pointer to a fake window object.
+ */
+std::unique_ptr<WindowInterface> CreateVulkanOffscreen(glm::uvec2 size);
 
 /**
  * @brief Ensure the Vulkan window factory is registered with the shared
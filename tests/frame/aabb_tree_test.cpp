@@ -0,0 +1,181 @@
+#include "frame/aabb_tree.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+
+namespace test
+{
+
+namespace
+{
+
+frame::AABB MakeBox(glm::vec3 center, float half_size)
+{
+    frame::AABB aabb;
+    aabb.min = center - glm::vec3(half_size);
+    aabb.max = center + glm::vec3(half_size);
+    return aabb;
+}
+
+glm::vec3 GridPosition(int i)
+{
+    return glm::vec3(
+        static_cast<float>(i % 100) * 2.f,
+        0.f,
+        static_cast<float>(i / 100) * 2.f);
+}
+
+std::set<frame::EntityId> CollectBox(
+    const frame::AABBTree& tree, const frame::AABB& aabb)
+{
+    std::set<frame::EntityId> result;
+    tree.QueryBox(aabb, [&result](frame::EntityId id) {
+        result.insert(id);
+        return true;
+    });
+    return result;
+}
+
+} // namespace
+
+TEST(AABBTreeTest, InsertAndQueryBox)
+{
+    frame::AABBTree tree;
+    for (int i = 0; i < 1000; ++i)
+    {
+        tree.Insert(MakeBox(GridPosition(i), 0.5f), i + 1);
+    }
+    EXPECT_EQ(tree.GetProxyCount(), 1000);
+    // A balanced tree of 1000 leaves should be far from degenerate.
+    EXPECT_LT(tree.GetHeight(), 30);
+    const auto result = CollectBox(tree, MakeBox({0.f, 0.f, 0.f}, 0.1f));
+    EXPECT_EQ(result, std::set<frame::EntityId>({1}));
+    const auto row =
+        CollectBox(tree, {glm::vec3(-1.f, -1.f, -1.f), glm::vec3(7.5f, 1.f, 1.f)});
+    EXPECT_EQ(row, std::set<frame::EntityId>({1, 2, 3, 4, 5}));
+}
+
+TEST(AABBTreeTest, MoveAndRemove)
+{
+    frame::AABBTree tree(0.5f);
+    const auto proxy = tree.Insert(MakeBox({0.f, 0.f, 0.f}, 1.f), 42);
+    const auto other = tree.Insert(MakeBox({10.f, 0.f, 0.f}, 1.f), 43);
+    // Small motion stays inside the fat box.
+    EXPECT_FALSE(tree.Move(proxy, MakeBox({0.2f, 0.f, 0.f}, 1.f)));
+    // Large motion reinserts.
+    EXPECT_TRUE(tree.Move(proxy, MakeBox({20.f, 0.f, 0.f}, 1.f)));
+    EXPECT_TRUE(CollectBox(tree, MakeBox({0.f, 0.f, 0.f}, 0.1f)).empty());
+    EXPECT_EQ(
+        CollectBox(tree, MakeBox({20.f, 0.f, 0.f}, 0.1f)),
+        std::set<frame::EntityId>({42}));
+    tree.Remove(other);
+    EXPECT_EQ(tree.GetProxyCount(), 1);
+    EXPECT_TRUE(CollectBox(tree, MakeBox({10.f, 0.f, 0.f}, 0.1f)).empty());
+    EXPECT_THROW(tree.Remove(other), std::runtime_error);
+}
+
+TEST(AABBTreeTest, QueryFrustum)
+{
+    frame::AABBTree tree;
+    for (int i = 0; i < 1000; ++i)
+    {
+        tree.Insert(MakeBox(GridPosition(i), 0.5f), i + 1);
+    }
+    // Camera above the grid origin looking at +z.
+    const glm::mat4 projection =
+        glm::perspective(glm::radians(65.0f), 1.0f, 0.1f, 10.0f);
+    const glm::mat4 view = glm::lookAt(
+        glm::vec3(0.f, 0.f, -1.f),
+        glm::vec3(0.f, 0.f, 1.f),
+        glm::vec3(0.f, 1.f, 0.f));
+    const frame::Frustum frustum(projection * view);
+    std::set<frame::EntityId> visible;
+    tree.QueryFrustum(frustum, [&visible](frame::EntityId id) {
+        visible.insert(id);
+        return true;
+    });
+    // Compare with a brute force test on the boxes.
+    std::set<frame::EntityId> expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (frustum.IsVisible(MakeBox(GridPosition(i), 0.5f)))
+        {
+            expected.insert(i + 1);
+        }
+    }
+    EXPECT_FALSE(visible.empty());
+    EXPECT_LT(visible.size(), 1000);
+    EXPECT_EQ(visible, expected);
+}
+
+TEST(AABBTreeTest, QueryRayReturnsClosest)
+{
+    frame::AABBTree tree;
+    tree.Insert(MakeBox({0.f, 0.f, 5.f}, 1.f), 1);
+    tree.Insert(MakeBox({0.f, 0.f, 10.f}, 1.f), 2);
+    tree.Insert(MakeBox({5.f, 0.f, 2.f}, 1.f), 3);
+    const auto hit = tree.QueryRay({0.f, 0.f, 0.f}, {0.f, 0.f, 1.f});
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->id, 1);
+    EXPECT_NEAR(hit->distance, 4.f, 1e-5);
+    EXPECT_FALSE(tree.QueryRay({0.f, 0.f, 0.f}, {0.f, 0.f, -1.f}));
+    EXPECT_FALSE(tree.QueryRay({0.f, 0.f, 0.f}, {0.f, 0.f, 1.f}, 3.f));
+}
+
+TEST(AABBTreeTest, FatMarginIsNotAHit)
+{
+    frame::AABBTree tree(0.5f);
+    tree.Insert(MakeBox({0.f, 0.f, 0.f}, 1.f), 1);
+    // Inside the fat box but outside the object.
+    EXPECT_TRUE(CollectBox(tree, MakeBox({1.25f, 0.f, 0.f}, 0.1f)).empty());
+    EXPECT_EQ(
+        CollectBox(tree, MakeBox({0.95f, 0.f, 0.f}, 0.1f)),
+        std::set<frame::EntityId>({1}));
+}
+
+TEST(AABBTreeTest, MoveTenThousandObjects)
+{
+    constexpr int kObjectCount = 10000;
+    constexpr int kFrameCount = 60;
+    frame::AABBTree tree;
+    std::vector<std::int32_t> proxies;
+    proxies.reserve(kObjectCount);
+    for (int i = 0; i < kObjectCount; ++i)
+    {
+        proxies.push_back(tree.Insert(MakeBox(GridPosition(i), 0.5f), i + 1));
+    }
+    std::vector<glm::vec3> centers(kObjectCount);
+    std::size_t reinserted = 0;
+    for (int frame = 1; frame <= kFrameCount; ++frame)
+    {
+        const float t = static_cast<float>(frame) * 0.05f;
+        for (int i = 0; i < kObjectCount; ++i)
+        {
+            const glm::vec3 offset(
+                std::sin(t + static_cast<float>(i)),
+                std::cos(t * 0.5f + static_cast<float>(i)),
+                0.f);
+            centers[i] = GridPosition(i) + offset;
+            if (tree.Move(proxies[i], MakeBox(centers[i], 0.5f)))
+            {
+                ++reinserted;
+            }
+        }
+    }
+    EXPECT_EQ(tree.GetProxyCount(), kObjectCount);
+    EXPECT_LT(tree.GetHeight(), 64);
+    // The fat boxes absorb most of the small motions.
+    EXPECT_GT(reinserted, 0u);
+    EXPECT_LT(reinserted, static_cast<std::size_t>(kObjectCount) * kFrameCount);
+    // Every object is found where it ended up.
+    for (int i = 0; i < kObjectCount; ++i)
+    {
+        EXPECT_TRUE(CollectBox(tree, MakeBox(centers[i], 0.01f)).count(i + 1));
+    }
+}
+
+} // namespace test
@@ -54,6 +54,16 @@ class DeviceMock : public frame::DeviceInterface
         CreateTexture,
         ((const frame::TextureParameter&)),
         (override));
+    MOCK_METHOD(
+        std::vector<frame::GpuPassStats>,
+        GetGpuPassStats,
+        (),
+        (const, override));
+    MOCK_METHOD(
+        frame::RenderCallStats,
+        GetRenderCallStats,
+        (),
+        (const, override));
 };
 
 } // End namespace test.
@@ -0,0 +1,132 @@
+#include "frame/frame_allocator.h"
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <glm/glm.hpp>
+
+namespace test
+{
+
+namespace
+{
+
+// Upstream of the frame allocator counting the allocations it serves.
+class CountingResource : public std::pmr::memory_resource
+{
+  public:
+    std::size_t GetAllocationCount() const
+    {
+        return allocation_count_;
+    }
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocation_count_;
+        return upstream_->allocate(bytes, alignment);
+    }
+    void do_deallocate(
+        void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        upstream_->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_ = std::pmr::new_delete_resource();
+    std::size_t allocation_count_ = 0;
+};
+
+// Transient work of a renderer frame: models grouped by (mesh, material)
+// and bone matrices, all from the frame allocator.
+float RunFrame(frame::FrameAllocator& allocator, int item_count)
+{
+    allocator.BeginFrame();
+    std::pmr::map<std::pair<std::uint64_t, std::uint64_t>, std::size_t>
+        group_indices(&allocator);
+    std::pmr::vector<std::pmr::vector<glm::mat4>> groups(&allocator);
+    for (int i = 0; i < item_count; ++i)
+    {
+        const auto [it, inserted] = group_indices.try_emplace(
+            std::make_pair(i % 7, i % 3), groups.size());
+        if (inserted)
+        {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(glm::mat4(static_cast<float>(i)));
+    }
+    std::pmr::vector<glm::mat4> bone_matrices(
+        128, glm::mat4(1.0f), &allocator);
+    float sum = bone_matrices.back()[0][0];
+    for (const auto& models : groups)
+    {
+        sum += models.back()[0][0];
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST(FrameAllocatorTest, AllocationsAreAlignedAndKeptForTheFramesInFlight)
+{
+    frame::FrameAllocator allocator(1024, 2);
+    allocator.BeginFrame();
+    auto* first = static_cast<std::uint8_t*>(allocator.allocate(3, 1));
+    auto* aligned = allocator.allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    first[0] = 42;
+    // The next frame uses the other arena.
+    allocator.BeginFrame();
+    auto* second = static_cast<std::uint8_t*>(allocator.allocate(3, 1));
+    EXPECT_NE(second, first);
+    EXPECT_EQ(first[0], 42);
+    // Back to the first arena.
+    allocator.BeginFrame();
+    EXPECT_EQ(allocator.allocate(3, 1), first);
+}
+
+TEST(FrameAllocatorTest, OverflowGrowsTheArena)
+{
+    frame::FrameAllocator allocator(256, 1);
+    allocator.BeginFrame();
+    auto* big = allocator.allocate(4096, 16);
+    EXPECT_NE(big, nullptr);
+    EXPECT_EQ(allocator.GetOverflowCount(), 1u);
+    EXPECT_GE(allocator.GetUsedBytes(), 4096u);
+    allocator.BeginFrame();
+    EXPECT_NE(allocator.allocate(4096, 16), nullptr);
+    EXPECT_EQ(allocator.GetOverflowCount(), 0u);
+}
+
+TEST(FrameAllocatorTest, SteadyStateFramesDoNotHitTheHeap)
+{
+    constexpr int kItemCount = 1000;
+    CountingResource upstream;
+    frame::FrameAllocator allocator(1024, 2, &upstream);
+    // Warm up, the arenas grow to the size of a frame.
+    float sum = 0.0f;
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        sum += RunFrame(allocator, kItemCount);
+    }
+    std::size_t overflow_count = 0;
+    const std::size_t before = upstream.GetAllocationCount();
+    for (int frame = 0; frame < 16; ++frame)
+    {
+        sum += RunFrame(allocator, kItemCount);
+        overflow_count += allocator.GetOverflowCount();
+    }
+    EXPECT_EQ(upstream.GetAllocationCount() - before, 0u);
+    EXPECT_EQ(overflow_count, 0u);
+    EXPECT_GT(sum, 0.0f);
+}
+
+} // namespace test
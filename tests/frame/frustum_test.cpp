@@ -0,0 +1,117 @@
+#include "frame/bounding_volume.h"
+#include "frame/frustum.h"
+
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+
+namespace test
+{
+
+namespace
+{
+
+frame::AABB MakeBox(glm::vec3 center, float half_size)
+{
+    frame::AABB aabb;
+    aabb.min = center - glm::vec3(half_size);
+    aabb.max = center + glm::vec3(half_size);
+    return aabb;
+}
+
+frame::Frustum MakeFrustum()
+{
+    // Camera at the origin looking down -z.
+    const glm::mat4 projection =
+        glm::perspective(glm::radians(65.0f), 1.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(
+        glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+    return frame::Frustum(projection * view);
+}
+
+} // namespace
+
+TEST(FrustumTest, BoxVisibility)
+{
+    const auto frustum = MakeFrustum();
+    EXPECT_TRUE(frustum.IsVisible(MakeBox({0.f, 0.f, -10.f}, 1.f)));
+    // Behind the camera.
+    EXPECT_FALSE(frustum.IsVisible(MakeBox({0.f, 0.f, 10.f}, 1.f)));
+    // Beyond the far plane.
+    EXPECT_FALSE(frustum.IsVisible(MakeBox({0.f, 0.f, -200.f}, 1.f)));
+    // Far to the side.
+    EXPECT_FALSE(frustum.IsVisible(MakeBox({100.f, 0.f, -10.f}, 1.f)));
+    // Straddling the left plane.
+    EXPECT_TRUE(frustum.IsVisible(MakeBox({-6.5f, 0.f, -10.f}, 1.f)));
+}
+
+TEST(FrustumTest, SphereVisibility)
+{
+    const auto frustum = MakeFrustum();
+    EXPECT_TRUE(frustum.IsVisible(frame::BoundingSphere{{0.f, 0.f, -5.f}, 1.f}));
+    EXPECT_FALSE(
+        frustum.IsVisible(frame::BoundingSphere{{0.f, 0.f, 5.f}, 1.f}));
+}
+
+TEST(FrustumTest, DefaultAcceptsEverything)
+{
+    const frame::Frustum frustum;
+    EXPECT_TRUE(frustum.IsVisible(MakeBox({1000.f, -1000.f, 1000.f}, 1.f)));
+}
+
+TEST(FrustumTest, BatchMatchesScalar)
+{
+    const auto frustum = MakeFrustum();
+    std::vector<frame::AABB> boxes;
+    for (int i = 0; i < 23; ++i)
+    {
+        const float offset = static_cast<float>(i) - 11.f;
+        boxes.push_back(
+            MakeBox({offset * 2.f, offset * 0.5f, -offset * 3.f}, 0.5f));
+    }
+    std::vector<std::uint8_t> visible;
+    frustum.CullAABBs(boxes, visible);
+    ASSERT_EQ(visible.size(), boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+        EXPECT_EQ(visible[i] != 0, frustum.IsVisible(boxes[i])) << i;
+    }
+}
+
+TEST(BoundingVolumeTest, ComputeFromPoints)
+{
+    const std::vector<float> points = {
+        -1.f, 0.f, 0.f, 1.f, 2.f, 0.f, 0.f, 0.f, 4.f};
+    const auto bounding_volume = frame::ComputeBoundingVolume(points);
+    ASSERT_TRUE(bounding_volume.IsValid());
+    EXPECT_NEAR(bounding_volume.aabb.min.x, -1.f, 1e-5);
+    EXPECT_NEAR(bounding_volume.aabb.max.y, 2.f, 1e-5);
+    EXPECT_NEAR(bounding_volume.aabb.max.z, 4.f, 1e-5);
+    for (std::size_t i = 0; i < points.size(); i += 3)
+    {
+        const glm::vec3 point(points[i], points[i + 1], points[i + 2]);
+        EXPECT_LE(
+            glm::length(point - bounding_volume.sphere.center),
+            bounding_volume.sphere.radius + 1e-5f);
+    }
+    EXPECT_FALSE(frame::ComputeBoundingVolume({}).IsValid());
+}
+
+TEST(BoundingVolumeTest, TransformAABB)
+{
+    const auto aabb = MakeBox(glm::vec3(0.f), 1.f);
+    const glm::mat4 model = glm::rotate(
+        glm::translate(glm::mat4(1.f), glm::vec3(5.f, 0.f, 0.f)),
+        glm::radians(45.f),
+        glm::vec3(0.f, 0.f, 1.f));
+    const auto result = frame::TransformAABB(aabb, model);
+    const float half_diagonal = std::sqrt(2.f);
+    EXPECT_NEAR(result.min.x, 5.f - half_diagonal, 1e-4);
+    EXPECT_NEAR(result.max.x, 5.f + half_diagonal, 1e-4);
+    EXPECT_NEAR(result.min.z, -1.f, 1e-4);
+    EXPECT_NEAR(result.max.z, 1.f, 1e-4);
+}
+
+} // namespace test
@@ -0,0 +1,48 @@
+#include "frame/gpu_pass_stats.h"
+
+#include <gtest/gtest.h>
+
+namespace test
+{
+
+TEST(GpuPassHistoryTest, StatsOverTheWindowInFirstSeenOrder)
+{
+    frame::GpuPassHistory history(3);
+    const double scene_ms[] = {4.0, 1.0, 2.0, 3.0};
+    for (const double ms : scene_ms)
+    {
+        history.AddSample(frame::gpu_pass::kScene, ms);
+        history.AddSample(frame::gpu_pass::kGui, 0.5);
+        history.EndFrame();
+    }
+    const auto stats = history.GetStats();
+    ASSERT_EQ(stats.size(), 2);
+    EXPECT_EQ(stats[0].name, frame::gpu_pass::kScene);
+    EXPECT_EQ(stats[1].name, frame::gpu_pass::kGui);
+    // The first frame left the window.
+    EXPECT_EQ(stats[0].sample_count, 3);
+    EXPECT_DOUBLE_EQ(stats[0].last_ms, 3.0);
+    EXPECT_DOUBLE_EQ(stats[0].min_ms, 1.0);
+    EXPECT_DOUBLE_EQ(stats[0].avg_ms, 2.0);
+    EXPECT_DOUBLE_EQ(stats[0].max_ms, 3.0);
+    EXPECT_DOUBLE_EQ(stats[1].avg_ms, 0.5);
+}
+
+TEST(GpuPassHistoryTest, PassTimedTwiceInAFrameIsSummed)
+{
+    frame::GpuPassHistory history;
+    // Stereo: the scene is drawn for each eye.
+    history.AddSample(frame::gpu_pass::kScene, 1.5);
+    history.AddSample(frame::gpu_pass::kScene, 2.5);
+    history.EndFrame();
+    // A frame without the pass does not count for it.
+    history.EndFrame();
+    const auto stats = history.GetStats();
+    ASSERT_EQ(stats.size(), 1);
+    EXPECT_EQ(stats[0].sample_count, 1);
+    EXPECT_DOUBLE_EQ(stats[0].last_ms, 4.0);
+    history.Clear();
+    EXPECT_TRUE(history.GetStats().empty());
+}
+
+} // namespace test
@@ -0,0 +1,107 @@
+#include "frame/jobs.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace test
+{
+
+TEST(JobsTest, ParallelForVisitsEveryIndexOnce)
+{
+    for (const std::size_t worker_count : {0, 1, 4})
+    {
+        frame::jobs::Scheduler scheduler(worker_count);
+        EXPECT_EQ(scheduler.GetWorkerCount(), worker_count);
+        std::vector<std::atomic<int>> visits(1000);
+        scheduler.ParallelFor(
+            visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+        for (const auto& visit : visits)
+        {
+            EXPECT_EQ(visit.load(), 1);
+        }
+    }
+}
+
+TEST(JobsTest, NestedJobsWaitOnTheirChildren)
+{
+    // A single worker: the parents only finish because waiting runs the
+    // queued children.
+    frame::jobs::Scheduler scheduler(1);
+    std::atomic<int> sum = 0;
+    frame::jobs::Counter parents;
+    for (int parent = 0; parent < 8; ++parent)
+    {
+        scheduler.Run(
+            [&scheduler, &sum] {
+                frame::jobs::Counter children;
+                for (int child = 1; child <= 10; ++child)
+                {
+                    scheduler.Run([&sum, child] { sum += child; }, children);
+                }
+                scheduler.Wait(children);
+                EXPECT_TRUE(children.IsDone());
+            },
+            parents);
+    }
+    scheduler.Wait(parents);
+    EXPECT_EQ(sum.load(), 8 * 55);
+}
+
+TEST(JobsTest, WaitRethrowsTheErrorOfAJob)
+{
+    frame::jobs::Scheduler scheduler(2);
+    std::atomic<int> finished = 0;
+    frame::jobs::Counter counter;
+    for (int i = 0; i < 16; ++i)
+    {
+        scheduler.Run(
+            [&finished, i] {
+                if (i == 5)
+                {
+                    throw std::runtime_error("Job failed.");
+                }
+                ++finished;
+            },
+            counter);
+    }
+    EXPECT_THROW(scheduler.Wait(counter), std::runtime_error);
+    // The other jobs still ran, the counter can be used again.
+    EXPECT_EQ(finished.load(), 15);
+    scheduler.Run([&finished] { ++finished; }, counter);
+    scheduler.Wait(counter);
+    EXPECT_EQ(finished.load(), 16);
+}
+
+TEST(JobsTest, WorkersHaveTheirThreadIndex)
+{
+    frame::jobs::Scheduler scheduler(3);
+    EXPECT_EQ(frame::jobs::Scheduler::GetThreadIndex(), 0);
+    std::vector<std::size_t> indices(64);
+    scheduler.ParallelFor(
+        indices.size(),
+        [&indices](std::size_t i) {
+            indices[i] = frame::jobs::Scheduler::GetThreadIndex();
+        },
+        1);
+    for (const auto index : indices)
+    {
+        EXPECT_LE(index, 3);
+    }
+    scheduler.SetWorkerCount(1);
+    EXPECT_EQ(scheduler.GetWorkerCount(), 1);
+    scheduler.ParallelFor(
+        indices.size(),
+        [&indices](std::size_t i) {
+            indices[i] = frame::jobs::Scheduler::GetThreadIndex();
+        },
+        1);
+    for (const auto index : indices)
+    {
+        EXPECT_LE(index, 1);
+    }
+}
+
+} // namespace test
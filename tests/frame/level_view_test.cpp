@@ -0,0 +1,185 @@
+#include "frame/level.h"
+
+#include <format>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "frame/node_mesh.h"
+#include "frame/vulkan/material.h"
+#include "frame/vulkan/skinned_mesh.h"
+#include "frame/vulkan/static_mesh.h"
+
+namespace test
+{
+
+namespace
+{
+
+frame::NodeInterface* NoParent(const std::string&)
+{
+    return nullptr;
+}
+
+frame::EntityId AddMesh(
+    frame::Level& level, const std::string& name, bool skinned)
+{
+    std::unique_ptr<frame::MeshInterface> mesh;
+    if (skinned)
+    {
+        mesh = std::make_unique<frame::vulkan::SkinnedMesh>(
+            frame::MeshParameter{}, false);
+    }
+    else
+    {
+        mesh = std::make_unique<frame::vulkan::StaticMesh>(
+            frame::MeshParameter{}, false);
+    }
+    mesh->SetName(name);
+    mesh->SetIndexSize(3 * sizeof(std::uint32_t));
+    return level.AddMesh(std::move(mesh));
+}
+
+frame::EntityId AddMaterial(frame::Level& level, const std::string& name)
+{
+    auto material = std::make_unique<frame::vulkan::Material>();
+    material->SetName(name);
+    return level.AddMaterial(std::move(material));
+}
+
+frame::EntityId AddNode(
+    frame::Level& level,
+    const std::string& name,
+    frame::EntityId mesh_id,
+    frame::EntityId material_id)
+{
+    auto node = std::make_unique<frame::NodeMesh>(NoParent, mesh_id);
+    node->SetName(name);
+    const auto node_id = level.AddSceneNode(std::move(node));
+    level.AddMeshMaterialId(node_id, material_id);
+    return node_id;
+}
+
+// A level with node_count mesh nodes sharing a few meshes and materials.
+void FillLevel(frame::Level& level, std::size_t node_count)
+{
+    const frame::EntityId meshes[] = {
+        AddMesh(level, "Static.0", false),
+        AddMesh(level, "Static.1", false),
+        AddMesh(level, "Skinned.0", true)};
+    const frame::EntityId materials[] = {
+        AddMaterial(level, "Material.0"), AddMaterial(level, "Material.1")};
+    for (std::size_t i = 0; i < node_count; ++i)
+    {
+        AddNode(
+            level,
+            std::format("Node.{}", i),
+            meshes[i % std::size(meshes)],
+            materials[i % std::size(materials)]);
+    }
+}
+
+} // namespace
+
+TEST(LevelViewTest, RenderItemsMatchMeshMaterialIds)
+{
+    frame::Level level;
+    FillLevel(level, 16);
+    // Not attached to a node, not part of the skinned meshes.
+    AddMesh(level, "Skinned.Unused", true);
+    const auto ids = level.GetMeshMaterialIds();
+    const auto& items = level.GetRenderItems();
+    ASSERT_EQ(items.size(), ids.size());
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        EXPECT_EQ(items[i].node_id, ids[i].first);
+        EXPECT_EQ(items[i].material_id, ids[i].second);
+        EXPECT_EQ(items[i].node_mesh, &level.GetSceneNodeFromId(ids[i].first));
+        EXPECT_EQ(
+            items[i].mesh,
+            &level.GetMeshFromId(items[i].node_mesh->GetLocalMesh()));
+        EXPECT_EQ(items[i].material, &level.GetMaterialFromId(ids[i].second));
+    }
+    EXPECT_TRUE(
+        level.GetRenderItems(frame::proto::NodeMesh::POST_PROCESS_TIME)
+            .empty());
+    // Skinned.0 is shared by several nodes and listed once.
+    ASSERT_EQ(level.GetSkinnedMeshes().size(), 1u);
+    EXPECT_EQ(
+        level.GetSkinnedMeshes().front(),
+        &level.GetMeshFromId(level.GetIdFromName("Skinned.0")));
+}
+
+TEST(LevelViewTest, ViewsFollowLevelChanges)
+{
+    frame::Level level;
+    FillLevel(level, 4);
+    const auto* items = &level.GetRenderItems();
+    const auto revision = level.GetRevision();
+    // No change, same list.
+    EXPECT_EQ(&level.GetRenderItems(), items);
+    EXPECT_EQ(level.GetRenderItems().size(), 4u);
+    AddNode(
+        level,
+        "Node.Extra",
+        level.GetIdFromName("Static.0"),
+        level.GetIdFromName("Material.0"));
+    EXPECT_GT(level.GetRevision(), revision);
+    EXPECT_EQ(level.GetRenderItems().size(), 5u);
+    // Replacing a static mesh by a skinned one updates both views.
+    const auto mesh_id = level.GetIdFromName("Static.1");
+    auto skinned = std::make_unique<frame::vulkan::SkinnedMesh>(
+        frame::MeshParameter{}, false);
+    skinned->SetName("Static.1");
+    auto* skinned_ptr = skinned.get();
+    level.ReplaceMesh(std::move(skinned), mesh_id);
+    EXPECT_EQ(level.GetSkinnedMeshes().size(), 2u);
+    bool found = false;
+    for (const auto& item : level.GetRenderItems())
+    {
+        if (item.node_mesh->GetLocalMesh() == mesh_id)
+        {
+            EXPECT_EQ(item.mesh_id, mesh_id);
+            EXPECT_EQ(item.mesh, skinned_ptr);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(LevelViewTest, RenderItemsMatchLookups)
+{
+    constexpr std::size_t kItemCount = 10000;
+    frame::Level level;
+    FillLevel(level, kItemCount);
+    // Work of the draw loop before the views: id lookups in the level maps
+    // and casts to find the node, the mesh and its type.
+    std::size_t lookup_sum = 0;
+    for (const auto& [node_id, material_id] : level.GetMeshMaterialIds())
+    {
+        auto& node_mesh = dynamic_cast<frame::NodeMesh&>(
+            level.GetSceneNodeFromId(node_id));
+        auto& mesh = level.GetMeshFromId(node_mesh.GetLocalMesh());
+        auto& material = level.GetMaterialFromId(material_id);
+        const bool skinned =
+            dynamic_cast<frame::vulkan::SkinnedMesh*>(&mesh) != nullptr;
+        lookup_sum += mesh.GetIndexSize() + skinned + material.GetProgramId();
+    }
+    // Same work on the pre-resolved items, the second frame reuses them.
+    const auto* items = &level.GetRenderItems();
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        std::size_t item_sum = 0;
+        for (const auto& item : level.GetRenderItems())
+        {
+            const bool skinned = item.mesh->GetMeshType() ==
+                                 frame::MeshTypeEnum::SKINNED_MESH;
+            item_sum += item.mesh->GetIndexSize() + skinned +
+                        item.material->GetProgramId();
+        }
+        EXPECT_EQ(item_sum, lookup_sum);
+        EXPECT_EQ(&level.GetRenderItems(), items);
+    }
+}
+
+} // namespace test
@@ -2,6 +2,12 @@
 
 #include "frame/opengl/file/load_program.h"
 
+#include <filesystem>
+#include <fstream>
+
+#include "frame/file/file_system.h"
+#include "frame/opengl/file/program_binary_cache.h"
+
 namespace test
 {
 
@@ -25,4 +31,70 @@ TEST_F(LoadProgramTest, LoadFromFileTest)
             "asset/shader/opengl/blur.frag"));
 }
 
+TEST_F(LoadProgramTest, ProgramBinaryCacheTest)
+{
+    frame::proto::Program proto_program;
+    proto_program.set_name("blur");
+    proto_program.set_pipeline_name("blur");
+    std::ifstream vertex_ifs{
+        frame::file::FindFile("asset/shader/opengl/blur.vert")};
+    std::ifstream fragment_ifs{
+        frame::file::FindFile("asset/shader/opengl/blur.frag")};
+    const std::string vertex_source(
+        std::istreambuf_iterator<char>(vertex_ifs), {});
+    const std::string fragment_source(
+        std::istreambuf_iterator<char>(fragment_ifs), {});
+    const auto key = frame::opengl::file::MakeProgramBinaryCacheKey(
+        "blur", vertex_source, fragment_source);
+    ASSERT_TRUE(key);
+    // Other sources are cached in another file.
+    EXPECT_NE(
+        frame::opengl::file::MakeProgramBinaryCacheKey(
+            "blur", vertex_source + "\n", fragment_source)
+            ->cache_path,
+        key->cache_path);
+    EXPECT_EQ(
+        key->cache_path.filename(),
+        frame::opengl::file::MakeProgramBinaryCacheFileName(*key));
+    // Another driver gets its own file.
+    auto stale_key = *key;
+    stale_key.version += " (other)";
+    EXPECT_NE(
+        frame::opengl::file::MakeProgramBinaryCacheFileName(stale_key),
+        key->cache_path.filename());
+    std::filesystem::remove(key->cache_path);
+    // Cold start, the program is compiled and its binary saved.
+    auto stats = frame::opengl::file::GetProgramLoadStats();
+    EXPECT_TRUE(frame::opengl::file::LoadProgram(proto_program));
+    EXPECT_EQ(
+        frame::opengl::file::GetProgramLoadStats().compiled,
+        stats.compiled + 1);
+    if (!frame::opengl::file::LoadProgramBinaryCache(*key))
+    {
+        GTEST_SKIP() << "The driver has no program binary format.";
+    }
+    // Warm start, the program is linked from the binary.
+    const auto write_time = std::filesystem::last_write_time(key->cache_path);
+    stats = frame::opengl::file::GetProgramLoadStats();
+    EXPECT_TRUE(frame::opengl::file::LoadProgram(proto_program));
+    EXPECT_EQ(
+        frame::opengl::file::GetProgramLoadStats().from_binary,
+        stats.from_binary + 1);
+    EXPECT_EQ(
+        frame::opengl::file::GetProgramLoadStats().compiled,
+        stats.compiled);
+    EXPECT_EQ(std::filesystem::last_write_time(key->cache_path), write_time);
+    // A binary from another driver at the same path is rejected, the
+    // program is compiled.
+    frame::opengl::file::SaveProgramBinaryCache(
+        stale_key, *frame::opengl::file::LoadProgramBinaryCache(*key));
+    EXPECT_FALSE(frame::opengl::file::LoadProgramBinaryCache(*key));
+    stats = frame::opengl::file::GetProgramLoadStats();
+    EXPECT_TRUE(frame::opengl::file::LoadProgram(proto_program));
+    EXPECT_EQ(
+        frame::opengl::file::GetProgramLoadStats().compiled,
+        stats.compiled + 1);
+    EXPECT_TRUE(frame::opengl::file::LoadProgramBinaryCache(*key));
+}
+
 } // End namespace test.
@@ -1,5 +1,7 @@
 #include "frame/opengl/material_test.h"
 
+#include <stdexcept>
+
 #include "frame/file/file_system.h"
 #include "frame/level.h"
 #include "frame/opengl/file/load_texture.h"
@@ -51,4 +53,22 @@ TEST_F(MaterialTest, CheckAddRemoveTextureTest)
     EXPECT_EQ(2, material_->GetTextureIds().size());
 }
 
+TEST_F(MaterialTest, InnerNamesAreInternedTest)
+{
+    frame::opengl::Material material;
+    EXPECT_TRUE(material.AddTextureId(1, "Albedo"));
+    EXPECT_EQ(
+        material.GetInnerNameId(1), frame::InternUniformName("Albedo"));
+    EXPECT_TRUE(material.AddNodeName("Light", "light_model"));
+    EXPECT_FALSE(material.AddNodeName("Light", "other_model"));
+    ASSERT_EQ(material.GetNodeNameIds().size(), 1);
+    EXPECT_EQ(
+        material.GetNodeNameIds().at("Light"),
+        frame::InternUniformName("light_model"));
+    EXPECT_EQ(material.EnableTextureSlot(1), 0);
+    material.DisableAll();
+    EXPECT_TRUE(material.RemoveTextureId(1));
+    EXPECT_THROW(material.GetInnerNameId(1), std::out_of_range);
+}
+
 } // End namespace test.
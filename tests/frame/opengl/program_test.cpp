@@ -75,6 +75,87 @@ TEST_F(ProgramTest, UniformTest)
     EXPECT_TRUE(program_);
 }
 
+TEST_F(ProgramTest, HasUniformByIdTest)
+{
+    std::istringstream iss_vertex(GetVertexSource());
+    std::istringstream iss_fragment(GetFragmentSource());
+    auto program = frame::opengl::CreateProgram(
+        "test", "test_vert", "test_frag", iss_vertex, iss_fragment);
+    ASSERT_TRUE(program);
+    auto& gl_program = dynamic_cast<frame::opengl::Program&>(*program);
+    const auto model_id = frame::InternUniformName("model");
+    EXPECT_TRUE(gl_program.HasUniform(model_id));
+    EXPECT_TRUE(program->HasUniform("model"));
+    EXPECT_FALSE(
+        gl_program.HasUniform(frame::InternUniformName("not_a_uniform")));
+    program->RemoveUniform("model");
+    EXPECT_FALSE(gl_program.HasUniform(model_id));
+}
+
+TEST_F(ProgramTest, SkipUnchangedUniformTest)
+{
+    std::istringstream iss_vertex(GetVertexSource());
+    std::istringstream iss_fragment(GetFragmentSource());
+    auto program = frame::opengl::CreateProgram(
+        "test", "test_vert", "test_frag", iss_vertex, iss_fragment);
+    ASSERT_TRUE(program);
+    auto& gl_program = dynamic_cast<frame::opengl::Program&>(*program);
+    gl_program.Use();
+    gl_program.TakeUniformUploadCounters();
+    const auto model_id = frame::InternUniformName("model");
+    gl_program.SetUniformValue({model_id, glm::mat4(2.0f)});
+    gl_program.SetUniformValue({model_id, glm::mat4(2.0f)});
+    gl_program.SetUniformValue({model_id, glm::mat4(3.0f)});
+    auto counters = gl_program.TakeUniformUploadCounters();
+    EXPECT_EQ(counters.issued, 2u);
+    EXPECT_EQ(counters.skipped, 1u);
+    // Going through the proto resets the shadow copy.
+    program->AddUniform(
+        std::make_unique<frame::Uniform>("model", glm::mat4(3.0f)));
+    gl_program.SetUniformValue({model_id, glm::mat4(3.0f)});
+    counters = gl_program.TakeUniformUploadCounters();
+    EXPECT_EQ(counters.issued, 1u);
+    EXPECT_EQ(counters.skipped, 0u);
+    gl_program.UnUse();
+}
+
+TEST_F(ProgramTest, UniformBlockTest)
+{
+    std::string vertex_source = GetVertexSource();
+    const std::string loose_uniforms = "uniform mat4 projection;\n"
+                                       "uniform mat4 view;\n"
+                                       "uniform mat4 model;\n";
+    const auto pos = vertex_source.find(loose_uniforms);
+    ASSERT_NE(pos, std::string::npos);
+    vertex_source.replace(
+        pos,
+        loose_uniforms.size(),
+        R"vert(
+layout(std140) uniform FrameBlock
+{
+	mat4 projection;
+	mat4 view;
+};
+layout(std140) uniform ObjectBlock
+{
+	mat4 model;
+};
+)vert");
+    std::istringstream iss_vertex(vertex_source);
+    std::istringstream iss_fragment(GetFragmentSource());
+    auto program = frame::opengl::CreateProgram(
+        "test", "test_vert", "test_frag", iss_vertex, iss_fragment);
+    ASSERT_TRUE(program);
+    auto& gl_program = dynamic_cast<frame::opengl::Program&>(*program);
+    EXPECT_TRUE(gl_program.HasFrameBlock());
+    EXPECT_TRUE(gl_program.HasObjectBlock());
+    // Block members are not loose uniforms.
+    EXPECT_FALSE(program->HasUniform("projection"));
+    EXPECT_FALSE(program->HasUniform("model"));
+    EXPECT_TRUE(program->HasUniform("Color"));
+    ASSERT_EQ(1, program->GetUniformNameList().size());
+}
+
 const std::string ProgramTest::GetVertexSource() const
 {
     return R"vert(
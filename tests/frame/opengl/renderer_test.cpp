@@ -1,10 +1,51 @@
 #include "frame/opengl/renderer_test.h"
 
+#include <format>
+#include <memory_resource>
+#include <vector>
+
 #include "frame/level.h"
+#include "frame/opengl/frame_buffer.h"
+#include "frame/opengl/state_cache.h"
 
 namespace test
 {
 
+namespace
+{
+
+// Upstream of the renderer frame allocator counting its allocations.
+class CountingResource : public std::pmr::memory_resource
+{
+  public:
+    std::size_t GetAllocationCount() const
+    {
+        return allocation_count_;
+    }
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocation_count_;
+        return upstream_->allocate(bytes, alignment);
+    }
+    void do_deallocate(
+        void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        upstream_->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_ = std::pmr::new_delete_resource();
+    std::size_t allocation_count_ = 0;
+};
+
+} // namespace
+
 TEST_F(RendererTest, CreateRenderingTest)
 {
     ASSERT_FALSE(renderer_);
@@ -26,4 +67,181 @@ TEST_F(RendererTest, RenderingDisplayTest)
     renderer_->PresentFinal();
 }
 
+TEST_F(RendererTest, RenderSceneCullingStatsTest)
+{
+    ASSERT_FALSE(renderer_);
+    ASSERT_TRUE(LoadDefaultLevel());
+    renderer_ = std::make_unique<frame::opengl::Renderer>(
+        *level_.get(),
+        glm::uvec4(0, 0, window_->GetSize().x, window_->GetSize().y));
+    renderer_->RenderScene(level_->GetDefaultCamera());
+    const auto stats = renderer_->GetCullingStats();
+    // Every scene pair is either drawn (maybe instanced) or culled.
+    EXPECT_EQ(
+        stats.drawn + stats.culled,
+        level_->GetMeshMaterialIds(frame::proto::NodeMesh::SCENE_RENDER_TIME)
+            .size());
+}
+
+TEST_F(RendererTest, StateCacheSkipsRedundantBindsTest)
+{
+    frame::opengl::StateCache state_cache;
+    frame::opengl::FrameBuffer frame_buffer;
+    const glm::uvec4 viewport(0, 0, size_.x, size_.y);
+    state_cache.Invalidate();
+    for (int i = 0; i < 2; ++i)
+    {
+        state_cache.BindFrameBuffer(&frame_buffer);
+        state_cache.Viewport(viewport);
+        state_cache.BindVertexArray(0);
+    }
+    auto counters = state_cache.GetCounters();
+    // Only the first bind of each state reaches OpenGL.
+    EXPECT_EQ(counters.state_calls, 3);
+    EXPECT_EQ(counters.skipped_calls, 3);
+    // Reset unbinds the program (unknown after Invalidate) and the frame
+    // buffer, the vertex array is already 0.
+    state_cache.ResetCounters();
+    state_cache.Reset();
+    counters = state_cache.GetCounters();
+    EXPECT_EQ(counters.state_calls, 2);
+    EXPECT_EQ(counters.skipped_calls, 1);
+    // Everything is already in the default state.
+    state_cache.ResetCounters();
+    state_cache.Reset();
+    counters = state_cache.GetCounters();
+    EXPECT_EQ(counters.state_calls, 0);
+    EXPECT_EQ(counters.skipped_calls, 2);
+    EXPECT_EQ(counters.draw_calls, 0);
+}
+
+TEST_F(RendererTest, GLCallCountersTest)
+{
+    for (const auto* file : {"raytracing.json", "cubemap.json"})
+    {
+        auto level = frame::json::ParseLevel(
+            size_,
+            frame::file::FindFile(std::format("asset/json/{}", file)));
+        ASSERT_TRUE(level);
+        level_ = std::move(level);
+        renderer_ = std::make_unique<frame::opengl::Renderer>(
+            *level_.get(), glm::uvec4(0, 0, size_.x, size_.y));
+        // The first frame has the first render work, the next ones do the
+        // same calls every frame.
+        std::vector<frame::opengl::GLCallCounters> frames;
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            renderer_->PreRender();
+            renderer_->RenderSkybox(level_->GetDefaultCamera());
+            renderer_->RenderScene(level_->GetDefaultCamera());
+            renderer_->PostProcess();
+            frames.push_back(renderer_->GetGLCallCounters());
+        }
+        EXPECT_GT(frames[1].draw_calls, 0) << file;
+        EXPECT_GE(frames[0].draw_calls, frames[1].draw_calls) << file;
+        EXPECT_EQ(frames[1].draw_calls, frames[2].draw_calls) << file;
+        EXPECT_EQ(frames[1].state_calls, frames[2].state_calls) << file;
+        EXPECT_EQ(frames[1].skipped_calls, frames[2].skipped_calls) << file;
+        renderer_.reset();
+    }
+}
+
+TEST_F(RendererTest, InstancedNodesDrawOnceTest)
+{
+    ASSERT_TRUE(LoadLevel("renderer_instancing_test.json"));
+    renderer_ = std::make_unique<frame::opengl::Renderer>(
+        *level_.get(), glm::uvec4(0, 0, size_.x, size_.y));
+    renderer_->PreRender();
+    renderer_->RenderScene(level_->GetDefaultCamera());
+    // The 8 cubes share their mesh and material, they are depth tested
+    // together so they are drawn in a single instanced call.
+    EXPECT_EQ(renderer_->GetCullingStats().culled, 0u);
+    EXPECT_EQ(renderer_->GetGLCallCounters().draw_calls, 1u);
+}
+
+TEST_F(RendererTest, SteadyFramesDoNotAllocateTest)
+{
+    ASSERT_TRUE(LoadLevel("renderer_instancing_test.json"));
+    CountingResource upstream;
+    renderer_ = std::make_unique<frame::opengl::Renderer>(
+        *level_.get(), glm::uvec4(0, 0, size_.x, size_.y), &upstream);
+    // The arenas come from the upstream.
+    EXPECT_GT(upstream.GetAllocationCount(), 0u);
+    const auto render_frames = [this](int frame_count) {
+        for (int frame = 0; frame < frame_count; ++frame)
+        {
+            renderer_->PreRender();
+            renderer_->RenderScene(level_->GetDefaultCamera());
+        }
+    };
+    // Each arena in flight is grown at most once to fit a frame.
+    render_frames(4);
+    const auto warm_count = upstream.GetAllocationCount();
+    render_frames(16);
+    EXPECT_EQ(upstream.GetAllocationCount(), warm_count);
+    // The arenas go back to the upstream before it is destroyed.
+    renderer_.reset();
+}
+
+TEST_F(RendererTest, UnchangedUniformsSkippedTest)
+{
+    ASSERT_TRUE(LoadLevel("renderer_instancing_test.json"));
+    renderer_ = std::make_unique<frame::opengl::Renderer>(
+        *level_.get(), glm::uvec4(0, 0, size_.x, size_.y));
+    std::vector<frame::opengl::GLCallCounters> frames;
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        renderer_->PreRender();
+        renderer_->RenderScene(level_->GetDefaultCamera());
+        frames.push_back(renderer_->GetGLCallCounters());
+    }
+    EXPECT_GT(frames[0].uniform_uploads, 0u);
+    // Nothing moved and the time did not change, the program still holds
+    // every value.
+    EXPECT_EQ(frames[1].uniform_uploads, 0u);
+    EXPECT_GT(frames[1].skipped_uniform_uploads, 0u);
+}
+
+TEST_F(RendererTest, SortedSceneBindsLessTest)
+{
+    ASSERT_TRUE(LoadLevel("renderer_sort_test.json"));
+    // Every other material uses an other program and texture, in scene
+    // order the program and texture change on every draw.
+    const auto program_id = level_->GetIdFromName("SceneProgramOther");
+    const auto texture_id = level_->GetIdFromName("color_other");
+    ASSERT_NE(program_id, frame::NullId);
+    ASSERT_NE(texture_id, frame::NullId);
+    for (int i = 1; i < 8; i += 2)
+    {
+        auto& material = level_->GetMaterialFromId(
+            level_->GetIdFromName(std::format("SceneMaterial{}", i)));
+        material.SetProgramId(program_id);
+        for (const auto id : material.GetTextureIds())
+        {
+            material.RemoveTextureId(id);
+        }
+        material.AddTextureId(texture_id, "Color");
+    }
+    renderer_ = std::make_unique<frame::opengl::Renderer>(
+        *level_.get(), glm::uvec4(0, 0, size_.x, size_.y));
+    const auto render_frames = [this] {
+        // The second frame starts with the state left by the first one.
+        for (int frame = 0; frame < 2; ++frame)
+        {
+            renderer_->PreRender();
+            renderer_->RenderScene(level_->GetDefaultCamera());
+        }
+        return renderer_->GetGLCallCounters();
+    };
+    // Without depth test the draws keep the scene order.
+    renderer_->SetDepthTest(false);
+    const auto scene_order = render_frames();
+    renderer_->SetDepthTest(true);
+    const auto sorted = render_frames();
+    EXPECT_EQ(scene_order.draw_calls, 8u);
+    EXPECT_EQ(sorted.draw_calls, scene_order.draw_calls);
+    EXPECT_LT(sorted.state_calls, scene_order.state_calls);
+    EXPECT_GT(sorted.skipped_calls, scene_order.skipped_calls);
+}
+
 } // End namespace test.
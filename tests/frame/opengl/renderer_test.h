@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 #include "frame/device_interface.h"
 #include "frame/file/file_system.h"
 #include "frame/json/parse_level.h"
@@ -22,9 +24,13 @@ class RendererTest : public testing::Test
 
   public:
     bool LoadDefaultLevel()
+    {
+        return LoadLevel("renderer_test.json");
+    }
+    bool LoadLevel(const std::string& file_name)
     {
         auto level = frame::json::ParseLevel(
-            size_, frame::file::FindFile("asset/json/renderer_test.json"));
+            size_, frame::file::FindFile("asset/json/" + file_name));
         if (level)
         {
             level_ = std::move(level);
@@ -0,0 +1,84 @@
+#include "frame/profiler.h"
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace test
+{
+
+namespace
+{
+
+const frame::ProfileScopeStats* FindScope(
+    const frame::ProfileFrameStats& stats, const char* name)
+{
+    for (const auto& scope : stats.scopes)
+    {
+        if (std::strcmp(scope.name, name) == 0)
+        {
+            return &scope;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(ProfilerTest, FrameAggregatesNestedScopes)
+{
+    auto& profiler = frame::Profiler::GetInstance();
+    // Leave out what the other tests recorded.
+    profiler.EndFrame();
+    {
+        frame::ProfileScope outer("Outer");
+        for (int i = 0; i < 3; ++i)
+        {
+            frame::ProfileScope inner("Inner");
+        }
+    }
+    profiler.EndFrame();
+    const auto stats = profiler.GetLastFrameStats();
+    ASSERT_EQ(stats.scopes.size(), 2);
+    // Parents come before their children.
+    EXPECT_STREQ(stats.scopes[0].name, "Outer");
+    EXPECT_EQ(stats.scopes[0].calls, 1);
+    EXPECT_STREQ(stats.scopes[1].name, "Inner");
+    EXPECT_EQ(stats.scopes[1].calls, 3);
+    EXPECT_EQ(stats.scopes[1].depth, stats.scopes[0].depth + 1);
+    EXPECT_GE(stats.scopes[0].total_ms, stats.scopes[1].total_ms);
+    // Nothing new, the next frame is empty.
+    profiler.EndFrame();
+    EXPECT_TRUE(profiler.GetLastFrameStats().scopes.empty());
+}
+
+TEST(ProfilerTest, ChromeTraceHasTheScopesOfEveryThread)
+{
+    auto& profiler = frame::Profiler::GetInstance();
+    profiler.EndFrame();
+    std::jthread([] {
+        frame::Profiler::SetThreadName("Profiler test thread");
+        frame::ProfileScope scope("Worker scope");
+    }).join();
+    {
+        frame::ProfileScope scope("Main scope");
+    }
+    profiler.EndFrame();
+    const auto stats = profiler.GetLastFrameStats();
+    EXPECT_NE(FindScope(stats, "Worker scope"), nullptr);
+    EXPECT_NE(FindScope(stats, "Main scope"), nullptr);
+
+    std::ostringstream os;
+    profiler.WriteChromeTrace(os);
+    const std::string trace = os.str();
+    EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ms\""));
+    EXPECT_NE(
+        trace.find("{\"name\":\"Worker scope\",\"ph\":\"X\""),
+        std::string::npos);
+    EXPECT_NE(
+        trace.find("{\"name\":\"Main scope\",\"ph\":\"X\""), std::string::npos);
+}
+
+} // namespace test
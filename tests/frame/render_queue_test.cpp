@@ -0,0 +1,148 @@
+#include "frame/render_queue.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace test
+{
+
+TEST(RenderQueueTest, KeyOrder)
+{
+    // State changes dominate depth.
+    EXPECT_LT(
+        frame::MakeDrawKey(1, 9, 9, 9, 100.f),
+        frame::MakeDrawKey(2, 0, 0, 0, 0.f));
+    EXPECT_LT(
+        frame::MakeDrawKey(1, 1, 9, 9, 100.f),
+        frame::MakeDrawKey(1, 2, 0, 0, 0.f));
+    EXPECT_LT(
+        frame::MakeDrawKey(1, 1, 1, 9, 100.f),
+        frame::MakeDrawKey(1, 1, 2, 0, 0.f));
+    EXPECT_LT(
+        frame::MakeDrawKey(1, 1, 1, 1, 100.f),
+        frame::MakeDrawKey(1, 1, 1, 2, 0.f));
+    // Same state, front to back.
+    EXPECT_LT(
+        frame::MakeDrawKey(1, 1, 1, 1, 0.5f),
+        frame::MakeDrawKey(1, 1, 1, 1, 2.f));
+    EXPECT_EQ(
+        frame::MakeDrawKey(1, 1, 1, 1, -3.f),
+        frame::MakeDrawKey(1, 1, 1, 1, 0.f));
+}
+
+TEST(RenderQueueTest, SortMatchesStableSort)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> id(0, 7);
+    std::uniform_real_distribution<float> depth(0.f, 100.f);
+    for (const std::size_t size : {0, 1, 5, 31, 32, 1000})
+    {
+        std::vector<frame::DrawItem> items;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            items.push_back(
+                {frame::MakeDrawKey(
+                     id(generator),
+                     id(generator),
+                     id(generator),
+                     id(generator),
+                     depth(generator)),
+                 static_cast<std::uint32_t>(i)});
+        }
+        auto expected = items;
+        std::stable_sort(
+            expected.begin(),
+            expected.end(),
+            [](const frame::DrawItem& a, const frame::DrawItem& b) {
+                return a.key < b.key;
+            });
+        std::vector<frame::DrawItem> scratch;
+        frame::SortDrawItems(items, scratch);
+        ASSERT_EQ(items.size(), expected.size());
+        for (std::size_t i = 0; i < items.size(); ++i)
+        {
+            EXPECT_EQ(items[i].key, expected[i].key) << size << " " << i;
+            EXPECT_EQ(items[i].index, expected[i].index) << size << " " << i;
+        }
+    }
+}
+
+TEST(RenderQueueTest, SortRangeKeepsBarriers)
+{
+    frame::RenderQueue queue;
+    queue.Push(3, 0);
+    queue.Push(1, 1);
+    queue.Push(0, 2);
+    queue.Push(5, 3);
+    queue.Push(4, 4);
+    queue.Sort(0, 2);
+    queue.Sort(3, 5);
+    const auto items = queue.GetItems();
+    std::vector<std::uint32_t> order;
+    for (const auto& item : items)
+    {
+        order.push_back(item.index);
+    }
+    EXPECT_EQ(order, std::vector<std::uint32_t>({1, 0, 2, 4, 3}));
+}
+
+TEST(RenderQueueTest, SortTenThousandItems)
+{
+    constexpr std::size_t kItemCount = 10000;
+    constexpr int kProgramCount = 64;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> id(0, kProgramCount - 1);
+    std::uniform_real_distribution<float> depth(0.f, 1000.f);
+    frame::RenderQueue queue;
+    // The queue is refilled every frame, the second one reuses its buffers.
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        queue.Clear();
+        for (std::size_t i = 0; i < kItemCount; ++i)
+        {
+            queue.Push(
+                frame::MakeDrawKey(
+                    1,
+                    id(generator),
+                    id(generator),
+                    id(generator),
+                    depth(generator)),
+                static_cast<std::uint32_t>(i));
+        }
+        queue.Sort();
+    }
+    const auto items = queue.GetItems();
+    ASSERT_EQ(items.size(), kItemCount);
+    EXPECT_TRUE(std::is_sorted(
+        items.begin(),
+        items.end(),
+        [](const frame::DrawItem& a, const frame::DrawItem& b) {
+            return a.key < b.key;
+        }));
+    // Every item is still there once.
+    std::vector<bool> seen(kItemCount, false);
+    for (const auto& item : items)
+    {
+        ASSERT_LT(item.index, kItemCount);
+        EXPECT_FALSE(seen[item.index]) << item.index;
+        seen[item.index] = true;
+    }
+    // The program bits (below the 10 target bits) change once per program.
+    const auto program_of = [](const frame::DrawItem& item) {
+        return (item.key >> 42) & 0xfff;
+    };
+    int program_changes = 0;
+    for (std::size_t i = 1; i < items.size(); ++i)
+    {
+        if (program_of(items[i]) != program_of(items[i - 1]))
+        {
+            ++program_changes;
+        }
+    }
+    EXPECT_EQ(program_changes, kProgramCount - 1);
+}
+
+} // namespace test
@@ -0,0 +1,164 @@
+#include "frame/uniform_value.h"
+
+#include <map>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "frame/json/parse_uniform.h"
+#include "frame/uniform.h"
+#include "frame/uniform_collection_wrapper.h"
+
+namespace test
+{
+
+TEST(UniformValueTest, InternedNames)
+{
+    const auto id = frame::InternUniformName("uniform_value_test");
+    EXPECT_EQ(frame::InternUniformName("uniform_value_test"), id);
+    EXPECT_NE(frame::InternUniformName("uniform_value_test_other"), id);
+    EXPECT_EQ(frame::GetUniformName(id), "uniform_value_test");
+    EXPECT_EQ(frame::InternUniformName(""), 0u);
+}
+
+TEST(UniformValueTest, ProtoRoundTrip)
+{
+    const auto name_id = frame::InternUniformName("value");
+    const glm::mat4 matrix(
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+    const frame::UniformValue values[] = {
+        {name_id, 42},
+        {name_id, 1.5f},
+        {name_id, glm::vec2(1, 2)},
+        {name_id, glm::vec3(1, 2, 3)},
+        {name_id, glm::vec4(1, 2, 3, 4)},
+        {name_id, matrix}};
+    for (const auto& value : values)
+    {
+        const auto proto = frame::UniformValueToProto(value);
+        EXPECT_EQ(proto.name(), "value");
+        const auto maybe_value = frame::UniformValueFromProto(proto);
+        ASSERT_TRUE(maybe_value);
+        EXPECT_EQ(maybe_value->GetNameId(), name_id);
+        EXPECT_TRUE(maybe_value->SameValue(value));
+    }
+    // Same conversion as the proto based uniform.
+    const frame::Uniform uniform("value", matrix);
+    EXPECT_EQ(
+        frame::json::ParseUniform(
+            frame::UniformValueToProto(values[5]).uniform_mat4()),
+        frame::json::ParseUniform(uniform.GetData().uniform_mat4()));
+    // Arrays have no plain payload.
+    const frame::Uniform ints(
+        "ints", glm::uvec2(2, 1), std::vector<int>{1, 2});
+    EXPECT_FALSE(frame::UniformValueFromProto(ints.GetData()));
+}
+
+TEST(UniformValueTest, CollectionWrapper)
+{
+    frame::UniformCollectionWrapper wrapper(
+        glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(2.0f), 0.5);
+    wrapper.AddUniform(std::make_unique<frame::Uniform>("extra", 3));
+    wrapper.AddUniform(
+        std::make_unique<frame::Uniform>(
+            "ints", glm::uvec2(2, 1), std::vector<int>{1, 2}));
+    wrapper.AddUniformValue({frame::InternUniformName("extra"), 4});
+    EXPECT_EQ(wrapper.GetUniform("extra").GetData().uniform_int(), 4);
+    EXPECT_EQ(
+        frame::json::ParseUniform(
+            wrapper.GetUniform("model").GetData().uniform_mat4()),
+        glm::mat4(2.0f));
+    EXPECT_EQ(
+        wrapper.GetUniform("ints").GetData().uniform_ints().values_size(), 2);
+    std::size_t invalid_count = 0;
+    for (const auto& value : wrapper.GetUniformValues())
+    {
+        invalid_count += value.GetType() == frame::UniformValueType::INVALID;
+    }
+    EXPECT_EQ(invalid_count, 1u);
+    EXPECT_EQ(
+        wrapper.GetUniformNames().size(), wrapper.GetUniformValues().size());
+    wrapper.RemoveUniform("extra");
+    EXPECT_THROW(wrapper.GetUniform("extra"), std::runtime_error);
+}
+
+TEST(UniformValueTest, CollectionWrapperReset)
+{
+    const auto extra_id = frame::InternUniformName("extra");
+    frame::UniformCollectionWrapper wrapper(
+        glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f), 0.0);
+    wrapper.AddUniformValue({extra_id, 1});
+    wrapper.AddUniform(
+        std::make_unique<frame::Uniform>(
+            "ints", glm::uvec2(2, 1), std::vector<int>{1, 2}));
+    const auto size = wrapper.GetUniformValues().size();
+    const auto* data = wrapper.GetUniformValues().data();
+    for (int draw = 0; draw < 8; ++draw)
+    {
+        wrapper.Reset(
+            glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(2.0f), draw);
+        EXPECT_THROW(wrapper.GetUniform("ints"), std::runtime_error);
+        wrapper.AddUniformValue({extra_id, draw});
+        EXPECT_EQ(wrapper.GetUniform("extra").GetData().uniform_int(), draw);
+        EXPECT_EQ(wrapper.GetUniformValues().size(), size - 1);
+        // Same storage from one draw to the next.
+        EXPECT_EQ(wrapper.GetUniformValues().data(), data);
+    }
+    EXPECT_EQ(
+        frame::json::ParseUniform(
+            wrapper.GetUniform("model").GetData().uniform_mat4()),
+        glm::mat4(2.0f));
+}
+
+TEST(UniformValueTest, PerDrawUniformsMatchProtoUniforms)
+{
+    const glm::mat4 projection(2.0f);
+    const glm::mat4 view(1.0f);
+    const glm::vec3 light_dir(0.0f, -1.0f, 0.0f);
+    const auto light_dir_id = frame::InternUniformName("light_dir");
+    const auto light_color_id = frame::InternUniformName("light_color");
+    const auto env_map_id = frame::InternUniformName("env_map_model");
+    frame::UniformCollectionWrapper wrapper;
+    for (int draw = 0; draw < 3; ++draw)
+    {
+        const glm::mat4 model(static_cast<float>(draw + 1));
+        // Before: a proto uniform per value in a string keyed map (the
+        // default uniforms, the light and the environment map).
+        std::map<std::string, std::unique_ptr<frame::UniformInterface>> map;
+        const auto add = [&map](auto&& uniform) {
+            const auto name = uniform->GetName();
+            map[name] = std::move(uniform);
+        };
+        add(std::make_unique<frame::Uniform>("projection", projection));
+        add(std::make_unique<frame::Uniform>("view", view));
+        add(std::make_unique<frame::Uniform>("model", model));
+        add(std::make_unique<frame::Uniform>("env_map_model", view));
+        // After: runtime values in a collection reused between draws.
+        wrapper.Reset(projection, view, model, 1.0);
+        wrapper.AddUniformValue({light_dir_id, light_dir});
+        wrapper.AddUniformValue({light_color_id, light_dir});
+        wrapper.AddUniformValue({env_map_id, view});
+        std::size_t matched = 0;
+        for (const auto& value : wrapper.GetUniformValues())
+        {
+            const auto it = map.find(value.GetName());
+            if (it == map.end())
+            {
+                continue;
+            }
+            ASSERT_EQ(value.GetType(), frame::UniformValueType::FLOAT_MATRIX4)
+                << value.GetName();
+            EXPECT_EQ(
+                value.GetMatrix4(),
+                frame::json::ParseUniform(it->second->GetData().uniform_mat4()))
+                << value.GetName() << " " << draw;
+            ++matched;
+        }
+        EXPECT_EQ(matched, map.size()) << draw;
+        EXPECT_EQ(
+            wrapper.GetUniform("light_dir").GetData().uniform_vec3().y(),
+            -1.0f);
+    }
+}
+
+} // namespace test
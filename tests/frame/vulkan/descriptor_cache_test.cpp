@@ -0,0 +1,70 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+#include "frame/vulkan/descriptor_cache.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+
+using DescriptorLayoutCacheTest = VulkanDeviceTest;
+using DescriptorAllocatorTest = VulkanDeviceTest;
+
+TEST_F(DescriptorLayoutCacheTest, SharesSignatures)
+{
+    frame::vulkan::DescriptorLayoutCache cache(*device_);
+    const std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+        vk::DescriptorSetLayoutBinding(
+            0,
+            vk::DescriptorType::eUniformBuffer,
+            1,
+            vk::ShaderStageFlagBits::eVertex),
+        vk::DescriptorSetLayoutBinding(
+            1,
+            vk::DescriptorType::eCombinedImageSampler,
+            1,
+            vk::ShaderStageFlagBits::eFragment)};
+    // Same signature declared in another order.
+    const std::array<vk::DescriptorSetLayoutBinding, 2> reordered = {
+        bindings[1], bindings[0]};
+    const auto layout = cache.Get(bindings);
+    EXPECT_EQ(cache.Get(reordered), layout);
+    EXPECT_EQ(cache.GetSize(), 1u);
+
+    auto other = bindings;
+    other[1].stageFlags |= vk::ShaderStageFlagBits::eVertex;
+    EXPECT_NE(cache.Get(other), layout);
+    EXPECT_EQ(cache.GetSize(), 2u);
+}
+
+TEST_F(DescriptorAllocatorTest, GrowsAndReusesPools)
+{
+    frame::vulkan::DescriptorLayoutCache cache(*device_);
+    const vk::DescriptorSetLayoutBinding binding(
+        0,
+        vk::DescriptorType::eStorageBuffer,
+        1,
+        vk::ShaderStageFlagBits::eCompute);
+    const auto layout = cache.Get({&binding, 1});
+    frame::vulkan::DescriptorAllocator allocator(*device_);
+    constexpr std::uint32_t kSetCount =
+        frame::vulkan::DescriptorAllocator::kSetsPerPool + 1;
+    for (std::uint32_t i = 0; i < kSetCount; ++i)
+    {
+        EXPECT_TRUE(static_cast<bool>(allocator.Allocate(layout)));
+    }
+    EXPECT_EQ(allocator.GetPoolCount(), 2u);
+    // A level reload reuses the pools.
+    allocator.Reset();
+    for (std::uint32_t i = 0; i < kSetCount; ++i)
+    {
+        allocator.Allocate(layout);
+    }
+    EXPECT_EQ(allocator.GetPoolCount(), 2u);
+}
+
+} // namespace test
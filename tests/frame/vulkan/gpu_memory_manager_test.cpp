@@ -0,0 +1,103 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+
+using GpuMemoryManagerTest = VulkanDeviceTest;
+
+TEST_F(GpuMemoryManagerTest, SubAllocatesBuffers)
+{
+    constexpr std::size_t kBufferCount = 256;
+    constexpr vk::DeviceSize kBufferSize = 4096;
+    std::vector<vk::UniqueBuffer> buffers;
+    std::vector<frame::vulkan::GpuAllocation> allocations(kBufferCount);
+    for (auto& allocation : allocations)
+    {
+        buffers.push_back(memory_manager_->CreateBuffer(
+            kBufferSize,
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            allocation));
+    }
+
+    auto stats = memory_manager_->GetStats();
+    EXPECT_EQ(stats.allocation_count, kBufferCount);
+    EXPECT_EQ(stats.dedicated_count, 0u);
+    EXPECT_LT(stats.device_allocation_count, 4u);
+    EXPECT_LE(
+        stats.device_allocation_count, stats.max_device_allocation_count);
+    EXPECT_GE(stats.used_bytes, kBufferCount * kBufferSize);
+    // Ranges of the same block never overlap.
+    for (std::size_t i = 1; i < allocations.size(); ++i)
+    {
+        const auto& previous = allocations[i - 1];
+        const auto& current = allocations[i];
+        if (previous.GetMemory() == current.GetMemory())
+        {
+            EXPECT_TRUE(
+                previous.GetOffset() + previous.GetSize() <=
+                    current.GetOffset() ||
+                current.GetOffset() + current.GetSize() <=
+                    previous.GetOffset());
+        }
+    }
+
+    // Releasing every other range leaves holes, then everything merges back.
+    for (std::size_t i = 0; i < allocations.size(); i += 2)
+    {
+        allocations[i].Reset();
+    }
+    EXPECT_GT(memory_manager_->GetStats().fragmentation, 0.0);
+    allocations.clear();
+    buffers.clear();
+    stats = memory_manager_->GetStats();
+    EXPECT_EQ(stats.allocation_count, 0u);
+    EXPECT_EQ(stats.allocated_bytes, 0u);
+    EXPECT_DOUBLE_EQ(stats.fragmentation, 0.0);
+}
+
+TEST_F(GpuMemoryManagerTest, TransientPoolRewinds)
+{
+    const auto host_visible = vk::MemoryPropertyFlagBits::eHostVisible |
+                              vk::MemoryPropertyFlagBits::eHostCoherent;
+    frame::vulkan::GpuAllocation first;
+    frame::vulkan::GpuAllocation second;
+    auto first_buffer = memory_manager_->CreateBuffer(
+        1024,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        host_visible,
+        first,
+        frame::vulkan::GpuMemoryPool::eTransient);
+    auto second_buffer = memory_manager_->CreateBuffer(
+        1024,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        host_visible,
+        second,
+        frame::vulkan::GpuMemoryPool::eTransient);
+    ASSERT_NE(first.GetMappedData(), nullptr);
+    ASSERT_NE(second.GetMappedData(), nullptr);
+    EXPECT_EQ(first.GetMemory(), second.GetMemory());
+    EXPECT_GT(second.GetOffset(), first.GetOffset());
+    std::memset(second.GetMappedData(), 0xab, 1024);
+
+    first.Reset();
+    second.Reset();
+    frame::vulkan::GpuAllocation third;
+    auto third_buffer = memory_manager_->CreateBuffer(
+        1024,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        host_visible,
+        third,
+        frame::vulkan::GpuMemoryPool::eTransient);
+    EXPECT_EQ(third.GetOffset(), 0u);
+}
+
+} // namespace test
@@ -0,0 +1,219 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/parallel_command_recorder.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+
+using ParallelCommandRecorderTest = VulkanDeviceTest;
+
+TEST_F(ParallelCommandRecorderTest, RecordsSecondaries)
+{
+    // A pass without attachments is enough for the inheritance.
+    vk::SubpassDescription subpass({}, vk::PipelineBindPoint::eGraphics);
+    auto render_pass = device_->createRenderPassUnique(
+        vk::RenderPassCreateInfo({}, nullptr, subpass));
+    auto framebuffer = device_->createFramebufferUnique(
+        vk::FramebufferCreateInfo({}, *render_pass, nullptr, 16, 16, 1));
+
+    frame::vulkan::ParallelCommandRecorder recorder(
+        *device_, graphics_family_index_, 2);
+    std::array<std::thread::id, 3> thread_ids;
+    std::vector<frame::vulkan::SecondaryCommandTask> tasks;
+    for (std::size_t i = 0; i < thread_ids.size(); ++i)
+    {
+        tasks.push_back(
+            {"task",
+             *render_pass,
+             *framebuffer,
+             [&thread_ids, i](vk::CommandBuffer) {
+                 thread_ids[i] = std::this_thread::get_id();
+             }});
+    }
+    for (std::size_t frame = 0; frame < 4; ++frame)
+    {
+        recorder.BeginFrame(frame % 2);
+        const auto secondaries = recorder.Record(tasks);
+        ASSERT_EQ(secondaries.size(), tasks.size());
+        command_queue_->SubmitOneTime([&](vk::CommandBuffer command_buffer) {
+            command_buffer.beginRenderPass(
+                vk::RenderPassBeginInfo(
+                    *render_pass, *framebuffer, vk::Rect2D({0, 0}, {16, 16})),
+                vk::SubpassContents::eSecondaryCommandBuffers);
+            command_buffer.executeCommands(secondaries);
+            command_buffer.endRenderPass();
+        });
+    }
+    // The calling thread records the first task, the others get their own.
+    EXPECT_EQ(thread_ids[0], std::this_thread::get_id());
+    EXPECT_NE(thread_ids[1], thread_ids[0]);
+    EXPECT_NE(thread_ids[2], thread_ids[1]);
+    EXPECT_EQ(recorder.GetRecordTimes().size(), tasks.size());
+
+    tasks[1].record = [](vk::CommandBuffer) {
+        throw std::runtime_error("recording failed");
+    };
+    recorder.BeginFrame(0);
+    EXPECT_THROW(recorder.Record(tasks), std::runtime_error);
+}
+
+TEST_F(ParallelCommandRecorderTest, ExecutesInTaskOrder)
+{
+    // Task i clears the pixels [i, kTaskCount) to i + 1, pixel x ends up
+    // with x + 1 only if the secondaries run in the order of the tasks.
+    constexpr std::uint32_t kTaskCount = 6;
+    constexpr vk::Format kFormat = vk::Format::eR32Uint;
+    auto image = device_->createImageUnique(vk::ImageCreateInfo(
+        {},
+        vk::ImageType::e2D,
+        kFormat,
+        vk::Extent3D(kTaskCount, 1, 1),
+        1,
+        1,
+        vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eColorAttachment |
+            vk::ImageUsageFlagBits::eTransferSrc));
+    auto image_allocation = memory_manager_->AllocateImage(
+        *image, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    auto image_view = device_->createImageViewUnique(vk::ImageViewCreateInfo(
+        {},
+        *image,
+        vk::ImageViewType::e2D,
+        kFormat,
+        {},
+        {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}));
+
+    const vk::AttachmentDescription attachment(
+        {},
+        kFormat,
+        vk::SampleCountFlagBits::e1,
+        vk::AttachmentLoadOp::eClear,
+        vk::AttachmentStoreOp::eStore,
+        vk::AttachmentLoadOp::eDontCare,
+        vk::AttachmentStoreOp::eDontCare,
+        vk::ImageLayout::eUndefined,
+        vk::ImageLayout::eTransferSrcOptimal);
+    const vk::AttachmentReference color_reference(
+        0, vk::ImageLayout::eColorAttachmentOptimal);
+    const vk::SubpassDescription subpass(
+        {}, vk::PipelineBindPoint::eGraphics, {}, color_reference);
+    const vk::SubpassDependency to_transfer(
+        0,
+        VK_SUBPASS_EXTERNAL,
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::AccessFlagBits::eColorAttachmentWrite,
+        vk::AccessFlagBits::eTransferRead);
+    auto render_pass = device_->createRenderPassUnique(
+        vk::RenderPassCreateInfo({}, attachment, subpass, to_transfer));
+    auto framebuffer = device_->createFramebufferUnique(
+        vk::FramebufferCreateInfo(
+            {}, *render_pass, *image_view, kTaskCount, 1, 1));
+
+    std::vector<frame::vulkan::SecondaryCommandTask> tasks;
+    for (std::uint32_t i = 0; i < kTaskCount; ++i)
+    {
+        tasks.push_back(
+            {"task",
+             *render_pass,
+             *framebuffer,
+             [i](vk::CommandBuffer command_buffer) {
+                 const vk::ClearAttachment clear(
+                     vk::ImageAspectFlagBits::eColor,
+                     0,
+                     vk::ClearColorValue(
+                         std::array<std::uint32_t, 4>{i + 1, 0, 0, 0}));
+                 const vk::ClearRect rect(
+                     vk::Rect2D(
+                         {static_cast<std::int32_t>(i), 0},
+                         {kTaskCount - i, 1}),
+                     0,
+                     1);
+                 command_buffer.clearAttachments(clear, rect);
+             }});
+    }
+
+    frame::vulkan::GpuAllocation readback_allocation;
+    auto readback = memory_manager_->CreateBuffer(
+        kTaskCount * sizeof(std::uint32_t),
+        vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        readback_allocation);
+    frame::vulkan::ParallelCommandRecorder recorder(
+        *device_, graphics_family_index_, 1);
+    recorder.BeginFrame(0);
+    const auto secondaries = recorder.Record(tasks);
+    ASSERT_EQ(secondaries.size(), tasks.size());
+    command_queue_->SubmitOneTime([&](vk::CommandBuffer command_buffer) {
+        const vk::ClearValue clear_value(
+            vk::ClearColorValue(std::array<std::uint32_t, 4>{0, 0, 0, 0}));
+        command_buffer.beginRenderPass(
+            vk::RenderPassBeginInfo(
+                *render_pass,
+                *framebuffer,
+                vk::Rect2D({0, 0}, {kTaskCount, 1}),
+                clear_value),
+            vk::SubpassContents::eSecondaryCommandBuffers);
+        command_buffer.executeCommands(secondaries);
+        command_buffer.endRenderPass();
+        command_buffer.copyImageToBuffer(
+            *image,
+            vk::ImageLayout::eTransferSrcOptimal,
+            *readback,
+            vk::BufferImageCopy(
+                0,
+                0,
+                0,
+                {vk::ImageAspectFlagBits::eColor, 0, 0, 1},
+                {0, 0, 0},
+                {kTaskCount, 1, 1}));
+    });
+
+    std::array<std::uint32_t, kTaskCount> pixels{};
+    std::memcpy(
+        pixels.data(),
+        readback_allocation.GetMappedData(),
+        sizeof(pixels));
+    for (std::uint32_t x = 0; x < kTaskCount; ++x)
+    {
+        EXPECT_EQ(pixels[x], x + 1) << "pixel " << x;
+    }
+}
+
+TEST(ParallelCommandChunkTest, SplitsDrawListInOrder)
+{
+    // Not enough items for more than one chunk.
+    EXPECT_EQ(frame::vulkan::GetChunkCount(0, 8, 16), 1u);
+    EXPECT_EQ(frame::vulkan::GetChunkCount(20, 8, 16), 1u);
+    EXPECT_EQ(frame::vulkan::GetChunkCount(100, 8, 16), 6u);
+    EXPECT_EQ(frame::vulkan::GetChunkCount(1000, 8, 16), 8u);
+
+    constexpr std::size_t kCount = 100;
+    const std::size_t chunk_count = frame::vulkan::GetChunkCount(kCount, 8);
+    ASSERT_EQ(chunk_count, 8u);
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < chunk_count; ++i)
+    {
+        const auto [begin, end] =
+            frame::vulkan::GetChunkRange(kCount, chunk_count, i);
+        EXPECT_EQ(begin, next);
+        EXPECT_EQ(end - begin, i < kCount % chunk_count ? 13u : 12u);
+        next = end;
+    }
+    EXPECT_EQ(next, kCount);
+}
+
+} // namespace test
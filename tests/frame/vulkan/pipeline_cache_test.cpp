@@ -0,0 +1,164 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "frame/vulkan/pipeline_cache.h"
+#include "frame/vulkan/shader_compiler.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+namespace
+{
+
+// Offset of the pipeline cache UUID in VkPipelineCacheHeaderVersionOne.
+constexpr std::size_t kUuidOffset = 16;
+
+class PipelineCacheTest : public VulkanDeviceTest
+{
+  protected:
+    void SetUp() override
+    {
+        VulkanDeviceTest::SetUp();
+        if (IsSkipped() || HasFatalFailure())
+        {
+            return;
+        }
+        directory_ = std::filesystem::temp_directory_path() /
+                     "frame_pipeline_cache_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+        path_ = directory_ / "pipeline.cache";
+    }
+
+    void TearDown() override
+    {
+        VulkanDeviceTest::TearDown();
+        if (!directory_.empty())
+        {
+            std::filesystem::remove_all(directory_);
+        }
+    }
+
+    // Size of the data of a cache without any pipeline (header only).
+    std::size_t GetEmptySize() const
+    {
+        frame::vulkan::PipelineCache cache(physical_device_, *device_, {});
+        return GetData(cache).size();
+    }
+
+    std::vector<std::uint8_t> GetData(
+        const frame::vulkan::PipelineCache& cache) const
+    {
+        return device_->getPipelineCacheData(cache.Get());
+    }
+
+    // Put a compute pipeline in the cache so its data is more than a header.
+    void AddPipeline(const frame::vulkan::PipelineCache& cache) const
+    {
+        frame::vulkan::ShaderCompiler compiler(directory_ / "spirv");
+        const auto code = compiler.CompileSource(
+            "#version 450\n"
+            "layout(local_size_x = 1) in;\n"
+            "layout(std430, binding = 0) buffer Out { vec4 color; };\n"
+            "void main() { color = vec4(1.0); }\n",
+            shaderc_compute_shader,
+            "pipeline_cache_test.comp");
+        auto module = device_->createShaderModuleUnique(
+            vk::ShaderModuleCreateInfo(
+                {}, code.size() * sizeof(std::uint32_t), code.data()));
+        const vk::DescriptorSetLayoutBinding binding(
+            0,
+            vk::DescriptorType::eStorageBuffer,
+            1,
+            vk::ShaderStageFlagBits::eCompute);
+        auto set_layout = device_->createDescriptorSetLayoutUnique(
+            vk::DescriptorSetLayoutCreateInfo({}, binding));
+        auto pipeline_layout = device_->createPipelineLayoutUnique(
+            vk::PipelineLayoutCreateInfo({}, *set_layout));
+        auto pipeline = device_->createComputePipelineUnique(
+            cache.Get(),
+            vk::ComputePipelineCreateInfo(
+                {},
+                vk::PipelineShaderStageCreateInfo(
+                    {}, vk::ShaderStageFlagBits::eCompute, *module, "main"),
+                *pipeline_layout));
+        ASSERT_EQ(pipeline.result, vk::Result::eSuccess);
+    }
+
+    std::vector<std::uint8_t> ReadFile() const
+    {
+        std::ifstream file(path_, std::ios::binary);
+        return {(std::istreambuf_iterator<char>(file)), {}};
+    }
+
+    void WriteFile(const std::vector<std::uint8_t>& data) const
+    {
+        std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+        file.write(
+            reinterpret_cast<const char*>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+    }
+
+    // Save a cache holding one pipeline and return the file content.
+    std::vector<std::uint8_t> SaveFilledCache() const
+    {
+        frame::vulkan::PipelineCache cache(physical_device_, *device_, path_);
+        AddPipeline(cache);
+        cache.Save();
+        return ReadFile();
+    }
+
+    std::filesystem::path directory_;
+    std::filesystem::path path_;
+};
+
+} // namespace
+
+TEST_F(PipelineCacheTest, SaveAndLoadRoundTrip)
+{
+    const auto saved = SaveFilledCache();
+    ASSERT_GT(saved.size(), GetEmptySize());
+    EXPECT_FALSE(std::filesystem::exists(directory_ / "pipeline.cache.tmp"));
+
+    frame::vulkan::PipelineCache cache(physical_device_, *device_, path_);
+    EXPECT_EQ(GetData(cache).size(), saved.size());
+    // Saving again what was loaded leaves the same data on disk.
+    cache.Save();
+    EXPECT_EQ(ReadFile().size(), saved.size());
+}
+
+TEST_F(PipelineCacheTest, TruncatedHeaderStartsEmpty)
+{
+    auto data = SaveFilledCache();
+    ASSERT_GT(data.size(), kUuidOffset);
+    data.resize(kUuidOffset);
+    WriteFile(data);
+
+    frame::vulkan::PipelineCache cache(physical_device_, *device_, path_);
+    EXPECT_EQ(GetData(cache).size(), GetEmptySize());
+}
+
+TEST_F(PipelineCacheTest, OtherPipelineCacheUuidStartsEmpty)
+{
+    auto data = SaveFilledCache();
+    ASSERT_GT(data.size(), kUuidOffset + VK_UUID_SIZE);
+    data[kUuidOffset] ^= 0xff;
+    WriteFile(data);
+
+    frame::vulkan::PipelineCache cache(physical_device_, *device_, path_);
+    EXPECT_EQ(GetData(cache).size(), GetEmptySize());
+}
+
+TEST_F(PipelineCacheTest, MissingFileStartsEmpty)
+{
+    frame::vulkan::PipelineCache cache(physical_device_, *device_, path_);
+    EXPECT_EQ(GetData(cache).size(), GetEmptySize());
+}
+
+} // namespace test
@@ -2,7 +2,6 @@
 
 #include <gtest/gtest.h>
 
-#include <array>
 #include <cstring>
 #include <optional>
 #include <vector>
@@ -13,6 +12,7 @@
 #include "frame/vulkan/gpu_memory_manager.h"
 #include "frame/vulkan/mesh_resources.h"
 #include "frame/vulkan/scene_state.h"
+#include "frame/vulkan/vulkan_device_test.h"
 #include "frame/vulkan/vulkan_dispatch.h"
 
 namespace test
@@ -115,6 +115,9 @@ class VulkanResourceFixture : public ::testing::Test
     std::unique_ptr<frame::vulkan::CommandQueue> command_queue_;
 };
 
+// Runs on CPU devices too.
+using BufferResourcesTest = VulkanDeviceTest;
+
 } // namespace
 
 TEST_F(VulkanResourceFixture, MeshResourcesBuildFallbackQuad)
@@ -248,12 +251,47 @@ TEST_F(VulkanResourceFixture, BufferResourcesUpdateUniformData)
     const auto* uniform = manager.GetUniformBuffer();
     ASSERT_NE(uniform, nullptr);
     auto mapped = static_cast<const frame::vulkan::UniformBlock*>(
-        device_->mapMemory(*uniform->memory, 0, uniform->size));
+        uniform->allocation.GetMappedData());
     ASSERT_NE(mapped, nullptr);
     EXPECT_FLOAT_EQ(mapped->camera_position.x, 1.0f);
     EXPECT_FLOAT_EQ(mapped->camera_position.y, 2.0f);
     EXPECT_FLOAT_EQ(mapped->camera_position.z, 3.0f);
-    device_->unmapMemory(*uniform->memory);
+}
+
+TEST_F(BufferResourcesTest, UniformCopyPerFrame)
+{
+    frame::vulkan::BufferResourceManager manager(
+        *device_,
+        *memory_manager_,
+        *command_queue_,
+        frame::Logger::GetInstance(),
+        2);
+    manager.BuildUniformBuffer(sizeof(frame::vulkan::UniformBlock));
+
+    frame::vulkan::UniformBlock block{};
+    manager.BeginFrame(0);
+    block.camera_position = glm::vec4(1.0f);
+    manager.UpdateUniform(&block, sizeof(block));
+    EXPECT_EQ(manager.GetUniformOffset(), 0u);
+    // The next frame must not overwrite the block of the frame in flight.
+    manager.BeginFrame(1);
+    block.camera_position = glm::vec4(2.0f);
+    manager.UpdateUniform(&block, sizeof(block));
+    const std::uint32_t offset = manager.GetUniformOffset();
+    EXPECT_GE(offset, sizeof(frame::vulkan::UniformBlock));
+    EXPECT_EQ(offset % 256, 0u);
+
+    const auto* mapped = static_cast<const std::uint8_t*>(
+        manager.GetUniformBuffer()->allocation.GetMappedData());
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_FLOAT_EQ(
+        reinterpret_cast<const frame::vulkan::UniformBlock*>(mapped)
+            ->camera_position.x,
+        1.0f);
+    EXPECT_FLOAT_EQ(
+        reinterpret_cast<const frame::vulkan::UniformBlock*>(mapped + offset)
+            ->camera_position.x,
+        2.0f);
 }
 
 } // namespace test
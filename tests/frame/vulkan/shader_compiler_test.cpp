@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "frame/file/file_system.h"
+#include "frame/json/parse_level.h"
+#include "frame/vulkan/shader_compiler.h"
+
+namespace test
+{
+
+class ShaderCompilerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        directory_ = std::filesystem::temp_directory_path() /
+                     "frame_shader_compiler_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_ / "shader");
+        WriteFile(
+            "shader/test.comp",
+            "#version 450\n"
+            "#extension GL_GOOGLE_include_directive : require\n"
+            "#include \"color.glsl\"\n"
+            "layout(local_size_x = 1) in;\n"
+            "layout(std430, binding = 0) buffer Out { vec4 color; };\n"
+            "void main() { color = kColor; }\n");
+        WriteFile("shader/color.glsl", "const vec4 kColor = vec4(1.0);\n");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    void WriteFile(const std::string& name, const std::string& content)
+    {
+        std::ofstream file(directory_ / name, std::ios::trunc);
+        file << content;
+    }
+
+    std::filesystem::path GetSourcePath() const
+    {
+        return directory_ / "shader" / "test.comp";
+    }
+
+    std::filesystem::path GetCacheDirectory() const
+    {
+        return directory_ / "cache";
+    }
+
+    std::filesystem::path directory_;
+};
+
+TEST_F(ShaderCompilerTest, MemoryThenDiskHits)
+{
+    std::vector<std::uint32_t> compiled;
+    {
+        frame::vulkan::ShaderCompiler compiler(GetCacheDirectory());
+        compiled =
+            compiler.CompileFile(GetSourcePath(), shaderc_compute_shader);
+        ASSERT_FALSE(compiled.empty());
+        EXPECT_EQ(
+            compiler.CompileFile(GetSourcePath(), shaderc_compute_shader),
+            compiled);
+        const auto stats = compiler.GetCacheStats();
+        EXPECT_EQ(stats.misses, 1u);
+        EXPECT_EQ(stats.memory_hits, 1u);
+        // The second call found the key of the unchanged source.
+        EXPECT_EQ(stats.preprocessed, 1u);
+    }
+    // A new compiler (restart) finds the module on disk.
+    frame::vulkan::ShaderCompiler compiler(GetCacheDirectory());
+    EXPECT_EQ(
+        compiler.CompileFile(GetSourcePath(), shaderc_compute_shader),
+        compiled);
+    const auto stats = compiler.GetCacheStats();
+    EXPECT_EQ(stats.disk_hits, 1u);
+    EXPECT_EQ(stats.misses, 0u);
+}
+
+TEST_F(ShaderCompilerTest, IncludeChangeIsAMiss)
+{
+    frame::vulkan::ShaderCompiler compiler(GetCacheDirectory());
+    const auto first =
+        compiler.CompileFile(GetSourcePath(), shaderc_compute_shader);
+    EXPECT_EQ(compiler.GetCacheStats().misses, 1u);
+    // The source did not change, only the included file.
+    WriteFile("shader/color.glsl", "const vec4 kColor = vec4(0.5);\n");
+    const auto second =
+        compiler.CompileFile(GetSourcePath(), shaderc_compute_shader);
+    EXPECT_EQ(compiler.GetCacheStats().misses, 2u);
+    EXPECT_EQ(compiler.GetCacheStats().preprocessed, 2u);
+    EXPECT_NE(first, second);
+}
+
+TEST_F(ShaderCompilerTest, RaytracingBvhLevelThreads)
+{
+    const auto asset_root = frame::file::FindDirectory("asset");
+    const auto level_data = frame::json::ParseLevelData(
+        {320, 200}, asset_root / "json" / "raytracing_bvh.json", asset_root);
+    std::vector<frame::vulkan::ShaderCompileRequest> requests;
+    const auto shader_root = asset_root / "shader" / "vulkan";
+    for (const auto& program_info : level_data.programs)
+    {
+        if (!program_info.vertex_shader.empty())
+            requests.push_back(
+                {shader_root / program_info.vertex_shader,
+                 shaderc_vertex_shader});
+        if (!program_info.fragment_shader.empty())
+            requests.push_back(
+                {shader_root / program_info.fragment_shader,
+                 shaderc_fragment_shader});
+        if (!program_info.compute_shader.empty())
+            requests.push_back(
+                {shader_root / program_info.compute_shader,
+                 shaderc_compute_shader});
+    }
+    ASSERT_FALSE(requests.empty());
+    const std::size_t thread_count =
+        std::max(2u, std::thread::hardware_concurrency());
+    for (const std::size_t threads : {std::size_t{1}, thread_count})
+    {
+        // Cold caches, every module is compiled.
+        frame::vulkan::ShaderCompiler compiler(
+            GetCacheDirectory() / std::to_string(threads));
+        compiler.CompileFiles(requests, threads);
+        const auto cold = compiler.GetCacheStats();
+        EXPECT_EQ(cold.disk_hits, 0u);
+        EXPECT_GT(cold.misses, 0u);
+        EXPECT_EQ(cold.misses + cold.memory_hits, requests.size());
+        // Level reload, every module is found in memory.
+        compiler.CompileFiles(requests, threads);
+        const auto warm = compiler.GetCacheStats();
+        EXPECT_EQ(warm.misses, cold.misses);
+        EXPECT_EQ(warm.disk_hits, 0u);
+        EXPECT_EQ(warm.memory_hits, cold.memory_hits + requests.size());
+        EXPECT_EQ(warm.preprocessed, cold.preprocessed);
+    }
+}
+
+} // namespace test
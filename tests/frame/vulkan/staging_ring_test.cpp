@@ -0,0 +1,62 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/staging_ring.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+
+using StagingRingTest = VulkanDeviceTest;
+
+TEST_F(StagingRingTest, UploadsAndGrows)
+{
+    constexpr vk::DeviceSize kSize = 512;
+    frame::vulkan::GpuAllocation gpu_allocation;
+    auto gpu_buffer = memory_manager_->CreateBuffer(
+        kSize,
+        vk::BufferUsageFlagBits::eTransferDst |
+            vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eDeviceLocal,
+        gpu_allocation);
+    frame::vulkan::StagingRing ring(*memory_manager_, 2, 256);
+    std::vector<std::uint8_t> bytes(kSize);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::uint8_t>(i * 7);
+    }
+
+    // Too big for the region, it grows the next time the frame comes up.
+    ring.BeginFrame(0);
+    EXPECT_FALSE(ring.Upload(bytes.data(), kSize, *gpu_buffer));
+    ring.BeginFrame(1);
+    EXPECT_EQ(ring.GetCapacity(1), 256u);
+    ring.BeginFrame(0);
+    EXPECT_GE(ring.GetCapacity(0), kSize);
+    ASSERT_TRUE(ring.Upload(bytes.data(), kSize, *gpu_buffer));
+    std::size_t copy_count = 0;
+    command_queue_->SubmitOneTime([&](vk::CommandBuffer command_buffer) {
+        copy_count = ring.RecordCopies(command_buffer);
+    });
+    EXPECT_EQ(copy_count, 1u);
+
+    frame::vulkan::GpuAllocation readback_allocation;
+    auto readback = memory_manager_->CreateBuffer(
+        kSize,
+        vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        readback_allocation);
+    command_queue_->CopyBuffer(*gpu_buffer, *readback, kSize);
+    EXPECT_EQ(
+        std::memcmp(readback_allocation.GetMappedData(), bytes.data(), kSize),
+        0);
+}
+
+} // namespace test
@@ -0,0 +1,68 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "frame/logger.h"
+#include "frame/vulkan/swapchain_resources.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+
+namespace
+{
+
+// Swapchain without a surface, the target of the benchmark run mode.
+class OffscreenSwapchainTest : public VulkanDeviceTest
+{
+  protected:
+    void SetUp() override
+    {
+        VulkanDeviceTest::SetUp();
+        if (IsSkipped() || HasFatalFailure())
+        {
+            return;
+        }
+        swapchain_ = std::make_unique<frame::vulkan::SwapchainResources>(
+            physical_device_,
+            *device_,
+            VK_NULL_HANDLE,
+            graphics_family_index_,
+            graphics_family_index_,
+            frame::Logger::GetInstance(),
+            kImageCount);
+    }
+
+    void TearDown() override
+    {
+        VulkanDeviceTest::TearDown();
+        swapchain_.reset();
+    }
+
+    static constexpr std::uint32_t kImageCount = 3;
+    std::unique_ptr<frame::vulkan::SwapchainResources> swapchain_;
+};
+
+} // namespace
+
+TEST_F(OffscreenSwapchainTest, WithoutSurfaceIsOffscreen)
+{
+    auto& swapchain = *swapchain_;
+    swapchain.Create({64, 32});
+    EXPECT_TRUE(swapchain.IsValid());
+    EXPECT_TRUE(swapchain.IsOffscreen());
+    EXPECT_FALSE(static_cast<bool>(swapchain.GetSwapchain()));
+    EXPECT_EQ(swapchain.GetImages().size(), kImageCount);
+    EXPECT_EQ(swapchain.GetFramebuffers().size(), kImageCount);
+    EXPECT_EQ(swapchain.GetGuiFramebuffers().size(), kImageCount);
+    EXPECT_EQ(swapchain.GetExtent().width, 64u);
+    EXPECT_EQ(swapchain.GetExtent().height, 32u);
+    EXPECT_EQ(
+        swapchain.GetPresentLayout(), vk::ImageLayout::eTransferSrcOptimal);
+    swapchain.Destroy();
+    EXPECT_FALSE(swapchain.IsValid());
+}
+
+} // namespace test
@@ -0,0 +1,59 @@
+#define VULKAN_HPP_ENABLE_DYNAMIC_LOADER_TOOL 1
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/upload_context.h"
+#include "frame/vulkan/vulkan_device_test.h"
+
+namespace test
+{
+
+using UploadContextTest = VulkanDeviceTest;
+
+TEST_F(UploadContextTest, SubmitsWithoutWaiting)
+{
+    constexpr vk::DeviceSize kSize = 256;
+    frame::vulkan::GpuAllocation gpu_allocation;
+    auto gpu_buffer = memory_manager_->CreateBuffer(
+        kSize,
+        vk::BufferUsageFlagBits::eTransferDst |
+            vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eDeviceLocal,
+        gpu_allocation);
+    std::vector<std::uint8_t> bytes(kSize);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::uint8_t>(i * 3);
+    }
+
+    frame::vulkan::UploadContext upload_context(
+        *device_, *memory_manager_, queue_, graphics_family_index_, true);
+    // Nothing recorded, the future is ready.
+    EXPECT_TRUE(upload_context.Submit().IsReady());
+    // Two halves in one batch.
+    upload_context.CopyToBuffer(bytes.data(), kSize / 2, *gpu_buffer);
+    upload_context.CopyToBuffer(
+        bytes.data() + kSize / 2, kSize / 2, *gpu_buffer, kSize / 2);
+    auto future = upload_context.Submit();
+    future.Wait();
+    EXPECT_TRUE(future.IsReady());
+
+    frame::vulkan::GpuAllocation readback_allocation;
+    auto readback = memory_manager_->CreateBuffer(
+        kSize,
+        vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        readback_allocation);
+    command_queue_->CopyBuffer(*gpu_buffer, *readback, kSize);
+    EXPECT_EQ(
+        std::memcmp(readback_allocation.GetMappedData(), bytes.data(), kSize),
+        0);
+}
+
+} // namespace test
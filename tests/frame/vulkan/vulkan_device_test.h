@@ -0,0 +1,107 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "frame/vulkan/command_queue.h"
+#include "frame/vulkan/gpu_memory_manager.h"
+#include "frame/vulkan/vulkan_dispatch.h"
+
+namespace test
+{
+
+// Device with one graphics queue, on the first physical device even if it
+// is a CPU one (lavapipe), so the tests run on machines without a GPU.
+class VulkanDeviceTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto vk_get_instance_proc_addr =
+            reinterpret_cast<PFN_vkGetInstanceProcAddr>(vkGetInstanceProcAddr);
+        ASSERT_NE(vk_get_instance_proc_addr, nullptr);
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(vk_get_instance_proc_addr);
+
+        vk::ApplicationInfo app_info(
+            "VulkanDeviceTest",
+            1,
+            "Frame",
+            1,
+            VK_API_VERSION_1_1);
+        vk::InstanceCreateInfo instance_info({}, &app_info);
+        try
+        {
+            instance_ = vk::createInstanceUnique(instance_info);
+        }
+        catch (const vk::SystemError& err)
+        {
+            GTEST_SKIP()
+                << "Skipping Vulkan tests: unable to create instance ("
+                << err.what() << ").";
+            return;
+        }
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance_);
+
+        auto physical_devices = instance_->enumeratePhysicalDevices();
+        if (physical_devices.empty())
+        {
+            GTEST_SKIP()
+                << "Skipping Vulkan tests: no physical devices found.";
+            return;
+        }
+        physical_device_ = physical_devices.front();
+
+        const auto queue_props = physical_device_.getQueueFamilyProperties();
+        std::optional<std::uint32_t> graphics_index;
+        for (std::uint32_t i = 0; i < queue_props.size(); ++i)
+        {
+            if (queue_props[i].queueFlags & vk::QueueFlagBits::eGraphics)
+            {
+                graphics_index = i;
+                break;
+            }
+        }
+        ASSERT_TRUE(graphics_index.has_value());
+        graphics_family_index_ = graphics_index.value();
+
+        float priority = 1.0f;
+        vk::DeviceQueueCreateInfo queue_info(
+            {}, graphics_family_index_, 1, &priority);
+        vk::DeviceCreateInfo device_info({}, 1, &queue_info);
+        device_ = physical_device_.createDeviceUnique(device_info);
+        VULKAN_HPP_DEFAULT_DISPATCHER.init(*device_);
+
+        queue_ = device_->getQueue(graphics_family_index_, 0);
+        vk::CommandPoolCreateInfo pool_info(
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            graphics_family_index_);
+        command_pool_ = device_->createCommandPoolUnique(pool_info);
+
+        memory_manager_ = std::make_unique<frame::vulkan::GpuMemoryManager>(
+            physical_device_, *device_);
+        command_queue_ = std::make_unique<frame::vulkan::CommandQueue>(
+            *device_, queue_, *command_pool_);
+    }
+
+    void TearDown() override
+    {
+        if (device_)
+        {
+            device_->waitIdle();
+        }
+    }
+
+    vk::UniqueInstance instance_;
+    vk::PhysicalDevice physical_device_;
+    std::uint32_t graphics_family_index_ = 0;
+    vk::UniqueDevice device_;
+    vk::Queue queue_;
+    vk::UniqueCommandPool command_pool_;
+    std::unique_ptr<frame::vulkan::GpuMemoryManager> memory_manager_;
+    std::unique_ptr<frame::vulkan::CommandQueue> command_queue_;
+};
+
+} // namespace test